@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// RGB565 目标上的几种混合内核，不依赖 LVGL，主机工具（tools/blend_bench）直接拿来测。
+// 结果和 LVGL 9.2 lv_draw_sw_blend_to_rgb565.c 的 C 代码逐位一致：
+//   lv_color_16_16_mix 的 0x7E0F81F 打包算法等价于按通道 (f * m + b * (32 - m)) >> 5，m = (mix + 4) >> 3，
+//   mix 为 0/255、前景等于背景时也是同一个式子，不用分支。
+// blend_kern_ref 是可移植的 C 实现。
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    uint16_t *dst;
+    int32_t dst_stride; // 字节
+    const uint16_t *src; // 图像，普通字节序 RGB565；填色时不用
+    int32_t src_stride;
+    const uint8_t *mask; // 可为 NULL
+    int32_t mask_stride;
+    int32_t w;
+    int32_t h;
+    uint16_t color; // 填色，普通字节序 RGB565
+    uint8_t opa;    // 255 为不透明；有遮罩时按 LV_OPA_MIX2 和遮罩相乘
+    bool swapped;   // 目标是 RGB565_SWAPPED（高字节在前）
+} blend_job_t;
+
+typedef struct
+{
+    const char *name;
+    void (*fill)(const blend_job_t *j);     // 不透明纯色，不看 opa/mask
+    void (*fill_mix)(const blend_job_t *j); // 纯色带 opa 和/或遮罩
+    void (*copy)(const blend_job_t *j);     // 不透明图像，不看 opa/mask
+    void (*img_mix)(const blend_job_t *j);  // 图像带 opa 和/或遮罩
+} blend_kern_t;
+
+extern const blend_kern_t blend_kern_ref;
+
+static inline uint16_t blend_swap16(uint16_t c)
+{
+    return (uint16_t)((c >> 8) | (c << 8));
+}
+
+// 和 lv_color_16_16_mix 一致
+static inline uint16_t blend_mix16(uint16_t fg, uint16_t bg, uint8_t mix)
+{
+    uint32_t m = ((uint32_t)mix + 4) >> 3;
+    uint32_t f = (fg | ((uint32_t)fg << 16)) & 0x7E0F81F;
+    uint32_t b = (bg | ((uint32_t)bg << 16)) & 0x7E0F81F;
+    uint32_t r = ((f * m + b * (32 - m)) >> 5) & 0x7E0F81F;
+    return (uint16_t)((r >> 16) | r);
+}
+
+// 和 LV_OPA_MIX2 一致
+static inline uint8_t blend_opa_mix2(uint8_t a, uint8_t b)
+{
+    return (uint8_t)(((uint32_t)a * b) >> 8);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,46 @@
+#pragma once
+
+// LVGL 软件渲染的自定义加速入口（LV_USE_DRAW_SW_ASM = LV_DRAW_SW_ASM_CUSTOM，
+// LV_DRAW_SW_ASM_CUSTOM_INCLUDE = "lv_blend_s3.h"），LVGL 的绘制源文件会 include 这个头。
+// 接管由 CONFIG_LV_BLEND_S3 控制（默认关）：关着时下面的宏都不定义，LVGL 照旧用自己的 C 代码。
+// 只接管 tools/blend_bench 量出来比 LVGL 快的几种：带 opa 的纯色填充、带 opa 和/或遮罩的 RGB565 图像 NORMAL 混合。
+// 不透明填充、只带遮罩的填充和不透明图像拷贝和 LVGL 持平或更慢，不定义对应的宏，其他格式也一样不接管。
+//
+// lv_draw_sw_blend_to_rgb565.c 编两遍（普通和 SWAPPED 字节序），宏展开时
+// LV_DRAW_SW_BLEND_RGB565_SWAPPED 告诉我们当前是哪一遍。
+
+// 在 LVGL 源文件里被 include 时类型已经齐了，不再 include lvgl.h；自己的代码先 include "lvgl.h"
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef LV_DRAW_SW_BLEND_RGB565_SWAPPED
+#define LV_BLEND_S3_SWAPPED LV_DRAW_SW_BLEND_RGB565_SWAPPED
+#else
+#define LV_BLEND_S3_SWAPPED 0
+#endif
+
+#if defined(CONFIG_LV_BLEND_S3) && CONFIG_LV_BLEND_S3
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_OPA(dsc)          lv_blend_s3_color(dsc, LV_BLEND_S3_SWAPPED)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_MIX_MASK_OPA(dsc)      lv_blend_s3_color(dsc, LV_BLEND_S3_SWAPPED)
+
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc)  lv_blend_s3_image(dsc, LV_BLEND_S3_SWAPPED)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_MASK(dsc) lv_blend_s3_image(dsc, LV_BLEND_S3_SWAPPED)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA(dsc) lv_blend_s3_image(dsc, LV_BLEND_S3_SWAPPED)
+#endif
+
+// 纯色填充到 RGB565 目标，swapped 为目标字节序；总是返回 LV_RESULT_OK。
+// 没接管的情况（不透明、只带遮罩）也能算，tools/blend_bench 拿它和 LVGL 对比
+lv_result_t lv_blend_s3_color(lv_draw_sw_blend_fill_dsc_t *dsc, bool swapped);
+
+// RGB565 图像以 NORMAL 模式混合到 RGB565 目标
+lv_result_t lv_blend_s3_image(lv_draw_sw_blend_image_dsc_t *dsc, bool swapped);
+
+// 使用的内核名字（"c"）
+const char *lv_blend_s3_kernel_name(void);
+
+#ifdef __cplusplus
+}
+#endif
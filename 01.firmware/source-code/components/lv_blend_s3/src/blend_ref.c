@@ -0,0 +1,218 @@
+#include <string.h>
+
+#include "blend_kern.h"
+
+// 可移植的 C 实现。按行处理，目标字节序在读写两头换，混合本身总在普通字节序上算。
+// 作业里的字段先拷到局部变量：写 uint16_t / uint32_t 像素时编译器不能假设 j-> 没被改，否则每个像素都要重新读
+
+static inline uint16_t *next_row(const void *p, int32_t stride)
+{
+    return (uint16_t *)((uint8_t *)p + stride);
+}
+
+static inline uint16_t to_dest(uint16_t c, bool swapped)
+{
+    return swapped ? blend_swap16(c) : c;
+}
+
+// 普通字节序的 RGB565 展开成 0x7E0F81F 布局，三个通道之间留出乘法的空位
+static inline uint32_t spread(uint16_t c)
+{
+    return (c | ((uint32_t)c << 16)) & 0x7E0F81F;
+}
+
+static inline uint16_t pack(uint32_t r)
+{
+    return (uint16_t)((r >> 16) | r);
+}
+
+static void ref_fill(const blend_job_t *j)
+{
+    const int32_t w = j->w, h = j->h, stride = j->dst_stride;
+    const uint16_t c = to_dest(j->color, j->swapped);
+    const uint32_t c32 = c | ((uint32_t)c << 16);
+    uint16_t *d = j->dst;
+    for (int32_t y = 0; y < h; y++)
+    {
+        int32_t x = 0;
+        if (((uintptr_t)d & 0x3) && w > 0)
+            d[x++] = c;
+        uint32_t *d32 = (uint32_t *)&d[x];
+        int32_t n = (w - x) >> 1, i = 0;
+        // 和 LVGL 一样 8 个字一组展开
+        for (; i + 8 <= n; i += 8)
+        {
+            d32[i + 0] = c32;
+            d32[i + 1] = c32;
+            d32[i + 2] = c32;
+            d32[i + 3] = c32;
+            d32[i + 4] = c32;
+            d32[i + 5] = c32;
+            d32[i + 6] = c32;
+            d32[i + 7] = c32;
+        }
+        for (; i < n; i++)
+            d32[i] = c32;
+        x += n * 2;
+        if (x < w)
+            d[x] = c;
+        d = next_row(d, stride);
+    }
+}
+
+static void ref_fill_mix(const blend_job_t *j)
+{
+    const int32_t w = j->w, h = j->h, stride = j->dst_stride, mask_stride = j->mask_stride;
+    const bool sw = j->swapped;
+    const uint8_t opa = j->opa;
+    const uint16_t color = j->color;
+    uint16_t *d = j->dst;
+    const uint8_t *mask = j->mask;
+
+    if (!mask)
+    {
+        // 前景是常量，f * m 只算一次
+        const uint32_t m = ((uint32_t)opa + 4) >> 3;
+        const uint32_t fm = spread(color) * m;
+        const uint32_t mi = 32 - m;
+        for (int32_t y = 0; y < h; y++)
+        {
+            for (int32_t x = 0; x < w; x++)
+            {
+                uint32_t b = spread(to_dest(d[x], sw));
+                d[x] = to_dest(pack(((fm + b * mi) >> 5) & 0x7E0F81F), sw);
+            }
+            d = next_row(d, stride);
+        }
+        return;
+    }
+
+    const uint16_t full = to_dest(color, sw);
+    for (int32_t y = 0; y < h; y++)
+    {
+        int32_t x = 0;
+        if (opa == 255)
+        {
+            // 文字和圆角边缘的遮罩大片是 0 或 255，4 个一组跳过或直接写
+            for (; x < w && ((uintptr_t)&mask[x] & 0x3); x++)
+                d[x] = to_dest(blend_mix16(color, to_dest(d[x], sw), mask[x]), sw);
+            for (; x + 4 <= w; x += 4)
+            {
+                uint32_t m4 = *(const uint32_t *)&mask[x];
+                if (m4 == 0)
+                    continue;
+                if (m4 == 0xFFFFFFFF)
+                {
+                    d[x] = d[x + 1] = d[x + 2] = d[x + 3] = full;
+                    continue;
+                }
+                for (int32_t k = x; k < x + 4; k++)
+                    d[k] = to_dest(blend_mix16(color, to_dest(d[k], sw), mask[k]), sw);
+            }
+            for (; x < w; x++)
+                d[x] = to_dest(blend_mix16(color, to_dest(d[x], sw), mask[x]), sw);
+        }
+        else
+        {
+            for (; x < w; x++)
+            {
+                uint8_t a = blend_opa_mix2(mask[x], opa);
+                if (a)
+                    d[x] = to_dest(blend_mix16(color, to_dest(d[x], sw), a), sw);
+            }
+        }
+        d = next_row(d, stride);
+        mask += mask_stride;
+    }
+}
+
+static void ref_copy(const blend_job_t *j)
+{
+    const int32_t w = j->w, h = j->h, dst_stride = j->dst_stride, src_stride = j->src_stride;
+    uint16_t *d = j->dst;
+    const uint16_t *s = j->src;
+
+    if (!j->swapped)
+    {
+        for (int32_t y = 0; y < h; y++)
+        {
+            memcpy(d, s, (size_t)w * 2);
+            d = next_row(d, dst_stride);
+            s = next_row(s, src_stride);
+        }
+        return;
+    }
+
+    for (int32_t y = 0; y < h; y++)
+    {
+        int32_t x = 0;
+        // 源和目标同样 4 字节对齐时一次换两个像素
+        if ((((uintptr_t)d ^ (uintptr_t)s) & 0x3) == 0)
+        {
+            if (((uintptr_t)d & 0x3) && w > 0)
+            {
+                d[0] = blend_swap16(s[0]);
+                x = 1;
+            }
+            uint32_t *d32 = (uint32_t *)&d[x];
+            const uint32_t *s32 = (const uint32_t *)&s[x];
+            int32_t n = (w - x) >> 1;
+            for (int32_t i = 0; i < n; i++)
+            {
+                uint32_t v = s32[i];
+                d32[i] = ((v & 0xFF00FF00) >> 8) | ((v & 0x00FF00FF) << 8);
+            }
+            x += n * 2;
+        }
+        for (; x < w; x++)
+            d[x] = blend_swap16(s[x]);
+        d = next_row(d, dst_stride);
+        s = next_row(s, src_stride);
+    }
+}
+
+static void ref_img_mix(const blend_job_t *j)
+{
+    const int32_t w = j->w, h = j->h, dst_stride = j->dst_stride, src_stride = j->src_stride;
+    const int32_t mask_stride = j->mask_stride;
+    const bool sw = j->swapped;
+    const uint8_t opa = j->opa;
+    uint16_t *d = j->dst;
+    const uint16_t *s = j->src;
+    const uint8_t *mask = j->mask;
+
+    const uint32_t m = ((uint32_t)opa + 4) >> 3;
+    const uint32_t mi = 32 - m;
+    for (int32_t y = 0; y < h; y++)
+    {
+        if (!mask)
+        {
+            for (int32_t x = 0; x < w; x++)
+            {
+                uint32_t f = spread(s[x]);
+                uint32_t b = spread(to_dest(d[x], sw));
+                d[x] = to_dest(pack(((f * m + b * mi) >> 5) & 0x7E0F81F), sw);
+            }
+        }
+        else
+        {
+            for (int32_t x = 0; x < w; x++)
+            {
+                uint8_t a = opa == 255 ? mask[x] : blend_opa_mix2(mask[x], opa);
+                if (a)
+                    d[x] = to_dest(blend_mix16(s[x], to_dest(d[x], sw), a), sw);
+            }
+            mask += mask_stride;
+        }
+        d = next_row(d, dst_stride);
+        s = next_row(s, src_stride);
+    }
+}
+
+const blend_kern_t blend_kern_ref = {
+    .name = "c",
+    .fill = ref_fill,
+    .fill_mix = ref_fill_mix,
+    .copy = ref_copy,
+    .img_mix = ref_img_mix,
+};
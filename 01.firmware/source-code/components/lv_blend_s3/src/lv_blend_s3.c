@@ -0,0 +1,56 @@
+#include "lvgl.h"
+#include "src/draw/sw/blend/lv_draw_sw_blend_private.h"
+#include "lv_blend_s3.h"
+#include "blend_kern.h"
+
+// LVGL 的 opa >= LV_OPA_MAX 按完全不透明处理，带遮罩时直接用遮罩值
+static inline uint8_t job_opa(lv_opa_t opa)
+{
+    return opa >= LV_OPA_MAX ? 255 : opa;
+}
+
+lv_result_t LV_ATTRIBUTE_FAST_MEM lv_blend_s3_color(lv_draw_sw_blend_fill_dsc_t *dsc, bool swapped)
+{
+    blend_job_t j = {
+        .dst = dsc->dest_buf,
+        .dst_stride = dsc->dest_stride,
+        .mask = dsc->mask_buf,
+        .mask_stride = dsc->mask_stride,
+        .w = dsc->dest_w,
+        .h = dsc->dest_h,
+        .color = lv_color_to_u16(dsc->color),
+        .opa = job_opa(dsc->opa),
+        .swapped = swapped,
+    };
+    if (!j.mask && j.opa == 255)
+        blend_kern_ref.fill(&j);
+    else
+        blend_kern_ref.fill_mix(&j);
+    return LV_RESULT_OK;
+}
+
+lv_result_t LV_ATTRIBUTE_FAST_MEM lv_blend_s3_image(lv_draw_sw_blend_image_dsc_t *dsc, bool swapped)
+{
+    blend_job_t j = {
+        .dst = dsc->dest_buf,
+        .dst_stride = dsc->dest_stride,
+        .src = dsc->src_buf,
+        .src_stride = dsc->src_stride,
+        .mask = dsc->mask_buf,
+        .mask_stride = dsc->mask_stride,
+        .w = dsc->dest_w,
+        .h = dsc->dest_h,
+        .opa = job_opa(dsc->opa),
+        .swapped = swapped,
+    };
+    if (!j.mask && j.opa == 255)
+        blend_kern_ref.copy(&j);
+    else
+        blend_kern_ref.img_mix(&j);
+    return LV_RESULT_OK;
+}
+
+const char *lv_blend_s3_kernel_name(void)
+{
+    return blend_kern_ref.name;
+}
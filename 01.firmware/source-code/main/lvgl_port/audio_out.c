@@ -0,0 +1,335 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_err.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+
+#include "bsp_board_extra.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "audio_out.h"
+
+static const char *TAG = "audio_out";
+
+#define MAX_FRAME_BYTES 8 // 32 位双声道
+
+typedef struct
+{
+    audio_out_config_t cfg;
+
+    uint8_t *ring;
+    size_t ring_alloc;
+    uint8_t *pad; // 欠载时把零头补满一块静音再写，放内部内存
+
+    // 以下由 lock 保护
+    uint32_t cap;   // ring_alloc 向下取整到块大小
+    uint32_t block; // dma_frames x 每帧字节数
+    uint32_t head;  // 下一个要写 codec 的字节在环内的偏移
+    uint32_t fill;  // 环里待写字节，写入端从 (head + fill) % cap 往后放
+    uint32_t bytes_per_sec;
+    bool starved; // 播放中被取空，下次有数据写入时记一次欠载
+    audio_out_stats_t st;
+
+    SemaphoreHandle_t lock;
+    SemaphoreHandle_t io;    // 写入任务写一块期间持有；flush/改格式时用来等它写完
+    SemaphoreHandle_t data;  // 有新数据
+    SemaphoreHandle_t space; // 有空位
+    SemaphoreHandle_t done;  // 写入任务退出信号
+    TaskHandle_t task;
+    volatile bool running;
+} audio_out_t;
+
+static audio_out_t s_ao = {0};
+
+// 按格式算块大小和环的可用大小，lock 内调用
+static void apply_format(uint32_t rate, uint32_t bits, uint32_t ch)
+{
+    uint32_t frame = bits / 8 * ch;
+    if (frame == 0 || frame > MAX_FRAME_BYTES)
+        frame = CODEC_DEFAULT_BIT_WIDTH / 8 * CODEC_DEFAULT_CHANNEL;
+    s_ao.block = s_ao.cfg.dma_frames * frame;
+    s_ao.cap = s_ao.ring_alloc / s_ao.block * s_ao.block;
+    s_ao.bytes_per_sec = rate * frame;
+    s_ao.head = 0;
+    s_ao.fill = 0;
+    s_ao.starved = false;
+    s_ao.st.capacity = s_ao.cap;
+    s_ao.st.block = s_ao.block;
+    s_ao.st.queued = 0;
+}
+
+// 从环里取一块写 codec。环里不足一块时先等一块的时长，还不够就补静音写出去，免得 DMA 断流
+static void writer_task(void *arg)
+{
+    bool waited = false;
+    while (s_ao.running)
+    {
+        xSemaphoreTake(s_ao.io, portMAX_DELAY);
+        xSemaphoreTake(s_ao.lock, portMAX_DELAY);
+        uint32_t fill = s_ao.fill;
+        uint32_t block = s_ao.block;
+        uint32_t off = s_ao.head;
+        uint32_t block_ms = s_ao.bytes_per_sec ? block * 1000 / s_ao.bytes_per_sec : 15;
+        xSemaphoreGive(s_ao.lock);
+
+        const uint8_t *src;
+        size_t n, len;
+        if (fill >= block || (fill > 0 && waited))
+        {
+            n = fill < block ? fill : block;
+            if (off + n <= s_ao.cap && n == block)
+            {
+                // 常见情况：整块在环里连续，直接写
+                src = s_ao.ring + off;
+                len = n;
+            }
+            else
+            {
+                size_t first = s_ao.cap - off < n ? s_ao.cap - off : n;
+                memcpy(s_ao.pad, s_ao.ring + off, first);
+                memcpy(s_ao.pad + first, s_ao.ring, n - first);
+                memset(s_ao.pad + n, 0, block - n);
+                src = s_ao.pad;
+                len = block;
+            }
+        }
+        else
+        {
+            xSemaphoreGive(s_ao.io);
+            if (fill == 0)
+            {
+                waited = false;
+                xSemaphoreTake(s_ao.data, pdMS_TO_TICKS(100));
+            }
+            else
+            {
+                waited = xSemaphoreTake(s_ao.data, pdMS_TO_TICKS(block_ms + 1)) != pdTRUE;
+            }
+            continue;
+        }
+        waited = false;
+
+        int64_t t0 = esp_timer_get_time();
+        size_t bytes_written = 0;
+        esp_err_t err = bsp_extra_i2s_write((void *)src, len, &bytes_written, portMAX_DELAY);
+        uint32_t spent = (uint32_t)(esp_timer_get_time() - t0);
+        if (err != ESP_OK)
+            ESP_LOGE(TAG, "codec write failed: %s", esp_err_to_name(err));
+
+        xSemaphoreTake(s_ao.lock, portMAX_DELAY);
+        s_ao.head = (s_ao.head + n) % s_ao.cap;
+        s_ao.fill -= n;
+        s_ao.st.played += n;
+        if (spent > s_ao.st.max_write_us)
+            s_ao.st.max_write_us = spent;
+        if (s_ao.fill == 0)
+            s_ao.starved = true;
+        xSemaphoreGive(s_ao.lock);
+        xSemaphoreGive(s_ao.space);
+        xSemaphoreGive(s_ao.io);
+    }
+    xSemaphoreGive(s_ao.done);
+    vTaskDelete(NULL);
+}
+
+esp_err_t audio_out_start(const audio_out_config_t *cfg)
+{
+    if (s_ao.running)
+        return ESP_OK;
+
+    audio_out_config_t def = AUDIO_OUT_DEFAULT_CONFIG();
+    memset(&s_ao, 0, sizeof(s_ao));
+    s_ao.cfg = cfg ? *cfg : def;
+    if (s_ao.cfg.dma_frames <= 0)
+        s_ao.cfg.dma_frames = def.dma_frames;
+    if (s_ao.cfg.writer_stack == 0)
+        s_ao.cfg.writer_stack = def.writer_stack;
+    // 最大块的整数倍，任何格式下都至少放得下两块
+    size_t max_block = s_ao.cfg.dma_frames * MAX_FRAME_BYTES;
+    if (s_ao.cfg.ring_size < 2 * max_block)
+        s_ao.cfg.ring_size = 2 * max_block;
+
+    s_ao.ring_alloc = s_ao.cfg.ring_size;
+    s_ao.ring = heap_caps_malloc(s_ao.ring_alloc, MALLOC_CAP_SPIRAM);
+    if (!s_ao.ring)
+        s_ao.ring = heap_caps_malloc(s_ao.ring_alloc, MALLOC_CAP_DEFAULT);
+    s_ao.pad = heap_caps_malloc(max_block, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    s_ao.lock = xSemaphoreCreateMutex();
+    s_ao.io = xSemaphoreCreateMutex();
+    s_ao.data = xSemaphoreCreateBinary();
+    s_ao.space = xSemaphoreCreateBinary();
+    s_ao.done = xSemaphoreCreateBinary();
+    if (!s_ao.ring || !s_ao.pad || !s_ao.lock || !s_ao.io || !s_ao.data || !s_ao.space || !s_ao.done)
+    {
+        ESP_LOGE(TAG, "no mem for audio ring");
+        audio_out_stop();
+        return ESP_ERR_NO_MEM;
+    }
+    apply_format(CODEC_DEFAULT_SAMPLE_RATE, CODEC_DEFAULT_BIT_WIDTH, CODEC_DEFAULT_CHANNEL);
+
+    s_ao.running = true;
+    if (xTaskCreatePinnedToCore(writer_task, "audio_out", s_ao.cfg.writer_stack, NULL,
+                                s_ao.cfg.writer_priority, &s_ao.task, s_ao.cfg.writer_core) != pdPASS)
+    {
+        ESP_LOGE(TAG, "create writer task fail");
+        s_ao.running = false;
+        audio_out_stop();
+        return ESP_FAIL;
+    }
+
+    ESP_LOGI(TAG, "started: %u B ring, %d frames per write, writer on core %d prio %u",
+             (unsigned)s_ao.ring_alloc, s_ao.cfg.dma_frames, s_ao.cfg.writer_core, (unsigned)s_ao.cfg.writer_priority);
+    return ESP_OK;
+}
+
+void audio_out_stop(void)
+{
+    if (s_ao.running)
+    {
+        s_ao.running = false;
+        xSemaphoreGive(s_ao.data);
+        xSemaphoreTake(s_ao.done, portMAX_DELAY);
+        s_ao.task = NULL;
+        ESP_LOGI(TAG, "stopped: played %llu B, underruns %lu, overruns %lu (%lu B dropped), max write %lums",
+                 (unsigned long long)s_ao.st.played, (unsigned long)s_ao.st.underruns,
+                 (unsigned long)s_ao.st.overruns, (unsigned long)s_ao.st.dropped,
+                 (unsigned long)(s_ao.st.max_write_us / 1000));
+    }
+
+    heap_caps_free(s_ao.ring);
+    heap_caps_free(s_ao.pad);
+    if (s_ao.lock)
+        vSemaphoreDelete(s_ao.lock);
+    if (s_ao.io)
+        vSemaphoreDelete(s_ao.io);
+    if (s_ao.data)
+        vSemaphoreDelete(s_ao.data);
+    if (s_ao.space)
+        vSemaphoreDelete(s_ao.space);
+    if (s_ao.done)
+        vSemaphoreDelete(s_ao.done);
+    memset(&s_ao, 0, sizeof(s_ao));
+}
+
+esp_err_t audio_out_set_format(uint32_t rate, uint32_t bits, uint32_t ch)
+{
+    i2s_slot_mode_t slot_mode = (ch == 2) ? I2S_SLOT_MODE_STEREO : I2S_SLOT_MODE_MONO;
+    if (!s_ao.running)
+        return bsp_extra_codec_set_fs(rate, bits, slot_mode);
+
+    // 上一集的尾巴按旧格式播完再切，最多等环里存量的时长
+    xSemaphoreTake(s_ao.lock, portMAX_DELAY);
+    uint32_t wait_ms = s_ao.bytes_per_sec ? (uint64_t)s_ao.fill * 1000 / s_ao.bytes_per_sec + 100 : 100;
+    xSemaphoreGive(s_ao.lock);
+    int64_t deadline = esp_timer_get_time() + (int64_t)wait_ms * 1000;
+    while (audio_out_queued() > 0 && esp_timer_get_time() < deadline)
+        xSemaphoreTake(s_ao.space, pdMS_TO_TICKS(10));
+
+    xSemaphoreTake(s_ao.io, portMAX_DELAY);
+    esp_err_t err = bsp_extra_codec_set_fs(rate, bits, slot_mode);
+    xSemaphoreTake(s_ao.lock, portMAX_DELAY);
+    if (s_ao.fill)
+        ESP_LOGW(TAG, "format change drops %lu B", (unsigned long)s_ao.fill);
+    apply_format(rate, bits, ch);
+    xSemaphoreGive(s_ao.lock);
+    xSemaphoreGive(s_ao.io);
+    return err;
+}
+
+size_t audio_out_write(const void *data, size_t len, uint32_t timeout_ms)
+{
+    if (!s_ao.running || !data || len == 0)
+        return 0;
+
+    const uint8_t *p = data;
+    size_t done = 0;
+    int64_t deadline = esp_timer_get_time() + (int64_t)timeout_ms * 1000;
+    while (done < len)
+    {
+        xSemaphoreTake(s_ao.lock, portMAX_DELAY);
+        uint32_t cap = s_ao.cap;
+        uint32_t space = cap - s_ao.fill;
+        uint32_t off = (s_ao.head + s_ao.fill) % cap;
+        xSemaphoreGive(s_ao.lock);
+
+        if (space == 0)
+        {
+            int64_t left = deadline - esp_timer_get_time();
+            if (left <= 0)
+                break;
+            xSemaphoreTake(s_ao.space, pdMS_TO_TICKS(left / 1000 + 1));
+            continue;
+        }
+
+        // 写入任务只读 head 起的 fill 字节，往空位里拷贝不用持锁
+        size_t n = len - done < space ? len - done : space;
+        size_t first = cap - off < n ? cap - off : n;
+        memcpy(s_ao.ring + off, p + done, first);
+        memcpy(s_ao.ring, p + done + first, n - first);
+        done += n;
+
+        xSemaphoreTake(s_ao.lock, portMAX_DELAY);
+        s_ao.fill += n;
+        s_ao.st.written += n;
+        if (s_ao.starved)
+        {
+            s_ao.starved = false;
+            s_ao.st.underruns++;
+        }
+        if (s_ao.fill > s_ao.st.peak)
+            s_ao.st.peak = s_ao.fill;
+        xSemaphoreGive(s_ao.lock);
+        xSemaphoreGive(s_ao.data);
+    }
+
+    if (done < len)
+    {
+        xSemaphoreTake(s_ao.lock, portMAX_DELAY);
+        s_ao.st.overruns++;
+        s_ao.st.dropped += len - done;
+        xSemaphoreGive(s_ao.lock);
+    }
+    return done;
+}
+
+size_t audio_out_queued(void)
+{
+    if (!s_ao.running)
+        return 0;
+    xSemaphoreTake(s_ao.lock, portMAX_DELAY);
+    size_t queued = s_ao.fill;
+    xSemaphoreGive(s_ao.lock);
+    return queued;
+}
+
+void audio_out_flush(void)
+{
+    if (!s_ao.running)
+        return;
+    xSemaphoreTake(s_ao.io, portMAX_DELAY);
+    xSemaphoreTake(s_ao.lock, portMAX_DELAY);
+    s_ao.fill = 0;
+    s_ao.starved = false;
+    xSemaphoreGive(s_ao.lock);
+    xSemaphoreGive(s_ao.space);
+    xSemaphoreGive(s_ao.io);
+}
+
+void audio_out_get_stats(audio_out_stats_t *st)
+{
+    if (!st)
+        return;
+    if (!s_ao.lock)
+    {
+        memset(st, 0, sizeof(*st));
+        return;
+    }
+    xSemaphoreTake(s_ao.lock, portMAX_DELAY);
+    *st = s_ao.st;
+    st->queued = s_ao.fill;
+    xSemaphoreGive(s_ao.lock);
+}
@@ -0,0 +1,140 @@
+#include "esp_log.h"
+#include "esp_err.h"
+#include "esp_partition.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "flash_clips.h"
+
+static const char *TAG = "flash_clips";
+
+// 和 tools/clip_pack.py 的镜像布局一致
+#define CLIPS_PARTITION_LABEL "clips"
+#define CLIPS_MAGIC "CLPK"
+#define CLIPS_VERSION 1
+#define CLIP_NAME_LEN 48
+
+typedef struct
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t count;
+    uint32_t reserved;
+} clips_head_t;
+
+typedef struct
+{
+    char name[CLIP_NAME_LEN];
+    uint32_t offset; // 分区内偏移，64KB 对齐
+    uint32_t size;
+    uint32_t reserved[2];
+} clip_entry_t;
+
+static const esp_partition_t *s_part = NULL;
+static clip_entry_t *s_entries = NULL;
+static int s_count = 0;
+
+esp_err_t flash_clips_init(void)
+{
+    if (s_part)
+        return s_count > 0 ? ESP_OK : ESP_ERR_NOT_FOUND;
+
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, CLIPS_PARTITION_LABEL);
+    if (!part)
+    {
+        ESP_LOGW(TAG, "no \"%s\" partition", CLIPS_PARTITION_LABEL);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    clips_head_t head;
+    esp_err_t err = esp_partition_read(part, 0, &head, sizeof(head));
+    if (err != ESP_OK)
+        return err;
+    if (memcmp(head.magic, CLIPS_MAGIC, 4) != 0 || head.version != CLIPS_VERSION)
+    {
+        // 没烧过片段镜像时这里是 0xFF
+        ESP_LOGW(TAG, "no clips in \"%s\" (flash it with idf.py clips-flash)", CLIPS_PARTITION_LABEL);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    size_t toc = head.count * sizeof(clip_entry_t);
+    if (head.count == 0 || sizeof(head) + toc > part->size)
+        return ESP_ERR_NOT_FOUND;
+    clip_entry_t *entries = malloc(toc);
+    if (!entries)
+        return ESP_ERR_NO_MEM;
+    err = esp_partition_read(part, sizeof(head), entries, toc);
+    if (err != ESP_OK)
+    {
+        free(entries);
+        return err;
+    }
+
+    // 去掉越界的目录项，名字强制结尾
+    int n = 0;
+    for (uint32_t i = 0; i < head.count; i++)
+    {
+        clip_entry_t *e = &entries[i];
+        e->name[CLIP_NAME_LEN - 1] = '\0';
+        if (e->size == 0 || e->offset > part->size || e->size > part->size - e->offset)
+        {
+            ESP_LOGW(TAG, "bad entry %s", e->name);
+            continue;
+        }
+        entries[n++] = *e;
+        ESP_LOGI(TAG, "clip %s @0x%lx, %lu bytes", e->name, (unsigned long)e->offset, (unsigned long)e->size);
+    }
+
+    s_part = part;
+    s_entries = entries;
+    s_count = n;
+    return n > 0 ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+int flash_clips_count(void)
+{
+    return s_count;
+}
+
+const char *flash_clips_name(int idx)
+{
+    if (idx < 0 || idx >= s_count)
+        return NULL;
+    return s_entries[idx].name;
+}
+
+esp_err_t flash_clips_map(const char *name, flash_clip_t *clip)
+{
+    if (!name || !clip)
+        return ESP_ERR_INVALID_ARG;
+
+    for (int i = 0; i < s_count; i++)
+    {
+        const clip_entry_t *e = &s_entries[i];
+        if (strcmp(e->name, name) != 0)
+            continue;
+
+        // 只映射这一个片段，占用的 MMU 页和片段大小相当
+        const void *ptr = NULL;
+        esp_err_t err = esp_partition_mmap(s_part, e->offset, e->size, ESP_PARTITION_MMAP_DATA, &ptr, &clip->handle);
+        if (err != ESP_OK)
+        {
+            ESP_LOGE(TAG, "mmap %s: %s", name, esp_err_to_name(err));
+            return err;
+        }
+        clip->data = ptr;
+        clip->size = e->size;
+        return ESP_OK;
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+void flash_clips_unmap(flash_clip_t *clip)
+{
+    if (!clip || !clip->data)
+        return;
+    esp_partition_munmap(clip->handle);
+    clip->data = NULL;
+    clip->size = 0;
+}
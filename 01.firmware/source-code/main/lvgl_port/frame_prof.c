@@ -0,0 +1,581 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_err.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "sdkconfig.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "esp_lvgl_port.h"
+
+#include "frame_prof.h"
+
+static const char *TAG = "frame_prof";
+
+// 直方图：32us 以下一格，之后每 1/4 倍频程一格，最后一格到 ~1.8s 并兜住更大的值
+#define PROF_BUCKETS 64
+#define PROF_MIN_US 32
+#define PROF_TICK_GAP_US 1000000 // tick 间隔超过这个算暂停过，不记
+#define PROF_LOCK_SITES 24
+#define PROF_TASK_TYPES (LV_DRAW_TASK_TYPE_VECTOR + 1)
+
+typedef struct
+{
+    uint32_t ring[FRAME_PROF_WINDOW];
+    uint16_t hist[PROF_BUCKETS]; // 只数窗口里的样本：新样本进、最老的样本出
+    uint32_t head;
+    uint32_t n;
+    uint32_t total;
+    uint64_t sum; // 窗口内总和
+} prof_series_t;
+
+typedef struct
+{
+    const void *caller;
+    char task[configMAX_TASK_NAME_LEN];
+    uint32_t count;
+    uint32_t max_us;
+    uint32_t max_wait_us;
+    uint64_t total_us;
+} prof_lock_site_t;
+
+// 当前这次刷新；除了绘制单元累加的部分，都只在 LVGL 任务里改
+typedef struct
+{
+    bool in_refr;
+    bool rendered;
+    int64_t start_us;
+    int64_t render_start_us;
+    int64_t render_end_us;
+    int64_t flush_start_us;
+    int64_t wait_start_us;
+    uint32_t flush_us;
+    uint32_t wait_us;
+    uint32_t unit_us[FRAME_PROF_UNITS]; // 各绘制单元线程只写自己那一格
+} prof_frame_t;
+
+static const char *const s_metric_names[FRAME_PROF_METRICS] = {
+    [FRAME_PROF_FRAME] = "frame",
+    [FRAME_PROF_INTERVAL] = "interval",
+    [FRAME_PROF_LAYOUT] = "layout",
+    [FRAME_PROF_RENDER] = "render",
+    [FRAME_PROF_UNIT0] = "unit0",
+    [FRAME_PROF_UNIT0 + 1] = "unit1",
+    [FRAME_PROF_UNIT0 + 2] = "unit2",
+    [FRAME_PROF_UNIT0 + 3] = "unit3",
+    [FRAME_PROF_FLUSH] = "flush_cb",
+    [FRAME_PROF_FLUSH_WAIT] = "flush_wait",
+    [FRAME_PROF_LOCK] = "lock_hold",
+    [FRAME_PROF_LOCK_WAIT] = "lock_wait",
+    [FRAME_PROF_VIDEO_DECODE] = "video_decode",
+    [FRAME_PROF_VIDEO_PRESENT] = "video_present",
+    [FRAME_PROF_VIDEO_LATENCY] = "video_latency",
+};
+
+static const char *const s_task_names[PROF_TASK_TYPES] = {
+    [LV_DRAW_TASK_TYPE_NONE] = "none",
+    [LV_DRAW_TASK_TYPE_FILL] = "fill",
+    [LV_DRAW_TASK_TYPE_BORDER] = "border",
+    [LV_DRAW_TASK_TYPE_BOX_SHADOW] = "shadow",
+    [LV_DRAW_TASK_TYPE_LABEL] = "label",
+    [LV_DRAW_TASK_TYPE_IMAGE] = "image",
+    [LV_DRAW_TASK_TYPE_LAYER] = "layer",
+    [LV_DRAW_TASK_TYPE_LINE] = "line",
+    [LV_DRAW_TASK_TYPE_ARC] = "arc",
+    [LV_DRAW_TASK_TYPE_TRIANGLE] = "triangle",
+    [LV_DRAW_TASK_TYPE_MASK_RECTANGLE] = "mask_rect",
+    [LV_DRAW_TASK_TYPE_MASK_BITMAP] = "mask_bitmap",
+    [LV_DRAW_TASK_TYPE_VECTOR] = "vector",
+};
+
+static prof_series_t *s_series; // FRAME_PROF_METRICS 个，放 PSRAM
+static int64_t s_tick_us[FRAME_PROF_METRICS];
+static prof_frame_t s_frame;
+static int64_t s_unit_start_us[FRAME_PROF_UNITS];
+static uint32_t s_task_n[PROF_TASK_TYPES];
+static uint64_t s_task_us[PROF_TASK_TYPES];
+static prof_lock_site_t s_sites[PROF_LOCK_SITES];
+static uint32_t s_sites_lost; // 调用点表满了没记上的次数
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static lv_obj_t *s_overlay;
+static lv_timer_t *s_overlay_timer;
+
+static int bucket_of(uint32_t us)
+{
+    if (us < PROF_MIN_US)
+        return 0;
+    int l = 31 - __builtin_clz(us); // >= 5
+    int b = (l - 5) * 4 + (int)((us >> (l - 2)) & 3) + 1;
+    return b < PROF_BUCKETS ? b : PROF_BUCKETS - 1;
+}
+
+// 格的上沿（含）
+static uint32_t bucket_top(int b)
+{
+    if (b == 0)
+        return PROF_MIN_US - 1;
+    int l = (b - 1) / 4 + 5;
+    uint32_t frac = (uint32_t)((b - 1) % 4);
+    return ((5 + frac) << (l - 2)) - 1;
+}
+
+static void series_add(prof_series_t *s, uint32_t us)
+{
+    if (s->n == FRAME_PROF_WINDOW)
+    {
+        uint32_t old = s->ring[s->head];
+        s->hist[bucket_of(old)]--;
+        s->sum -= old;
+    }
+    else
+    {
+        s->n++;
+    }
+    s->ring[s->head] = us;
+    s->head = (s->head + 1) % FRAME_PROF_WINDOW;
+    s->hist[bucket_of(us)]++;
+    s->sum += us;
+    s->total++;
+}
+
+static uint32_t series_pct(const prof_series_t *s, uint32_t pct)
+{
+    if (s->n == 0)
+        return 0;
+    uint32_t rank = (s->n * pct + 99) / 100; // 第 rank 个（从 1 数）
+    uint32_t seen = 0;
+    for (int b = 0; b < PROF_BUCKETS; b++)
+    {
+        seen += s->hist[b];
+        if (seen >= rank)
+            return bucket_top(b);
+    }
+    return bucket_top(PROF_BUCKETS - 1);
+}
+
+static void series_summary(const prof_series_t *s, frame_prof_summary_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    out->n = s->n;
+    out->total = s->total;
+    if (s->n == 0)
+        return;
+    out->last = s->ring[(s->head + FRAME_PROF_WINDOW - 1) % FRAME_PROF_WINDOW];
+    out->mean = (uint32_t)(s->sum / s->n);
+    out->p50 = series_pct(s, 50);
+    out->p95 = series_pct(s, 95);
+    out->p99 = series_pct(s, 99);
+    for (uint32_t i = 0; i < s->n; i++)
+    {
+        if (s->ring[i] > out->max)
+            out->max = s->ring[i];
+    }
+}
+
+void frame_prof_record(frame_prof_metric_t m, uint32_t us)
+{
+    if (!s_series || m >= FRAME_PROF_METRICS)
+        return;
+    portENTER_CRITICAL_SAFE(&s_mux);
+    series_add(&s_series[m], us);
+    portEXIT_CRITICAL_SAFE(&s_mux);
+}
+
+void frame_prof_tick(frame_prof_metric_t m)
+{
+    if (!s_series || m >= FRAME_PROF_METRICS)
+        return;
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL_SAFE(&s_mux);
+    int64_t prev = s_tick_us[m];
+    s_tick_us[m] = now;
+    if (prev && now - prev < PROF_TICK_GAP_US)
+        series_add(&s_series[m], (uint32_t)(now - prev));
+    portEXIT_CRITICAL_SAFE(&s_mux);
+}
+
+void frame_prof_get(frame_prof_metric_t m, frame_prof_summary_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    if (!s_series || m >= FRAME_PROF_METRICS)
+        return;
+    prof_series_t copy; // 拷出来再算，不在临界区里扫窗口
+    portENTER_CRITICAL(&s_mux);
+    copy = s_series[m];
+    portEXIT_CRITICAL(&s_mux);
+    series_summary(&copy, out);
+}
+
+void frame_prof_reset(void)
+{
+    if (!s_series)
+        return;
+    portENTER_CRITICAL(&s_mux);
+    memset(s_series, 0, sizeof(prof_series_t) * FRAME_PROF_METRICS);
+    memset(s_tick_us, 0, sizeof(s_tick_us));
+    memset(s_task_n, 0, sizeof(s_task_n));
+    memset(s_task_us, 0, sizeof(s_task_us));
+    memset(s_sites, 0, sizeof(s_sites));
+    s_sites_lost = 0;
+    portEXIT_CRITICAL(&s_mux);
+}
+
+// ---- 钩子 ----
+
+// 绘制单元线程里调用
+static void prof_draw_task_cb(uint32_t unit_idx, lv_draw_task_type_t type, bool done)
+{
+    int64_t now = esp_timer_get_time();
+    if (unit_idx >= FRAME_PROF_UNITS)
+        return;
+    if (!done)
+    {
+        s_unit_start_us[unit_idx] = now;
+        return;
+    }
+    uint32_t cost = (uint32_t)(now - s_unit_start_us[unit_idx]);
+    if (s_frame.in_refr)
+        s_frame.unit_us[unit_idx] += cost;
+    if (type < PROF_TASK_TYPES)
+    {
+        portENTER_CRITICAL(&s_mux);
+        s_task_n[type]++;
+        s_task_us[type] += cost;
+        portEXIT_CRITICAL(&s_mux);
+    }
+}
+
+// 释放显示锁的任务里、还没还锁时调用
+static void prof_lock_hook(const void *caller, uint32_t wait_us, uint32_t hold_us)
+{
+    const char *task = pcTaskGetName(NULL);
+
+    portENTER_CRITICAL(&s_mux);
+    series_add(&s_series[FRAME_PROF_LOCK], hold_us);
+    series_add(&s_series[FRAME_PROF_LOCK_WAIT], wait_us);
+    prof_lock_site_t *site = NULL;
+    for (int i = 0; i < PROF_LOCK_SITES; i++)
+    {
+        if (s_sites[i].caller == caller || s_sites[i].caller == NULL)
+        {
+            site = &s_sites[i];
+            break;
+        }
+    }
+    if (site)
+    {
+        if (site->caller == NULL)
+        {
+            site->caller = caller;
+            snprintf(site->task, sizeof(site->task), "%s", task ? task : "?");
+        }
+        site->count++;
+        site->total_us += hold_us;
+        if (hold_us > site->max_us)
+            site->max_us = hold_us;
+        if (wait_us > site->max_wait_us)
+            site->max_wait_us = wait_us;
+    }
+    else
+    {
+        s_sites_lost++;
+    }
+    portEXIT_CRITICAL(&s_mux);
+}
+
+// LVGL 任务里调用
+static void prof_disp_event_cb(lv_event_t *e)
+{
+    int64_t now = esp_timer_get_time();
+    prof_frame_t *f = &s_frame;
+
+    switch (lv_event_get_code(e))
+    {
+    case LV_EVENT_REFR_START:
+        memset(f, 0, sizeof(*f));
+        f->start_us = now;
+        f->in_refr = true;
+        break;
+    case LV_EVENT_RENDER_START:
+        f->render_start_us = now;
+        f->rendered = true;
+        break;
+    case LV_EVENT_FLUSH_START:
+        f->flush_start_us = now;
+        break;
+    case LV_EVENT_FLUSH_FINISH:
+        f->flush_us += (uint32_t)(now - f->flush_start_us);
+        break;
+    case LV_EVENT_FLUSH_WAIT_START:
+        f->wait_start_us = now;
+        break;
+    case LV_EVENT_FLUSH_WAIT_FINISH:
+        f->wait_us += (uint32_t)(now - f->wait_start_us);
+        break;
+    case LV_EVENT_RENDER_READY:
+        f->render_end_us = now;
+        break;
+    case LV_EVENT_REFR_READY:
+    {
+        f->in_refr = false;
+        if (!f->rendered)
+            break;
+        uint32_t render = (uint32_t)(f->render_end_us - f->render_start_us);
+        uint32_t side = f->flush_us + f->wait_us;
+        frame_prof_record(FRAME_PROF_FRAME, (uint32_t)(now - f->start_us));
+        frame_prof_record(FRAME_PROF_LAYOUT, (uint32_t)(f->render_start_us - f->start_us));
+        frame_prof_record(FRAME_PROF_RENDER, render > side ? render - side : 0);
+        for (int i = 0; i < FRAME_PROF_UNITS && i < LV_DRAW_SW_DRAW_UNIT_CNT; i++)
+            frame_prof_record(FRAME_PROF_UNIT0 + i, f->unit_us[i]);
+        frame_prof_record(FRAME_PROF_FLUSH, f->flush_us);
+        frame_prof_record(FRAME_PROF_FLUSH_WAIT, f->wait_us);
+        frame_prof_tick(FRAME_PROF_INTERVAL);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+esp_err_t frame_prof_init(lv_display_t *disp)
+{
+    if (!disp)
+        return ESP_ERR_INVALID_ARG;
+    if (s_series)
+        return ESP_OK;
+
+    size_t size = sizeof(prof_series_t) * FRAME_PROF_METRICS;
+    prof_series_t *series = heap_caps_calloc(1, size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!series)
+        series = calloc(1, size);
+    if (!series)
+        return ESP_ERR_NO_MEM;
+    s_series = series;
+
+    static const lv_event_code_t codes[] = {
+        LV_EVENT_REFR_START, LV_EVENT_RENDER_START, LV_EVENT_RENDER_READY, LV_EVENT_REFR_READY,
+        LV_EVENT_FLUSH_START, LV_EVENT_FLUSH_FINISH, LV_EVENT_FLUSH_WAIT_START, LV_EVENT_FLUSH_WAIT_FINISH,
+    };
+    for (size_t i = 0; i < sizeof(codes) / sizeof(codes[0]); i++)
+        lv_display_add_event_cb(disp, prof_disp_event_cb, codes[i], NULL);
+    lv_draw_sw_set_task_cb(prof_draw_task_cb);
+    lvgl_port_set_lock_hook(prof_lock_hook);
+
+    ESP_LOGI(TAG, "%u metrics x %u samples, %u bytes", FRAME_PROF_METRICS, FRAME_PROF_WINDOW, (unsigned)size);
+    return ESP_OK;
+}
+
+// ---- 报告 ----
+
+// 返回地址换成 addr2line 能直接用的调用指令地址
+static uintptr_t site_pc(const void *caller)
+{
+    uintptr_t pc = (uintptr_t)caller;
+#if CONFIG_IDF_TARGET_ARCH_XTENSA
+    // 窗口调用把增量放在返回地址的高两位
+    pc = (pc & 0x3fffffff) | 0x40000000;
+    return pc - 3;
+#else
+    return pc - 4;
+#endif
+}
+
+void frame_prof_dump(FILE *out)
+{
+    if (!s_series)
+    {
+        fprintf(out, "frame_prof: not initialized\n");
+        return;
+    }
+
+    fprintf(out, "=== frame_prof @ %" PRId64 " ms, window %u, %u draw units ===\n",
+            esp_timer_get_time() / 1000, FRAME_PROF_WINDOW, LV_DRAW_SW_DRAW_UNIT_CNT);
+    fprintf(out, "%-14s %5s %7s %7s %7s %7s %7s %7s %7s  (us)\n",
+            "metric", "n", "total", "last", "mean", "p50", "p95", "p99", "max");
+
+    prof_series_t *copy = malloc(sizeof(*copy));
+    if (!copy)
+        return;
+    for (int m = 0; m < FRAME_PROF_METRICS; m++)
+    {
+        if (m >= FRAME_PROF_UNIT0 + LV_DRAW_SW_DRAW_UNIT_CNT && m < FRAME_PROF_FLUSH)
+            continue;
+        portENTER_CRITICAL(&s_mux);
+        *copy = s_series[m];
+        portEXIT_CRITICAL(&s_mux);
+
+        frame_prof_summary_t sm;
+        series_summary(copy, &sm);
+        fprintf(out, "%-14s %5lu %7lu %7lu %7lu %7lu %7lu %7lu %7lu\n", s_metric_names[m],
+                (unsigned long)sm.n, (unsigned long)sm.total, (unsigned long)sm.last, (unsigned long)sm.mean,
+                (unsigned long)sm.p50, (unsigned long)sm.p95, (unsigned long)sm.p99, (unsigned long)sm.max);
+        if (sm.n == 0)
+            continue;
+        // 直方图只打非空的格：<=上沿:个数
+        fprintf(out, "  hist");
+        for (int b = 0; b < PROF_BUCKETS; b++)
+        {
+            if (copy->hist[b])
+                fprintf(out, " <=%lu:%u", (unsigned long)bucket_top(b), copy->hist[b]);
+        }
+        fprintf(out, "\n");
+    }
+    free(copy);
+
+    uint32_t task_n[PROF_TASK_TYPES];
+    uint64_t task_us[PROF_TASK_TYPES];
+    portENTER_CRITICAL(&s_mux);
+    memcpy(task_n, s_task_n, sizeof(task_n));
+    memcpy(task_us, s_task_us, sizeof(task_us));
+    portEXIT_CRITICAL(&s_mux);
+    fprintf(out, "draw tasks since reset (count / total us / mean us):\n");
+    for (int t = 0; t < PROF_TASK_TYPES; t++)
+    {
+        if (task_n[t])
+            fprintf(out, "  %-12s %8lu %10llu %7lu\n", s_task_names[t], (unsigned long)task_n[t],
+                    (unsigned long long)task_us[t], (unsigned long)(task_us[t] / task_n[t]));
+    }
+
+    prof_lock_site_t *sites = malloc(sizeof(s_sites));
+    if (!sites)
+        return;
+    portENTER_CRITICAL(&s_mux);
+    memcpy(sites, s_sites, sizeof(s_sites));
+    uint32_t lost = s_sites_lost;
+    portEXIT_CRITICAL(&s_mux);
+    fprintf(out, "display lock holds since reset (pc for addr2line):\n");
+    for (int i = 0; i < PROF_LOCK_SITES && sites[i].caller; i++)
+    {
+        fprintf(out, "  0x%08lx %-16s n %6lu mean %7lu max %7lu wait max %7lu\n",
+                (unsigned long)site_pc(sites[i].caller), sites[i].task, (unsigned long)sites[i].count,
+                (unsigned long)(sites[i].total_us / sites[i].count), (unsigned long)sites[i].max_us,
+                (unsigned long)sites[i].max_wait_us);
+    }
+    if (lost)
+        fprintf(out, "  (%lu holds from sites beyond the table)\n", (unsigned long)lost);
+    free(sites);
+    fflush(out);
+}
+
+esp_err_t frame_prof_dump_file(const char *path)
+{
+    FILE *f = fopen(path, "a");
+    if (!f)
+    {
+        ESP_LOGE(TAG, "open %s failed", path);
+        return ESP_FAIL;
+    }
+    frame_prof_dump(f);
+    fclose(f);
+    return ESP_OK;
+}
+
+// ---- 屏幕面板 ----
+
+#define MS(us) (unsigned)((us) / 1000), (unsigned)((us) % 1000 / 100)
+
+static void overlay_update(lv_timer_t *t)
+{
+    if (!s_overlay)
+        return;
+
+    frame_prof_summary_t fr, iv, lay, ren, fl, wt, lk, vd, vp;
+    frame_prof_get(FRAME_PROF_FRAME, &fr);
+    frame_prof_get(FRAME_PROF_INTERVAL, &iv);
+    frame_prof_get(FRAME_PROF_LAYOUT, &lay);
+    frame_prof_get(FRAME_PROF_RENDER, &ren);
+    frame_prof_get(FRAME_PROF_FLUSH, &fl);
+    frame_prof_get(FRAME_PROF_FLUSH_WAIT, &wt);
+    frame_prof_get(FRAME_PROF_LOCK, &lk);
+    frame_prof_get(FRAME_PROF_VIDEO_DECODE, &vd);
+    frame_prof_get(FRAME_PROF_VIDEO_PRESENT, &vp);
+
+    char units[48] = "";
+    int len = 0;
+    for (int i = 0; i < FRAME_PROF_UNITS && i < LV_DRAW_SW_DRAW_UNIT_CNT; i++)
+    {
+        frame_prof_summary_t u;
+        frame_prof_get(FRAME_PROF_UNIT0 + i, &u);
+        len += snprintf(units + len, sizeof(units) - len, " u%d %u.%u", i, MS(u.mean));
+        if (len >= (int)sizeof(units))
+            break;
+    }
+
+    char buf[320];
+    unsigned fps = iv.mean ? (unsigned)(1000000 / iv.mean) : 0;
+    int n = snprintf(buf, sizeof(buf),
+                     "frame %u.%u p95 %u.%u max %u.%u ms, %u fps\n"
+                     "layout %u.%u render %u.%u%s\n"
+                     "flush %u.%u wait %u.%u p95 %u.%u\n"
+                     "lock p95 %u.%u max %u.%u ms",
+                     MS(fr.mean), MS(fr.p95), MS(fr.max), fps,
+                     MS(lay.mean), MS(ren.mean), units,
+                     MS(fl.mean), MS(wt.mean), MS(wt.p95),
+                     MS(lk.p95), MS(lk.max));
+    if (vd.n && n < (int)sizeof(buf))
+    {
+        snprintf(buf + n, sizeof(buf) - n, "\nvideo dec %u.%u p95 %u.%u, every %u.%u ms",
+                 MS(vd.mean), MS(vd.p95), MS(vp.mean));
+    }
+    lv_label_set_text(s_overlay, buf);
+}
+
+static void overlay_event_cb(lv_event_t *e)
+{
+    switch (lv_event_get_code(e))
+    {
+    case LV_EVENT_SHORT_CLICKED:
+        frame_prof_dump(stdout);
+        break;
+    case LV_EVENT_LONG_PRESSED:
+        frame_prof_reset();
+        overlay_update(NULL);
+        ESP_LOGI(TAG, "reset");
+        break;
+    case LV_EVENT_DELETE:
+        s_overlay = NULL;
+        if (s_overlay_timer)
+        {
+            lv_timer_delete(s_overlay_timer);
+            s_overlay_timer = NULL;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void frame_prof_overlay_show(bool show)
+{
+    if (!show)
+    {
+        if (s_overlay)
+            lv_obj_delete(s_overlay); // DELETE 事件里停定时器
+        return;
+    }
+    if (s_overlay)
+        return;
+
+    // 放在顶层，换页面也一直在；面板自己的重绘也算进统计，区域很小
+    s_overlay = lv_label_create(lv_layer_top());
+    lv_obj_set_style_bg_color(s_overlay, lv_color_black(), 0);
+    lv_obj_set_style_bg_opa(s_overlay, LV_OPA_70, 0);
+    lv_obj_set_style_text_color(s_overlay, lv_color_hex(0x7CFC9A), 0);
+    lv_obj_set_style_pad_all(s_overlay, 4, 0);
+    lv_obj_set_style_radius(s_overlay, 6, 0);
+    lv_obj_align(s_overlay, LV_ALIGN_TOP_MID, 0, 24);
+    lv_obj_add_flag(s_overlay, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_event_cb(s_overlay, overlay_event_cb, LV_EVENT_ALL, NULL);
+    s_overlay_timer = lv_timer_create(overlay_update, FRAME_PROF_OVERLAY_MS, NULL);
+    overlay_update(NULL);
+}
+
+bool frame_prof_overlay_visible(void)
+{
+    return s_overlay != NULL;
+}
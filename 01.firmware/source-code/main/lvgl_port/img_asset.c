@@ -0,0 +1,194 @@
+#include "esp_log.h"
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "img_asset.h"
+
+#if LV_USE_LZ4_EXTERNAL
+#include <lz4.h>
+#elif LV_USE_LZ4_INTERNAL
+#include "src/libs/lz4/lz4.h"
+#endif
+
+static const char *TAG = "img_asset";
+
+// 和 tools/asset_pack.py 写出的压缩头一致（也是 LVGL bin 的格式）
+typedef struct
+{
+    uint32_t method; // 低 4 位，LV_IMAGE_COMPRESS_LZ4
+    uint32_t compressed_size;
+    uint32_t decompressed_size;
+} asset_comp_head_t;
+
+// /spiffs/a.jpg -> /spiffs/a.bin 或 /spiffs/a.fit.bin
+static bool bin_path_of(const char *jpg_path, bool fit, char *out, size_t out_len)
+{
+    const char *ext = fit ? ".fit.bin" : ".bin";
+    const char *slash = strrchr(jpg_path, '/');
+    const char *dot = strrchr(jpg_path, '.');
+    size_t stem = (dot && (!slash || dot > slash)) ? (size_t)(dot - jpg_path) : strlen(jpg_path);
+    if (stem + strlen(ext) + 1 > out_len)
+        return false;
+    memcpy(out, jpg_path, stem);
+    strcpy(out + stem, ext);
+    return true;
+}
+
+esp_err_t img_asset_open(const char *jpg_path, int w, int h, bool fit, img_asset_t *a)
+{
+    if (!jpg_path || !a)
+        return ESP_ERR_INVALID_ARG;
+    memset(a, 0, sizeof(*a));
+
+    char path[256];
+    if (!bin_path_of(jpg_path, fit, path, sizeof(path)))
+        return ESP_ERR_NOT_FOUND;
+    return img_asset_open_bin(path, w, h, a);
+}
+
+esp_err_t img_asset_open_bin(const char *path, int w, int h, img_asset_t *a)
+{
+    if (!path || !a)
+        return ESP_ERR_INVALID_ARG;
+    memset(a, 0, sizeof(*a));
+
+    FILE *fp = fopen(path, "rb");
+    if (!fp)
+        return ESP_ERR_NOT_FOUND;
+
+    esp_err_t err = ESP_ERR_INVALID_SIZE;
+    lv_image_header_t head;
+    if (fread(&head, 1, sizeof(head), fp) != sizeof(head) || head.magic != LV_IMAGE_HEADER_MAGIC)
+    {
+        ESP_LOGW(TAG, "%s: not an LVGL image", path);
+        goto fail;
+    }
+    if (head.w != w || head.h != h ||
+        (head.cf != LV_COLOR_FORMAT_RGB565 && head.cf != LV_COLOR_FORMAT_RGB565A8) ||
+        head.stride != (uint32_t)w * 2)
+    {
+        // 多半是改了页面尺寸没重新生成，退回 JPEG
+        ESP_LOGW(TAG, "%s: %dx%d cf 0x%02x, want %dx%d", path, head.w, head.h, head.cf, w, h);
+        goto fail;
+    }
+
+    uint32_t data_size = (uint32_t)w * h * 2;
+    if (head.cf == LV_COLOR_FORMAT_RGB565A8)
+        data_size += (uint32_t)w * h;
+    uint32_t packed_size = data_size;
+
+    if (head.flags & LV_IMAGE_FLAGS_COMPRESSED)
+    {
+        asset_comp_head_t comp;
+        if (fread(&comp, 1, sizeof(comp), fp) != sizeof(comp) ||
+            (comp.method & 0xF) != LV_IMAGE_COMPRESS_LZ4 || comp.decompressed_size != data_size)
+        {
+            ESP_LOGW(TAG, "%s: bad compression header", path);
+            goto fail;
+        }
+#if !LV_USE_LZ4
+        ESP_LOGW(TAG, "%s: LZ4 asset but CONFIG_LV_USE_LZ4 is off", path);
+        err = ESP_ERR_NOT_SUPPORTED;
+        goto fail;
+#endif
+        packed_size = comp.compressed_size;
+        a->lz4 = true;
+    }
+
+    head.flags &= ~LV_IMAGE_FLAGS_COMPRESSED;
+    a->header = head;
+    a->data_size = data_size;
+    a->packed_size = packed_size;
+    a->fp = fp;
+    return ESP_OK;
+
+fail:
+    fclose(fp);
+    return err;
+}
+
+esp_err_t img_asset_read(img_asset_t *a, uint8_t *dst, uint8_t *scratch)
+{
+    if (!a || !a->fp || !dst)
+        return ESP_ERR_INVALID_ARG;
+
+    esp_err_t err = ESP_OK;
+    if (!a->lz4)
+    {
+        if (fread(dst, 1, a->data_size, a->fp) != a->data_size)
+            err = ESP_FAIL;
+    }
+    else
+    {
+#if LV_USE_LZ4
+        // 压缩数据整块读进 PSRAM 再一次解压到目标，LZ4 解压比 SPIFFS 读快得多
+        char *packed = (char *)scratch;
+        if (!packed)
+            packed = heap_caps_malloc(a->packed_size, MALLOC_CAP_SPIRAM);
+        if (!packed)
+            packed = malloc(a->packed_size);
+        if (!packed)
+        {
+            err = ESP_ERR_NO_MEM;
+        }
+        else
+        {
+            if (fread(packed, 1, a->packed_size, a->fp) != a->packed_size ||
+                LZ4_decompress_safe(packed, (char *)dst, (int)a->packed_size, (int)a->data_size) != (int)a->data_size)
+                err = ESP_FAIL;
+            if (packed != (char *)scratch)
+                free(packed);
+        }
+#else
+        err = ESP_ERR_NOT_SUPPORTED;
+#endif
+    }
+
+    if (err != ESP_OK)
+        ESP_LOGW(TAG, "read asset: %s", esp_err_to_name(err));
+    img_asset_close(a);
+    return err;
+}
+
+void img_asset_close(img_asset_t *a)
+{
+    if (a && a->fp)
+    {
+        fclose(a->fp);
+        a->fp = NULL;
+    }
+}
+
+esp_err_t img_asset_write(const char *path, const lv_image_dsc_t *dsc)
+{
+    if (!path || !dsc || !dsc->data)
+        return ESP_ERR_INVALID_ARG;
+    if (dsc->header.cf != LV_COLOR_FORMAT_RGB565 && dsc->header.cf != LV_COLOR_FORMAT_RGB565A8)
+        return ESP_ERR_NOT_SUPPORTED;
+
+    // 先写临时文件再改名，写到一半掉电不会留下能通过头检查的坏文件
+    char tmp[256];
+    if (snprintf(tmp, sizeof(tmp), "%s.tmp", path) >= (int)sizeof(tmp))
+        return ESP_ERR_INVALID_ARG;
+    FILE *fp = fopen(tmp, "wb");
+    if (!fp)
+        return ESP_FAIL;
+
+    lv_image_header_t head = dsc->header;
+    head.magic = LV_IMAGE_HEADER_MAGIC;
+    head.flags &= ~LV_IMAGE_FLAGS_COMPRESSED;
+    bool ok = fwrite(&head, 1, sizeof(head), fp) == sizeof(head) &&
+              fwrite(dsc->data, 1, dsc->data_size, fp) == dsc->data_size;
+    ok = fclose(fp) == 0 && ok;
+    remove(path);
+    if (!ok || rename(tmp, path) != 0)
+    {
+        remove(tmp);
+        ESP_LOGW(TAG, "write %s failed", path);
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
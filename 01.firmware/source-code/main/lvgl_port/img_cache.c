@@ -0,0 +1,284 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "img_cache.h"
+
+static const char *TAG = "img_cache";
+
+typedef struct img_entry
+{
+    lv_image_dsc_t dsc; // 必须放第一个，dsc 指针和条目指针可以互转
+    struct img_entry *prev;
+    struct img_entry *next;
+    char *path;
+    int w, h;
+    int variant;
+    lv_color_format_t cf;
+    uint32_t refs;
+    bool listed; // 已 commit、在链表里
+    // 像素紧跟在后面
+} img_entry_t;
+
+typedef struct
+{
+    SemaphoreHandle_t lock;
+    img_entry_t *head; // 最近用过的在前
+    img_entry_t *tail;
+    img_cache_stats_t st;
+} img_cache_t;
+
+static img_cache_t s_cache = {0};
+
+static inline img_entry_t *entry_of(const lv_image_dsc_t *dsc)
+{
+    return (img_entry_t *)dsc;
+}
+
+static void entry_free(img_entry_t *e)
+{
+    free(e->path);
+    heap_caps_free(e);
+}
+
+// 以下链表操作都在 lock 内调用
+static void list_unlink(img_entry_t *e)
+{
+    if (e->prev)
+        e->prev->next = e->next;
+    else
+        s_cache.head = e->next;
+    if (e->next)
+        e->next->prev = e->prev;
+    else
+        s_cache.tail = e->prev;
+    e->prev = e->next = NULL;
+}
+
+static void list_push_front(img_entry_t *e)
+{
+    e->prev = NULL;
+    e->next = s_cache.head;
+    if (s_cache.head)
+        s_cache.head->prev = e;
+    s_cache.head = e;
+    if (!s_cache.tail)
+        s_cache.tail = e;
+}
+
+static void drop_entry(img_entry_t *e)
+{
+    list_unlink(e);
+    s_cache.st.entries--;
+    s_cache.st.bytes -= e->dsc.data_size;
+    // LV_CACHE_DEF_SIZE 为 0，LVGL 自己不缓存变量图源，像素可以直接释放
+    entry_free(e);
+}
+
+// 从尾部往前淘汰没被引用的条目，直到不超预算
+static void evict_locked(size_t budget)
+{
+    img_entry_t *e = s_cache.tail;
+    while (e && s_cache.st.bytes > budget)
+    {
+        img_entry_t *prev = e->prev;
+        if (e->refs == 0)
+        {
+            ESP_LOGD(TAG, "evict %s %dx%d", e->path, e->w, e->h);
+            drop_entry(e);
+            s_cache.st.evictions++;
+        }
+        e = prev;
+    }
+}
+
+static img_entry_t *find_locked(const char *path, int w, int h, int variant, lv_color_format_t cf)
+{
+    for (img_entry_t *e = s_cache.head; e; e = e->next)
+    {
+        if (e->w == w && e->h == h && e->variant == variant && (cf == LV_COLOR_FORMAT_UNKNOWN || e->cf == cf) && strcmp(e->path, path) == 0)
+            return e;
+    }
+    return NULL;
+}
+
+static void touch_locked(img_entry_t *e)
+{
+    if (e->refs++ == 0)
+        s_cache.st.pinned++;
+    if (s_cache.head != e)
+    {
+        list_unlink(e);
+        list_push_front(e);
+    }
+}
+
+esp_err_t img_cache_init(size_t budget)
+{
+    if (!s_cache.lock)
+    {
+        s_cache.lock = xSemaphoreCreateMutex();
+        if (!s_cache.lock)
+            return ESP_ERR_NO_MEM;
+    }
+    img_cache_set_budget(budget);
+    ESP_LOGI(TAG, "budget %u KB", (unsigned)(budget / 1024));
+    return ESP_OK;
+}
+
+void img_cache_set_budget(size_t budget)
+{
+    if (!s_cache.lock)
+        return;
+    xSemaphoreTake(s_cache.lock, portMAX_DELAY);
+    s_cache.st.budget = budget;
+    evict_locked(budget);
+    xSemaphoreGive(s_cache.lock);
+}
+
+const lv_image_dsc_t *img_cache_get(const char *path, int w, int h, int variant, lv_color_format_t cf)
+{
+    if (!s_cache.lock || !path)
+        return NULL;
+
+    xSemaphoreTake(s_cache.lock, portMAX_DELAY);
+    img_entry_t *e = find_locked(path, w, h, variant, cf);
+    if (e)
+    {
+        touch_locked(e);
+        s_cache.st.hits++;
+    }
+    else
+    {
+        s_cache.st.misses++;
+    }
+    xSemaphoreGive(s_cache.lock);
+    return e ? &e->dsc : NULL;
+}
+
+lv_image_dsc_t *img_cache_create(const char *path, int w, int h, int variant, lv_color_format_t cf)
+{
+    if (!s_cache.lock || !path || w <= 0 || h <= 0)
+        return NULL;
+
+    uint32_t stride = (uint32_t)w * lv_color_format_get_size(cf);
+    size_t bytes = (size_t)stride * h;
+    if (cf == LV_COLOR_FORMAT_RGB565A8)
+        bytes += (size_t)w * h; // RGB565 平面后面跟 A8 平面
+    if (bytes == 0)
+        return NULL;
+
+    // 先腾地方，免得 PSRAM 紧张时分配失败
+    xSemaphoreTake(s_cache.lock, portMAX_DELAY);
+    size_t room = s_cache.st.budget > bytes ? s_cache.st.budget - bytes : 0;
+    evict_locked(room);
+    xSemaphoreGive(s_cache.lock);
+
+    // 像素由调用者整块写满，不清零（几百 KB 的 memset 白花时间）
+    img_entry_t *e = heap_caps_malloc(sizeof(img_entry_t) + bytes, MALLOC_CAP_SPIRAM);
+    if (!e)
+        e = malloc(sizeof(img_entry_t) + bytes);
+    if (!e)
+    {
+        ESP_LOGW(TAG, "no mem for %s (%u bytes)", path, (unsigned)bytes);
+        return NULL;
+    }
+    memset(e, 0, sizeof(img_entry_t));
+    e->path = strdup(path);
+    if (!e->path)
+    {
+        heap_caps_free(e);
+        return NULL;
+    }
+    e->w = w;
+    e->h = h;
+    e->variant = variant;
+    e->cf = cf;
+    e->refs = 1;
+
+    e->dsc.header.magic = LV_IMAGE_HEADER_MAGIC;
+    e->dsc.header.cf = cf;
+    e->dsc.header.flags = 0;
+    e->dsc.header.w = w;
+    e->dsc.header.h = h;
+    e->dsc.header.stride = stride;
+    e->dsc.data = (const uint8_t *)(e + 1);
+    e->dsc.data_size = bytes;
+    return &e->dsc;
+}
+
+const lv_image_dsc_t *img_cache_commit(lv_image_dsc_t *dsc)
+{
+    if (!dsc)
+        return NULL;
+    img_entry_t *e = entry_of(dsc);
+
+    xSemaphoreTake(s_cache.lock, portMAX_DELAY);
+    img_entry_t *old = find_locked(e->path, e->w, e->h, e->variant, e->cf);
+    if (old)
+    {
+        touch_locked(old);
+        xSemaphoreGive(s_cache.lock);
+        entry_free(e);
+        return &old->dsc;
+    }
+
+    e->listed = true;
+    list_push_front(e);
+    s_cache.st.entries++;
+    s_cache.st.pinned++;
+    s_cache.st.bytes += dsc->data_size;
+    evict_locked(s_cache.st.budget);
+    xSemaphoreGive(s_cache.lock);
+    return dsc;
+}
+
+void img_cache_release(const lv_image_dsc_t *dsc)
+{
+    if (!dsc)
+        return;
+    img_entry_t *e = entry_of(dsc);
+
+    // 没 commit 过的条目只有调用者一个人知道，直接释放
+    if (!e->listed)
+    {
+        entry_free(e);
+        return;
+    }
+
+    xSemaphoreTake(s_cache.lock, portMAX_DELAY);
+    if (e->refs > 0 && --e->refs == 0)
+    {
+        s_cache.st.pinned--;
+        evict_locked(s_cache.st.budget);
+    }
+    xSemaphoreGive(s_cache.lock);
+}
+
+void img_cache_clear(void)
+{
+    if (!s_cache.lock)
+        return;
+    xSemaphoreTake(s_cache.lock, portMAX_DELAY);
+    evict_locked(0);
+    xSemaphoreGive(s_cache.lock);
+}
+
+void img_cache_get_stats(img_cache_stats_t *st)
+{
+    if (!st)
+        return;
+    if (!s_cache.lock)
+    {
+        memset(st, 0, sizeof(*st));
+        return;
+    }
+    xSemaphoreTake(s_cache.lock, portMAX_DELAY);
+    *st = s_cache.st;
+    xSemaphoreGive(s_cache.lock);
+}
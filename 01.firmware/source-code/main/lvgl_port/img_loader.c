@@ -0,0 +1,304 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_err.h"
+#include "esp_timer.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bsp/esp-bsp.h"
+#include "bsp_board_extra.h"
+#include "img_cache.h"
+#include "img_loader.h"
+
+static const char *TAG = "img_loader";
+
+#define LOADER_QUEUE_LEN 16
+#define LOADER_TASK_PRIO 3 // 低于 LVGL 任务(4)，动画不掉帧
+#define LOADER_TASK_STACK 8192
+
+typedef struct
+{
+    lv_obj_t *img;         // 目标对象；对象删除时（持显示锁）置 NULL
+    volatile bool gone;    // 同上，给后台任务不加锁时提前放弃用
+    char *path;
+    int w, h;
+    img_load_opts_t opts;
+    img_load_cb_t cb;
+    void *user;
+    lv_img_dsc_t *preview; // 预览占位，换上原图后释放
+    int64_t t_submit;
+} load_job_t;
+
+typedef struct
+{
+    QueueHandle_t queue;
+    SemaphoreHandle_t lock; // 只保护 st
+    img_loader_stats_t st;
+} img_loader_t;
+
+static img_loader_t s_ld = {0};
+
+// 没初始化时没有锁，也就没有后台任务，只会在 LVGL 任务里计数
+static void stat_inc(uint32_t *field)
+{
+    if (s_ld.lock)
+        xSemaphoreTake(s_ld.lock, portMAX_DELAY);
+    (*field)++;
+    if (s_ld.lock)
+        xSemaphoreGive(s_ld.lock);
+}
+
+static void release_on_delete(lv_event_t *e)
+{
+    img_cache_release((const lv_image_dsc_t *)lv_event_get_user_data(e));
+}
+
+static void free_on_delete(lv_event_t *e)
+{
+    jpg_image_free((lv_img_dsc_t *)lv_event_get_user_data(e));
+}
+
+// 对象在任务完成前被删：只做标记，任务收尾时释放 job
+static void job_on_delete(lv_event_t *e)
+{
+    load_job_t *job = (load_job_t *)lv_event_get_user_data(e);
+    job->img = NULL;
+    job->gone = true;
+}
+
+static void job_free(load_job_t *job)
+{
+    free(job->path);
+    free(job);
+}
+
+// 以下在显示锁内调用
+static void show_placeholder(lv_obj_t *img, const img_load_opts_t *o)
+{
+    if (o->placeholder == IMG_PLACEHOLDER_SOLID)
+    {
+        lv_obj_set_style_bg_color(img, o->color, 0);
+        lv_obj_set_style_bg_opa(img, LV_OPA_COVER, 0);
+    }
+}
+
+static void clear_placeholder(lv_obj_t *img)
+{
+    lv_obj_set_style_bg_opa(img, LV_OPA_TRANSP, 0);
+    lv_image_set_scale(img, LV_SCALE_NONE);
+}
+
+// 预览：1/8 大小解一张，放大显示（图片对象默认开抗锯齿，放大后就是模糊效果）
+static void load_preview(load_job_t *job)
+{
+    int pw = (job->w + 7) / 8, ph = (job->h + 7) / 8;
+    lv_img_dsc_t *p = jpg_image_load(job->path, pw, ph, job->opts.mode);
+    if (!p)
+        return;
+
+    bsp_display_lock(portMAX_DELAY);
+    if (job->img)
+    {
+        lv_image_set_src(job->img, p);
+        lv_image_set_scale_x(job->img, (uint32_t)(LV_SCALE_NONE * job->w / pw));
+        lv_image_set_scale_y(job->img, (uint32_t)(LV_SCALE_NONE * job->h / ph));
+        job->preview = p;
+        p = NULL;
+    }
+    bsp_display_unlock();
+    if (p)
+        jpg_image_free(p);
+}
+
+// 原图：优先进共享缓存，缓存用不了时单独分配
+static void load_full(load_job_t *job, const lv_image_dsc_t **cached, lv_img_dsc_t **own)
+{
+    esp_err_t err = ESP_ERR_NO_MEM;
+    if (!job->opts.uncached)
+        err = jpg_image_acquire(job->path, job->w, job->h, job->opts.mode, cached);
+    if (err == ESP_ERR_NO_MEM)
+        *own = jpg_image_load(job->path, job->w, job->h, job->opts.mode);
+}
+
+static void run_job(load_job_t *job)
+{
+    const lv_image_dsc_t *cached = NULL;
+    lv_img_dsc_t *own = NULL;
+
+    if (!job->gone && job->opts.placeholder == IMG_PLACEHOLDER_PREVIEW)
+        load_preview(job);
+    if (!job->gone)
+        load_full(job, &cached, &own);
+    bool ok = cached || own;
+
+    bsp_display_lock(portMAX_DELAY);
+    lv_obj_t *img = job->img;
+    if (img)
+    {
+        lv_obj_remove_event_cb_with_user_data(img, job_on_delete, job);
+        clear_placeholder(img);
+        if (cached)
+        {
+            lv_image_set_src(img, cached);
+            lv_obj_add_event_cb(img, release_on_delete, LV_EVENT_DELETE, (void *)cached);
+        }
+        else if (own)
+        {
+            lv_image_set_src(img, own);
+            lv_obj_add_event_cb(img, free_on_delete, LV_EVENT_DELETE, own);
+        }
+        else if (job->preview)
+        {
+            lv_image_set_src(img, NULL); // 预览马上要释放
+        }
+        if (job->cb)
+            job->cb(img, ok, job->user);
+    }
+    bsp_display_unlock();
+
+    if (job->preview)
+        jpg_image_free(job->preview);
+    if (!img)
+    {
+        img_cache_release(cached);
+        if (own)
+            jpg_image_free(own);
+        stat_inc(&s_ld.st.dropped);
+    }
+    else if (!ok)
+    {
+        ESP_LOGW(TAG, "load %s failed", job->path);
+        stat_inc(&s_ld.st.failed);
+    }
+    else
+    {
+        uint32_t ms = (uint32_t)((esp_timer_get_time() - job->t_submit) / 1000);
+        ESP_LOGD(TAG, "%s ready in %u ms", job->path, (unsigned)ms);
+        stat_inc(&s_ld.st.done);
+        if (ms > s_ld.st.max_ms)
+            s_ld.st.max_ms = ms; // 只是统计，不加锁
+    }
+    job_free(job);
+}
+
+static void loader_task(void *arg)
+{
+    load_job_t *job;
+    for (;;)
+    {
+        if (xQueueReceive(s_ld.queue, &job, portMAX_DELAY) == pdTRUE)
+            run_job(job);
+    }
+}
+
+esp_err_t img_loader_init(int workers)
+{
+    if (s_ld.queue)
+        return ESP_OK;
+    if (workers < 1)
+        workers = 1;
+
+    s_ld.lock = xSemaphoreCreateMutex();
+    s_ld.queue = xQueueCreate(LOADER_QUEUE_LEN, sizeof(load_job_t *));
+    if (!s_ld.lock || !s_ld.queue)
+        return ESP_ERR_NO_MEM;
+
+    for (int i = 0; i < workers; i++)
+    {
+        char name[16];
+        snprintf(name, sizeof(name), "img_load%d", i);
+        if (xTaskCreatePinnedToCore(loader_task, name, LOADER_TASK_STACK, NULL, LOADER_TASK_PRIO, NULL,
+                                    tskNO_AFFINITY) != pdPASS)
+        {
+            ESP_LOGE(TAG, "create %s failed", name);
+            return i ? ESP_OK : ESP_ERR_NO_MEM; // 起来一个也能用
+        }
+    }
+    ESP_LOGI(TAG, "%d workers", workers);
+    return ESP_OK;
+}
+
+lv_obj_t *image_load_async(lv_obj_t *parent, const char *path, int w, int h, const img_load_opts_t *opts,
+                           img_load_cb_t cb, void *user)
+{
+    if (!parent || !path || w <= 0 || h <= 0)
+        return NULL;
+    img_load_opts_t def = IMG_LOAD_OPTS_DEFAULT();
+    if (!opts)
+        opts = &def;
+
+    stat_inc(&s_ld.st.submitted);
+
+    // 缓存里已有就当场显示，不走队列
+    const lv_image_dsc_t *hit = opts->uncached ? NULL : img_cache_get(path, w, h, opts->mode, LV_COLOR_FORMAT_UNKNOWN);
+
+    bsp_display_lock(portMAX_DELAY);
+    lv_obj_t *img = lv_image_create(parent);
+    if (!img)
+    {
+        bsp_display_unlock();
+        img_cache_release(hit);
+        return NULL;
+    }
+    lv_obj_set_size(img, w, h);
+    lv_obj_align(img, LV_ALIGN_CENTER, 0, 0);
+    if (hit)
+    {
+        lv_image_set_src(img, hit);
+        lv_obj_add_event_cb(img, release_on_delete, LV_EVENT_DELETE, (void *)hit);
+        if (cb)
+            cb(img, true, user);
+        bsp_display_unlock();
+        stat_inc(&s_ld.st.hits);
+        return img;
+    }
+    // 作业在锁里建好并挂上删除回调：放锁之后页面随时可能删掉 img，回调晚挂一步就会漏掉
+    load_job_t *job = (load_job_t *)calloc(1, sizeof(load_job_t));
+    if (job)
+        job->path = strdup(path);
+    if (!job || !job->path)
+    {
+        free(job);
+        if (cb)
+            cb(img, false, user);
+        bsp_display_unlock();
+        stat_inc(&s_ld.st.failed);
+        return img;
+    }
+    job->img = img;
+    job->w = w;
+    job->h = h;
+    job->opts = *opts;
+    job->cb = cb;
+    job->user = user;
+    job->t_submit = esp_timer_get_time();
+    show_placeholder(img, opts);
+    lv_obj_add_event_cb(img, job_on_delete, LV_EVENT_DELETE, job);
+    bsp_display_unlock();
+
+    // 没初始化或队列满：当场加载（和 show_jpg_as_img 一样阻塞）
+    if (!s_ld.queue || xQueueSend(s_ld.queue, &job, 0) != pdTRUE)
+    {
+        ESP_LOGD(TAG, "load %s inline", path);
+        run_job(job);
+    }
+    return img;
+}
+
+void img_loader_get_stats(img_loader_stats_t *st)
+{
+    if (!st)
+        return;
+    if (!s_ld.lock)
+    {
+        memset(st, 0, sizeof(*st));
+        return;
+    }
+    xSemaphoreTake(s_ld.lock, portMAX_DELAY);
+    *st = s_ld.st;
+    xSemaphoreGive(s_ld.lock);
+}
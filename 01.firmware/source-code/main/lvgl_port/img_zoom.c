@@ -0,0 +1,1060 @@
+// img_zoom.c — 相册大图缩放浏览（瓦片金字塔）
+
+#include "lvgl.h"
+#include "esp_jpeg_dec.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "bsp/esp-bsp.h"
+#include "bsp_board_extra.h" // 为了 bsp_display_lock/unlock
+#include "ui.h"
+#include "jpg_pool.h"
+#include "touch_multi.h"
+#include "img_zoom.h"
+
+static const char *TAG = "img_zoom";
+
+// ============================= 配置项 =============================
+
+// 瓦片边长，解码器 clipper 要求 8 的倍数
+#ifndef ZOOM_TILE
+#define ZOOM_TILE 128
+#endif
+#if ZOOM_TILE % 8
+#error "ZOOM_TILE must be a multiple of 8"
+#endif
+
+// 原图、1/2、1/4、1/8：解码器最多缩到 1/8
+#define ZOOM_LEVELS 4
+
+// 选层时允许把瓦片放大到 1/ZOOM_LEVEL_SLACK 倍：层像素 / 屏幕像素落在 0.7～1.4，
+// 一屏用到的瓦片数有上限，也不会为了一点点放大去解细一倍的层
+#define ZOOM_LEVEL_SLACK 0.7f
+
+// 缓存的瓦片数（每块 ZOOM_TILE^2 RGB565 = 32KB，48 块 1.5MB PSRAM）。
+// 必须比一屏可见的瓦片多（410x502 按上面的比例最多 6x7 块），否则新露出来的没地方放
+#ifndef ZOOM_TILE_CACHE
+#define ZOOM_TILE_CACHE 48
+#endif
+
+// scale + clipper 一次输出（左上角到这批瓦片右下角）的上限；超过就改走块模式流式解，内存只要一条 MCU 行
+#ifndef ZOOM_DECODE_BUDGET
+#define ZOOM_DECODE_BUDGET (1536 * 1024)
+#endif
+
+// 最细的一层最多再放大几倍
+#ifndef ZOOM_MAX_MAG
+#define ZOOM_MAX_MAG 2.0f
+#endif
+
+#define ZOOM_JOB_MAX 16             // 一次解码最多填几块瓦片
+#define ZOOM_TRIM_KEEP (512 * 1024) // 关闭后解码池里留下的缓冲上限（够相册整屏图用）
+#define ZOOM_EXIT_SLACK 1.05f       // 松手时不超过适应屏幕的这么多倍就退出
+#define ZOOM_TAP_SLOP 8             // 按下后移动不到这么多像素算点按
+#define ZOOM_DOUBLE_TAP_MS 350
+#define ZOOM_TASK_PRIO 2 // 和相册预取一样，只用 LVGL 任务空闲的时间
+#define ZOOM_TASK_STACK 8192
+
+#define ALIGN8_UP(v) (((v) + 7) & ~7)
+
+// ========================== 内部状态/资源 =========================
+
+typedef enum
+{
+    TILE_EMPTY = 0,
+    TILE_LOADING, // 后台任务正在写 buf，不能画也不能淘汰
+    TILE_READY,
+    TILE_FAILED, // 留着占位免得反复重试，底图垫着
+} tile_state_t;
+
+typedef struct
+{
+    tile_state_t state;
+    uint8_t level;
+    uint16_t tx, ty;
+    uint32_t gen;       // 属于哪次 open；对不上就是旧图的
+    uint32_t stamp;     // 最近一次被画的时间，LRU 用
+    lv_image_dsc_t dsc; // 边缘瓦片 w/h 小一些，stride 不变
+    uint8_t *buf;       // ZOOM_TILE x ZOOM_TILE RGB565，第一次用时分配，之后复用
+} zoom_tile_t;
+
+typedef struct
+{
+    int w, h; // 这一层的尺寸
+    bool ok;  // 这一层解得出来
+} zoom_level_t;
+
+// 可见瓦片范围（闭区间）
+typedef struct
+{
+    int l;
+    int tx0, ty0, tx1, ty1;
+} tile_range_t;
+
+// 对象删除时不等正在进行的解码：只置 quit，由后台任务收尾后释放整块状态。
+// 所有字段都由显示锁保护：LVGL 任务本来就持着它，后台任务只在取活/交结果时拿
+typedef struct
+{
+    lv_obj_t *obj;
+    TaskHandle_t task;
+    bool quit;
+    int vw, vh;
+
+    // 当前图片
+    uint32_t gen; // 每次打开/关闭加一，旧图的解码结果作废
+    char *path;   // NULL 表示没打开
+    const lv_image_dsc_t *base;
+    int img_w, img_h;
+    zoom_level_t lv[ZOOM_LEVELS];
+    bool broken; // 文件读不出来，只剩底图
+
+    // 视图：原图坐标 (cx, cy) 落在视口中心，z = 屏幕像素 / 原图像素
+    float cx, cy, z;
+    float z_fit, z_max;
+
+    // 手势
+    int touches; // 当前跟踪的触点数，0 表示要重新取起点
+    lv_point_t p0;
+    float cx0, cy0;
+    float d0, z0; // 双指起始距离和缩放
+    float ax, ay; // 双指中点下的原图坐标，缩放时保持它不动
+    bool moved;
+    uint32_t last_tap;
+
+    img_zoom_exit_cb_t exit_cb;
+    void *exit_user;
+
+    zoom_tile_t tiles[ZOOM_TILE_CACHE];
+    uint32_t clock;
+
+    uint32_t decoded, clip_passes, block_passes, failed, max_ms;
+} zoom_view_t;
+
+// 一次解码：同一层的一批瓦片，解码期间只有后台任务碰它们
+typedef struct
+{
+    uint32_t gen;
+    int l, lw, lh;
+    int img_w, img_h;
+    int n;
+    zoom_tile_t *t[ZOOM_JOB_MAX];
+    bool ok[ZOOM_JOB_MAX];
+} zoom_job_t;
+
+// =========================== 金字塔几何 ============================
+
+// 第 l 层的尺寸：l>0 时是解码器 scale 的输出，要凑成 8 的倍数
+static int level_dim(int full, int l)
+{
+    if (l == 0)
+        return full;
+    int d = (full + (1 << l) - 1) >> l;
+    return ALIGN8_UP(d);
+}
+
+// 哪些层解得出来：输出整层放得进预算就能用 scale + clipper；放不下要靠块模式（宽高都是 8 的倍数）
+static int setup_levels(zoom_view_t *zv)
+{
+    bool block = (zv->img_w % 8) == 0 && (zv->img_h % 8) == 0;
+    int n = 0;
+    for (int l = 0; l < ZOOM_LEVELS; l++)
+    {
+        zoom_level_t *lv = &zv->lv[l];
+        lv->w = level_dim(zv->img_w, l);
+        lv->h = level_dim(zv->img_h, l);
+        bool exists = l == 0 || (lv->w < zv->img_w && lv->h < zv->img_h);
+        lv->ok = exists && ((size_t)lv->w * lv->h * 2 <= ZOOM_DECODE_BUDGET || block);
+        n += lv->ok;
+    }
+    return n;
+}
+
+// 够细（放大不超过 1/ZOOM_LEVEL_SLACK）的层里最粗的；都不够细就用最细的
+static int pick_level(const zoom_view_t *zv)
+{
+    int pick = -1;
+    for (int l = 0; l < ZOOM_LEVELS; l++)
+    {
+        if (!zv->lv[l].ok)
+            continue;
+        if (pick < 0 || zv->lv[l].w >= zv->z * zv->img_w * ZOOM_LEVEL_SLACK)
+            pick = l;
+    }
+    return pick;
+}
+
+static bool at_fit(const zoom_view_t *zv)
+{
+    return zv->z <= zv->z_fit * 1.001f;
+}
+
+static bool visible_range(const zoom_view_t *zv, tile_range_t *r)
+{
+    r->l = pick_level(zv);
+    if (r->l < 0)
+        return false;
+    const zoom_level_t *lv = &zv->lv[r->l];
+    float kx = (float)lv->w / zv->img_w, ky = (float)lv->h / zv->img_h; // 层像素 / 原图像素
+    float hw = zv->vw / (2 * zv->z), hh = zv->vh / (2 * zv->z);
+    int x0 = (int)floorf((zv->cx - hw) * kx), x1 = (int)ceilf((zv->cx + hw) * kx);
+    int y0 = (int)floorf((zv->cy - hh) * ky), y1 = (int)ceilf((zv->cy + hh) * ky);
+    if (x0 < 0)
+        x0 = 0;
+    if (y0 < 0)
+        y0 = 0;
+    if (x1 > lv->w)
+        x1 = lv->w;
+    if (y1 > lv->h)
+        y1 = lv->h;
+    if (x1 <= x0 || y1 <= y0)
+        return false;
+    r->tx0 = x0 / ZOOM_TILE;
+    r->ty0 = y0 / ZOOM_TILE;
+    r->tx1 = (x1 - 1) / ZOOM_TILE;
+    r->ty1 = (y1 - 1) / ZOOM_TILE;
+    return true;
+}
+
+// 原图坐标 -> 对象内坐标
+static float map_x(const zoom_view_t *zv, float sx)
+{
+    return (sx - zv->cx) * zv->z + zv->vw / 2.0f;
+}
+
+static float map_y(const zoom_view_t *zv, float sy)
+{
+    return (sy - zv->cy) * zv->z + zv->vh / 2.0f;
+}
+
+// 缩放夹在 [适应屏幕, 最大]，比视口小的方向居中，否则不让拖出图外
+static void clamp_view(zoom_view_t *zv)
+{
+    if (zv->z > zv->z_max)
+        zv->z = zv->z_max;
+    if (zv->z < zv->z_fit)
+        zv->z = zv->z_fit;
+    float hw = zv->vw / (2 * zv->z), hh = zv->vh / (2 * zv->z);
+    if (zv->img_w <= 2 * hw)
+        zv->cx = zv->img_w / 2.0f;
+    else if (zv->cx < hw)
+        zv->cx = hw;
+    else if (zv->cx > zv->img_w - hw)
+        zv->cx = zv->img_w - hw;
+    if (zv->img_h <= 2 * hh)
+        zv->cy = zv->img_h / 2.0f;
+    else if (zv->cy < hh)
+        zv->cy = hh;
+    else if (zv->cy > zv->img_h - hh)
+        zv->cy = zv->img_h - hh;
+}
+
+// =========================== 瓦片缓存 ============================
+
+// 以下 *_locked 都在显示锁内调用
+static zoom_tile_t *find_tile_locked(zoom_view_t *zv, int l, int tx, int ty)
+{
+    for (int i = 0; i < ZOOM_TILE_CACHE; i++)
+    {
+        zoom_tile_t *t = &zv->tiles[i];
+        if (t->state != TILE_EMPTY && t->gen == zv->gen && t->level == l && t->tx == tx && t->ty == ty)
+            return t;
+    }
+    return NULL;
+}
+
+static bool in_range(const tile_range_t *r, const zoom_tile_t *t)
+{
+    return t->level == r->l && t->tx >= r->tx0 && t->tx <= r->tx1 && t->ty >= r->ty0 && t->ty <= r->ty1;
+}
+
+// 空的优先，否则淘汰不可见的里最久没画的；正在解的不动
+static zoom_tile_t *victim_locked(zoom_view_t *zv, const tile_range_t *r)
+{
+    zoom_tile_t *best = NULL;
+    for (int i = 0; i < ZOOM_TILE_CACHE; i++)
+    {
+        zoom_tile_t *t = &zv->tiles[i];
+        if (t->state == TILE_LOADING)
+            continue;
+        if (t->state == TILE_EMPTY || t->gen != zv->gen)
+            return t;
+        if (in_range(r, t))
+            continue;
+        if (!best || t->stamp < best->stamp)
+            best = t;
+    }
+    return best;
+}
+
+// 当前视口里缺的瓦片，一批最多 ZOOM_JOB_MAX 块；适应屏幕时底图就是原样，不用解
+static bool next_job_locked(zoom_view_t *zv, zoom_job_t *job)
+{
+    tile_range_t r;
+    if (at_fit(zv) || !visible_range(zv, &r))
+        return false;
+
+    job->gen = zv->gen;
+    job->l = r.l;
+    job->lw = zv->lv[r.l].w;
+    job->lh = zv->lv[r.l].h;
+    job->img_w = zv->img_w;
+    job->img_h = zv->img_h;
+    job->n = 0;
+    for (int ty = r.ty0; ty <= r.ty1; ty++)
+    {
+        for (int tx = r.tx0; tx <= r.tx1 && job->n < ZOOM_JOB_MAX; tx++)
+        {
+            if (find_tile_locked(zv, r.l, tx, ty))
+                continue;
+            zoom_tile_t *t = victim_locked(zv, &r);
+            if (!t)
+                return job->n > 0;
+            t->state = TILE_LOADING;
+            t->gen = zv->gen;
+            t->level = (uint8_t)r.l;
+            t->tx = (uint16_t)tx;
+            t->ty = (uint16_t)ty;
+            job->ok[job->n] = false;
+            job->t[job->n++] = t;
+        }
+    }
+    return job->n > 0;
+}
+
+// 旧图的瓦片全部作废（正在解的等交结果时按 gen 丢掉）
+static void drop_image_locked(zoom_view_t *zv)
+{
+    if (zv->path)
+        ESP_LOGI(TAG, "%s: %u tiles in %u clip / %u block passes, %u failed, slowest %u ms", zv->path,
+                 (unsigned)zv->decoded, (unsigned)zv->clip_passes, (unsigned)zv->block_passes, (unsigned)zv->failed,
+                 (unsigned)zv->max_ms);
+    free(zv->path);
+    zv->path = NULL;
+    zv->base = NULL;
+    zv->gen++;
+    for (int i = 0; i < ZOOM_TILE_CACHE; i++)
+    {
+        if (zv->tiles[i].state != TILE_LOADING)
+            zv->tiles[i].state = TILE_EMPTY;
+    }
+}
+
+// =========================== 后台解码 ============================
+
+// 文件整段读进上下文的输入缓冲（解码器要求整段输入）
+static uint8_t *read_file(jpg_ctx_t *ctx, const char *path, size_t *len)
+{
+    FILE *fp = fopen(path, "rb");
+    if (!fp)
+        return NULL;
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    uint8_t *buf = size > 0 ? jpg_ctx_in(ctx, (size_t)size) : NULL;
+    bool ok = buf && fread(buf, 1, (size_t)size, fp) == (size_t)size;
+    fclose(fp);
+    *len = ok ? (size_t)size : 0;
+    return ok ? buf : NULL;
+}
+
+static jpeg_dec_handle_t open_decoder(jpg_ctx_t *ctx, const jpeg_dec_config_t *cfg, jpeg_dec_io_t *io)
+{
+    jpeg_dec_handle_t j = jpg_ctx_decoder(ctx, cfg);
+    if (!j)
+        return NULL;
+    jpeg_dec_header_info_t hi;
+    if (jpeg_dec_parse_header(j, io, &hi) != JPEG_ERR_OK)
+    {
+        jpg_ctx_reset_decoder(ctx);
+        return NULL;
+    }
+    return j;
+}
+
+static void tile_rect(const zoom_job_t *job, const zoom_tile_t *t, int *x, int *y, int *w, int *h)
+{
+    *x = t->tx * ZOOM_TILE;
+    *y = t->ty * ZOOM_TILE;
+    *w = job->lw - *x < ZOOM_TILE ? job->lw - *x : ZOOM_TILE;
+    *h = job->lh - *y < ZOOM_TILE ? job->lh - *y : ZOOM_TILE;
+}
+
+// 这批瓦片在层里的右/下边界
+static void job_extent(const zoom_job_t *job, int *x1, int *y0, int *y1)
+{
+    *x1 = 0;
+    *y0 = job->lh;
+    *y1 = 0;
+    for (int k = 0; k < job->n; k++)
+    {
+        int x, y, w, h;
+        tile_rect(job, job->t[k], &x, &y, &w, &h);
+        if (x + w > *x1)
+            *x1 = x + w;
+        if (y < *y0)
+            *y0 = y;
+        if (y + h > *y1)
+            *y1 = y + h;
+    }
+}
+
+// 方式一：解码器直接 scale 到这一层，clipper 只留左上角到这批瓦片右下角，输出整块拷进各瓦片
+static bool decode_clipped(jpg_ctx_t *ctx, const uint8_t *bytes, size_t len, zoom_job_t *job, int cw, int ch)
+{
+    jpeg_dec_config_t cfg = DEFAULT_JPEG_DEC_CONFIG();
+    cfg.output_type = JPEG_PIXEL_FORMAT_RGB565_LE;
+    if (job->l > 0)
+    {
+        cfg.scale.width = job->lw;
+        cfg.scale.height = job->lh;
+    }
+    if (cw < job->lw)
+        cfg.clipper.width = cw;
+    if (ch < job->lh)
+        cfg.clipper.height = ch;
+
+    jpeg_dec_io_t io = {.inbuf = (uint8_t *)bytes, .inbuf_len = (int)len};
+    jpeg_dec_handle_t j = open_decoder(ctx, &cfg, &io);
+    if (!j)
+        return false;
+    int out_len = 0;
+    if (jpeg_dec_get_outbuf_len(j, &out_len) != JPEG_ERR_OK || out_len < cw * ch * 2)
+    {
+        ESP_LOGW(TAG, "clip out len %d for %dx%d", out_len, cw, ch);
+        jpg_ctx_reset_decoder(ctx);
+        return false;
+    }
+    uint8_t *out = jpg_ctx_out(ctx, (size_t)out_len);
+    if (!out)
+    {
+        jpg_ctx_reset_decoder(ctx);
+        return false;
+    }
+    io.outbuf = out;
+    if (jpeg_dec_process(j, &io) != JPEG_ERR_OK)
+    {
+        jpg_ctx_reset_decoder(ctx);
+        return false;
+    }
+
+    for (int k = 0; k < job->n; k++)
+    {
+        int x, y, w, h;
+        tile_rect(job, job->t[k], &x, &y, &w, &h);
+        for (int row = 0; row < h; row++)
+            memcpy(job->t[k]->buf + (size_t)row * ZOOM_TILE * 2, out + ((size_t)(y + row) * cw + x) * 2,
+                   (size_t)w * 2);
+        job->ok[k] = true;
+    }
+    return true;
+}
+
+// 层坐标 -> 原图坐标（像素中心对齐的最近邻）
+static int src_of(int lx, int full, int level)
+{
+    return (int)(((int64_t)(2 * lx + 1) * full) / (2 * level));
+}
+
+// 方式二：块模式按 MCU 行解原图，这批瓦片用到的原图行当场最近邻采样进瓦片；
+// 内存只有一条 MCU 行，最后一行瓦片以下不再解
+static bool decode_blocks(jpg_ctx_t *ctx, const uint8_t *bytes, size_t len, zoom_job_t *job)
+{
+    jpeg_dec_config_t cfg = DEFAULT_JPEG_DEC_CONFIG();
+    cfg.output_type = JPEG_PIXEL_FORMAT_RGB565_LE;
+    cfg.block_enable = true;
+
+    jpeg_dec_io_t io = {.inbuf = (uint8_t *)bytes, .inbuf_len = (int)len};
+    jpeg_dec_handle_t j = open_decoder(ctx, &cfg, &io);
+    if (!j)
+        return false;
+    int block_len = 0, count = 0;
+    if (jpeg_dec_get_outbuf_len(j, &block_len) != JPEG_ERR_OK || block_len <= 0 ||
+        jpeg_dec_get_process_count(j, &count) != JPEG_ERR_OK || count <= 0)
+    {
+        jpg_ctx_reset_decoder(ctx);
+        return false;
+    }
+    uint8_t *strip = jpg_ctx_strip(ctx, (size_t)block_len);
+    if (!strip)
+    {
+        jpg_ctx_reset_decoder(ctx);
+        return false;
+    }
+
+    int x1, ly, ly1;
+    job_extent(job, &x1, &ly, &ly1);
+    uint32_t step = (uint32_t)(((uint64_t)job->img_w << 16) / job->lw);
+    int y = 0, i;
+    bool ok = true;
+    for (i = 0; i < count && ly < ly1; i++)
+    {
+        io.outbuf = strip;
+        if (jpeg_dec_process(j, &io) != JPEG_ERR_OK)
+        {
+            ok = false;
+            break;
+        }
+        int lines = io.out_size / (job->img_w * 2);
+        for (int sy; ly < ly1 && (sy = src_of(ly, job->img_h, job->lh)) < y + lines; ly++)
+        {
+            const uint16_t *src = (const uint16_t *)strip + (size_t)(sy - y) * job->img_w;
+            for (int k = 0; k < job->n; k++)
+            {
+                int tx, ty, w, h;
+                tile_rect(job, job->t[k], &tx, &ty, &w, &h);
+                if (ly < ty || ly >= ty + h)
+                    continue;
+                uint16_t *d = (uint16_t *)job->t[k]->buf + (size_t)(ly - ty) * ZOOM_TILE;
+                uint32_t fx = (uint32_t)(((uint64_t)(2 * tx + 1) * job->img_w << 15) / job->lw);
+                for (int x = 0; x < w; x++, fx += step)
+                    d[x] = src[fx >> 16];
+            }
+        }
+        y += lines;
+    }
+    if (i < count)
+        jpg_ctx_reset_decoder(ctx); // 提前结束，句柄里还留着没解完的状态
+    if (!ok || ly < ly1)
+        return false;
+    for (int k = 0; k < job->n; k++)
+        job->ok[k] = true;
+    return true;
+}
+
+// 小于预算用 scale + clipper（一次出整块，快）；否则块模式（setup_levels 保证这时能用）
+static bool decode_job(jpg_ctx_t *ctx, const uint8_t *bytes, size_t len, zoom_job_t *job, bool *block)
+{
+    for (int k = 0; k < job->n; k++)
+    {
+        zoom_tile_t *t = job->t[k];
+        if (!t->buf)
+            t->buf = heap_caps_malloc((size_t)ZOOM_TILE * ZOOM_TILE * 2, MALLOC_CAP_SPIRAM);
+        if (!t->buf)
+            return false;
+    }
+
+    int x1, y0, y1;
+    job_extent(job, &x1, &y0, &y1);
+    int cw = ALIGN8_UP(x1) < job->lw ? ALIGN8_UP(x1) : job->lw;
+    int ch = ALIGN8_UP(y1) < job->lh ? ALIGN8_UP(y1) : job->lh;
+    *block = (size_t)cw * ch * 2 > ZOOM_DECODE_BUDGET;
+    return *block ? decode_blocks(ctx, bytes, len, job) : decode_clipped(ctx, bytes, len, job, cw, ch);
+}
+
+// 持显示锁：结果交回缓存，旧图的直接作废
+static void commit_job_locked(zoom_view_t *zv, const zoom_job_t *job, bool block, uint32_t ms)
+{
+    bool any = false;
+    for (int k = 0; k < job->n; k++)
+    {
+        zoom_tile_t *t = job->t[k];
+        if (t->gen != zv->gen)
+        {
+            t->state = TILE_EMPTY;
+            continue;
+        }
+        if (!job->ok[k])
+        {
+            t->state = TILE_FAILED;
+            zv->failed++;
+            continue;
+        }
+        int x, y, w, h;
+        tile_rect(job, t, &x, &y, &w, &h);
+        memset(&t->dsc, 0, sizeof(t->dsc));
+        t->dsc.header.magic = LV_IMAGE_HEADER_MAGIC;
+        t->dsc.header.cf = LV_COLOR_FORMAT_RGB565;
+        t->dsc.header.w = w;
+        t->dsc.header.h = h;
+        t->dsc.header.stride = ZOOM_TILE * 2;
+        t->dsc.data = t->buf;
+        t->dsc.data_size = (uint32_t)ZOOM_TILE * 2 * h;
+        lv_image_cache_drop(&t->dsc); // 同一个描述符换了内容
+        t->state = TILE_READY;
+        zv->decoded++;
+        any = true;
+    }
+    if (job->gen == zv->gen)
+    {
+        if (block)
+            zv->block_passes++;
+        else
+            zv->clip_passes++;
+        if (ms > zv->max_ms)
+            zv->max_ms = ms;
+    }
+    if (any && zv->obj)
+        lv_obj_invalidate(zv->obj);
+}
+
+static void zoom_free(zoom_view_t *zv)
+{
+    for (int i = 0; i < ZOOM_TILE_CACHE; i++)
+        heap_caps_free(zv->tiles[i].buf);
+    free(zv->path);
+    free(zv);
+}
+
+static void zoom_task(void *arg)
+{
+    zoom_view_t *zv = (zoom_view_t *)arg;
+    jpg_ctx_t *ctx = NULL; // 打开期间一直占着：输入缓冲里是整个文件
+    const uint8_t *bytes = NULL;
+    size_t len = 0;
+    uint32_t file_gen = 0; // bytes 属于哪次 open（gen 从 1 起）
+    zoom_job_t job;
+
+    for (;;)
+    {
+        bsp_display_lock(portMAX_DELAY);
+        bool quit = zv->quit;
+        uint32_t gen = zv->gen;
+        bool open = zv->path && !zv->broken;
+        char *path = open && file_gen != gen ? strdup(zv->path) : NULL;
+        bool have = open && !path && next_job_locked(zv, &job);
+        bsp_display_unlock();
+        if (quit)
+            break;
+
+        if (path)
+        {
+            if (!ctx)
+                ctx = jpg_pool_acquire();
+            bytes = ctx ? read_file(ctx, path, &len) : NULL;
+            file_gen = gen;
+            if (!bytes)
+            {
+                ESP_LOGW(TAG, "read %s failed", path);
+                bsp_display_lock(portMAX_DELAY);
+                if (zv->gen == gen)
+                    zv->broken = true;
+                bsp_display_unlock();
+            }
+            free(path);
+            continue;
+        }
+        if (!have)
+        {
+            if (!open && ctx)
+            {
+                // 关掉了：整个文件和大块输出缓冲都还给池，再把池里的大块释放掉
+                jpg_pool_release(ctx);
+                ctx = NULL;
+                bytes = NULL;
+                file_gen = 0;
+                jpg_pool_trim(ZOOM_TRIM_KEEP);
+            }
+            // 可见的都有了；视图变化、打开/关闭或删除时会被通知
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        int64_t t0 = esp_timer_get_time();
+        bool block = false;
+        if (!decode_job(ctx, bytes, len, &job, &block))
+            ESP_LOGW(TAG, "level %d: %d tiles failed", job.l, job.n);
+        uint32_t ms = (uint32_t)((esp_timer_get_time() - t0) / 1000);
+        ESP_LOGD(TAG, "level %d: %d tiles (%s) in %u ms", job.l, job.n, block ? "block" : "clip", (unsigned)ms);
+
+        bsp_display_lock(portMAX_DELAY);
+        commit_job_locked(zv, &job, block, ms);
+        bsp_display_unlock();
+    }
+
+    if (ctx)
+    {
+        jpg_pool_release(ctx);
+        jpg_pool_trim(ZOOM_TRIM_KEEP);
+    }
+    zoom_free(zv);
+    vTaskDelete(NULL);
+}
+
+// =========================== 绘制 ============================
+
+// 把 src 画到对象内 [x, x+w) x [y, y+h)，缩放按左上角；比例向上取整，和下一块之间不留缝
+static void draw_scaled(lv_layer_t *layer, const lv_image_dsc_t *src, int32_t x, int32_t y, int32_t w, int32_t h,
+                        bool smooth)
+{
+    lv_draw_image_dsc_t d;
+    lv_draw_image_dsc_init(&d);
+    d.src = src;
+    d.scale_x = (int32_t)(((int64_t)w * LV_SCALE_NONE + src->header.w - 1) / src->header.w);
+    d.scale_y = (int32_t)(((int64_t)h * LV_SCALE_NONE + src->header.h - 1) / src->header.h);
+    d.pivot.x = 0;
+    d.pivot.y = 0;
+    d.antialias = smooth;
+    lv_area_t a = {x, y, x + src->header.w - 1, y + src->header.h - 1};
+    lv_draw_image(layer, &d, &a);
+}
+
+// 底图：相册的整屏图（JPG_FIT，图居中、四周黑边），按 plan_scale 的算法还原它和原图的比例
+static void draw_base(zoom_view_t *zv, lv_layer_t *layer, const lv_area_t *oc, bool smooth)
+{
+    const lv_image_dsc_t *b = zv->base;
+    if (at_fit(zv))
+    {
+        draw_scaled(layer, b, oc->x1, oc->y1, b->header.w, b->header.h, false);
+        return;
+    }
+    float r = fminf((float)b->header.w / zv->img_w, (float)b->header.h / zv->img_h);
+    int tw = zv->img_w, th = zv->img_h;
+    if (r < 1.0f)
+    {
+        tw = (int)(zv->img_w * r + 0.5f);
+        th = (int)(zv->img_h * r + 0.5f);
+    }
+    float ox = (b->header.w - tw) / 2, oy = (b->header.h - th) / 2; // 底图里图的左上角
+    float kx = (float)zv->img_w / tw, ky = (float)zv->img_h / th;  // 原图像素 / 底图像素
+    int32_t x0 = (int32_t)lroundf(map_x(zv, -ox * kx)), y0 = (int32_t)lroundf(map_y(zv, -oy * ky));
+    int32_t x1 = (int32_t)lroundf(map_x(zv, (b->header.w - ox) * kx));
+    int32_t y1 = (int32_t)lroundf(map_y(zv, (b->header.h - oy) * ky));
+    draw_scaled(layer, b, oc->x1 + x0, oc->y1 + y0, x1 - x0, y1 - y0, smooth);
+}
+
+static void zoom_draw(zoom_view_t *zv, lv_layer_t *layer)
+{
+    if (!zv->path)
+        return;
+    lv_area_t oc;
+    lv_obj_get_coords(zv->obj, &oc);
+    bool smooth = zv->touches == 0; // 手指在动时不做插值，松手后重画一遍平滑的
+
+    tile_range_t r = {0};
+    bool tiled = !at_fit(zv) && !zv->broken && visible_range(zv, &r);
+    bool complete = tiled; // 可见瓦片全齐就不用画底图
+    for (int ty = r.ty0; complete && ty <= r.ty1; ty++)
+    {
+        for (int tx = r.tx0; complete && tx <= r.tx1; tx++)
+        {
+            zoom_tile_t *t = find_tile_locked(zv, r.l, tx, ty);
+            complete = t && t->state == TILE_READY;
+        }
+    }
+    if (!complete && zv->base)
+        draw_base(zv, layer, &oc, smooth);
+    if (!tiled)
+        return;
+
+    const zoom_level_t *lv = &zv->lv[r.l];
+    float kx = (float)zv->img_w / lv->w, ky = (float)zv->img_h / lv->h; // 原图像素 / 层像素
+    for (int ty = r.ty0; ty <= r.ty1; ty++)
+    {
+        int32_t y0 = (int32_t)lroundf(map_y(zv, ty * ZOOM_TILE * ky));
+        int ly1 = (ty + 1) * ZOOM_TILE < lv->h ? (ty + 1) * ZOOM_TILE : lv->h;
+        int32_t y1 = (int32_t)lroundf(map_y(zv, ly1 * ky));
+        for (int tx = r.tx0; tx <= r.tx1; tx++)
+        {
+            zoom_tile_t *t = find_tile_locked(zv, r.l, tx, ty);
+            if (!t || t->state != TILE_READY)
+                continue;
+            t->stamp = ++zv->clock;
+            int32_t x0 = (int32_t)lroundf(map_x(zv, tx * ZOOM_TILE * kx));
+            int lx1 = (tx + 1) * ZOOM_TILE < lv->w ? (tx + 1) * ZOOM_TILE : lv->w;
+            int32_t x1 = (int32_t)lroundf(map_x(zv, lx1 * kx));
+            if (x1 > x0 && y1 > y0)
+                draw_scaled(layer, &t->dsc, oc.x1 + x0, oc.y1 + y0, x1 - x0, y1 - y0, smooth);
+        }
+    }
+}
+
+// =========================== 手势 ============================
+
+static void view_changed(zoom_view_t *zv)
+{
+    clamp_view(zv);
+    lv_obj_invalidate(zv->obj);
+    xTaskNotifyGive(zv->task);
+}
+
+// 触点数变了（落下/抬起一根手指）就以当前位置重新起算，画面不跳
+static void track_touch(zoom_view_t *zv)
+{
+    lv_point_t pts[TOUCH_MULTI_MAX];
+    int n = touch_multi_get(pts);
+    if (n == 0)
+    {
+        // 没接管触摸驱动：只有 LVGL 的单点
+        lv_indev_t *indev = lv_indev_get_act();
+        if (!indev)
+            return;
+        lv_indev_get_point(indev, &pts[0]);
+        n = 1;
+    }
+    lv_area_t oc;
+    lv_obj_get_coords(zv->obj, &oc);
+    for (int i = 0; i < n; i++)
+    {
+        pts[i].x -= oc.x1;
+        pts[i].y -= oc.y1;
+    }
+
+    if (n >= 2)
+    {
+        float mx = (pts[0].x + pts[1].x) / 2.0f, my = (pts[0].y + pts[1].y) / 2.0f;
+        float d = hypotf((float)(pts[1].x - pts[0].x), (float)(pts[1].y - pts[0].y));
+        if (zv->touches != 2)
+        {
+            zv->touches = 2;
+            zv->d0 = d > 1.0f ? d : 1.0f;
+            zv->z0 = zv->z;
+            zv->ax = zv->cx + (mx - zv->vw / 2.0f) / zv->z;
+            zv->ay = zv->cy + (my - zv->vh / 2.0f) / zv->z;
+            return;
+        }
+        zv->z = zv->z0 * d / zv->d0;
+        if (zv->z > zv->z_max)
+            zv->z = zv->z_max;
+        if (zv->z < zv->z_fit)
+            zv->z = zv->z_fit;
+        zv->cx = zv->ax - (mx - zv->vw / 2.0f) / zv->z;
+        zv->cy = zv->ay - (my - zv->vh / 2.0f) / zv->z;
+        zv->moved = true;
+    }
+    else
+    {
+        if (zv->touches != 1)
+        {
+            zv->touches = 1;
+            zv->p0 = pts[0];
+            zv->cx0 = zv->cx;
+            zv->cy0 = zv->cy;
+            return;
+        }
+        int dx = pts[0].x - zv->p0.x, dy = pts[0].y - zv->p0.y;
+        if (!zv->moved && abs(dx) < ZOOM_TAP_SLOP && abs(dy) < ZOOM_TAP_SLOP)
+            return;
+        zv->moved = true;
+        zv->cx = zv->cx0 - dx / zv->z;
+        zv->cy = zv->cy0 - dy / zv->z;
+    }
+    view_changed(zv);
+}
+
+static void request_exit(zoom_view_t *zv)
+{
+    if (zv->exit_cb)
+        zv->exit_cb(zv->obj, zv->exit_user);
+    else
+        img_zoom_close(zv->obj);
+}
+
+static void zoom_event_cb(lv_event_t *e)
+{
+    zoom_view_t *zv = (zoom_view_t *)lv_event_get_user_data(e);
+    lv_event_code_t code = lv_event_get_code(e);
+
+    switch (code)
+    {
+    case LV_EVENT_DRAW_MAIN:
+        zoom_draw(zv, lv_event_get_layer(e));
+        break;
+
+    case LV_EVENT_PRESSED:
+        zv->touches = 0;
+        zv->moved = false;
+        break;
+
+    case LV_EVENT_PRESSING:
+        if (zv->path)
+            track_touch(zv);
+        break;
+
+    case LV_EVENT_RELEASED:
+    case LV_EVENT_PRESS_LOST:
+        zv->touches = 0;
+        if (!zv->path)
+            break;
+        lv_obj_invalidate(zv->obj); // 按平滑模式重画
+        if (zv->z <= zv->z_fit * ZOOM_EXIT_SLACK)
+            request_exit(zv);
+        break;
+
+    case LV_EVENT_CLICKED:
+    {
+        if (zv->moved || !zv->path)
+            break;
+        uint32_t now = lv_tick_get();
+        if (zv->last_tap && lv_tick_elaps(zv->last_tap) < ZOOM_DOUBLE_TAP_MS)
+        {
+            zv->last_tap = 0;
+            request_exit(zv);
+        }
+        else
+        {
+            zv->last_tap = now ? now : 1;
+        }
+        break;
+    }
+
+    case LV_EVENT_DELETE:
+        // LVGL 任务里、持显示锁：置 quit 后后台任务不会再碰对象
+        drop_image_locked(zv);
+        zv->obj = NULL;
+        zv->quit = true;
+        xTaskNotifyGive(zv->task);
+        break;
+
+    default:
+        break;
+    }
+}
+
+// =========================== 对外接口 ============================
+
+lv_obj_t *img_zoom_create(lv_obj_t *parent, int w, int h)
+{
+    zoom_view_t *zv = (zoom_view_t *)calloc(1, sizeof(zoom_view_t));
+    if (!zv)
+        return NULL;
+    zv->vw = w;
+    zv->vh = h;
+    zv->gen = 1;
+
+    lv_obj_t *obj = lv_obj_create(parent);
+    lv_obj_remove_style_all(obj);
+    lv_obj_set_size(obj, w, h);
+    lv_obj_align(obj, LV_ALIGN_CENTER, 0, 0);
+    lv_obj_set_style_bg_color(obj, lv_color_black(), 0);
+    lv_obj_set_style_bg_opa(obj, LV_OPA_COVER, 0);
+    lv_obj_add_flag(obj, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_HIDDEN);
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_SCROLLABLE | LV_OBJ_FLAG_GESTURE_BUBBLE);
+    zv->obj = obj;
+
+    if (xTaskCreatePinnedToCore(zoom_task, "img_zoom", ZOOM_TASK_STACK, zv, ZOOM_TASK_PRIO, &zv->task,
+                                tskNO_AFFINITY) != pdPASS)
+    {
+        ESP_LOGE(TAG, "create task failed");
+        lv_obj_del(obj);
+        free(zv);
+        return NULL;
+    }
+    lv_obj_set_user_data(obj, zv);
+    lv_obj_add_event_cb(obj, zoom_event_cb, LV_EVENT_ALL, zv);
+    return obj;
+}
+
+// 只读文件开头取尺寸：SOF 一般在前 4KB，带大 EXIF 缩略图的相机照片可能在几十 KB 之后
+static bool read_size(const char *path, int *w, int *h)
+{
+    static const size_t tries[] = {4 * 1024, 64 * 1024};
+    FILE *fp = fopen(path, "rb");
+    if (!fp)
+        return false;
+    bool ok = false;
+    for (size_t i = 0; i < sizeof(tries) / sizeof(tries[0]) && !ok; i++)
+    {
+        uint8_t *buf = (uint8_t *)malloc(tries[i]);
+        if (!buf)
+            break;
+        fseek(fp, 0, SEEK_SET);
+        size_t rd = fread(buf, 1, tries[i], fp);
+        ok = jpg_peek_size(buf, rd, w, h);
+        free(buf);
+        if (rd < tries[i])
+            break;
+    }
+    fclose(fp);
+    return ok;
+}
+
+bool img_zoom_open(lv_obj_t *zoom, const char *path, const lv_image_dsc_t *base)
+{
+    zoom_view_t *zv = zoom ? (zoom_view_t *)lv_obj_get_user_data(zoom) : NULL;
+    if (!zv || !path)
+        return false;
+
+    int w = 0, h = 0;
+    char *p = read_size(path, &w, &h) ? strdup(path) : NULL;
+    if (!p)
+    {
+        ESP_LOGW(TAG, "can't open %s", path);
+        return false;
+    }
+    drop_image_locked(zv);
+    zv->img_w = w;
+    zv->img_h = h;
+    if (!setup_levels(zv))
+    {
+        ESP_LOGW(TAG, "%s: %dx%d too large to zoom", path, w, h);
+        free(p);
+        return false;
+    }
+    zv->path = p;
+    zv->base = base;
+    zv->broken = false;
+    zv->decoded = zv->clip_passes = zv->block_passes = zv->failed = zv->max_ms = 0;
+
+    zv->z_fit = fminf(fminf((float)zv->vw / w, (float)zv->vh / h), 1.0f);
+    int finest = 0;
+    while (!zv->lv[finest].ok)
+        finest++;
+    zv->z_max = fmaxf(ZOOM_MAX_MAG * zv->lv[finest].w / w, zv->z_fit);
+    zv->z = zv->z_fit;
+    zv->cx = w / 2.0f;
+    zv->cy = h / 2.0f;
+    zv->touches = 0;
+    zv->moved = false;
+    zv->last_tap = 0;
+
+    ESP_LOGI(TAG, "open %s %dx%d, zoom %.3f..%.2f, finest level %d", path, w, h, zv->z_fit, zv->z_max, finest);
+    lv_obj_clear_flag(zoom, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_move_foreground(zoom);
+    view_changed(zv);
+    return true;
+}
+
+void img_zoom_zoom_at(lv_obj_t *zoom, float scale, const lv_point_t *p)
+{
+    zoom_view_t *zv = zoom ? (zoom_view_t *)lv_obj_get_user_data(zoom) : NULL;
+    if (!zv || !zv->path)
+        return;
+    float px = zv->vw / 2.0f, py = zv->vh / 2.0f;
+    if (p)
+    {
+        lv_area_t oc;
+        lv_obj_get_coords(zoom, &oc);
+        px = p->x - oc.x1;
+        py = p->y - oc.y1;
+    }
+    // p 下的原图点移到视口中心
+    zv->cx += (px - zv->vw / 2.0f) / zv->z;
+    zv->cy += (py - zv->vh / 2.0f) / zv->z;
+    zv->z = scale;
+    zv->touches = 0;
+    view_changed(zv);
+}
+
+void img_zoom_close(lv_obj_t *zoom)
+{
+    zoom_view_t *zv = zoom ? (zoom_view_t *)lv_obj_get_user_data(zoom) : NULL;
+    if (!zv || !zv->path)
+        return;
+    drop_image_locked(zv);
+    lv_obj_add_flag(zoom, LV_OBJ_FLAG_HIDDEN);
+    xTaskNotifyGive(zv->task); // 让后台任务把文件和大缓冲还回去
+}
+
+bool img_zoom_is_open(lv_obj_t *zoom)
+{
+    zoom_view_t *zv = zoom ? (zoom_view_t *)lv_obj_get_user_data(zoom) : NULL;
+    return zv && zv->path;
+}
+
+void img_zoom_set_exit_cb(lv_obj_t *zoom, img_zoom_exit_cb_t cb, void *user)
+{
+    zoom_view_t *zv = zoom ? (zoom_view_t *)lv_obj_get_user_data(zoom) : NULL;
+    if (!zv)
+        return;
+    zv->exit_cb = cb;
+    zv->exit_user = user;
+}
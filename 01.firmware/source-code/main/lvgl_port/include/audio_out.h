@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+// 音频输出环：
+//   解析端(avi_player 的 audio_cb) -> PSRAM PCM 环 -> 写入任务(高优先级) -> esp_codec_dev_write
+// 解析端只做一次拷贝，不再等 I2S DMA；写入任务按 DMA 块大小整块写 codec，
+// SD 卡或解码卡顿时靠环里的存量顶住。
+
+typedef struct
+{
+    size_t ring_size;             // PCM 环大小（字节），优先放 PSRAM
+    int dma_frames;               // 每次写 codec 的采样帧数，和 I2S 单个 DMA 描述符一致
+    int writer_core;              // 写入任务绑定的核
+    UBaseType_t writer_priority;  // 写入任务优先级，要高于 avi_player 和读文件任务
+    uint32_t writer_stack;        // 写入任务栈大小
+} audio_out_config_t;
+
+#define AUDIO_OUT_DEFAULT_CONFIG()  \
+    {                               \
+        .ring_size = 128 * 1024,    \
+        .dma_frames = 240,          \
+        .writer_core = 0,           \
+        .writer_priority = 10,      \
+        .writer_stack = 3 * 1024,   \
+    }
+
+typedef struct
+{
+    uint32_t queued;       // 环里还没写进 codec 的字节
+    uint32_t capacity;     // 当前格式下环的可用大小
+    uint32_t peak;         // 占用峰值
+    uint32_t block;        // 每次写 codec 的字节数
+    uint64_t written;      // 解析端写入的字节
+    uint64_t played;       // 已写进 codec 的字节（不含补的静音）
+    uint32_t underruns;    // 播放中环被取空的次数（flush 之后的不算）
+    uint32_t overruns;     // 环满、数据被丢弃的次数
+    uint32_t dropped;      // 环满丢弃的字节
+    uint32_t max_write_us; // 单块写 codec 的最长耗时
+} audio_out_stats_t;
+
+// 分配 PCM 环并启动写入任务，codec 需已初始化
+esp_err_t audio_out_start(const audio_out_config_t *cfg);
+
+// 停止写入任务并释放环，环里没播完的数据直接丢弃
+void audio_out_stop(void);
+
+// 等环里旧格式的数据播完，再按新格式重配 codec；没启动时直接配 codec
+esp_err_t audio_out_set_format(uint32_t rate, uint32_t bits, uint32_t ch);
+
+// 解析端：拷贝 PCM 入环。环满时最多等 timeout_ms，放不下的部分丢弃并计入 overrun。
+// 返回实际入环的字节数
+size_t audio_out_write(const void *data, size_t len, uint32_t timeout_ms);
+
+// 环里还没写进 codec 的字节数（不含已在 DMA 里的）
+size_t audio_out_queued(void);
+
+// 丢掉环里还没播的数据（跳转、切集时用），返回时写入任务不再引用旧数据
+void audio_out_flush(void);
+
+void audio_out_get_stats(audio_out_stats_t *st);
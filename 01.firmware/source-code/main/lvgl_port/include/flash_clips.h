@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_partition.h"
+
+// 播放列表里用这个前缀表示 clips 分区里的片段，例如 "flash:boot.avi"
+#define FLASH_CLIP_PREFIX "flash:"
+
+typedef struct
+{
+    const uint8_t *data; // 映射后的只读地址，直接交给 avi_player_play_from_memory
+    size_t size;
+    esp_partition_mmap_handle_t handle;
+} flash_clip_t;
+
+// 找到 clips 分区并读目录；没有分区或里面没有片段返回 ESP_ERR_NOT_FOUND
+esp_err_t flash_clips_init(void);
+
+int flash_clips_count(void);
+const char *flash_clips_name(int idx);
+
+// 按名字映射一个片段（不拷贝），用完必须 flash_clips_unmap
+esp_err_t flash_clips_map(const char *name, flash_clip_t *clip);
+void flash_clips_unmap(flash_clip_t *clip);
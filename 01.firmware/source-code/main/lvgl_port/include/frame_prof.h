@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "esp_err.h"
+#include "lvgl.h"
+
+// 帧耗时剖析：
+//   挂在 LVGL 显示事件、软件绘制单元和显示锁上，按刷新记下布局、各绘制单元渲染、flush_cb、等传输的时间，
+//   以及每个调用点持有显示锁的时间；视频路径自己上报解码和上屏。
+//   每项保留最近 FRAME_PROF_WINDOW 个样本的滚动直方图（1/4 倍频程一格），出分位数；
+//   可以在屏幕上叠一个小面板，也可以把完整报告打到串口或写文件。
+// 只统计真正画了东西的刷新；时间单位都是微秒。
+
+#ifndef FRAME_PROF_WINDOW
+#define FRAME_PROF_WINDOW 128 // 每项保留的样本数
+#endif
+
+#ifndef FRAME_PROF_OVERLAY_MS
+#define FRAME_PROF_OVERLAY_MS 500 // 面板刷新周期
+#endif
+
+#define FRAME_PROF_UNITS 4 // 最多统计的软件绘制单元数（LV_DRAW_SW_DRAW_UNIT_CNT）
+
+typedef enum
+{
+    FRAME_PROF_FRAME = 0,     // 一次刷新 REFR_START -> REFR_READY
+    FRAME_PROF_INTERVAL,      // 相邻两次刷新的间隔（帧节奏）
+    FRAME_PROF_LAYOUT,        // REFR_START -> RENDER_START：布局、合并脏区
+    FRAME_PROF_RENDER,        // RENDER_START -> RENDER_READY，去掉 flush_cb 和等传输
+    FRAME_PROF_UNIT0,         // 各软件绘制单元在这一帧里忙的时间
+    FRAME_PROF_FLUSH = FRAME_PROF_UNIT0 + FRAME_PROF_UNITS, // flush_cb 合计（字节交换、旋转、下发传输）
+    FRAME_PROF_FLUSH_WAIT,    // 等上一块传完的合计
+    FRAME_PROF_LOCK,          // 每次持有显示锁的时间
+    FRAME_PROF_LOCK_WAIT,     // 每次等显示锁的时间
+    FRAME_PROF_VIDEO_DECODE,  // 视频一帧解码（直出模式含送屏）
+    FRAME_PROF_VIDEO_PRESENT, // 视频相邻两帧上屏的间隔
+    FRAME_PROF_VIDEO_LATENCY, // 视频帧从入队到上屏
+    FRAME_PROF_METRICS,
+} frame_prof_metric_t;
+
+typedef struct
+{
+    uint32_t n;     // 窗口里的样本数
+    uint32_t total; // 清零以来的样本数
+    uint32_t last;
+    uint32_t mean;
+    uint32_t p50; // 分位数取所在直方图格的上沿
+    uint32_t p95;
+    uint32_t p99;
+    uint32_t max; // 窗口里的最大值
+} frame_prof_summary_t;
+
+// 挂上显示事件、绘制单元和显示锁的钩子（持显示锁调用）
+esp_err_t frame_prof_init(lv_display_t *disp);
+
+// 上报一个样本；任何任务都可调用
+void frame_prof_record(frame_prof_metric_t m, uint32_t us);
+
+// 记下一次事件，样本是离上一次的间隔；隔了 1 秒以上（暂停过）不算
+void frame_prof_tick(frame_prof_metric_t m);
+
+void frame_prof_get(frame_prof_metric_t m, frame_prof_summary_t *out);
+
+// 清空所有窗口、绘制类型和锁调用点统计（例如切到要看的页面之后）
+void frame_prof_reset(void);
+
+// 完整报告：各项分位数和直方图、各绘制类型耗时、各调用点持锁时间
+void frame_prof_dump(FILE *out);
+
+// 追加写到文件，例如 /sdcard/prof.txt
+esp_err_t frame_prof_dump_file(const char *path);
+
+// 屏幕面板（持显示锁调用）：点一下打印报告到串口，长按清零
+void frame_prof_overlay_show(bool show);
+bool frame_prof_overlay_visible(void);
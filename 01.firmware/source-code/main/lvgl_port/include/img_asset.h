@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "esp_err.h"
+#include "lvgl.h"
+
+// 构建时预转换好的图片（tools/asset_pack.py，清单见 assets.txt）：
+//   /spiffs/a.jpg 旁边的 /spiffs/a.bin（JPG_FILL）或 /spiffs/a.fit.bin（JPG_FIT）是 LVGL 原生格式，
+//   已按视口缩放、裁好，RGB565 或 RGB565A8，可带 LZ4 压缩。读出来就是最终像素，没有 JPEG 解码。
+
+typedef struct
+{
+    lv_image_header_t header; // flags 里已去掉压缩标志
+    uint32_t data_size;       // 像素字节数（解压后）
+    uint32_t packed_size;     // 文件里像素数据的字节数，未压缩时等于 data_size
+    bool lz4;
+    FILE *fp;
+} img_asset_t;
+
+// 打开 jpg_path 对应的 .bin（fit 时找 .fit.bin），读头并检查：必须正好是 w x h 的 RGB565/RGB565A8。
+// 没有 .bin 返回 ESP_ERR_NOT_FOUND；尺寸或格式对不上返回 ESP_ERR_INVALID_SIZE；
+// 压缩了但固件没开 LZ4 返回 ESP_ERR_NOT_SUPPORTED。失败时不用 close
+esp_err_t img_asset_open(const char *jpg_path, int w, int h, bool fit, img_asset_t *a);
+
+// 同上，直接给 .bin 的路径（运行时生成的缓存，如相册缩略图）
+esp_err_t img_asset_open_bin(const char *path, int w, int h, img_asset_t *a);
+
+// 把像素读到 dst（至少 data_size 字节），读完关闭文件。
+// scratch 放 LZ4 压缩数据（至少 packed_size 字节），传 NULL 时临时申请
+esp_err_t img_asset_read(img_asset_t *a, uint8_t *dst, uint8_t *scratch);
+
+// 不读了直接关闭；重复调用无害
+void img_asset_close(img_asset_t *a);
+
+// 把 RGB565/RGB565A8 图写成不压缩的 LVGL bin，之后能用 img_asset_open_bin 读回
+esp_err_t img_asset_write(const char *path, const lv_image_dsc_t *dsc);
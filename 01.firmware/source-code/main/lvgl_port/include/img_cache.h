@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "lvgl.h"
+
+// 解码后图片的共享缓存（PSRAM）：
+//   按 路径 + 视口宽高 + 处理方式 + 像素格式 查找，命中直接复用同一份像素，不再读文件和解码；
+//   每个 lv_image 对象持有一个引用，对象删除时归还；
+//   总字节超过预算时，从最久没用的、且没人引用的条目开始淘汰。
+// 页面每次滑动都会重建，背景和按钮图标第一次之后都走缓存。
+
+// 三张全屏背景（410x502 RGB565 各约 400KB）加一组 90x90 图标
+#define IMG_CACHE_DEFAULT_BUDGET (2 * 1024 * 1024)
+
+typedef struct
+{
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+    uint32_t entries; // 当前条目数
+    uint32_t pinned;  // 其中正被引用的条目数
+    size_t bytes;     // 当前占用（只算像素）
+    size_t budget;
+} img_cache_stats_t;
+
+// 建锁并设预算；不调用时缓存不生效，show_jpg_as_img 每次都解码
+esp_err_t img_cache_init(size_t budget);
+
+// 改预算，立即按新预算淘汰
+void img_cache_set_budget(size_t budget);
+
+// 查缓存：命中返回描述符并加一个引用，没命中返回 NULL（计一次 miss）。
+// variant 区分同一张图同样大小的不同处理方式（如 jpg_view_mode_t）；
+// cf 传 LV_COLOR_FORMAT_UNKNOWN 表示格式不限（预转换图可能是 RGB565A8）
+const lv_image_dsc_t *img_cache_get(const char *path, int w, int h, int variant, lv_color_format_t cf);
+
+// 为没命中的图新建条目：像素不清零，引用为 1，还不能被查到。
+// 调用者把像素（包括边框）全部写进 dsc->data 后 img_cache_commit；失败则直接 img_cache_release 丢掉
+lv_image_dsc_t *img_cache_create(const char *path, int w, int h, int variant, lv_color_format_t cf);
+
+// 把新条目放进缓存。期间别的任务已放入同一张图时，丢掉这份、返回已有的那份（引用转过去）
+const lv_image_dsc_t *img_cache_commit(lv_image_dsc_t *dsc);
+
+// 归还引用；没人引用的条目留在缓存里，等超预算时再淘汰
+void img_cache_release(const lv_image_dsc_t *dsc);
+
+// 丢掉所有没被引用的条目
+void img_cache_clear(void);
+
+void img_cache_get_stats(img_cache_stats_t *st);
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "lvgl.h"
+#include "ui.h"
+
+// 异步加载图片：
+//   image_load_async 立刻建好 lv_image（先显示占位），读文件/解码交给后台任务池，
+//   完成后在显示锁内换上像素；期间对象被删了就直接丢掉结果。
+// 页面切换动画不用等背景和图标解码完才开始。
+
+#define IMG_LOADER_DEFAULT_WORKERS 2 // 双核各一个
+
+typedef enum
+{
+    IMG_PLACEHOLDER_NONE = 0, // 透明，露出父对象的底色
+    IMG_PLACEHOLDER_SOLID,    // 纯色 opts.color
+    IMG_PLACEHOLDER_PREVIEW,  // 先解一张 1/8 大小的小图放大显示（模糊），再换成原图；多花一次小解码
+} img_placeholder_t;
+
+typedef struct
+{
+    jpg_view_mode_t mode;
+    img_placeholder_t placeholder;
+    lv_color_t color; // IMG_PLACEHOLDER_SOLID 的颜色
+    bool uncached;    // 不进共享缓存（只看一次的大图）
+} img_load_opts_t;
+
+#define IMG_LOAD_OPTS_DEFAULT()                    \
+    {                                              \
+        .mode = JPG_FILL,                          \
+        .placeholder = IMG_PLACEHOLDER_SOLID,      \
+        .color = LV_COLOR_MAKE(0x20, 0x20, 0x20),  \
+        .uncached = false,                         \
+    }
+
+// 加载结束时调用（在后台任务里、持有显示锁，可以直接操作 LVGL 对象）；
+// 对象已被删除时不调用。缓存命中时在 image_load_async 里直接调用
+typedef void (*img_load_cb_t)(lv_obj_t *img, bool ok, void *user);
+
+typedef struct
+{
+    uint32_t submitted;
+    uint32_t hits;    // 缓存命中，当场显示
+    uint32_t done;    // 后台加载成功
+    uint32_t failed;  // 读/解码失败
+    uint32_t dropped; // 完成前对象已删除
+    uint32_t max_ms;  // 提交到换上像素的最长耗时
+} img_loader_stats_t;
+
+// 建任务池；不调用时 image_load_async 退化为同步加载
+esp_err_t img_loader_init(int workers);
+
+// 在 parent 上建一个 w x h 的 lv_image 并返回，像素稍后到位。opts 为 NULL 用默认值。
+// 和 show_jpg_as_img 一样可以在 LVGL 任务里直接调用（内部会加显示锁）
+lv_obj_t *image_load_async(lv_obj_t *parent, const char *path, int w, int h, const img_load_opts_t *opts,
+                           img_load_cb_t cb, void *user);
+
+void img_loader_get_stats(img_loader_stats_t *st);
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "lvgl.h"
+
+// 大图缩放浏览：双指缩放、单指拖动，双击或捏回适应屏幕时退出。
+// 图按金字塔分层（原图、1/2、1/4、1/8），每层切成 ZOOM_TILE 见方的瓦片；
+// 后台任务只解当前视口里缺的瓦片（解码器 scale 到该层 + clipper 去掉右/下，超出预算时块模式流式解），
+// 放进固定数量的 LRU 瓦片缓存。绘制时只画可见瓦片，还没解出来的地方用相册的整屏图放大垫底。
+// 以下接口都在 LVGL 任务里（持显示锁）调用
+
+typedef void (*img_zoom_exit_cb_t)(lv_obj_t *zoom, void *user);
+
+// 建一个 w x h 的浏览对象（默认隐藏）；对象删除后后台任务自己收尾
+lv_obj_t *img_zoom_create(lv_obj_t *parent, int w, int h);
+
+// 打开 path 并显示，起始为适应屏幕。base 是相册正在显示的整图（JPG_FIT、w x h），
+// 缺瓦片时垫底，关闭前必须一直有效。图太大、哪一层都解不了时返回 false
+bool img_zoom_open(lv_obj_t *zoom, const char *path, const lv_image_dsc_t *base);
+
+// 把屏幕点 p 下的位置移到中心并缩放到 scale（屏幕像素 / 原图像素，1.0 即原图 1:1），超出范围会被夹住
+void img_zoom_zoom_at(lv_obj_t *zoom, float scale, const lv_point_t *p);
+
+// 隐藏并丢掉这张图的瓦片
+void img_zoom_close(lv_obj_t *zoom);
+
+bool img_zoom_is_open(lv_obj_t *zoom);
+
+// 用户捏回适应屏幕或双击时调用（一般在回调里 img_zoom_close）；不设就直接关闭
+void img_zoom_set_exit_cb(lv_obj_t *zoom, img_zoom_exit_cb_t cb, void *user);
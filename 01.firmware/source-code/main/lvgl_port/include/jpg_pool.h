@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "esp_jpeg_dec.h"
+
+// JPEG 解码上下文池：
+//   每个上下文带一个按配置复用的解码器句柄，以及只增不减的输入/输出/条带缓冲。
+//   建页面时连续解几张图不再反复 open/close、申请释放几百 KB 的临时块，PSRAM 不被切碎。
+// 池满时临时建一个（用完就释放），计入 overflow。
+
+// LVGL 任务 + 两个后台加载任务
+#define JPG_POOL_SIZE 3
+
+typedef struct
+{
+    uint32_t acquires;
+    uint32_t overflow;      // 池满时临时建的上下文
+    uint32_t dec_opens;     // jpeg_dec_open 次数
+    uint32_t dec_reuses;    // 配置相同、直接复用句柄的次数
+    uint32_t buf_grows;     // 缓冲不够大、重新申请的次数（热路径上的大块分配）
+    uint32_t buf_reuses;    // 缓冲够大、直接复用的次数
+    size_t pooled_bytes;    // 池里缓冲的总字节数（常驻）
+} jpg_pool_stats_t;
+
+typedef struct jpg_ctx jpg_ctx_t;
+
+// 取一个空闲上下文，不会阻塞；只有内存不够时返回 NULL
+jpg_ctx_t *jpg_pool_acquire(void);
+void jpg_pool_release(jpg_ctx_t *ctx);
+
+// 至少 len 字节的缓冲，内容不保留。in 放 PSRAM；out 16 字节对齐（解码器要求）；
+// strip 是块模式的条带，优先内部 RAM
+uint8_t *jpg_ctx_in(jpg_ctx_t *ctx, size_t len);
+uint8_t *jpg_ctx_out(jpg_ctx_t *ctx, size_t len);
+uint8_t *jpg_ctx_strip(jpg_ctx_t *ctx, size_t len);
+
+// 按 cfg 拿解码器：和上次配置相同就复用，否则重开
+jpeg_dec_handle_t jpg_ctx_decoder(jpg_ctx_t *ctx, const jpeg_dec_config_t *cfg);
+
+// 解码没走完（出错、块模式提前结束）时调用，下次重开句柄，不带着残留状态复用
+void jpg_ctx_reset_decoder(jpg_ctx_t *ctx);
+
+void jpg_pool_get_stats(jpg_pool_stats_t *st);
+
+// 释放空闲上下文里超过 keep 字节的缓冲（临时解过特别大的图之后调用，不让大块一直常驻）
+void jpg_pool_trim(size_t keep);
+
+// 打印池统计和 PSRAM 空闲/最大连续块，where 标明时机
+void jpg_pool_log_stats(const char *where);
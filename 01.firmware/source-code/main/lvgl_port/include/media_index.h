@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+// 媒体目录索引：
+//   每个目录的文件列表（文件名、大小、修改时间、图片宽高、视频时长/帧率）存成一个紧凑的二进制目录文件，
+//   放在同一文件系统的 /<挂载点>/INDEX 下。打开页面时读这一个文件就够，不再每次 readdir 两遍、
+//   逐个 fopen/stat；目录的 mtime 对不上才当场增量重扫（只探测新文件）。
+//   FAT 上加文件不一定更新目录 mtime，所以每次开机第一次用到某个目录时，后台任务再核对一遍，
+//   有变化就重写目录文件（本次打开的列表不变，下次生效）。
+// 已有文件名的条目不重新 stat：同名覆盖的文件要等目录 mtime 变了才会重新探测。
+
+#ifndef MEDIA_INDEX_DIRNAME
+#define MEDIA_INDEX_DIRNAME "INDEX"
+#endif
+
+typedef enum
+{
+    MEDIA_JPEG = 0, // .jpg/.jpeg，SOI 不对的不收
+    MEDIA_AVI,      // .avi
+} media_kind_t;
+
+typedef struct
+{
+    const char *name; // 文件名（不含目录）
+    uint32_t size;
+    uint32_t mtime;
+    uint16_t width, height; // 读不出来为 0
+    uint32_t duration_ms;   // 仅视频
+    uint16_t fps_x100;      // 仅视频，帧率 x100
+} media_entry_t;
+
+typedef struct
+{
+    uint32_t opens;
+    uint32_t catalog_hits; // 目录文件有效，直接用
+    uint32_t scans;        // 当场扫目录（没有目录文件或 mtime 变了）
+    uint32_t verifies;     // 后台核对
+    uint32_t changed;      // 核对发现有变化、重写了的
+    uint32_t probes;       // 逐个打开新文件读头
+    uint32_t writes;
+} media_index_stats_t;
+
+typedef struct media_index media_index_t;
+
+// 起后台核对任务；不调用也能用，只是不做开机核对
+esp_err_t media_index_init(void);
+
+// 打开目录的索引（目录不存在返回 ESP_ERR_NOT_FOUND）；没有匹配的文件时 count 为 0。
+// 得到的是快照，用 media_index_release 释放
+esp_err_t media_index_open(const char *dir, media_kind_t kind, media_index_t **out);
+void media_index_release(media_index_t *idx);
+
+int media_index_count(const media_index_t *idx);
+const media_entry_t *media_index_entry(const media_index_t *idx, int i);
+
+// 完整路径列表（每项和数组都用 free 释放），给原来用 char ** 列表的地方
+esp_err_t media_index_paths(const media_index_t *idx, char ***out_list, int *out_n);
+
+void media_index_get_stats(media_index_stats_t *st);
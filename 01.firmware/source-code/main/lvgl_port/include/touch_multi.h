@@ -0,0 +1,16 @@
+#pragma once
+
+#include "esp_err.h"
+#include "lvgl.h"
+
+// 多点触摸：esp_lvgl_port 只把第一个触点交给 LVGL，双指缩放需要第二个。
+// touch_multi_init 接管触摸的 read 回调：照旧把第一个点交给 LVGL，同时记下前两个点。
+
+#define TOUCH_MULTI_MAX 2
+
+// 在 bsp_display_start 之后调用一次
+esp_err_t touch_multi_init(void);
+
+// 最近一次读到的触点（屏幕坐标），返回个数 0..TOUCH_MULTI_MAX。
+// 只在 LVGL 任务里调用（事件回调里），和 read 回调同一个任务，不用加锁
+int touch_multi_get(lv_point_t pts[TOUCH_MULTI_MAX]);
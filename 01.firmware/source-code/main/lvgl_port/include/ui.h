@@ -1,15 +1,46 @@
 #ifndef UI_H_
 #define UI_H_
 
+#include "esp_err.h"
 #include "lvgl.h"
 
 void my_lv_start(void);
 
 void solid_test(void);
 
-lv_obj_t *show_jpg_as_img(lv_obj_t *parent, const char *jpg_path, int view_w, int view_h);
+// 比视口大的图怎么缩小（都不放大，小图居中留黑边）
+typedef enum
+{
+    JPG_FILL = 0, // 铺满视口，居中裁掉多出的部分
+    JPG_FIT,      // 整张放进视口，居中留黑边
+} jpg_view_mode_t;
+
+lv_obj_t *show_jpg_as_img(lv_obj_t *parent, const char *jpg_path, int view_w, int view_h, jpg_view_mode_t mode);
+// 不进图片缓存，用于只看一次的大图（相册）
+lv_obj_t *show_jpg_as_img_uncached(lv_obj_t *parent, const char *jpg_path, int view_w, int view_h,
+                                   jpg_view_mode_t mode);
+// 只解码不建对象（可在后台任务调用），得到的描述符用 lv_image_set_src 显示，不用了 jpg_image_free
+lv_img_dsc_t *jpg_image_load(const char *jpg_path, int view_w, int view_h, jpg_view_mode_t mode);
+void jpg_image_free(lv_img_dsc_t *dsc);
+// 只解 JPEG 到调用者的缓冲（view_w x view_h RGB565），自己管理像素内存时用（如缩略图）
+bool jpg_image_decode_to(const char *jpg_path, uint8_t *dst_pixels, int view_w, int view_h, jpg_view_mode_t mode);
+// 从文件开头的一段数据（到 SOF 为止）取图像尺寸，不打开解码器
+bool jpg_peek_size(const uint8_t *buf, size_t len, int *w, int *h);
+#if LVGL_VERSION_MAJOR >= 9
+// 走共享缓存的版本：成功时 *out 带一个引用，用 img_cache_release 归还；
+// 缓存不可用返回 ESP_ERR_NO_MEM（改用 jpg_image_load），读/解码失败返回 ESP_FAIL
+esp_err_t jpg_image_acquire(const char *jpg_path, int view_w, int view_h, jpg_view_mode_t mode,
+                            const lv_image_dsc_t **out);
+#endif
 
 lv_obj_t *photo_album_create(const char *dir, int canvas_w, int canvas_h, bool loop);
+// 同上，从第 start 张开始（序号和 photo_album_scan 的列表一致）
+lv_obj_t *photo_album_create_at(const char *dir, int canvas_w, int canvas_h, bool loop, int start);
+// 扫描目录（或单个 .jpg）得到图片路径列表，用 photo_album_free_list 释放
+esp_err_t photo_album_scan(const char *dir, char ***out_list, int *out_n);
+void photo_album_free_list(char **list, int n);
+// 缩略图网格，滚动到第 focus 张附近；点缩略图打开相册单张浏览
+lv_obj_t *photo_grid_create(const char *dir, int view_w, int view_h, int focus);
 
 lv_obj_t *page_lock_create(void);
 lv_obj_t *page_main_create(void);
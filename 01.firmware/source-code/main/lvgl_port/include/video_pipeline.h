@@ -0,0 +1,109 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "esp_lcd_types.h"
+#include "freertos/FreeRTOS.h"
+
+// MJPEG 预解码流水线：
+//   读取(avi_player 的 video_cb) -> 压缩帧队列(有界) -> 解码任务(core 1) -> RGB565 帧环 -> 显示(LVGL)
+// 读取端永不阻塞在解码上，队列满时直接丢帧；显示端取帧、用完归还。
+// 直出模式下解码任务跳过帧环和 LVGL，按块解码成条带直接送屏。
+
+typedef struct
+{
+    int comp_slots;               // 压缩帧队列深度
+    size_t comp_slot_size;        // 单个压缩槽初始大小（放不下时自动扩容）
+    int frame_slots;              // 解码帧环大小 N
+    int decoder_core;             // 解码任务绑定的核
+    UBaseType_t decoder_priority; // 解码任务优先级
+    uint32_t decoder_stack;       // 解码任务栈大小
+} video_pipeline_config_t;
+
+#define VIDEO_PIPELINE_DEFAULT_CONFIG() \
+    {                                   \
+        .comp_slots = 4,                \
+        .comp_slot_size = 48 * 1024,    \
+        .frame_slots = 3,               \
+        .decoder_core = 1,              \
+        .decoder_priority = 6,          \
+        .decoder_stack = 6 * 1024,      \
+    }
+
+// 一帧已解码的画面（显示端持有期间不会被解码任务改写）
+typedef struct
+{
+    uint8_t *buf;      // RGB565 像素，16 字节对齐
+    uint16_t w;
+    uint16_t h;
+    uint32_t seq;      // 压缩帧入队序号
+    int64_t arrive_us; // 压缩帧入队时间（esp_timer_get_time）
+    int idx;           // 帧环索引，归还时使用
+} video_frame_t;
+
+typedef struct
+{
+    uint32_t comp_queued;   // 压缩队列当前占用
+    uint32_t comp_depth;    // 压缩队列深度
+    uint32_t comp_peak;     // 压缩队列占用峰值
+    uint32_t frames_ready;  // 已解码待显示帧数
+    uint32_t frames_free;   // 空闲帧数
+    uint32_t frame_slots;   // 帧环大小
+    uint32_t pushed;        // 入队压缩帧总数
+    uint32_t pushed_ref;    // 其中不拷贝入队的帧数
+    uint32_t dropped_full;  // 队列满被丢弃的压缩帧
+    uint32_t decoded;       // 成功解码帧数
+    uint32_t decode_errors; // 解码失败帧数
+    uint32_t last_decode_us;
+    uint32_t max_decode_us;
+    uint32_t direct_frames;  // 直出模式送屏帧数
+    uint32_t last_direct_us; // 直出一帧的解码+送屏耗时
+} video_pipeline_stats_t;
+
+typedef struct
+{
+    esp_lcd_panel_handle_t panel;
+    esp_lcd_panel_io_handle_t io; // 用来挂传输完成回调，回收条带缓冲
+    int disp_w;                   // 画面在屏幕上居中
+    int disp_h;
+    int present_delay_ms;         // 和 LVGL 路径的呈现延时一致，切换前后音画同步不变
+} video_direct_config_t;
+
+// 创建队列与解码任务，帧环在 video_pipeline_set_frame_size 时分配
+esp_err_t video_pipeline_start(const video_pipeline_config_t *cfg);
+
+// 停止解码任务并释放全部缓冲；调用前显示端必须已不再引用任何帧
+void video_pipeline_stop(void);
+
+// 按新尺寸重建帧环并清空所有队列；调用方需保证显示端未持有帧（一般在显示锁内调用）
+esp_err_t video_pipeline_set_frame_size(int w, int h);
+
+// 读取端：拷贝一帧压缩数据入队，不阻塞；队列满返回 false
+bool video_pipeline_push(const uint8_t *data, size_t len);
+
+// 同上但不拷贝，只记下指针（例如映射的 flash）；数据在解码完之前必须一直有效，
+// 释放前先调用 video_pipeline_flush
+bool video_pipeline_push_ref(const uint8_t *data, size_t len);
+
+// 丢掉还没解码的压缩帧；返回后解码任务不再引用 push_ref 交进来的数据
+void video_pipeline_flush(void);
+
+// 显示端：取一帧已解码画面（不阻塞），用完后必须 video_pipeline_release
+bool video_pipeline_acquire(video_frame_t *out);
+void video_pipeline_release(const video_frame_t *frame);
+
+void video_pipeline_get_stats(video_pipeline_stats_t *st);
+
+// 进入直出模式：之后的帧不进帧环，由解码任务直接画到面板上。
+// 要求帧宽高是 8 的倍数且不超过屏幕，否则返回 ESP_ERR_NOT_SUPPORTED。
+// 调用方负责在此期间暂停 LVGL 刷屏（lvgl_port_stop），并先等 LVGL 在途的传输结束（bsp_display_take_panel）。
+esp_err_t video_pipeline_direct_enable(const video_direct_config_t *cfg);
+
+// 退出直出模式，返回前等在途的条带传完并摘掉完成回调，之后面板可以交还给 LVGL（bsp_display_give_panel）。
+// 会清空帧环里的旧帧，调用方需保证显示端未持有帧
+void video_pipeline_direct_disable(void);
+
+bool video_pipeline_direct_active(void);
@@ -0,0 +1,272 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+
+#include <stdlib.h>
+
+#include "jpg_pool.h"
+
+static const char *TAG = "jpg_pool";
+
+// 缓冲按块向上取整，相近尺寸的图共用同一块，不会每张都重新申请
+#define BUF_GRANULE (16 * 1024)
+#define STRIP_GRANULE 1024
+
+typedef struct
+{
+    uint8_t *p;
+    size_t cap;
+} pool_buf_t;
+
+struct jpg_ctx
+{
+    jpeg_dec_handle_t dec;
+    jpeg_dec_config_t cfg; // dec 打开时的配置
+    pool_buf_t in, out, strip;
+    bool pooled; // 属于池；否则是池满时临时建的
+    bool busy;
+};
+
+typedef struct
+{
+    SemaphoreHandle_t lock;
+    jpg_ctx_t ctx[JPG_POOL_SIZE];
+    jpg_pool_stats_t st;
+} jpg_pool_t;
+
+static jpg_pool_t s_pool = {0};
+static portMUX_TYPE s_pool_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// 池的锁懒创建：第一次解码可能早于任何初始化
+static void pool_lock(void)
+{
+    if (!s_pool.lock)
+    {
+        SemaphoreHandle_t m = xSemaphoreCreateMutex();
+        portENTER_CRITICAL(&s_pool_mux);
+        if (!s_pool.lock)
+        {
+            s_pool.lock = m;
+            m = NULL;
+        }
+        portEXIT_CRITICAL(&s_pool_mux);
+        if (m)
+            vSemaphoreDelete(m);
+    }
+    xSemaphoreTake(s_pool.lock, portMAX_DELAY);
+}
+
+static void pool_unlock(void)
+{
+    xSemaphoreGive(s_pool.lock);
+}
+
+static void buf_free(pool_buf_t *b, bool aligned)
+{
+    if (b->p)
+    {
+        if (aligned)
+            jpeg_free_align(b->p);
+        else
+            heap_caps_free(b->p);
+    }
+    b->p = NULL;
+    b->cap = 0;
+}
+
+static void ctx_free_all(jpg_ctx_t *c)
+{
+    jpg_ctx_reset_decoder(c);
+    buf_free(&c->in, false);
+    buf_free(&c->out, true);
+    buf_free(&c->strip, false);
+}
+
+jpg_ctx_t *jpg_pool_acquire(void)
+{
+    pool_lock();
+    s_pool.st.acquires++;
+    for (int i = 0; i < JPG_POOL_SIZE; i++)
+    {
+        jpg_ctx_t *c = &s_pool.ctx[i];
+        if (!c->busy)
+        {
+            c->busy = true;
+            c->pooled = true;
+            pool_unlock();
+            return c;
+        }
+    }
+    s_pool.st.overflow++;
+    pool_unlock();
+
+    jpg_ctx_t *c = (jpg_ctx_t *)calloc(1, sizeof(jpg_ctx_t));
+    if (c)
+        c->busy = true;
+    return c;
+}
+
+void jpg_pool_release(jpg_ctx_t *c)
+{
+    if (!c)
+        return;
+    if (!c->pooled)
+    {
+        ctx_free_all(c);
+        free(c);
+        return;
+    }
+    pool_lock();
+    c->busy = false;
+    pool_unlock();
+}
+
+// 缓冲够大就复用，不够就按 granule 取整重新申请（旧内容不保留）
+static uint8_t *buf_get(jpg_ctx_t *c, pool_buf_t *b, size_t len, size_t granule, bool aligned, uint32_t caps)
+{
+    if (b->p && b->cap >= len)
+    {
+        if (c->pooled)
+        {
+            pool_lock();
+            s_pool.st.buf_reuses++;
+            pool_unlock();
+        }
+        return b->p;
+    }
+
+    size_t old = b->cap;
+    buf_free(b, aligned);
+    size_t cap = (len + granule - 1) / granule * granule;
+    if (aligned)
+        b->p = (uint8_t *)jpeg_calloc_align(cap, 16);
+    else
+    {
+        // 条带会直接当 outbuf 交给解码器，esp_new_jpeg 要求 16 字节对齐；输入缓冲也一样对齐，分配路径只有一条
+        b->p = (uint8_t *)heap_caps_aligned_alloc(16, cap, caps);
+        if (!b->p)
+            b->p = (uint8_t *)heap_caps_aligned_alloc(16, cap, MALLOC_CAP_SPIRAM); // 内部 RAM 不够时退到 PSRAM
+    }
+    if (!b->p)
+    {
+        ESP_LOGW(TAG, "no mem for %u bytes", (unsigned)cap);
+        if (c->pooled)
+        {
+            pool_lock();
+            s_pool.st.pooled_bytes -= old;
+            pool_unlock();
+        }
+        return NULL;
+    }
+    b->cap = cap;
+
+    pool_lock();
+    s_pool.st.buf_grows++;
+    if (c->pooled)
+        s_pool.st.pooled_bytes += cap - old;
+    pool_unlock();
+    return b->p;
+}
+
+uint8_t *jpg_ctx_in(jpg_ctx_t *c, size_t len)
+{
+    return buf_get(c, &c->in, len, BUF_GRANULE, false, MALLOC_CAP_SPIRAM);
+}
+
+uint8_t *jpg_ctx_out(jpg_ctx_t *c, size_t len)
+{
+    return buf_get(c, &c->out, len, BUF_GRANULE, true, 0);
+}
+
+uint8_t *jpg_ctx_strip(jpg_ctx_t *c, size_t len)
+{
+    return buf_get(c, &c->strip, len, STRIP_GRANULE, false, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+}
+
+// 逐个字段比：结构体里的填充字节内容不确定，memcmp 会把同样的配置当成不同
+static bool cfg_equal(const jpeg_dec_config_t *a, const jpeg_dec_config_t *b)
+{
+    return a->output_type == b->output_type && a->scale.width == b->scale.width &&
+           a->scale.height == b->scale.height && a->clipper.width == b->clipper.width &&
+           a->clipper.height == b->clipper.height && a->rotate == b->rotate && a->block_enable == b->block_enable;
+}
+
+jpeg_dec_handle_t jpg_ctx_decoder(jpg_ctx_t *c, const jpeg_dec_config_t *cfg)
+{
+    if (c->dec && cfg_equal(&c->cfg, cfg))
+    {
+        pool_lock();
+        s_pool.st.dec_reuses++;
+        pool_unlock();
+        return c->dec;
+    }
+
+    jpg_ctx_reset_decoder(c);
+    c->cfg = *cfg;
+    if (jpeg_dec_open(&c->cfg, &c->dec) != JPEG_ERR_OK)
+    {
+        c->dec = NULL;
+        return NULL;
+    }
+    pool_lock();
+    s_pool.st.dec_opens++;
+    pool_unlock();
+    return c->dec;
+}
+
+void jpg_ctx_reset_decoder(jpg_ctx_t *c)
+{
+    if (c->dec)
+    {
+        jpeg_dec_close(c->dec);
+        c->dec = NULL;
+    }
+}
+
+void jpg_pool_trim(size_t keep)
+{
+    pool_lock();
+    size_t before = s_pool.st.pooled_bytes;
+    for (int i = 0; i < JPG_POOL_SIZE; i++)
+    {
+        jpg_ctx_t *c = &s_pool.ctx[i];
+        if (c->busy)
+            continue;
+        pool_buf_t *bufs[] = {&c->in, &c->out, &c->strip};
+        for (int k = 0; k < 3; k++)
+        {
+            if (bufs[k]->cap <= keep)
+                continue;
+            s_pool.st.pooled_bytes -= bufs[k]->cap;
+            buf_free(bufs[k], bufs[k] == &c->out);
+        }
+    }
+    size_t after = s_pool.st.pooled_bytes;
+    pool_unlock();
+    if (after != before)
+        ESP_LOGI(TAG, "trim: %u KB -> %u KB", (unsigned)(before / 1024), (unsigned)(after / 1024));
+}
+
+void jpg_pool_get_stats(jpg_pool_stats_t *st)
+{
+    if (!st)
+        return;
+    pool_lock();
+    *st = s_pool.st;
+    pool_unlock();
+}
+
+void jpg_pool_log_stats(const char *where)
+{
+    jpg_pool_stats_t st;
+    jpg_pool_get_stats(&st);
+    ESP_LOGI(TAG, "%s: %lu acquires (%lu overflow), dec open %lu / reuse %lu, buf grow %lu / reuse %lu, %u KB resident",
+             where ? where : "", (unsigned long)st.acquires, (unsigned long)st.overflow, (unsigned long)st.dec_opens,
+             (unsigned long)st.dec_reuses, (unsigned long)st.buf_grows, (unsigned long)st.buf_reuses,
+             (unsigned)(st.pooled_bytes / 1024));
+    ESP_LOGI(TAG, "%s: PSRAM free %u KB, largest block %u KB", where ? where : "",
+             (unsigned)(heap_caps_get_free_size(MALLOC_CAP_SPIRAM) / 1024),
+             (unsigned)(heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM) / 1024));
+}
@@ -1,5 +1,6 @@
 #include "lvgl.h"
 #include "ui.h"
+#include "img_loader.h"
 #include "esp_log.h"
 
 #include "bsp.h"
@@ -11,6 +12,9 @@
 
 static const char *TAG = "lock_page";
 
+// 背景和图标都异步加载，页面先出来；占位透明，露出页面/按钮本身的底色
+static const img_load_opts_t s_img_opts = {.mode = JPG_FILL, .placeholder = IMG_PLACEHOLDER_NONE};
+
 static lv_obj_t *s_lock_page = NULL;
 static lv_obj_t *s_time_label = NULL;
 
@@ -116,8 +120,8 @@ lv_obj_t *page_lock_create(void)
     lv_obj_set_style_bg_color(s_lock_page, lv_color_black(), 0);
     lv_obj_clear_flag(s_lock_page, LV_OBJ_FLAG_SCROLLABLE);
 
-    // 2) 背景图（show_jpg_on_canvas 内部会自己加锁）
-    lv_obj_t *img = show_jpg_as_img(s_lock_page, "/spiffs/4k1.jpg", BSP_LCD_H_RES, BSP_LCD_V_RES);
+    // 2) 背景图（后台加载，内部会自己加锁）
+    lv_obj_t *img = image_load_async(s_lock_page, "/spiffs/4k1.jpg", BSP_LCD_H_RES, BSP_LCD_V_RES, &s_img_opts, NULL, NULL);
 
     // 3) 时间与电量（这些是短操作，加锁-解锁快速包裹一下）
     bsp_display_lock(portMAX_DELAY);
@@ -1,5 +1,8 @@
 #include "lvgl.h"
 #include "ui.h"
+#include "img_loader.h"
+#include "img_cache.h"
+#include "jpg_pool.h"
 #include "esp_log.h"
 
 #include "bsp.h"
@@ -9,6 +12,9 @@
 
 static const char *TAG = "main_page";
 
+// 背景和图标都异步加载，页面先出来；占位透明，露出页面/按钮本身的底色
+static const img_load_opts_t s_img_opts = {.mode = JPG_FILL, .placeholder = IMG_PLACEHOLDER_NONE};
+
 static lv_obj_t *s_main_page = NULL;
 
 static void video_back_btn_cb(lv_event_t *e);
@@ -148,7 +154,7 @@ lv_obj_t *page_main_create(void)
 
     // 2) 背景图（用 lv_img 对象承载）
     const char *bg_path = "/spiffs/cute1.jpg";
-    lv_obj_t *bg_img = show_jpg_as_img(s_main_page, bg_path, BSP_LCD_H_RES, BSP_LCD_V_RES);
+    lv_obj_t *bg_img = image_load_async(s_main_page, bg_path, BSP_LCD_H_RES, BSP_LCD_V_RES, &s_img_opts, NULL, NULL);
     if (bg_img)
     {
         // 背景不吃事件，移到最底层
@@ -156,13 +162,6 @@ lv_obj_t *page_main_create(void)
         lv_obj_move_background(bg_img);
         lv_obj_align(bg_img, LV_ALIGN_CENTER, 0, 0);
 
-        // 把动态图片指针随对象保存，供销毁时释放
-#if LVGL_VERSION_MAJOR >= 9
-        lv_obj_set_user_data(bg_img, (void *)lv_image_get_src(bg_img));
-#else
-        lv_obj_set_user_data(bg_img, (void *)lv_img_get_src(bg_img));
-#endif
-
         // lv_obj_add_event_cb(bg_img, bg_img_delete_cb, LV_EVENT_DELETE, NULL);
     }
 
@@ -193,7 +192,7 @@ lv_obj_t *page_main_create(void)
     lv_obj_set_style_shadow_ofs_y(s_pic_button, 9, 0);
     lv_obj_set_style_clip_corner(s_pic_button, true, 0);
 
-    lv_obj_t *img_pic = show_jpg_as_img(s_pic_button, "/spiffs/btns/photo.jpg", ICON_W, ICON_H);
+    lv_obj_t *img_pic = image_load_async(s_pic_button, "/spiffs/btns/photo.jpg", ICON_W, ICON_H, &s_img_opts, NULL, NULL);
     if (img_pic)
     {
         lv_obj_center(img_pic);
@@ -215,7 +214,7 @@ lv_obj_t *page_main_create(void)
     lv_obj_set_style_shadow_ofs_y(s_video_button, 9, 0);
     lv_obj_set_style_clip_corner(s_video_button, true, 0);
 
-    lv_obj_t *img_video = show_jpg_as_img(s_video_button, "/spiffs/btns/video.jpg", ICON_W, ICON_H);
+    lv_obj_t *img_video = image_load_async(s_video_button, "/spiffs/btns/video.jpg", ICON_W, ICON_H, &s_img_opts, NULL, NULL);
     if (img_video)
     {
         lv_obj_center(img_video);
@@ -237,7 +236,7 @@ lv_obj_t *page_main_create(void)
     lv_obj_set_style_shadow_ofs_y(s_music_button, 9, 0);
     lv_obj_set_style_clip_corner(s_music_button, true, 0);
 
-    lv_obj_t *img_music = show_jpg_as_img(s_music_button, "/spiffs/btns/music.jpg", ICON_W, ICON_H);
+    lv_obj_t *img_music = image_load_async(s_music_button, "/spiffs/btns/music.jpg", ICON_W, ICON_H, &s_img_opts, NULL, NULL);
     if (img_music)
     {
         lv_obj_center(img_music);
@@ -256,6 +255,17 @@ lv_obj_t *page_main_create(void)
 
     lv_obj_add_event_cb(s_main_page, load_page_cb, LV_EVENT_ALL, NULL);
 
+    img_cache_stats_t cs;
+    img_cache_get_stats(&cs);
+    ESP_LOGI(TAG, "img cache: %lu hit / %lu miss, %u KB in %lu entries",
+             (unsigned long)cs.hits, (unsigned long)cs.misses, (unsigned)(cs.bytes / 1024), (unsigned long)cs.entries);
+    img_loader_stats_t ls;
+    img_loader_get_stats(&ls);
+    ESP_LOGI(TAG, "img loader: %lu submitted, %lu hit, %lu done, %lu failed, %lu dropped, max %lu ms",
+             (unsigned long)ls.submitted, (unsigned long)ls.hits, (unsigned long)ls.done, (unsigned long)ls.failed,
+             (unsigned long)ls.dropped, (unsigned long)ls.max_ms);
+    jpg_pool_log_stats("main page");
+
     return s_main_page;
 }
 
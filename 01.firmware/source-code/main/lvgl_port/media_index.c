@@ -0,0 +1,632 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_err.h"
+#include "esp_timer.h"
+
+#include <ctype.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "ui.h"
+#include "media_index.h"
+
+static const char *TAG = "media_index";
+
+#define INDEX_MAGIC 0x5844494Du // "MIDX"
+#define INDEX_VERSION 1
+#define INDEX_MAX_ENTRIES 20000 // 读目录文件时的合理性检查
+
+#define PROBE_HEAD (4 * 1024)  // SOF 一般在前 4KB
+#define PROBE_MAX (64 * 1024)  // 带大 EXIF 缩略图的相机照片
+#define AVI_HEAD 256           // RIFF/hdrl/avih 都在开头
+
+#define VERIFY_QUEUE_LEN 4
+#define VERIFY_TASK_PRIO 1 // 比相册预取(2)还低，纯属顺手的活
+#define VERIFY_TASK_STACK 6144
+#define VERIFIED_MAX 16 // 本次开机核对过的目录（按哈希记）
+
+// 目录文件：头 + 定长记录 + 以 0 结尾的文件名串
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint8_t kind;
+    uint8_t reserved;
+    uint32_t dir_mtime;
+    uint32_t count;
+    uint32_t names_size;
+    uint32_t checksum; // 记录和文件名的 FNV-1a
+} index_head_t;
+
+typedef struct
+{
+    uint32_t name_off;
+    uint32_t size;
+    uint32_t mtime;
+    uint16_t width, height;
+    uint32_t duration_ms;
+    uint16_t fps_x100;
+    uint16_t reserved;
+} index_rec_t;
+
+struct media_index
+{
+    media_kind_t kind;
+    uint32_t dir_mtime;
+    char *dir;
+    int count;
+    media_entry_t *entries;
+    index_rec_t *recs; // 和 entries 一一对应，写回目录文件用
+    char *names;
+    size_t names_size;
+};
+
+typedef struct
+{
+    char *dir;
+    media_kind_t kind;
+} verify_job_t;
+
+typedef struct
+{
+    QueueHandle_t queue;
+    SemaphoreHandle_t lock; // 保护 verified 和 st
+    uint32_t verified[VERIFIED_MAX];
+    int n_verified;
+    int next_verified; // 满了从最早的开始覆盖
+    media_index_stats_t st;
+} media_index_svc_t;
+
+static media_index_svc_t s_mi = {0};
+
+// 没初始化时没有锁，也就没有后台任务，只会在调用者的任务里计数
+static void stat_inc(uint32_t *field)
+{
+    if (s_mi.lock)
+        xSemaphoreTake(s_mi.lock, portMAX_DELAY);
+    (*field)++;
+    if (s_mi.lock)
+        xSemaphoreGive(s_mi.lock);
+}
+
+static uint32_t fnv1a(uint32_t h, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    for (size_t i = 0; i < len; i++)
+        h = (h ^ p[i]) * 16777619u;
+    return h;
+}
+
+static bool has_ext_icase(const char *name, const char *ext)
+{
+    const char *dot = strrchr(name, '.');
+    if (!dot)
+        return false;
+    while (*ext && *dot)
+    {
+        if (tolower((unsigned char)*dot++) != tolower((unsigned char)*ext++))
+            return false;
+    }
+    return *dot == '\0' && *ext == '\0';
+}
+
+static bool kind_match(media_kind_t kind, const char *name)
+{
+    if (name[0] == '.')
+        return false;
+    if (kind == MEDIA_AVI)
+        return has_ext_icase(name, ".avi");
+    return has_ext_icase(name, ".jpg") || has_ext_icase(name, ".jpeg");
+}
+
+// 目录文件放在同一文件系统的 /<挂载点>/INDEX 下，名字是目录和类型的哈希（FAT 没开长文件名也能用）
+static bool catalog_path(const char *dir, media_kind_t kind, char *out, size_t len)
+{
+    if (dir[0] != '/')
+        return false;
+    const char *slash = strchr(dir + 1, '/');
+    int root = slash ? (int)(slash - dir) : (int)strlen(dir);
+    uint32_t h = fnv1a(2166136261u, dir, strlen(dir));
+    h = fnv1a(h, &kind, sizeof(kind));
+    return snprintf(out, len, "%.*s/" MEDIA_INDEX_DIRNAME "/%08lX.IDX", root, dir, (unsigned long)h) < (int)len;
+}
+
+static uint32_t dir_key(const char *dir, media_kind_t kind)
+{
+    return fnv1a(fnv1a(2166136261u, dir, strlen(dir)), &kind, sizeof(kind));
+}
+
+// SPIFFS 没有真正的目录，stat 失败时当作 0：只靠后台核对发现变化
+static uint32_t dir_mtime(const char *dir)
+{
+    struct stat st;
+    return stat(dir, &st) == 0 ? (uint32_t)st.st_mtime : 0;
+}
+
+// =========================== 索引对象 ============================
+
+// recs/names 的所有权转给新对象
+static media_index_t *index_make(const char *dir, media_kind_t kind, uint32_t mtime, index_rec_t *recs, int count,
+                                 char *names, size_t names_size)
+{
+    media_index_t *idx = (media_index_t *)calloc(1, sizeof(media_index_t));
+    media_entry_t *entries = count ? (media_entry_t *)calloc((size_t)count, sizeof(media_entry_t)) : NULL;
+    char *d = strdup(dir);
+    if (!idx || (count && !entries) || !d)
+    {
+        free(idx);
+        free(entries);
+        free(d);
+        free(recs);
+        free(names);
+        return NULL;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        const index_rec_t *r = &recs[i];
+        media_entry_t *e = &entries[i];
+        e->name = names + r->name_off;
+        e->size = r->size;
+        e->mtime = r->mtime;
+        e->width = r->width;
+        e->height = r->height;
+        e->duration_ms = r->duration_ms;
+        e->fps_x100 = r->fps_x100;
+    }
+    idx->kind = kind;
+    idx->dir_mtime = mtime;
+    idx->dir = d;
+    idx->count = count;
+    idx->entries = entries;
+    idx->recs = recs;
+    idx->names = names;
+    idx->names_size = names_size;
+    return idx;
+}
+
+void media_index_release(media_index_t *idx)
+{
+    if (!idx)
+        return;
+    free(idx->entries);
+    free(idx->recs);
+    free(idx->names);
+    free(idx->dir);
+    free(idx);
+}
+
+int media_index_count(const media_index_t *idx)
+{
+    return idx ? idx->count : 0;
+}
+
+const media_entry_t *media_index_entry(const media_index_t *idx, int i)
+{
+    return idx && i >= 0 && i < idx->count ? &idx->entries[i] : NULL;
+}
+
+esp_err_t media_index_paths(const media_index_t *idx, char ***out_list, int *out_n)
+{
+    *out_list = NULL;
+    *out_n = 0;
+    if (!idx || idx->count == 0)
+        return ESP_OK;
+
+    char **list = (char **)calloc((size_t)idx->count, sizeof(char *));
+    if (!list)
+        return ESP_ERR_NO_MEM;
+    size_t dlen = strlen(idx->dir);
+    bool has_sep = dlen > 0 && (idx->dir[dlen - 1] == '/' || idx->dir[dlen - 1] == '\\');
+    for (int i = 0; i < idx->count; i++)
+    {
+        size_t need = dlen + (has_sep ? 0 : 1) + strlen(idx->entries[i].name) + 1;
+        list[i] = (char *)malloc(need);
+        if (!list[i])
+        {
+            for (int k = 0; k < i; k++)
+                free(list[k]);
+            free(list);
+            return ESP_ERR_NO_MEM;
+        }
+        snprintf(list[i], need, has_sep ? "%s%s" : "%s/%s", idx->dir, idx->entries[i].name);
+    }
+    *out_list = list;
+    *out_n = idx->count;
+    return ESP_OK;
+}
+
+// =========================== 目录文件 ============================
+
+static media_index_t *catalog_load(const char *path, const char *dir, media_kind_t kind)
+{
+    FILE *fp = fopen(path, "rb");
+    if (!fp)
+        return NULL;
+    index_head_t h;
+    index_rec_t *recs = NULL;
+    char *names = NULL;
+    bool ok = fread(&h, 1, sizeof(h), fp) == sizeof(h) && h.magic == INDEX_MAGIC && h.version == INDEX_VERSION &&
+              h.kind == kind && h.count <= INDEX_MAX_ENTRIES && h.names_size <= h.count * 256u;
+    if (ok && h.count)
+    {
+        recs = (index_rec_t *)malloc(h.count * sizeof(index_rec_t));
+        names = (char *)malloc(h.names_size);
+        ok = recs && names && fread(recs, sizeof(index_rec_t), h.count, fp) == h.count &&
+             fread(names, 1, h.names_size, fp) == h.names_size;
+    }
+    fclose(fp);
+
+    if (ok && h.count)
+    {
+        uint32_t sum = fnv1a(fnv1a(2166136261u, recs, h.count * sizeof(index_rec_t)), names, h.names_size);
+        ok = sum == h.checksum && h.names_size > 0 && names[h.names_size - 1] == '\0';
+        for (uint32_t i = 0; ok && i < h.count; i++)
+            ok = recs[i].name_off < h.names_size;
+    }
+    if (!ok)
+    {
+        ESP_LOGW(TAG, "%s: bad catalog, rescan", path);
+        free(recs);
+        free(names);
+        return NULL;
+    }
+    return index_make(dir, kind, h.dir_mtime, recs, (int)h.count, names, h.count ? h.names_size : 0);
+}
+
+// 先写临时文件再改名，写到一半掉电不会留下能通过校验的坏文件
+static void catalog_write(const char *path, const media_index_t *idx)
+{
+    char tmp[128];
+    if (snprintf(tmp, sizeof(tmp), "%s.tmp", path) >= (int)sizeof(tmp))
+        return;
+    char parent[128];
+    const char *slash = strrchr(path, '/');
+    if (slash && (size_t)(slash - path) < sizeof(parent))
+    {
+        memcpy(parent, path, (size_t)(slash - path));
+        parent[slash - path] = '\0';
+        mkdir(parent, 0775); // 已存在或 SPIFFS（没有目录）都会失败，不影响
+    }
+
+    index_head_t h = {
+        .magic = INDEX_MAGIC,
+        .version = INDEX_VERSION,
+        .kind = (uint8_t)idx->kind,
+        .dir_mtime = idx->dir_mtime,
+        .count = (uint32_t)idx->count,
+        .names_size = (uint32_t)idx->names_size,
+    };
+    h.checksum = fnv1a(fnv1a(2166136261u, idx->recs, idx->count * sizeof(index_rec_t)), idx->names,
+                       idx->names_size);
+
+    FILE *fp = fopen(tmp, "wb");
+    if (!fp)
+    {
+        ESP_LOGD(TAG, "can't write %s", tmp); // 只读的文件系统：每次当场扫
+        return;
+    }
+    bool ok = fwrite(&h, 1, sizeof(h), fp) == sizeof(h) &&
+              fwrite(idx->recs, sizeof(index_rec_t), (size_t)idx->count, fp) == (size_t)idx->count &&
+              fwrite(idx->names, 1, idx->names_size, fp) == idx->names_size;
+    ok = fclose(fp) == 0 && ok;
+    remove(path);
+    if (!ok || rename(tmp, path) != 0)
+    {
+        remove(tmp);
+        ESP_LOGW(TAG, "write %s failed", path);
+        return;
+    }
+    stat_inc(&s_mi.st.writes);
+}
+
+// =========================== 扫描 ============================
+
+static uint32_t rd32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// RIFF 'AVI ' -> LIST 'hdrl' -> 'avih'（MainAVIHeader：每帧微秒、总帧数、宽高）
+static void probe_avi(const uint8_t *b, size_t n, index_rec_t *r)
+{
+    if (n < 88 || memcmp(b, "RIFF", 4) || memcmp(b + 8, "AVI ", 4) || memcmp(b + 12, "LIST", 4) ||
+        memcmp(b + 20, "hdrl", 4) || memcmp(b + 24, "avih", 4))
+        return;
+    const uint8_t *avih = b + 32;
+    uint32_t us = rd32(avih + 0), frames = rd32(avih + 16);
+    r->width = (uint16_t)rd32(avih + 32);
+    r->height = (uint16_t)rd32(avih + 36);
+    if (us)
+    {
+        r->duration_ms = (uint32_t)((uint64_t)frames * us / 1000);
+        r->fps_x100 = (uint16_t)(100000000ull / us);
+    }
+}
+
+static bool full_path(const char *dir, const char *name, char *out, size_t len)
+{
+    size_t dlen = strlen(dir);
+    bool has_sep = dlen > 0 && dir[dlen - 1] == '/';
+    return snprintf(out, len, has_sep ? "%s%s" : "%s/%s", dir, name) < (int)len;
+}
+
+// 新文件才走这里：stat 取大小/时间，再读文件头。JPEG 的 SOI 不对返回 false（不收）
+static bool probe_file(const char *dir, const char *name, media_kind_t kind, index_rec_t *r)
+{
+    char full[256];
+    if (!full_path(dir, name, full, sizeof(full)))
+        return false;
+    stat_inc(&s_mi.st.probes);
+
+    struct stat st;
+    if (stat(full, &st) != 0 || S_ISDIR(st.st_mode))
+        return false;
+    r->size = (uint32_t)st.st_size;
+    r->mtime = (uint32_t)st.st_mtime;
+
+    FILE *fp = fopen(full, "rb");
+    if (!fp)
+        return false;
+    size_t cap = kind == MEDIA_AVI ? AVI_HEAD : PROBE_HEAD;
+    uint8_t *buf = (uint8_t *)malloc(PROBE_MAX);
+    size_t n = buf ? fread(buf, 1, cap, fp) : 0;
+    bool ok = true;
+    if (kind == MEDIA_AVI)
+    {
+        probe_avi(buf, n, r);
+    }
+    else if (n < 2 || buf[0] != 0xFF || buf[1] != 0xD8)
+    {
+        ESP_LOGW(TAG, "ignore non-jpeg: %s", full);
+        ok = false;
+    }
+    else
+    {
+        int w = 0, h = 0;
+        if (!jpg_peek_size(buf, n, &w, &h) && n == cap)
+        {
+            n += fread(buf + n, 1, PROBE_MAX - n, fp);
+            jpg_peek_size(buf, n, &w, &h);
+        }
+        r->width = (uint16_t)w;
+        r->height = (uint16_t)h;
+    }
+    free(buf);
+    fclose(fp);
+    return ok;
+}
+
+// 找旧索引里的同名条目：目录顺序一般不变，先看游标位置
+static const index_rec_t *find_old(const media_index_t *old, const char *name, int *cursor)
+{
+    if (!old)
+        return NULL;
+    for (int k = 0; k < old->count; k++)
+    {
+        int i = (*cursor + k) % old->count;
+        if (strcmp(old->entries[i].name, name) == 0)
+        {
+            *cursor = i + 1;
+            return &old->recs[i];
+        }
+    }
+    return NULL;
+}
+
+// 旧记录的大小和修改时间和文件还对得上。同名覆盖时 FAT 目录的修改时间不一定变，只看目录会漏掉
+static bool rec_current(const char *dir, const char *name, const index_rec_t *r)
+{
+    char full[256];
+    struct stat st;
+    return full_path(dir, name, full, sizeof(full)) && stat(full, &st) == 0 && (uint32_t)st.st_size == r->size &&
+           (uint32_t)st.st_mtime == r->mtime;
+}
+
+// 一遍 readdir；旧索引里有的直接沿用，新文件才打开探测。restat 时沿用前先 stat 一下，大小或时间变了就重新探测。
+// *changed 报告和旧索引是否不同
+static media_index_t *scan_dir(const char *dir, media_kind_t kind, uint32_t mtime, const media_index_t *old,
+                               bool restat, bool *changed)
+{
+    DIR *d = opendir(dir);
+    if (!d)
+        return NULL;
+
+    int count = 0, cap = 0, reused = 0, cursor = 0;
+    size_t names_size = 0, names_cap = 0;
+    index_rec_t *recs = NULL;
+    char *names = NULL;
+    bool ok = true;
+    struct dirent *ent;
+    while (ok && (ent = readdir(d)) != NULL)
+    {
+        if (ent->d_type == DT_DIR || !kind_match(kind, ent->d_name))
+            continue;
+
+        index_rec_t r = {0};
+        const index_rec_t *prev = find_old(old, ent->d_name, &cursor);
+        if (prev && restat && !rec_current(dir, ent->d_name, prev))
+            prev = NULL; // 按新文件处理，reused 少一个，索引就算变了
+        if (prev)
+        {
+            r = *prev;
+            reused++;
+        }
+        else if (!probe_file(dir, ent->d_name, kind, &r))
+        {
+            continue;
+        }
+
+        size_t len = strlen(ent->d_name) + 1;
+        if (count == cap)
+        {
+            cap = cap ? cap * 2 : 64;
+            index_rec_t *p = (index_rec_t *)realloc(recs, (size_t)cap * sizeof(index_rec_t));
+            ok = p != NULL;
+            if (p)
+                recs = p;
+        }
+        if (ok && names_size + len > names_cap)
+        {
+            names_cap = (names_size + len) * 2;
+            char *p = (char *)realloc(names, names_cap);
+            ok = p != NULL;
+            if (p)
+                names = p;
+        }
+        if (!ok)
+            break;
+        r.name_off = (uint32_t)names_size;
+        memcpy(names + names_size, ent->d_name, len);
+        names_size += len;
+        recs[count++] = r;
+    }
+    closedir(d);
+    if (!ok)
+    {
+        free(recs);
+        free(names);
+        return NULL;
+    }
+
+    *changed = !old || reused != old->count || count != old->count;
+    return index_make(dir, kind, mtime, recs, count, names, names_size);
+}
+
+// =========================== 后台核对 ============================
+
+// 本次开机没核对过就记下并返回 true
+static bool mark_verified(const char *dir, media_kind_t kind)
+{
+    uint32_t key = dir_key(dir, kind);
+    bool fresh = true;
+    if (s_mi.lock)
+        xSemaphoreTake(s_mi.lock, portMAX_DELAY);
+    for (int i = 0; i < s_mi.n_verified && fresh; i++)
+        fresh = s_mi.verified[i] != key;
+    if (fresh)
+    {
+        s_mi.verified[s_mi.next_verified] = key;
+        s_mi.next_verified = (s_mi.next_verified + 1) % VERIFIED_MAX;
+        if (s_mi.n_verified < VERIFIED_MAX)
+            s_mi.n_verified++;
+    }
+    if (s_mi.lock)
+        xSemaphoreGive(s_mi.lock);
+    return fresh;
+}
+
+static void verify(const char *dir, media_kind_t kind)
+{
+    char path[128];
+    if (!catalog_path(dir, kind, path, sizeof(path)))
+        return;
+    stat_inc(&s_mi.st.verifies);
+    int64_t t0 = esp_timer_get_time();
+    media_index_t *old = catalog_load(path, dir, kind);
+    bool changed = false;
+    media_index_t *idx = scan_dir(dir, kind, dir_mtime(dir), old, true, &changed);
+    if (idx && changed)
+    {
+        catalog_write(path, idx);
+        stat_inc(&s_mi.st.changed);
+        ESP_LOGI(TAG, "%s changed: %d -> %d files (%d ms)", dir, media_index_count(old), idx->count,
+                 (int)((esp_timer_get_time() - t0) / 1000));
+    }
+    media_index_release(idx);
+    media_index_release(old);
+}
+
+static void verify_task(void *arg)
+{
+    verify_job_t job;
+    for (;;)
+    {
+        if (xQueueReceive(s_mi.queue, &job, portMAX_DELAY) != pdTRUE)
+            continue;
+        verify(job.dir, job.kind);
+        free(job.dir);
+    }
+}
+
+esp_err_t media_index_init(void)
+{
+    if (s_mi.queue)
+        return ESP_OK;
+    s_mi.lock = xSemaphoreCreateMutex();
+    s_mi.queue = xQueueCreate(VERIFY_QUEUE_LEN, sizeof(verify_job_t));
+    if (!s_mi.lock || !s_mi.queue)
+        return ESP_ERR_NO_MEM;
+    if (xTaskCreatePinnedToCore(verify_task, "media_idx", VERIFY_TASK_STACK, NULL, VERIFY_TASK_PRIO, NULL,
+                                tskNO_AFFINITY) != pdPASS)
+    {
+        vQueueDelete(s_mi.queue);
+        s_mi.queue = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+// =========================== 对外接口 ============================
+
+esp_err_t media_index_open(const char *dir, media_kind_t kind, media_index_t **out)
+{
+    *out = NULL;
+    if (!dir)
+        return ESP_ERR_INVALID_ARG;
+    stat_inc(&s_mi.st.opens);
+    int64_t t0 = esp_timer_get_time();
+
+    char path[128];
+    bool have_path = catalog_path(dir, kind, path, sizeof(path));
+    uint32_t mtime = dir_mtime(dir);
+    media_index_t *old = have_path ? catalog_load(path, dir, kind) : NULL;
+
+    if (old && old->dir_mtime == mtime)
+    {
+        stat_inc(&s_mi.st.catalog_hits);
+        verify_job_t job = {.dir = NULL, .kind = kind};
+        if (s_mi.queue && mark_verified(dir, kind) && (job.dir = strdup(dir)) != NULL &&
+            xQueueSend(s_mi.queue, &job, 0) != pdTRUE)
+            free(job.dir); // 队列满：下次打开再说
+        ESP_LOGI(TAG, "%s: %d files from catalog in %d ms", dir, old->count,
+                 (int)((esp_timer_get_time() - t0) / 1000));
+        *out = old;
+        return ESP_OK;
+    }
+
+    // 没有目录文件或目录变了：当场扫。有旧索引时按名字沿用的记录也 stat 一下（和后台核对一样），
+    // 同名文件被替换也能重新探测，所以扫完就算核对过
+    stat_inc(&s_mi.st.scans);
+    bool changed = false;
+    media_index_t *idx = scan_dir(dir, kind, mtime, old, true, &changed);
+    if (!idx)
+    {
+        media_index_release(old);
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (have_path && (changed || !old || old->dir_mtime != mtime))
+        catalog_write(path, idx);
+    mark_verified(dir, kind);
+    ESP_LOGI(TAG, "%s: %d files scanned in %d ms (%d reused)", dir, idx->count,
+             (int)((esp_timer_get_time() - t0) / 1000), old ? old->count : 0);
+    media_index_release(old);
+    *out = idx;
+    return ESP_OK;
+}
+
+void media_index_get_stats(media_index_stats_t *st)
+{
+    if (!st)
+        return;
+    if (s_mi.lock)
+        xSemaphoreTake(s_mi.lock, portMAX_DELAY);
+    *st = s_mi.st;
+    if (s_mi.lock)
+        xSemaphoreGive(s_mi.lock);
+}
@@ -1,5 +1,6 @@
 #include "lvgl.h"
 #include "ui.h"
+#include "img_loader.h"
 #include "esp_log.h"
 
 #include "bsp.h"
@@ -11,6 +12,9 @@
 
 static const char *TAG = "page1";
 
+// 背景和图标都异步加载，页面先出来；占位透明，露出页面/按钮本身的底色
+static const img_load_opts_t s_img_opts = {.mode = JPG_FILL, .placeholder = IMG_PLACEHOLDER_NONE};
+
 static lv_obj_t *s_page1 = NULL;
 
 // static void video_back_btn_cb(lv_event_t *e);
@@ -162,7 +166,7 @@ lv_obj_t *page1_create(void)
 
     // 2) 背景图（用 lv_img 对象承载）
     const char *bg_path = "/spiffs/cute2.jpg";
-    lv_obj_t *bg_img = show_jpg_as_img(s_page1, bg_path, BSP_LCD_H_RES, BSP_LCD_V_RES);
+    lv_obj_t *bg_img = image_load_async(s_page1, bg_path, BSP_LCD_H_RES, BSP_LCD_V_RES, &s_img_opts, NULL, NULL);
     if (bg_img)
     {
         // 背景不吃事件，移到最底层
@@ -170,13 +174,6 @@ lv_obj_t *page1_create(void)
         lv_obj_move_background(bg_img);
         lv_obj_align(bg_img, LV_ALIGN_CENTER, 0, 0);
 
-        // 把动态图片指针随对象保存，供销毁时释放
-#if LVGL_VERSION_MAJOR >= 9
-        lv_obj_set_user_data(bg_img, (void *)lv_image_get_src(bg_img));
-#else
-        lv_obj_set_user_data(bg_img, (void *)lv_img_get_src(bg_img));
-#endif
-
         // lv_obj_add_event_cb(bg_img, bg_img_delete_cb, LV_EVENT_DELETE, NULL);
     }
 
@@ -207,7 +204,7 @@ lv_obj_t *page1_create(void)
     lv_obj_set_style_shadow_ofs_y(s_setting_button, 9, 0);
     lv_obj_set_style_clip_corner(s_setting_button, true, 0);
 
-    lv_obj_t *img_pic = show_jpg_as_img(s_setting_button, "/spiffs/btns/setting.jpg", ICON_W, ICON_H);
+    lv_obj_t *img_pic = image_load_async(s_setting_button, "/spiffs/btns/setting.jpg", ICON_W, ICON_H, &s_img_opts, NULL, NULL);
     if (img_pic)
     {
         lv_obj_center(img_pic);
@@ -229,7 +226,7 @@ lv_obj_t *page1_create(void)
     lv_obj_set_style_shadow_ofs_y(s_game1_button, 9, 0);
     lv_obj_set_style_clip_corner(s_game1_button, true, 0);
 
-    lv_obj_t *img_video = show_jpg_as_img(s_game1_button, "/spiffs/btns/game1.jpg", ICON_W, ICON_H);
+    lv_obj_t *img_video = image_load_async(s_game1_button, "/spiffs/btns/game1.jpg", ICON_W, ICON_H, &s_img_opts, NULL, NULL);
     if (img_video)
     {
         lv_obj_center(img_video);
@@ -251,7 +248,7 @@ lv_obj_t *page1_create(void)
     lv_obj_set_style_shadow_ofs_y(s_game2_button, 9, 0);
     lv_obj_set_style_clip_corner(s_game2_button, true, 0);
 
-    lv_obj_t *img_music = show_jpg_as_img(s_game2_button, "/spiffs/btns/music.jpg", ICON_W, ICON_H);
+    lv_obj_t *img_music = image_load_async(s_game2_button, "/spiffs/btns/music.jpg", ICON_W, ICON_H, &s_img_opts, NULL, NULL);
     if (img_music)
     {
         lv_obj_center(img_music);
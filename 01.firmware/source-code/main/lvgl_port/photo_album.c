@@ -4,12 +4,15 @@
 #include "esp_jpeg_dec.h"
 #include "esp_err.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
 
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <ctype.h>
-#include <dirent.h>
 #include <sys/stat.h>
 
 #include "bsp.h"
@@ -17,6 +20,9 @@
 #include "bsp/display.h"
 #include "bsp_board_extra.h" // 为了 bsp_display_lock/unlock
 #include "ui.h"              // 如果里头没有声明 page_*，下面有 extern
+#include "img_zoom.h"
+#include "touch_multi.h"
+#include "media_index.h"
 
 /* 如若 UI 头文件没声明这两个函数，请保留这两行 extern */
 extern lv_obj_t *page_lock_create(void);
@@ -26,7 +32,48 @@ extern lv_obj_t *page_main_create(void);
 #define ALBUM_LOG(fmt, ...) printf("[album] " fmt "\n", ##__VA_ARGS__)
 #define JPEG_ALIGN 16 // esp_jpeg 对齐
 
+// 前后各预解码几张（每张 cw x ch RGB565，410x502 约 400KB，放 PSRAM）
+#ifndef ALBUM_PREFETCH_RADIUS
+#define ALBUM_PREFETCH_RADIUS 1
+#endif
+#if ALBUM_PREFETCH_RADIUS < 1
+#error "ALBUM_PREFETCH_RADIUS must be at least 1"
+#endif
+// 窗口里最多 2R+1 张不同的图，槽位数与之相等就总有一个能腾出来
+#define ALBUM_PREFETCH_SLOTS (2 * ALBUM_PREFETCH_RADIUS + 1)
+#define ALBUM_PREFETCH_PRIO 2 // 低于 LVGL 任务(4)，只用它空闲的时间
+#define ALBUM_PREFETCH_STACK 8192
+
 // ========================== 内部状态/资源 =========================
+
+// 预取：后台任务把当前图前后 ALBUM_PREFETCH_RADIUS 张先解码进槽位，
+// 滑动时 LVGL 任务里只做一次 lv_image_set_src。
+// 这块状态单独分配：页面删除时不等正在进行的解码，由预取任务收尾后自己释放
+typedef struct
+{
+    int index;         // 图片序号，-1 表示空槽
+    lv_img_dsc_t *dsc; // 解码失败时为 NULL（也算“已处理”，不再重试）
+} album_slot_t;
+
+typedef struct
+{
+    SemaphoreHandle_t lock; // 保护以下所有字段
+    TaskHandle_t task;
+    album_slot_t slots[ALBUM_PREFETCH_SLOTS];
+
+    char *const *paths; // 借用相册的列表，页面删除时置 NULL
+    int count;
+    bool loop;
+    int cw, ch;
+
+    int center;                 // 当前显示的序号
+    int dir;                    // 最近一次滑动方向：+1 往后，-1 往前；同距离时先预取这一侧
+    const lv_img_dsc_t *shown;  // 正在显示的描述符，不能淘汰
+    bool quit;
+
+    uint32_t hits, misses, dropped; // dropped: 解码完已不在窗口里、直接丢掉的
+} album_prefetch_t;
+
 typedef struct
 {
     lv_obj_t *page;         // 相册页面（容器）
@@ -49,8 +96,14 @@ typedef struct
     bool pressed;
     lv_point_t p_down;
 
+    // 缩放浏览层：平时隐藏，双指捏开或长按时盖在图片上
+    lv_obj_t *zoom;
+    bool zoom_fwd; // 这次按压是在相册上开始的，后续事件转给缩放层
+
     // JPEG 解码器句柄（复用）
     jpeg_dec_handle_t j;
+
+    album_prefetch_t *pf;
 } album_ctx_t;
 
 static album_ctx_t s_ctx = {0};
@@ -99,8 +152,9 @@ static esp_err_t build_jpg_list(const char *path, char ***out_list, int *out_n)
     *out_list = NULL;
     *out_n = 0;
 
-    DIR *dir = opendir(path);
-    if (!dir)
+    // 目录走索引：不用每次 readdir 两遍、逐个打开查 SOI
+    media_index_t *mi = NULL;
+    if (media_index_open(path, MEDIA_JPEG, &mi) != ESP_OK)
     {
         // 支持单文件路径
         struct stat st;
@@ -124,89 +178,28 @@ static esp_err_t build_jpg_list(const char *path, char ***out_list, int *out_n)
         return ESP_FAIL;
     }
 
-    // 统计
-    int cnt = 0;
-    struct dirent *ent;
-    while ((ent = readdir(dir)) != NULL)
-    {
-        if (ent->d_name[0] == '.')
-            continue;
-        if (has_ext_icase(ent->d_name, ".jpg") || has_ext_icase(ent->d_name, ".jpeg"))
-            cnt++;
-    }
-    if (cnt == 0)
-    {
-        closedir(dir);
-        ALBUM_LOG("no jpg in %s", path);
-        return ESP_FAIL;
-    }
-
-    char **list = (char **)calloc((size_t)cnt, sizeof(char *));
-    if (!list)
-    {
-        closedir(dir);
-        return ESP_ERR_NO_MEM;
-    }
-
-    rewinddir(dir);
-    int idx = 0;
-    while ((ent = readdir(dir)) != NULL)
-    {
-        if (ent->d_name[0] == '.')
-            continue;
-        if (!(has_ext_icase(ent->d_name, ".jpg") || has_ext_icase(ent->d_name, ".jpeg")))
-            continue;
-
-        size_t dlen = strlen(path), flen = strlen(ent->d_name);
-        bool has_sep = (dlen > 0 && (path[dlen - 1] == '/' || path[dlen - 1] == '\\'));
-        size_t need = dlen + (has_sep ? 0 : 1) + flen + 1;
-
-        char *full = (char *)malloc(need);
-        if (!full)
-        {
-            closedir(dir);
-            free_list(list, idx);
-            return ESP_ERR_NO_MEM;
-        }
-
-        if (has_sep)
-            snprintf(full, need, "%s%s", path, ent->d_name);
-        else
-            snprintf(full, need, "%s/%s", path, ent->d_name);
-
-        // 快速 SOI 校验：不是 JPEG 就丢弃
-        FILE *fp = fopen(full, "rb");
-        bool ok = false;
-        if (fp)
-        {
-            unsigned char soi[2] = {0};
-            if (fread(soi, 1, 2, fp) == 2 && soi[0] == 0xFF && soi[1] == 0xD8)
-                ok = true;
-            fclose(fp);
-        }
-        if (!ok)
-        {
-            ESP_LOGW("album", "ignore non-jpeg: %s", full);
-            free(full);
-            continue;
-        }
-
-        list[idx++] = full;
-    }
-    closedir(dir);
-
-    if (idx == 0)
+    esp_err_t err = media_index_paths(mi, out_list, out_n);
+    media_index_release(mi);
+    if (err != ESP_OK)
+        return err;
+    if (*out_n == 0)
     {
-        free(list);
         ALBUM_LOG("no valid jpg in %s", path);
         return ESP_FAIL;
     }
-
-    *out_list = list;
-    *out_n = idx; // 用实际数量
     return ESP_OK;
 }
 
+esp_err_t photo_album_scan(const char *dir, char ***out_list, int *out_n)
+{
+    return build_jpg_list(dir, out_list, out_n);
+}
+
+void photo_album_free_list(char **list, int n)
+{
+    free_list(list, n);
+}
+
 // ========================== 画布/显示 ============================
 
 // 创建/复用 canvas（只在第一次创建）
@@ -235,97 +228,264 @@ static bool ensure_canvas(album_ctx_t *c)
     return true;
 }
 
-// 把一帧 RGB565 居中贴到 canvas（大图居中裁剪，小图留黑边）
-static void blit_center_rgb565(album_ctx_t *c, const uint8_t *rgb565, int img_w, int img_h)
+static void img_click_cb(lv_event_t *e)
 {
-    bsp_display_lock(portMAX_DELAY);
+    album_ctx_t *c = (album_ctx_t *)lv_event_get_user_data(e);
+    if (!c || !c->paths || c->count <= 0)
+        return;
 
-    // 清黑背景
-    memset(c->canvas_buf, 0, (size_t)c->cw * c->ch * sizeof(lv_color_t));
+    const char *path = c->paths[c->index];
+    ESP_LOGI("album", "clicked image: %s", path);
+    // 或者：printf("[album] clicked: %s\n", path);
+}
 
-    int copy_w = img_w, copy_h = img_h;
-    int src_x0 = 0, src_y0 = 0;
-    int dst_x0 = 0, dst_y0 = 0;
+// =========================== 预取 ============================
 
-    if (copy_w > c->cw)
+// 以下 *_locked 都在 pf->lock 内调用
+static int wrap_index_locked(const album_prefetch_t *pf, int i)
+{
+    if (pf->loop)
+        return ((i % pf->count) + pf->count) % pf->count;
+    return (i < 0 || i >= pf->count) ? -1 : i;
+}
+
+static bool in_window_locked(const album_prefetch_t *pf, int idx)
+{
+    int d = idx - pf->center;
+    if (pf->loop)
     {
-        src_x0 = (copy_w - c->cw) / 2;
-        copy_w = c->cw;
+        // 循环浏览时取近的一边
+        if (d > pf->count / 2)
+            d -= pf->count;
+        else if (d < -(pf->count / 2))
+            d += pf->count;
     }
-    else
+    return abs(d) <= ALBUM_PREFETCH_RADIUS;
+}
+
+static album_slot_t *find_slot_locked(album_prefetch_t *pf, int idx)
+{
+    for (int i = 0; i < ALBUM_PREFETCH_SLOTS; i++)
     {
-        dst_x0 = (c->cw - copy_w) / 2;
+        if (pf->slots[i].index == idx)
+            return &pf->slots[i];
     }
+    return NULL;
+}
 
-    if (copy_h > c->ch)
+// 放进空槽或窗口外的槽（旧图就地释放）；idx 不在任何槽里时总能放下
+static bool store_locked(album_prefetch_t *pf, int idx, lv_img_dsc_t *dsc)
+{
+    for (int i = 0; i < ALBUM_PREFETCH_SLOTS; i++)
     {
-        src_y0 = (copy_h - c->ch) / 2;
-        copy_h = c->ch;
+        album_slot_t *s = &pf->slots[i];
+        if (s->index >= 0 && (in_window_locked(pf, s->index) || (s->dsc && s->dsc == pf->shown)))
+            continue;
+        if (s->dsc)
+            jpg_image_free(s->dsc);
+        s->index = idx;
+        s->dsc = dsc;
+        return true;
     }
-    else
+    return false;
+}
+
+// 下一张要预取的：由近到远，同距离先滑动方向那一侧。
+// 当前这张不预取：没命中时 album_show 自己会当场解码
+static int next_job_locked(album_prefetch_t *pf)
+{
+    for (int k = 1; k <= ALBUM_PREFETCH_RADIUS; k++)
     {
-        dst_y0 = (c->ch - copy_h) / 2;
+        for (int side = 0; side < 2; side++)
+        {
+            int idx = wrap_index_locked(pf, pf->center + (side ? -pf->dir : pf->dir) * k);
+            if (idx >= 0 && !find_slot_locked(pf, idx))
+                return idx;
+        }
     }
+    return -1;
+}
+
+static void prefetch_task(void *arg)
+{
+    album_prefetch_t *pf = (album_prefetch_t *)arg;
 
-    for (int y = 0; y < copy_h; y++)
+    for (;;)
     {
-        const uint8_t *src_bytes = rgb565 + ((size_t)(src_y0 + y) * img_w + src_x0) * 2;
-        uint8_t *dst_bytes = (uint8_t *)(c->canvas_buf + ((size_t)(dst_y0 + y) * c->cw + dst_x0));
+        xSemaphoreTake(pf->lock, portMAX_DELAY);
+        bool quit = pf->quit;
+        int idx = quit ? -1 : next_job_locked(pf);
+        char *path = idx >= 0 ? strdup(pf->paths[idx]) : NULL;
+        xSemaphoreGive(pf->lock);
+        if (quit)
+            break;
+        if (!path)
+        {
+            // 窗口已满；换图或退出时会被通知
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        // 解码本身不能中途打断：方向变了的话，这张解完再按新窗口决定留不留
+        int64_t t0 = esp_timer_get_time();
+        lv_img_dsc_t *dsc = jpg_image_load(path, pf->cw, pf->ch, JPG_FIT);
+        int ms = (int)((esp_timer_get_time() - t0) / 1000);
+        if (!dsc)
+            ALBUM_LOG("prefetch %s fail", path);
+        free(path);
 
-#if LV_COLOR_16_SWAP
-        // 目标画布使用“交换后”的字节序：逐像素交换写入
-        for (int x = 0; x < copy_w; x++)
+        xSemaphoreTake(pf->lock, portMAX_DELAY);
+        if (!pf->quit && in_window_locked(pf, idx) && !find_slot_locked(pf, idx) && store_locked(pf, idx, dsc))
         {
-            uint8_t lo = src_bytes[2 * x + 0]; // LE: 低字节在前
-            uint8_t hi = src_bytes[2 * x + 1]; // LE: 高字节在后
-            // 画布需要 BE（或内存中交换后的序），把两个字节对调后写入
-            dst_bytes[2 * x + 0] = hi;
-            dst_bytes[2 * x + 1] = lo;
+            ESP_LOGD("album", "prefetched #%d in %d ms", idx, ms);
+            dsc = NULL;
         }
-#else
-        // 目标画布使用与解码相同的小端：直接搬
-        memcpy(dst_bytes, src_bytes, (size_t)copy_w * 2);
-#endif
+        else
+        {
+            pf->dropped++;
+        }
+        xSemaphoreGive(pf->lock);
+        if (dsc)
+            jpg_image_free(dsc);
     }
 
-    lv_obj_invalidate(c->canvas);
-    bsp_display_unlock();
+    ALBUM_LOG("prefetch exit: hit %u miss %u dropped %u", (unsigned)pf->hits, (unsigned)pf->misses,
+              (unsigned)pf->dropped);
+    for (int i = 0; i < ALBUM_PREFETCH_SLOTS; i++)
+    {
+        if (pf->slots[i].dsc)
+            jpg_image_free(pf->slots[i].dsc);
+    }
+    vSemaphoreDelete(pf->lock);
+    free(pf);
+    vTaskDelete(NULL);
 }
 
-static void img_click_cb(lv_event_t *e)
+static album_prefetch_t *prefetch_start(album_ctx_t *c)
 {
-    album_ctx_t *c = (album_ctx_t *)lv_event_get_user_data(e);
-    if (!c || !c->paths || c->count <= 0)
-        return;
+    album_prefetch_t *pf = (album_prefetch_t *)calloc(1, sizeof(album_prefetch_t));
+    if (!pf)
+        return NULL;
+    pf->lock = xSemaphoreCreateMutex();
+    if (!pf->lock)
+    {
+        free(pf);
+        return NULL;
+    }
+    for (int i = 0; i < ALBUM_PREFETCH_SLOTS; i++)
+        pf->slots[i].index = -1;
+    pf->paths = c->paths;
+    pf->count = c->count;
+    pf->loop = c->loop;
+    pf->cw = c->cw;
+    pf->ch = c->ch;
+    pf->center = c->index;
+    pf->dir = 1;
+
+    if (xTaskCreatePinnedToCore(prefetch_task, "album_pf", ALBUM_PREFETCH_STACK, pf, ALBUM_PREFETCH_PRIO,
+                                &pf->task, tskNO_AFFINITY) != pdPASS)
+    {
+        vSemaphoreDelete(pf->lock);
+        free(pf);
+        return NULL;
+    }
+    return pf;
+}
 
-    const char *path = c->paths[c->index];
-    ESP_LOGI("album", "clicked image: %s", path);
-    // 或者：printf("[album] clicked: %s\n", path);
+// 和相册脱钩：不再用 paths，任务解完手头这张后释放一切
+static void prefetch_stop(album_prefetch_t *pf)
+{
+    if (!pf)
+        return;
+    xSemaphoreTake(pf->lock, portMAX_DELAY);
+    pf->quit = true;
+    pf->paths = NULL;
+    xSemaphoreGive(pf->lock);
+    xTaskNotifyGive(pf->task);
 }
 
-// =========================== JPEG 加载 ============================
+// =========================== 图片切换 ============================
 
-static bool load_jpg(album_ctx_t *c, const char *path)
+// 显示第 index 张：预取好了只换描述符；还没好就当场解码（和以前一样会卡一下），也放进槽位
+static bool album_show(album_ctx_t *c, int index, int dir)
 {
-    // 删除旧的 img 对象
-    if (c->canvas)
-    {
-        lv_obj_del(c->canvas);
-        c->canvas = NULL;
+    album_prefetch_t *pf = c->pf;
+    const char *path = c->paths[index];
+    lv_img_dsc_t *dsc = NULL;
+    bool ready = false;
+    int64_t t0 = esp_timer_get_time();
+
+    if (pf)
+    {
+        xSemaphoreTake(pf->lock, portMAX_DELAY);
+        pf->center = index;
+        pf->dir = dir;
+        album_slot_t *s = find_slot_locked(pf, index);
+        if (s)
+        {
+            dsc = s->dsc;
+            pf->shown = dsc;
+            pf->hits++;
+            ready = true;
+        }
+        else
+        {
+            pf->misses++;
+        }
+        xSemaphoreGive(pf->lock);
     }
 
-    // 直接用 show_jpg_as_img 创建一个新的 lv_img 对象
-    lv_obj_t *img = show_jpg_as_img(c->page, path, c->cw, c->ch);
-    if (!img)
+    if (!ready)
     {
-        ALBUM_LOG("load_jpg: show_jpg_as_img(%s) fail", path);
-        return false;
+        dsc = jpg_image_load(path, c->cw, c->ch, JPG_FIT);
+        if (!dsc)
+            ALBUM_LOG("album_show: jpg_image_load(%s) fail", path);
+        if (pf)
+        {
+            xSemaphoreTake(pf->lock, portMAX_DELAY);
+            album_slot_t *s = find_slot_locked(pf, index);
+            if (s)
+            {
+                // 预取任务刚好同时解完了同一张，用它的
+                if (dsc)
+                    jpg_image_free(dsc);
+                dsc = s->dsc;
+            }
+            else if (!store_locked(pf, index, dsc))
+            {
+                ALBUM_LOG("album_show: no free slot"); // 按槽位数不会发生
+            }
+            pf->shown = dsc;
+            xSemaphoreGive(pf->lock);
+        }
     }
 
-    lv_obj_add_event_cb(img, img_click_cb, LV_EVENT_CLICKED, (void *)c);
+    // 旧描述符留在槽位里（现在是邻居），不在这里释放
+    lv_image_set_src(c->canvas, dsc);
+    if (pf)
+        xTaskNotifyGive(pf->task);
 
-    c->canvas = img; // 这里把 canvas 成员当成“当前显示的图片对象”保存
-    return true;
+    ESP_LOGI("album", "#%d %s %s in %d us", index, path, ready ? "prefetched" : "decoded",
+             (int)(esp_timer_get_time() - t0));
+    return dsc != NULL;
+}
+
+// =========================== 缩放 ============================
+
+// 底图用正在显示的描述符：预取槽位不会淘汰它，缩放期间也不换图
+static bool album_zoom_enter(album_ctx_t *c)
+{
+    if (!c->zoom || !c->paths || c->count <= 0 || img_zoom_is_open(c->zoom))
+        return false;
+    const lv_image_dsc_t *base = (const lv_image_dsc_t *)lv_image_get_src(c->canvas);
+    if (!base)
+        return false;
+    return img_zoom_open(c->zoom, c->paths[c->index], base);
+}
+
+static void zoom_exit_cb(lv_obj_t *zoom, void *user)
+{
+    img_zoom_close(zoom);
 }
 
 // =========================== 事件回调 ============================
@@ -341,6 +501,17 @@ static void album_event_cb(lv_event_t *e)
     lv_event_code_t code = lv_event_get_code(e);
     lv_indev_t *indev = lv_indev_get_act();
 
+    // 缩放层是在这次按压中途打开的：按压还记在页面上，松手前的事件转过去，不当滑动/点击
+    if (c->zoom_fwd && (code == LV_EVENT_PRESSING || code == LV_EVENT_RELEASED || code == LV_EVENT_PRESS_LOST))
+    {
+        gesture_detected = true;
+        if (code != LV_EVENT_PRESSING)
+            c->zoom_fwd = false;
+        if (img_zoom_is_open(c->zoom))
+            lv_obj_send_event(c->zoom, code, NULL);
+        return;
+    }
+
     switch (code)
     {
 
@@ -354,6 +525,33 @@ static void album_event_cb(lv_event_t *e)
         break;
     }
 
+    case LV_EVENT_PRESSING:
+    {
+        // 第二根手指落下：从适应屏幕开始双指缩放
+        lv_point_t pts[TOUCH_MULTI_MAX];
+        if (touch_multi_get(pts) >= 2 && album_zoom_enter(c))
+        {
+            c->zoom_fwd = true;
+            gesture_detected = true;
+            lv_obj_send_event(c->zoom, LV_EVENT_PRESSING, NULL);
+        }
+        break;
+    }
+
+    case LV_EVENT_LONG_PRESSED:
+    {
+        // 长按：在按住的地方放大到原图 1:1，不用双指也能看细节
+        if (indev && album_zoom_enter(c))
+        {
+            lv_point_t p;
+            lv_indev_get_point(indev, &p);
+            img_zoom_zoom_at(c->zoom, 1.0f, &p);
+            c->zoom_fwd = true;
+            gesture_detected = true;
+        }
+        break;
+    }
+
     case LV_EVENT_RELEASED:
     {
         if (!indev)
@@ -412,7 +610,7 @@ static void album_event_cb(lv_event_t *e)
             if (next != c->index)
             {
                 c->index = next;
-                (void)load_jpg(c, c->paths[c->index]);
+                (void)album_show(c, c->index, dx > 0 ? -1 : 1);
             }
         }
         else
@@ -437,17 +635,29 @@ static void album_event_cb(lv_event_t *e)
     }
 
     case LV_EVENT_CLICKED:
+    {
         if (gesture_detected)
             break; // 刚识别为滑动则不当点击
         ESP_LOGI("btn", "点击事件");
 
-        album_ctx_t *c = (album_ctx_t *)lv_event_get_user_data(e);
-        if (!c || !c->paths || c->count <= 0)
+        if (!c->paths || c->count <= 0)
             return;
 
+        // 点图片回到缩略图网格，停在当前这张附近
         const char *path = c->paths[c->index];
         ESP_LOGI("album", "clicked image: %s", path);
+        char dir[256];
+        const char *slash = strrchr(path, '/');
+        size_t n = slash ? (size_t)(slash - path) : 0;
+        if (n == 0 || n >= sizeof(dir))
+            break;
+        memcpy(dir, path, n);
+        dir[n] = '\0';
+        lv_obj_t *new_scr = photo_grid_create(dir, c->cw, c->ch, c->index);
+        if (new_scr)
+            lv_scr_load_anim(new_scr, LV_SCR_LOAD_ANIM_FADE_IN, 50, 0, true);
         break;
+    }
 
     default:
         break;
@@ -458,6 +668,11 @@ static void album_event_cb(lv_event_t *e)
 
 // 创建相册页面（dir 可为目录或单文件 .jpg/.jpeg）
 lv_obj_t *photo_album_create(const char *dir, int canvas_w, int canvas_h, bool loop)
+{
+    return photo_album_create_at(dir, canvas_w, canvas_h, loop, 0);
+}
+
+lv_obj_t *photo_album_create_at(const char *dir, int canvas_w, int canvas_h, bool loop, int start)
 {
     album_ctx_t *c = &s_ctx;
 
@@ -483,6 +698,8 @@ lv_obj_t *photo_album_create(const char *dir, int canvas_w, int canvas_h, bool l
         c->decode_buf = NULL;
         c->decode_cap = 0;
     }
+    prefetch_stop(c->pf); // 先停预取，它借用着 paths
+    c->pf = NULL;
     if (c->paths)
     {
         free_list(c->paths, c->count);
@@ -505,20 +722,41 @@ lv_obj_t *photo_album_create(const char *dir, int canvas_w, int canvas_h, bool l
         return NULL;
     }
 
-    c->index = 0;
+    c->index = (start >= 0 && start < c->count) ? start : 0;
 
     // 页面容器
     c->page = lv_obj_create(NULL);
     lv_obj_set_size(c->page, canvas_w, canvas_h);
     lv_obj_set_style_bg_opa(c->page, LV_OPA_COVER, 0);
     lv_obj_clear_flag(c->page, LV_OBJ_FLAG_SCROLLABLE);
+    // 屏幕默认不锁按压：双指时缩放层在手指下打开，LVGL 会把按压转给它并给页面发 PRESS_LOST，
+    // 转发过去缩放层当成松手、当场退出。锁住后这次按压一直记在页面上，由 zoom_fwd 转发
+    lv_obj_add_flag(c->page, LV_OBJ_FLAG_PRESS_LOCK);
 
     // 事件绑定
     lv_obj_add_event_cb(c->page, album_event_cb, LV_EVENT_ALL, NULL);
     lv_obj_add_event_cb(c->page, album_page_delete_cb, LV_EVENT_DELETE, NULL);
 
+    // 显示用的图片对象只建一次，之后换图只换描述符（canvas 成员存的就是它）
+    c->canvas = lv_image_create(c->page);
+    lv_obj_align(c->canvas, LV_ALIGN_CENTER, 0, 0);
+    lv_obj_add_event_cb(c->canvas, img_click_cb, LV_EVENT_CLICKED, (void *)c);
+
+    // 缩放层建不出来就不能缩放，其它照常
+    c->zoom = img_zoom_create(c->page, canvas_w, canvas_h);
+    c->zoom_fwd = false;
+    if (c->zoom)
+        img_zoom_set_exit_cb(c->zoom, zoom_exit_cb, c);
+    else
+        ALBUM_LOG("zoom disabled");
+
+    // 预取任务起不来也能用，只是每次滑动都当场解码
+    c->pf = prefetch_start(c);
+    if (!c->pf)
+        ALBUM_LOG("prefetch disabled");
+
     // 首张
-    (void)load_jpg(c, c->paths[c->index]);
+    (void)album_show(c, c->index, 1);
 
     return c->page;
 }
@@ -549,6 +787,8 @@ void photo_album_destroy(void)
         c->decode_buf = NULL;
         c->decode_cap = 0;
     }
+    prefetch_stop(c->pf); // 先停预取，它借用着 paths
+    c->pf = NULL;
     if (c->paths)
     {
         free_list(c->paths, c->count);
@@ -578,6 +818,8 @@ static void album_free_resources_only(void)
         c->decode_buf = NULL;
         c->decode_cap = 0;
     }
+    prefetch_stop(c->pf); // 先停预取，它借用着 paths
+    c->pf = NULL;
     if (c->paths)
     {
         free_list(c->paths, c->count);
@@ -601,5 +843,7 @@ static void album_page_delete_cb(lv_event_t *e)
     album_free_resources_only();
 
     s_ctx.canvas = NULL;
+    s_ctx.zoom = NULL;
+    s_ctx.zoom_fwd = false;
     s_ctx.page = NULL;
 }
\ No newline at end of file
@@ -0,0 +1,534 @@
+// photo_grid.c — 相册缩略图网格
+
+#include "lvgl.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <sys/stat.h>
+
+#include "bsp/esp-bsp.h"
+#include "bsp_board_extra.h" // 为了 bsp_display_lock/unlock
+#include "ui.h"
+#include "img_asset.h"
+
+// 几千张的目录也只建“视口附近几行”的格子：滚出去的格子挪到另一头换图再用，
+// 缩略图由后台任务按视口由近到远解码（解码器直接缩到 1/8 附近），放进固定大小的 LRU；
+// 有 SD 卡时同时写成 LVGL bin，下次打开直接读，不再解码。
+
+// ============================= 配置项 =============================
+#define GRID_LOG(fmt, ...) printf("[grid] " fmt "\n", ##__VA_ARGS__)
+
+#ifndef GRID_COLS
+#define GRID_COLS 3
+#endif
+#define GRID_GAP 4 // 格子之间的缝
+
+// 视口上下各多备几行格子，新露出来的行在滚到之前就开始解码
+#ifndef GRID_OVERSCAN_ROWS
+#define GRID_OVERSCAN_ROWS 1
+#endif
+
+// PSRAM 里最多留多少张缩略图（每张 tile x tile RGB565，3 列 410 宽时约 35KB）。
+// 必须比格子数多，否则新窗口里的图没地方放
+#ifndef GRID_TILE_CACHE
+#define GRID_TILE_CACHE 48
+#endif
+
+// 缩略图磁盘缓存目录；建不了（没插卡、只有 SPIFFS）就只用 PSRAM。FAT 没开长文件名也能用的 8.3 名字
+#ifndef GRID_THUMB_DIR
+#define GRID_THUMB_DIR "/sdcard/THUMBS"
+#endif
+
+#define GRID_TASK_PRIO 2 // 和相册预取一样，只用 LVGL 任务空闲的时间
+#define GRID_TASK_STACK 8192
+
+// ========================== 内部状态/资源 =========================
+
+typedef struct
+{
+    int index;         // 图片序号，-1 表示空
+    bool loading;      // 后台任务正在写 buf，不能显示也不能淘汰
+    bool failed;       // 解码失败，留着占位免得反复重试
+    uint16_t pins;     // 正在显示它的格子数，>0 不能淘汰
+    uint32_t stamp;    // 最近一次被显示的时间，LRU 用
+    lv_image_dsc_t dsc; // data 指向 buf
+    uint8_t *buf;      // 第一次用时分配，之后换图复用
+} grid_tile_t;
+
+typedef struct
+{
+    lv_obj_t *img;
+    int index;         // 当前对应的序号，-1 表示空闲（隐藏）
+    grid_tile_t *tile; // 已换上的缩略图，pins 里算着它
+} grid_cell_t;
+
+// 页面删除时不等正在进行的解码：只置 quit，由后台任务收尾后释放整块状态。
+// 锁顺序：显示锁在外，g->lock 在内
+typedef struct
+{
+    SemaphoreHandle_t lock; // 保护 tiles、窗口、quit、统计
+    TaskHandle_t task;
+
+    char *dir;
+    char **paths;
+    int count;
+    int view_w, view_h;
+    int cell;  // 格子边长（含缝）
+    int tile;  // 缩略图边长
+    int x0;    // 整行居中后的左边距
+    int rows;
+
+    lv_obj_t *page;
+    grid_cell_t *cells; // 只在持显示锁时改
+    int ncells;
+
+    int first, last;         // 窗口（含预备行）里的序号范围，后台按它找活
+    int vis_first, vis_last; // 其中真正看得见的
+    bool quit;
+    bool disk;
+    uint32_t clock;
+
+    grid_tile_t tiles[GRID_TILE_CACHE];
+    uint32_t hits, disk_hits, decoded, failed;
+} photo_grid_t;
+
+// =========================== 缩略图缓存 ============================
+
+// 以下 *_locked 都在 g->lock 内调用
+static grid_tile_t *find_tile_locked(photo_grid_t *g, int idx)
+{
+    for (int i = 0; i < GRID_TILE_CACHE; i++)
+    {
+        if (g->tiles[i].index == idx)
+            return &g->tiles[i];
+    }
+    return NULL;
+}
+
+static bool in_window_locked(const photo_grid_t *g, int idx)
+{
+    return idx >= g->first && idx <= g->last;
+}
+
+// 空的优先，否则淘汰窗口外最久没显示的；正在显示/正在解码的不动
+static grid_tile_t *victim_locked(photo_grid_t *g)
+{
+    grid_tile_t *best = NULL;
+    for (int i = 0; i < GRID_TILE_CACHE; i++)
+    {
+        grid_tile_t *t = &g->tiles[i];
+        if (t->loading || t->pins)
+            continue;
+        if (t->index < 0)
+            return t;
+        if (in_window_locked(g, t->index))
+            continue; // 刚解完又被挤掉会来回抖
+        if (!best || t->stamp < best->stamp)
+            best = t;
+    }
+    return best;
+}
+
+// 下一张要解的：先看得见的，再由近到远的预备行
+static int next_job_locked(photo_grid_t *g)
+{
+    for (int i = g->vis_first; i <= g->vis_last; i++)
+    {
+        if (!find_tile_locked(g, i))
+            return i;
+    }
+    for (int k = 1; g->vis_last + k <= g->last || g->vis_first - k >= g->first; k++)
+    {
+        int below = g->vis_last + k, above = g->vis_first - k;
+        if (below <= g->last && !find_tile_locked(g, below))
+            return below;
+        if (above >= g->first && !find_tile_locked(g, above))
+            return above;
+    }
+    return -1;
+}
+
+// 格子位置（相对页面内容）
+static void cell_pos(const photo_grid_t *g, int idx, int *x, int *y)
+{
+    *x = g->x0 + (idx % GRID_COLS) * g->cell + GRID_GAP / 2;
+    *y = (idx / GRID_COLS) * g->cell + GRID_GAP / 2;
+}
+
+// 持显示锁和 g->lock：缩略图刚解好，它的格子还在显示这张就换上
+static void show_tile_locked(photo_grid_t *g, grid_tile_t *t)
+{
+    grid_cell_t *cell = &g->cells[t->index % g->ncells];
+    if (cell->index != t->index || cell->tile)
+        return;
+    t->pins++;
+    t->stamp = ++g->clock;
+    cell->tile = t;
+    lv_image_set_src(cell->img, &t->dsc);
+}
+
+// =========================== 后台解码 ============================
+
+// 磁盘缓存文件名：路径、文件大小、修改时间和缩略图尺寸的哈希，原图改了自然失效
+static bool thumb_path_of(const photo_grid_t *g, const char *jpg_path, char *out, size_t out_len)
+{
+    struct stat st;
+    if (stat(jpg_path, &st) != 0)
+        return false;
+    uint32_t h = 2166136261u; // FNV-1a
+    for (const char *p = jpg_path; *p; p++)
+        h = (h ^ (uint8_t)*p) * 16777619u;
+    uint32_t extra[3] = {(uint32_t)st.st_size, (uint32_t)st.st_mtime, (uint32_t)g->tile};
+    for (size_t i = 0; i < sizeof(extra); i++)
+        h = (h ^ ((const uint8_t *)extra)[i]) * 16777619u;
+    return snprintf(out, out_len, "%s/%08lX.BIN", GRID_THUMB_DIR, (unsigned long)h) < (int)out_len;
+}
+
+typedef enum
+{
+    TILE_FAILED = 0,
+    TILE_FROM_DISK,
+    TILE_DECODED,
+} tile_result_t;
+
+// 只有后台任务写 t->buf：loading 期间别人不会读它
+static tile_result_t load_tile(photo_grid_t *g, grid_tile_t *t, const char *path)
+{
+    size_t bytes = (size_t)g->tile * g->tile * 2;
+    if (!t->buf)
+    {
+        t->buf = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM);
+        if (!t->buf)
+            t->buf = malloc(bytes);
+        if (!t->buf)
+            return TILE_FAILED;
+        t->dsc.header.magic = LV_IMAGE_HEADER_MAGIC;
+        t->dsc.header.cf = LV_COLOR_FORMAT_RGB565;
+        t->dsc.header.w = g->tile;
+        t->dsc.header.h = g->tile;
+        t->dsc.header.stride = g->tile * 2;
+        t->dsc.data = t->buf;
+        t->dsc.data_size = bytes;
+    }
+
+    char bin[64];
+    bool disk = g->disk && thumb_path_of(g, path, bin, sizeof(bin));
+    if (disk)
+    {
+        img_asset_t a;
+        if (img_asset_open_bin(bin, g->tile, g->tile, &a) == ESP_OK)
+        {
+            if (a.header.cf == LV_COLOR_FORMAT_RGB565 && img_asset_read(&a, t->buf, NULL) == ESP_OK)
+                return TILE_FROM_DISK;
+            img_asset_close(&a);
+        }
+    }
+
+    if (!jpg_image_decode_to(path, t->buf, g->tile, g->tile, JPG_FILL))
+        return TILE_FAILED;
+    if (disk)
+        img_asset_write(bin, &t->dsc); // 写不进去（卡满了）下次再解，不影响显示
+    return TILE_DECODED;
+}
+
+static void grid_free(photo_grid_t *g)
+{
+    for (int i = 0; i < GRID_TILE_CACHE; i++)
+        heap_caps_free(g->tiles[i].buf);
+    photo_album_free_list(g->paths, g->count);
+    free(g->cells);
+    free(g->dir);
+    if (g->lock)
+        vSemaphoreDelete(g->lock);
+    free(g);
+}
+
+static void grid_task(void *arg)
+{
+    photo_grid_t *g = (photo_grid_t *)arg;
+
+    struct stat st;
+    g->disk = (mkdir(GRID_THUMB_DIR, 0775) == 0 || errno == EEXIST) && stat(GRID_THUMB_DIR, &st) == 0 &&
+              S_ISDIR(st.st_mode);
+    if (!g->disk)
+        GRID_LOG("no %s, thumbnails stay in PSRAM", GRID_THUMB_DIR);
+
+    for (;;)
+    {
+        xSemaphoreTake(g->lock, portMAX_DELAY);
+        bool quit = g->quit;
+        int idx = quit ? -1 : next_job_locked(g);
+        grid_tile_t *t = idx >= 0 ? victim_locked(g) : NULL;
+        if (t)
+        {
+            t->index = idx;
+            t->loading = true;
+            t->failed = false;
+        }
+        xSemaphoreGive(g->lock);
+        if (quit)
+            break;
+        if (!t)
+        {
+            // 窗口里的都有了；滚动或退出时会被通知
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        // paths 归本任务释放，退出前一直有效
+        tile_result_t r = load_tile(g, t, g->paths[idx]);
+        if (r == TILE_FAILED)
+            GRID_LOG("thumb %s fail", g->paths[idx]);
+
+        bsp_display_lock(portMAX_DELAY);
+        xSemaphoreTake(g->lock, portMAX_DELAY);
+        t->loading = false;
+        t->failed = r == TILE_FAILED;
+        if (r == TILE_FROM_DISK)
+            g->disk_hits++;
+        else if (r == TILE_DECODED)
+            g->decoded++;
+        else
+            g->failed++;
+        if (!g->quit && !t->failed)
+            show_tile_locked(g, t); // 页面还在（删除回调也在显示锁内置 quit）
+        xSemaphoreGive(g->lock);
+        bsp_display_unlock();
+    }
+
+    GRID_LOG("exit: %u shown from cache, %u from disk, %u decoded, %u failed", (unsigned)g->hits,
+             (unsigned)g->disk_hits, (unsigned)g->decoded, (unsigned)g->failed);
+    grid_free(g);
+    vTaskDelete(NULL);
+}
+
+// =========================== 格子回收 ============================
+
+// 把格子挪去显示 idx（-1 隐藏）；缓存里有就当场换上，没有先露出底色等后台
+static void assign_cell(photo_grid_t *g, grid_cell_t *cell, int idx)
+{
+    if (cell->index == idx)
+        return;
+
+    xSemaphoreTake(g->lock, portMAX_DELAY);
+    if (cell->tile)
+        cell->tile->pins--;
+    cell->tile = NULL;
+    cell->index = idx;
+    grid_tile_t *t = idx >= 0 ? find_tile_locked(g, idx) : NULL;
+    if (t && !t->loading && !t->failed)
+    {
+        t->pins++;
+        t->stamp = ++g->clock;
+        cell->tile = t;
+        g->hits++;
+    }
+    xSemaphoreGive(g->lock);
+
+    if (idx < 0)
+    {
+        lv_image_set_src(cell->img, NULL);
+        lv_obj_add_flag(cell->img, LV_OBJ_FLAG_HIDDEN);
+        return;
+    }
+    int x, y;
+    cell_pos(g, idx, &x, &y);
+    lv_obj_set_pos(cell->img, x, y);
+    lv_image_set_src(cell->img, cell->tile ? &cell->tile->dsc : NULL);
+    lv_obj_remove_flag(cell->img, LV_OBJ_FLAG_HIDDEN);
+}
+
+// 按当前滚动位置算窗口，窗口里第 k 张固定用第 k % ncells 个格子，滚一行只挪一行格子
+static void update_window(photo_grid_t *g)
+{
+    int y = lv_obj_get_scroll_y(g->page);
+    if (y < 0)
+        y = 0;
+    int r0 = y / g->cell;
+    int r1 = (y + g->view_h - 1) / g->cell;
+    int first_row = r0 > GRID_OVERSCAN_ROWS ? r0 - GRID_OVERSCAN_ROWS : 0;
+    int first = first_row * GRID_COLS;
+    int vis_last = (r1 + 1) * GRID_COLS - 1;
+
+    for (int k = first; k < first + g->ncells; k++)
+        assign_cell(g, &g->cells[k % g->ncells], k < g->count ? k : -1);
+
+    int last = first + g->ncells - 1 < g->count - 1 ? first + g->ncells - 1 : g->count - 1;
+    if (vis_last > last)
+        vis_last = last;
+
+    xSemaphoreTake(g->lock, portMAX_DELAY);
+    bool changed = g->first != first || g->last != last || g->vis_first != r0 * GRID_COLS || g->vis_last != vis_last;
+    g->first = first;
+    g->last = last;
+    g->vis_first = r0 * GRID_COLS;
+    g->vis_last = vis_last;
+    xSemaphoreGive(g->lock);
+    if (changed)
+        xTaskNotifyGive(g->task);
+}
+
+// =========================== 事件回调 ============================
+
+static void grid_scroll_cb(lv_event_t *e)
+{
+    update_window((photo_grid_t *)lv_event_get_user_data(e));
+}
+
+static void cell_click_cb(lv_event_t *e)
+{
+    photo_grid_t *g = (photo_grid_t *)lv_event_get_user_data(e);
+    lv_obj_t *img = lv_event_get_target(e);
+    lv_indev_t *indev = lv_indev_active();
+    if (indev && lv_indev_get_gesture_dir(indev) != LV_DIR_NONE)
+        return; // 左右滑退出时不当点击
+
+    int idx = -1;
+    for (int i = 0; i < g->ncells; i++)
+    {
+        if (g->cells[i].img == img)
+            idx = g->cells[i].index;
+    }
+    if (idx < 0)
+        return;
+
+    ESP_LOGI("grid", "open #%d %s", idx, g->paths[idx]);
+    lv_obj_t *new_scr = photo_album_create_at(g->dir, g->view_w, g->view_h, true, idx);
+    if (new_scr)
+        lv_scr_load_anim(new_scr, LV_SCR_LOAD_ANIM_FADE_IN, 50, 0, true);
+}
+
+// 上下是滚动，左右滑回主界面
+static void grid_gesture_cb(lv_event_t *e)
+{
+    lv_indev_t *indev = lv_indev_active();
+    lv_dir_t dir = indev ? lv_indev_get_gesture_dir(indev) : LV_DIR_NONE;
+    if (dir != LV_DIR_LEFT && dir != LV_DIR_RIGHT)
+        return;
+    lv_obj_t *new_scr = page_main_create();
+    if (new_scr)
+        lv_scr_load_anim(new_scr, dir == LV_DIR_LEFT ? LV_SCR_LOAD_ANIM_MOVE_LEFT : LV_SCR_LOAD_ANIM_MOVE_RIGHT, 120, 0,
+                         true);
+}
+
+// 删除回调在 LVGL 任务里、持显示锁：置 quit 后后台任务不会再碰这些对象
+static void grid_delete_cb(lv_event_t *e)
+{
+    photo_grid_t *g = (photo_grid_t *)lv_event_get_user_data(e);
+    xSemaphoreTake(g->lock, portMAX_DELAY);
+    g->quit = true;
+    g->page = NULL;
+    xSemaphoreGive(g->lock);
+    xTaskNotifyGive(g->task);
+}
+
+// =========================== 对外接口 ============================
+
+lv_obj_t *photo_grid_create(const char *dir, int view_w, int view_h, int focus)
+{
+    if (!dir || view_w < GRID_COLS * (GRID_GAP + 8) || view_h <= 0)
+        return NULL;
+
+    photo_grid_t *g = (photo_grid_t *)calloc(1, sizeof(photo_grid_t));
+    if (!g)
+        return NULL;
+    for (int i = 0; i < GRID_TILE_CACHE; i++)
+        g->tiles[i].index = -1;
+    g->last = g->vis_last = -1; // 窗口在 update_window 里第一次算出来之前是空的
+    g->view_w = view_w;
+    g->view_h = view_h;
+    g->cell = view_w / GRID_COLS;
+    g->tile = g->cell - GRID_GAP;
+    g->x0 = (view_w - g->cell * GRID_COLS) / 2;
+
+    g->lock = xSemaphoreCreateMutex();
+    g->dir = strdup(dir);
+    if (!g->lock || !g->dir || photo_album_scan(dir, &g->paths, &g->count) != ESP_OK)
+    {
+        GRID_LOG("open %s fail", dir);
+        grid_free(g);
+        return NULL;
+    }
+    g->rows = (g->count + GRID_COLS - 1) / GRID_COLS;
+
+    // 视口最多跨 view_h / cell + 2 行，上下再各加预备行
+    int pool_rows = g->view_h / g->cell + 2 + 2 * GRID_OVERSCAN_ROWS;
+    g->ncells = pool_rows * GRID_COLS;
+    if (g->ncells + 1 >= GRID_TILE_CACHE) // 窗口里的都留着，还要一张给窗口外正在解的
+    {
+        GRID_LOG("GRID_TILE_CACHE %d too small for %d cells", GRID_TILE_CACHE, g->ncells);
+        grid_free(g);
+        return NULL;
+    }
+    g->cells = (grid_cell_t *)calloc((size_t)g->ncells, sizeof(grid_cell_t));
+    if (!g->cells)
+    {
+        grid_free(g);
+        return NULL;
+    }
+
+    // 页面：只能上下滚；内容高度由最底下一个 1x1 的占位撑出来
+    g->page = lv_obj_create(NULL);
+    lv_obj_set_size(g->page, view_w, view_h);
+    lv_obj_set_style_bg_color(g->page, lv_color_black(), 0);
+    lv_obj_set_style_bg_opa(g->page, LV_OPA_COVER, 0);
+    lv_obj_set_style_pad_all(g->page, 0, 0);
+    lv_obj_set_style_border_width(g->page, 0, 0);
+    lv_obj_set_scroll_dir(g->page, LV_DIR_VER);
+    lv_obj_set_scrollbar_mode(g->page, LV_SCROLLBAR_MODE_ACTIVE);
+
+    lv_obj_t *spacer = lv_obj_create(g->page);
+    lv_obj_remove_style_all(spacer);
+    lv_obj_remove_flag(spacer, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_set_size(spacer, 1, 1);
+    lv_obj_set_pos(spacer, 0, g->rows * g->cell - 1);
+
+    for (int i = 0; i < g->ncells; i++)
+    {
+        grid_cell_t *cell = &g->cells[i];
+        cell->index = -1;
+        cell->img = lv_image_create(g->page);
+        lv_obj_set_size(cell->img, g->tile, g->tile);
+        lv_obj_set_style_bg_color(cell->img, lv_color_hex(0x202020), 0); // 没解好前的底色
+        lv_obj_set_style_bg_opa(cell->img, LV_OPA_COVER, 0);
+        lv_obj_add_flag(cell->img, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_HIDDEN);
+        lv_obj_add_event_cb(cell->img, cell_click_cb, LV_EVENT_CLICKED, g);
+    }
+
+    if (xTaskCreatePinnedToCore(grid_task, "grid_thumb", GRID_TASK_STACK, g, GRID_TASK_PRIO, &g->task,
+                                tskNO_AFFINITY) != pdPASS)
+    {
+        GRID_LOG("create task fail");
+        lv_obj_del(g->page);
+        grid_free(g);
+        return NULL;
+    }
+
+    lv_obj_add_event_cb(g->page, grid_scroll_cb, LV_EVENT_SCROLL, g);
+    lv_obj_add_event_cb(g->page, grid_gesture_cb, LV_EVENT_GESTURE, g);
+    lv_obj_add_event_cb(g->page, grid_delete_cb, LV_EVENT_DELETE, g);
+
+    // 让 focus 那一行停在视口中间
+    if (focus < 0 || focus >= g->count)
+        focus = 0;
+    lv_obj_update_layout(g->page);
+    int y = (focus / GRID_COLS) * g->cell - (view_h - g->cell) / 2;
+    int max_y = g->rows * g->cell - view_h;
+    if (y > max_y)
+        y = max_y;
+    if (y < 0)
+        y = 0;
+    lv_obj_scroll_to_y(g->page, y, LV_ANIM_OFF);
+    update_window(g);
+
+    GRID_LOG("%s: %d photos, %d cells, tile %dx%d", dir, g->count, g->ncells, g->tile, g->tile);
+    return g->page;
+}
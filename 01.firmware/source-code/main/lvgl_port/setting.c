@@ -6,6 +6,7 @@
 #include "bsp/esp-bsp.h"
 #include "bsp/display.h"
 #include "bsp_board_extra.h"
+#include "frame_prof.h"
 
 #include <stdio.h>
 #include <inttypes.h>
@@ -26,6 +27,7 @@ typedef struct {
     lv_obj_t *label_val;
     lv_obj_t *sw_enable;
     lv_obj_t *btn_reset;
+    lv_obj_t *sw_prof;
 } disp_ui_t;
 
 static disp_ui_t s_ui;
@@ -206,6 +208,15 @@ static void reset_btn_event_cb(lv_event_t *e)
 }
 
 
+static void prof_switch_event_cb(lv_event_t *e)
+{
+    if (lv_event_get_code(e) == LV_EVENT_VALUE_CHANGED) {
+        bool on = lv_obj_has_state(s_ui.sw_prof, LV_STATE_CHECKED);
+        frame_prof_overlay_show(on);
+        ESP_LOGI(TAG, "Profiler overlay %s", on ? "on" : "off");
+    }
+}
+
 // 创建并返回设置页（独立 screen）。已存在则直接返回。
 lv_obj_t *settings_page(void)
 {
@@ -302,6 +313,27 @@ lv_obj_t *settings_page(void)
 
     lv_obj_add_event_cb(s_ui.slider, slider_event_cb, LV_EVENT_ALL, NULL);
 
+    // --- 帧耗时面板开关（面板点一下打印报告到串口，长按清零）---
+    lv_obj_t *prof_row = lv_obj_create(s_ui.screen);
+    lv_obj_remove_style_all(prof_row);
+    lv_obj_set_size(prof_row, LV_PCT(100), LV_SIZE_CONTENT);
+    lv_obj_set_flex_flow(prof_row, LV_FLEX_FLOW_ROW);
+    lv_obj_set_flex_align(prof_row, LV_FLEX_ALIGN_SPACE_BETWEEN, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    lv_obj_set_style_pad_all(prof_row, 14, 0);
+    lv_obj_set_style_radius(prof_row, 18, 0);
+    lv_obj_set_style_bg_color(prof_row, lv_color_hex(0x1F232B), 0);
+    lv_obj_set_style_bg_opa(prof_row, LV_OPA_COVER, 0);
+
+    lv_obj_t *prof_lbl = lv_label_create(prof_row);
+    lv_label_set_text(prof_lbl, "Profiler overlay");
+    lv_obj_set_style_text_color(prof_lbl, lv_color_hex(0xC8CCD5), 0);
+
+    s_ui.sw_prof = lv_switch_create(prof_row);
+    if (frame_prof_overlay_visible()) {
+        lv_obj_add_state(s_ui.sw_prof, LV_STATE_CHECKED);
+    }
+    lv_obj_add_event_cb(s_ui.sw_prof, prof_switch_event_cb, LV_EVENT_VALUE_CHANGED, NULL);
+
     // 应用当前状态到硬件
     if (saved_enable) {
         apply_enable_state(true);
@@ -1,5 +1,6 @@
 #include "lvgl.h"
 #include "esp_jpeg_dec.h"
+#include "esp_heap_caps.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -8,6 +9,8 @@
 #include "bsp/esp-bsp.h"
 #include "bsp/display.h"
 #include "bsp_board_extra.h"
+#include "ui.h"
+#include "jpg_pool.h"
 
 #if LVGL_VERSION_MAJOR >= 9
 #define USE_LVGL_V9 1
@@ -15,6 +18,11 @@
 #define USE_LVGL_V9 0
 #endif
 
+#if USE_LVGL_V9
+#include "img_cache.h"
+#include "img_asset.h"
+#endif
+
 #if USE_LVGL_V9
 typedef struct { lv_image_dsc_t dsc; } dyn_img_v9_t;
 #else
@@ -28,100 +36,396 @@ static void img_free_on_delete(lv_event_t *e)
     if(pkg) free(pkg);
 }
 
-/* 显示 JPG 为 lv_img/lv_image；视口大小 view_w x view_h；不缩放，小图居中，大图居中裁剪 */
-lv_obj_t *show_jpg_as_img(lv_obj_t *parent, const char *jpg_path, int view_w, int view_h)
+/* 居中裁剪窗口：源图里取 [src_x0, src_x0+copy_w) x [src_y0, src_y0+copy_h)，放到视口的 (dst_x0, dst_y0) */
+typedef struct {
+    int src_x0, src_y0;
+    int dst_x0, dst_y0;
+    int copy_w, copy_h;
+} crop_t;
+
+static void calc_crop(int img_w, int img_h, int view_w, int view_h, crop_t *c)
 {
-    if (!parent || !jpg_path || view_w <= 0 || view_h <= 0) return NULL;
+    memset(c, 0, sizeof(*c));
+    c->copy_w = img_w;
+    c->copy_h = img_h;
+
+    if (img_w > view_w) { c->src_x0 = (img_w - view_w) / 2; c->copy_w = view_w; }
+    else                { c->dst_x0 = (view_w - img_w) / 2; }
+
+    if (img_h > view_h) { c->src_y0 = (img_h - view_h) / 2; c->copy_h = view_h; }
+    else                { c->dst_y0 = (view_h - img_h) / 2; }
+}
+
+/* 视口里裁剪窗口以外的部分（小图的黑边）清零；窗口内马上会被像素盖满，不用先清 */
+static void clear_border(uint8_t *dst_pixels, int view_w, int view_h, const crop_t *c)
+{
+    size_t row = (size_t)view_w * 2;
+    if (c->dst_y0 > 0) memset(dst_pixels, 0, row * c->dst_y0);
+    int bottom = c->dst_y0 + c->copy_h;
+    if (bottom < view_h) memset(dst_pixels + row * bottom, 0, row * (view_h - bottom));
+    int right = c->dst_x0 + c->copy_w;
+    if (c->dst_x0 == 0 && right >= view_w) return;
+    for (int y = c->dst_y0; y < bottom; y++) {
+        uint8_t *d = dst_pixels + row * y;
+        memset(d, 0, (size_t)c->dst_x0 * 2);
+        memset(d + (size_t)right * 2, 0, (size_t)(view_w - right) * 2);
+    }
+}
+
+/* 把源图第 y0 行起的 lines 行（行宽 img_w）中落在裁剪窗口里的部分拷进视口像素 */
+static void place_rows(const uint8_t *src, int y0, int lines, int img_w,
+                       uint8_t *dst_pixels, int view_w, const crop_t *c)
+{
+    int from = y0 > c->src_y0 ? y0 : c->src_y0;
+    int to = y0 + lines < c->src_y0 + c->copy_h ? y0 + lines : c->src_y0 + c->copy_h;
+    for (int y = from; y < to; y++) {
+        const uint8_t *s = src + ((size_t)(y - y0) * img_w + c->src_x0) * 2;
+        uint8_t *d = dst_pixels + ((size_t)(c->dst_y0 + y - c->src_y0) * view_w + c->dst_x0) * 2;
+        memcpy(d, s, (size_t)c->copy_w * 2);
+    }
+}
+
+/* 块模式：每次出一个 MCU 行（8 或 16 行）到内部 RAM 的条带里，立刻裁剪进最终像素。
+ * 临时内存只有一条带，和原图分辨率无关；裁剪窗口以下的块不再解码。 */
+static bool decode_by_blocks(jpg_ctx_t *ctx, jpeg_dec_handle_t j, jpeg_dec_io_t *io, int img_w,
+                             uint8_t *dst_pixels, int view_w, const crop_t *c)
+{
+    int block_len = 0, count = 0;
+    if (jpeg_dec_get_outbuf_len(j, &block_len) != JPEG_ERR_OK || block_len <= 0 ||
+        jpeg_dec_get_process_count(j, &count) != JPEG_ERR_OK || count <= 0) {
+        printf("get block info fail\n");
+        return false;
+    }
+
+    uint8_t *strip = jpg_ctx_strip(ctx, (size_t)block_len); // 超宽图退到 PSRAM
+    if (!strip) { printf("no mem strip %d\n", block_len); return false; }
+
+    bool ok = true;
+    int y = 0, i;
+    for (i = 0; i < count && y < c->src_y0 + c->copy_h; i++) {
+        io->outbuf = strip;
+        if (jpeg_dec_process(j, io) != JPEG_ERR_OK) { printf("decode block %d fail\n", i); ok = false; break; }
+        int lines = io->out_size / (img_w * 2);
+        place_rows(strip, y, lines, img_w, dst_pixels, view_w, c);
+        y += lines;
+    }
+
+    if (i < count) jpg_ctx_reset_decoder(ctx); // 提前结束，句柄里还留着没解完的状态
+    return ok;
+}
+
+/* 非 8 倍数尺寸不能走块模式，整幅解码后再裁剪 */
+static bool decode_whole(jpg_ctx_t *ctx, jpeg_dec_handle_t j, jpeg_dec_io_t *io, int img_w,
+                         uint8_t *dst_pixels, int view_w, const crop_t *c)
+{
+    int out_len = 0;
+    if (jpeg_dec_get_outbuf_len(j, &out_len) != JPEG_ERR_OK || out_len <= 0) {
+        printf("get out len fail\n");
+        return false;
+    }
+
+    uint8_t *rgb565 = jpg_ctx_out(ctx, (size_t)out_len);
+    if (!rgb565) { printf("no mem out\n"); return false; }
+    io->outbuf = rgb565;
+
+    bool ok = jpeg_dec_process(j, io) == JPEG_ERR_OK;
+    if (ok) place_rows(rgb565, 0, c->src_y0 + c->copy_h, img_w, dst_pixels, view_w, c);
+    else    printf("decode fail\n");
+    return ok;
+}
+
+/* 缩放方案：图在视口里的尺寸 tw x th（保持宽高比，只缩小不放大）。
+ * 解码器先 scale 到 8 的倍数（最多缩到 1/8），再用 clipper 去掉右边和下边用不到的部分；
+ * clipper 保留左上角，所以居中偏移和剩下的零头比例由 place_scaled 做最近邻映射 */
+typedef struct {
+    int tw, th;           // 图在视口里的尺寸
+    int dec_w, dec_h;     // 解码器缩放后的尺寸
+    int out_w, out_h;     // 裁剪后实际输出的尺寸
+    jpeg_resolution_t scale;
+    jpeg_resolution_t clipper;
+} scale_plan_t;
+
+#define ALIGN8_UP(v) (((v) + 7) & ~7)
 
-    /* 1) 读文件 */
+/* 一个方向上的解码器缩放：不到原图 1/8 的部分留给 CPU；凑到 8 的倍数后不比原图小就不缩 */
+static int plan_axis_scale(int img, int target)
+{
+    int s = ALIGN8_UP(target);
+    int min = ALIGN8_UP((img + 7) / 8);
+    if (s < min) s = min;
+    return s < img ? s : 0;
+}
+
+/* 需要缩放时填 plan 并返回 true；原尺寸就能用（图不比视口大，或者正好铺满）返回 false */
+static bool plan_scale(int img_w, int img_h, int view_w, int view_h, jpg_view_mode_t mode, scale_plan_t *p)
+{
+    float rx = (float)view_w / img_w, ry = (float)view_h / img_h;
+    float r = mode == JPG_FIT ? (rx < ry ? rx : ry) : (rx > ry ? rx : ry);
+    if (r >= 1.0f) return false;
+
+    memset(p, 0, sizeof(*p));
+    p->tw = (int)(img_w * r + 0.5f);
+    p->th = (int)(img_h * r + 0.5f);
+    if (p->tw < 1) p->tw = 1;
+    if (p->th < 1) p->th = 1;
+    if (p->tw == img_w && p->th == img_h) return false;
+
+    p->scale.width = plan_axis_scale(img_w, p->tw);
+    p->scale.height = plan_axis_scale(img_h, p->th);
+    p->dec_w = p->scale.width ? p->scale.width : img_w;
+    p->dec_h = p->scale.height ? p->scale.height : img_h;
+
+    /* 视口只露出目标图的中间一块，解码输出只需要保留到它的右/下边界 */
+    crop_t c;
+    calc_crop(p->tw, p->th, view_w, view_h, &c);
+    int need_w = (int)(((int64_t)(c.src_x0 + c.copy_w) * p->dec_w + p->tw - 1) / p->tw);
+    int need_h = (int)(((int64_t)(c.src_y0 + c.copy_h) * p->dec_h + p->th - 1) / p->th);
+    if (ALIGN8_UP(need_w) < p->dec_w) p->clipper.width = ALIGN8_UP(need_w);
+    if (ALIGN8_UP(need_h) < p->dec_h) p->clipper.height = ALIGN8_UP(need_h);
+    p->out_w = p->clipper.width ? p->clipper.width : p->dec_w;
+    p->out_h = p->clipper.height ? p->clipper.height : p->dec_h;
+    return true;
+}
+
+/* 把解码器输出（out_w x out_h，对应目标图的 dec_w x dec_h 比例）最近邻映射进视口 */
+static void place_scaled(const uint16_t *src, const scale_plan_t *p,
+                         uint16_t *dst_pixels, int view_w, const crop_t *c)
+{
+    uint32_t step_x = (uint32_t)(((uint64_t)p->dec_w << 16) / p->tw);
+    uint32_t step_y = (uint32_t)(((uint64_t)p->dec_h << 16) / p->th);
+    uint32_t x0 = (uint32_t)(((uint64_t)(2 * c->src_x0 + 1) * p->dec_w << 15) / p->tw); // 像素中心对齐
+    uint32_t fy = (uint32_t)(((uint64_t)(2 * c->src_y0 + 1) * p->dec_h << 15) / p->th);
+
+    for (int y = 0; y < c->copy_h; y++, fy += step_y) {
+        int sy = (int)(fy >> 16);
+        if (sy >= p->out_h) sy = p->out_h - 1;
+        const uint16_t *s = src + (size_t)sy * p->out_w;
+        uint16_t *d = dst_pixels + (size_t)(c->dst_y0 + y) * view_w + c->dst_x0;
+        uint32_t fx = x0;
+        for (int x = 0; x < c->copy_w; x++, fx += step_x) {
+            int sx = (int)(fx >> 16);
+            d[x] = s[sx < p->out_w ? sx : p->out_w - 1];
+        }
+    }
+}
+
+/* 缩放模式不支持块解码：整幅输出（已缩小、已裁掉右/下）后映射进视口 */
+static bool decode_scaled(jpg_ctx_t *ctx, jpeg_dec_handle_t j, jpeg_dec_io_t *io, const scale_plan_t *p,
+                          uint8_t *dst_pixels, int view_w, const crop_t *c)
+{
+    int out_len = 0;
+    if (jpeg_dec_get_outbuf_len(j, &out_len) != JPEG_ERR_OK || out_len < p->out_w * p->out_h * 2) {
+        printf("get scaled out len fail (%d for %dx%d)\n", out_len, p->out_w, p->out_h);
+        return false;
+    }
+
+    uint8_t *rgb565 = jpg_ctx_out(ctx, (size_t)out_len);
+    if (!rgb565) { printf("no mem scaled %d\n", out_len); return false; }
+    io->outbuf = rgb565;
+
+    bool ok = jpeg_dec_process(j, io) == JPEG_ERR_OK;
+    if (ok) place_scaled((const uint16_t *)rgb565, p, (uint16_t *)dst_pixels, view_w, c);
+    else    printf("scaled decode fail\n");
+    return ok;
+}
+
+/* 从 SOF 段直接取图像尺寸，省掉一次“打开解码器只为读头”；认不出来返回 false */
+bool jpg_peek_size(const uint8_t *p, size_t len, int *w, int *h)
+{
+    if (len < 4 || p[0] != 0xFF || p[1] != 0xD8) return false;
+    size_t i = 2;
+    while (i + 4 <= len) {
+        if (p[i] != 0xFF) return false;
+        uint8_t m = p[i + 1];
+        if (m == 0xFF) { i++; continue; }                 // 填充字节
+        if (m == 0xD8 || m == 0x01 || (m >= 0xD0 && m <= 0xD7)) { i += 2; continue; } // 无长度的标记
+        if (m == 0xDA || m == 0xD9) return false;         // 到 SOS/EOI 还没见到 SOF
+        size_t seg = ((size_t)p[i + 2] << 8) | p[i + 3];
+        if (seg < 2) return false;
+        if (m >= 0xC0 && m <= 0xCF && m != 0xC4 && m != 0xC8 && m != 0xCC) {
+            if (i + 9 > len) return false;
+            *h = (p[i + 5] << 8) | p[i + 6];
+            *w = (p[i + 7] << 8) | p[i + 8];
+            return *w > 0 && *h > 0;
+        }
+        i += 2 + seg;
+    }
+    return false;
+}
+
+/* 按 cfg 拿上下文里的解码器（配置相同就复用）并解析头 */
+static jpeg_dec_handle_t ctx_open_decoder(jpg_ctx_t *ctx, jpeg_dec_config_t *cfg, jpeg_dec_io_t *io,
+                                          jpeg_dec_header_info_t *hi)
+{
+    jpeg_dec_handle_t j = jpg_ctx_decoder(ctx, cfg);
+    if (!j) { printf("jpeg open fail\n"); return NULL; }
+    if (jpeg_dec_parse_header(j, io, hi) != JPEG_ERR_OK) {
+        jpg_ctx_reset_decoder(ctx); printf("parse header fail\n"); return NULL;
+    }
+    return j;
+}
+
+/* 读文件并解码到 dst_pixels（view_w x view_h，RGB565，不需要预先清零，黑边在这里补）。
+ * 比视口大的图按 mode 缩小（解码器直接出目标尺寸附近的图），然后居中；小图不放大，居中留黑边。
+ * 文件缓冲、输出缓冲和解码器句柄都来自 ctx，连续解码不反复申请 */
+static bool decode_jpg_file(jpg_ctx_t *ctx, const char *jpg_path, uint8_t *dst_pixels, int view_w, int view_h,
+                            jpg_view_mode_t mode)
+{
+    /* 1) 读文件（压缩数据放 PSRAM，解码器要求整段输入） */
     FILE *fp = fopen(jpg_path, "rb");
-    if (!fp) { printf("open %s failed\n", jpg_path); return NULL; }
+    if (!fp) { printf("open %s failed\n", jpg_path); return false; }
     fseek(fp, 0, SEEK_END);
     long fsize = ftell(fp);
-    if (fsize <= 0) { fclose(fp); printf("bad file size\n"); return NULL; }
+    if (fsize <= 0) { fclose(fp); printf("bad file size\n"); return false; }
     fseek(fp, 0, SEEK_SET);
-    uint8_t *jpg_bytes = (uint8_t *)malloc((size_t)fsize);
-    if (!jpg_bytes) { fclose(fp); printf("no mem jpg\n"); return NULL; }
+    uint8_t *jpg_bytes = jpg_ctx_in(ctx, (size_t)fsize);
+    if (!jpg_bytes) { fclose(fp); printf("no mem jpg\n"); return false; }
     size_t rd = fread(jpg_bytes, 1, (size_t)fsize, fp);
     fclose(fp);
-    if (rd != (size_t)fsize) { free(jpg_bytes); printf("read fail\n"); return NULL; }
+    if (rd != (size_t)fsize) { printf("read fail\n"); return false; }
 
-    /* 2) 解码为 RGB565(LE) */
-    jpeg_dec_handle_t j = NULL;
+    /* 2) 先从 SOF 取尺寸定下解码配置，只打开一次；取不到再让解码器解析头 */
     jpeg_dec_config_t cfg = DEFAULT_JPEG_DEC_CONFIG();
     cfg.output_type = JPEG_PIXEL_FORMAT_RGB565_LE;
-    if (jpeg_dec_open(&cfg, &j) != JPEG_ERR_OK) { free(jpg_bytes); printf("jpeg open fail\n"); return NULL; }
-
     jpeg_dec_io_t io = {.inbuf = jpg_bytes, .inbuf_len = (int)fsize, .outbuf = NULL};
     jpeg_dec_header_info_t hi;
-    if (jpeg_dec_parse_header(j, &io, &hi) != JPEG_ERR_OK) {
-        jpeg_dec_close(j); free(jpg_bytes); printf("parse header fail\n"); return NULL;
+    int img_w = 0, img_h = 0;
+    if (!jpg_peek_size(jpg_bytes, (size_t)fsize, &img_w, &img_h)) {
+        if (!ctx_open_decoder(ctx, &cfg, &io, &hi)) return false;
+        img_w = (int)hi.width;
+        img_h = (int)hi.height;
+        io = (jpeg_dec_io_t){.inbuf = jpg_bytes, .inbuf_len = (int)fsize, .outbuf = NULL};
     }
 
-    int out_len = 0;
-    if (jpeg_dec_get_outbuf_len(j, &out_len) != JPEG_ERR_OK || out_len <= 0) {
-        jpeg_dec_close(j); free(jpg_bytes); printf("get out len fail\n"); return NULL;
+    /* 3) 需要缩小时用缩放方案（scale/clipper 不能和块模式一起用），否则尺寸是 8 的倍数就走块模式 */
+    scale_plan_t plan;
+    bool scaled = plan_scale(img_w, img_h, view_w, view_h, mode, &plan);
+    bool block = !scaled && (img_w % 8) == 0 && (img_h % 8) == 0;
+    cfg.block_enable = block;
+    if (scaled) {
+        cfg.scale = plan.scale;
+        cfg.clipper = plan.clipper;
     }
+    jpeg_dec_handle_t j = ctx_open_decoder(ctx, &cfg, &io, &hi);
+    if (!j) return false;
 
-    uint8_t *rgb565 = (uint8_t *)jpeg_calloc_align((size_t)out_len, 16);
-    if (!rgb565) { jpeg_dec_close(j); free(jpg_bytes); printf("no mem out\n"); return NULL; }
-    io.outbuf = rgb565;
+    /* 4) 计算居中裁剪窗口（缩放时按目标尺寸算），结果直接落到目标像素，窗口外补黑 */
+    crop_t crop;
+    bool ok;
+    if (scaled) {
+        calc_crop(plan.tw, plan.th, view_w, view_h, &crop);
+        ok = decode_scaled(ctx, j, &io, &plan, dst_pixels, view_w, &crop);
+    } else {
+        calc_crop(img_w, img_h, view_w, view_h, &crop);
+        ok = block ? decode_by_blocks(ctx, j, &io, img_w, dst_pixels, view_w, &crop)
+                   : decode_whole(ctx, j, &io, img_w, dst_pixels, view_w, &crop);
+    }
+    if (ok) clear_border(dst_pixels, view_w, view_h, &crop);
+    else    jpg_ctx_reset_decoder(ctx);
+    return ok;
+}
 
-    if (jpeg_dec_process(j, &io) != JPEG_ERR_OK) {
-        jpeg_dec_close(j); free(jpg_bytes); jpeg_free_align(rgb565); printf("decode fail\n"); return NULL;
+/* 创建居中的图片对象，删除时调 free_cb(user) */
+static lv_obj_t *create_img_obj(lv_obj_t *parent, const void *src, lv_event_cb_t free_cb, void *user)
+{
+    lv_obj_t *img = NULL;
+    bsp_display_lock(portMAX_DELAY);
+#if USE_LVGL_V9
+    img = lv_image_create(parent);
+    if (img) {
+        lv_image_set_src(img, src);
+        lv_obj_add_event_cb(img, free_cb, LV_EVENT_DELETE, user); // ★ 删除即释放
+        lv_obj_align(img, LV_ALIGN_CENTER, 0, 0);
     }
+#else
+    img = lv_img_create(parent);
+    if (img) {
+        lv_img_set_src(img, src);
+        lv_obj_add_event_cb(img, free_cb, LV_EVENT_DELETE, user); // ★ 删除即释放
+        lv_obj_align(img, LV_ALIGN_CENTER, 0, 0);
+    }
+#endif
+    bsp_display_unlock();
+    return img;
+}
 
-    const int img_w = (int)hi.width;
-    const int img_h = (int)hi.height;
+#if USE_LVGL_V9
+/* 像素来源：有构建时预转换的 .bin（tools/asset_pack.py）就直接读，没有再解码 JPEG。
+ * 返回像素格式，有 .bin 时 asset->fp 非空 */
+static lv_color_format_t open_source(const char *jpg_path, int view_w, int view_h, jpg_view_mode_t mode,
+                                     img_asset_t *asset)
+{
+    if (img_asset_open(jpg_path, view_w, view_h, mode == JPG_FIT, asset) == ESP_OK) return (lv_color_format_t)asset->header.cf;
+    return LV_COLOR_FORMAT_RGB565;
+}
 
-    /* 3) 计算居中裁剪窗口 */
-    int copy_w = img_w, copy_h = img_h;
-    int src_x0 = 0, src_y0 = 0;
-    int dst_x0 = 0, dst_y0 = 0;
+/* 从池里借一个解码上下文读像素；.bin 的 LZ4 压缩数据也放它的输入缓冲 */
+static bool load_pixels(const char *jpg_path, img_asset_t *asset, uint8_t *dst_pixels, int view_w, int view_h,
+                        jpg_view_mode_t mode)
+{
+    jpg_ctx_t *ctx = jpg_pool_acquire();
+    if (!ctx) { img_asset_close(asset); printf("no mem jpg ctx\n"); return false; }
+    bool ok;
+    if (asset->fp) {
+        uint8_t *scratch = asset->lz4 ? jpg_ctx_in(ctx, asset->packed_size) : NULL;
+        ok = img_asset_read(asset, dst_pixels, scratch) == ESP_OK;
+    } else {
+        ok = decode_jpg_file(ctx, jpg_path, dst_pixels, view_w, view_h, mode);
+    }
+    jpg_pool_release(ctx);
+    return ok;
+}
+#endif
 
-    if (copy_w > view_w) { src_x0 = (copy_w - view_w) / 2; copy_w = view_w; }
-    else                 { dst_x0 = (view_w - copy_w) / 2; }
+/* 只解 JPEG（不找 .bin）到调用者的缓冲：view_w x view_h RGB565，至少 view_w * view_h * 2 字节 */
+bool jpg_image_decode_to(const char *jpg_path, uint8_t *dst_pixels, int view_w, int view_h, jpg_view_mode_t mode)
+{
+    if (!jpg_path || !dst_pixels || view_w <= 0 || view_h <= 0) return false;
+    jpg_ctx_t *ctx = jpg_pool_acquire();
+    if (!ctx) { printf("no mem jpg ctx\n"); return false; }
+    bool ok = decode_jpg_file(ctx, jpg_path, dst_pixels, view_w, view_h, mode);
+    jpg_pool_release(ctx);
+    return ok;
+}
 
-    if (copy_h > view_h) { src_y0 = (copy_h - view_h) / 2; copy_h = view_h; }
-    else                 { dst_y0 = (view_h - copy_h) / 2; }
+/* 只读/解码成独立的描述符，像素和 dsc 放在一个包里；不碰 LVGL 对象，后台任务也能调 */
+lv_img_dsc_t *jpg_image_load(const char *jpg_path, int view_w, int view_h, jpg_view_mode_t mode)
+{
+    if (!jpg_path || view_w <= 0 || view_h <= 0) return NULL;
 
-    /* 4) 分配“一体化包”并拷入像素 */
-    size_t dst_bytes = (size_t)view_w * view_h * 2; // RGB565
+    /* 分配“一体化包”，像素直接落到包里 */
 #if USE_LVGL_V9
+    img_asset_t asset;
+    lv_color_format_t cf = open_source(jpg_path, view_w, view_h, mode, &asset);
+    size_t dst_bytes = asset.fp ? asset.data_size : (size_t)view_w * view_h * 2; // RGB565(A8)
     size_t pkg_bytes = sizeof(dyn_img_v9_t) + dst_bytes;
     dyn_img_v9_t *pkg = (dyn_img_v9_t *)malloc(pkg_bytes);
+    if (!pkg) { img_asset_close(&asset); printf("no mem pkg\n"); return NULL; }
 #else
+    size_t dst_bytes = (size_t)view_w * view_h * 2; // RGB565
     size_t pkg_bytes = sizeof(dyn_img_v8_t) + dst_bytes;
     dyn_img_v8_t *pkg = (dyn_img_v8_t *)malloc(pkg_bytes);
+    if (!pkg) { printf("no mem pkg\n"); return NULL; }
 #endif
-    if (!pkg) {
-        jpeg_dec_close(j); free(jpg_bytes); jpeg_free_align(rgb565);
-        printf("no mem pkg\n"); return NULL;
-    }
-    memset(pkg, 0, pkg_bytes);
-    uint8_t *dst_pixels =
+    memset(&pkg->dsc, 0, sizeof(pkg->dsc)); // 像素由 load_pixels 整块写满
+    uint8_t *dst_pixels = (uint8_t *)(pkg + 1);
+
 #if USE_LVGL_V9
-        (uint8_t *)(pkg + 1);
+    if (!load_pixels(jpg_path, &asset, dst_pixels, view_w, view_h, mode)) { free(pkg); return NULL; }
 #else
-        (uint8_t *)(pkg + 1);
+    if (!jpg_image_decode_to(jpg_path, dst_pixels, view_w, view_h, mode)) { free(pkg); return NULL; }
 #endif
-    memset(dst_pixels, 0, dst_bytes);
-
-    for (int y = 0; y < copy_h; y++) {
-        const uint8_t *src = rgb565 + ((size_t)(src_y0 + y) * img_w + src_x0) * 2;
-        uint8_t *dst = dst_pixels + ((size_t)(dst_y0 + y) * view_w + dst_x0) * 2;
-        memcpy(dst, src, (size_t)copy_w * 2);
-    }
 
-    /* 5) 填 dsc 头 */
+    /* 填 dsc 头 */
 #if USE_LVGL_V9
-    pkg->dsc.header.magic = LV_IMAGE_HEADER_MAGIC;
-    pkg->dsc.header.cf    = LV_COLOR_FORMAT_RGB565;
-    pkg->dsc.header.flags = 0;
-    pkg->dsc.header.w     = view_w;
-    pkg->dsc.header.h     = view_h;
-    pkg->dsc.data         = dst_pixels;
-    pkg->dsc.data_size    = dst_bytes;
+    pkg->dsc.header.magic  = LV_IMAGE_HEADER_MAGIC;
+    pkg->dsc.header.cf     = cf;
+    pkg->dsc.header.flags  = 0;
+    pkg->dsc.header.w      = view_w;
+    pkg->dsc.header.h      = view_h;
+    pkg->dsc.header.stride = view_w * 2;
+    pkg->dsc.data          = dst_pixels;
+    pkg->dsc.data_size     = dst_bytes;
 #else
     pkg->dsc.header.always_zero = 0;
     pkg->dsc.header.w           = view_w;
@@ -129,32 +433,82 @@ lv_obj_t *show_jpg_as_img(lv_obj_t *parent, const char *jpg_path, int view_w, in
     pkg->dsc.data               = dst_pixels;
     pkg->dsc.data_size          = dst_bytes;
     pkg->dsc.cf                 = LV_IMG_CF_TRUE_COLOR;
+#endif
+    return &pkg->dsc;
+}
+
+void jpg_image_free(lv_img_dsc_t *dsc)
+{
+    free(dsc); /* dsc 是包的第一个成员 */
+}
+
+/* 不走缓存：每次都读/解码，对象删除时释放 */
+lv_obj_t *show_jpg_as_img_uncached(lv_obj_t *parent, const char *jpg_path, int view_w, int view_h,
+                                   jpg_view_mode_t mode)
+{
+    if (!parent) return NULL;
+    lv_img_dsc_t *dsc = jpg_image_load(jpg_path, view_w, view_h, mode);
+    if (!dsc) return NULL;
+
+    lv_obj_t *img = create_img_obj(parent, dsc, img_free_on_delete, dsc);
+    if (!img) jpg_image_free(dsc);
+    return img;
+}
+
+#if USE_LVGL_V9
+static void img_release_on_delete(lv_event_t *e)
+{
+    img_cache_release((const lv_image_dsc_t *)lv_event_get_user_data(e));
+}
 #endif
 
-    /* 6) 创建对象 + 设置 src + 绑定删除回调(释放 pkg) */
-    lv_obj_t *img = NULL;
-    bsp_display_lock(portMAX_DELAY);
 #if USE_LVGL_V9
-    img = lv_image_create(parent);
-    if (img) {
-        lv_image_set_src(img, pkg);
-        lv_obj_add_event_cb(img, img_free_on_delete, LV_EVENT_DELETE, pkg); // ★ 删除即释放
-        lv_obj_align(img, LV_ALIGN_CENTER, 0, 0);
-    }
-#else
-    img = lv_img_create(parent);
-    if (img) {
-        lv_img_set_src(img, pkg);
-        lv_obj_add_event_cb(img, img_free_on_delete, LV_EVENT_DELETE, pkg); // ★ 删除即释放
-        lv_obj_align(img, LV_ALIGN_CENTER, 0, 0);
+/* 查共享缓存，没有就读/解码进缓存（可在后台任务调用）。成功时 *out 带一个引用，用 img_cache_release 归还；
+ * 缓存没初始化或没内存返回 ESP_ERR_NO_MEM（调用者可改用 jpg_image_load），读/解码失败返回 ESP_FAIL */
+esp_err_t jpg_image_acquire(const char *jpg_path, int view_w, int view_h, jpg_view_mode_t mode,
+                            const lv_image_dsc_t **out)
+{
+    if (!jpg_path || view_w <= 0 || view_h <= 0 || !out) return ESP_ERR_INVALID_ARG;
+
+    const lv_image_dsc_t *dsc = img_cache_get(jpg_path, view_w, view_h, mode, LV_COLOR_FORMAT_UNKNOWN);
+    if (!dsc) {
+        img_asset_t asset;
+        lv_color_format_t cf = open_source(jpg_path, view_w, view_h, mode, &asset);
+        lv_image_dsc_t *fresh = img_cache_create(jpg_path, view_w, view_h, mode, cf);
+        if (!fresh) {
+            img_asset_close(&asset);
+            return ESP_ERR_NO_MEM;
+        }
+        if (!load_pixels(jpg_path, &asset, (uint8_t *)fresh->data, view_w, view_h, mode)) {
+            img_cache_release(fresh);
+            return ESP_FAIL;
+        }
+        dsc = img_cache_commit(fresh);
     }
+    *out = dsc;
+    return ESP_OK;
+}
 #endif
-    bsp_display_unlock();
 
-    /* 7) 释放临时缓冲 */
-    jpeg_dec_close(j);
-    free(jpg_bytes);
-    jpeg_free_align(rgb565);
+/* 显示 JPG 为 lv_img/lv_image；视口大小 view_w x view_h；大图按 mode 缩小（FILL 铺满裁边 / FIT 整张留黑边），
+ * 小图不放大、居中。
+ * 有预转换的 .bin 时直接读像素；结果进共享缓存，同一张图同样大小再显示时不再读文件，
+ * 多个对象共用一份像素 */
+lv_obj_t *show_jpg_as_img(lv_obj_t *parent, const char *jpg_path, int view_w, int view_h, jpg_view_mode_t mode)
+{
+    if (!parent || !jpg_path || view_w <= 0 || view_h <= 0) return NULL;
+
+#if USE_LVGL_V9
+    const lv_image_dsc_t *dsc = NULL;
+    esp_err_t err = jpg_image_acquire(jpg_path, view_w, view_h, mode, &dsc);
+    if (err == ESP_ERR_NO_MEM) // 缓存没初始化或没内存
+        return show_jpg_as_img_uncached(parent, jpg_path, view_w, view_h, mode);
+    if (err != ESP_OK) return NULL;
 
+    lv_obj_t *img = create_img_obj(parent, dsc, img_release_on_delete, (void *)dsc);
+    if (!img) img_cache_release(dsc);
     return img;
-}
\ No newline at end of file
+#else
+    return show_jpg_as_img_uncached(parent, jpg_path, view_w, view_h, mode);
+#endif
+}
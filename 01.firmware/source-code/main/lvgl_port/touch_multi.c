@@ -0,0 +1,85 @@
+#include "esp_log.h"
+#include "esp_err.h"
+#include "esp_lcd_touch.h"
+
+#include "bsp/esp-bsp.h"
+#include "bsp_board_extra.h"
+#include "touch_multi.h"
+
+static const char *TAG = "touch_multi";
+
+// esp_lvgl_port 挂在 indev 上的 driver data（esp_lvgl_port_touch.c 里的私有结构，组件版本变了要核对）
+typedef struct
+{
+    esp_lcd_touch_handle_t handle;
+    lv_indev_t *indev;
+    struct
+    {
+        float x;
+        float y;
+    } scale;
+} port_touch_ctx_t;
+
+typedef struct
+{
+    port_touch_ctx_t *port;
+    int count;
+    lv_point_t pts[TOUCH_MULTI_MAX];
+} touch_multi_t;
+
+static touch_multi_t s_tm = {0};
+
+// 和 esp_lvgl_port 的 lvgl_port_touchpad_read 一样，只是多取一个点
+static void touch_multi_read(lv_indev_t *indev, lv_indev_data_t *data)
+{
+    port_touch_ctx_t *ctx = s_tm.port;
+    uint16_t x[TOUCH_MULTI_MAX] = {0}, y[TOUCH_MULTI_MAX] = {0};
+    uint8_t cnt = 0;
+
+    esp_lcd_touch_read_data(ctx->handle);
+    bool pressed = esp_lcd_touch_get_coordinates(ctx->handle, x, y, NULL, &cnt, TOUCH_MULTI_MAX);
+
+    s_tm.count = pressed ? cnt : 0;
+    for (int i = 0; i < s_tm.count; i++)
+    {
+        s_tm.pts[i].x = (int32_t)(ctx->scale.x * x[i]);
+        s_tm.pts[i].y = (int32_t)(ctx->scale.y * y[i]);
+    }
+
+    if (s_tm.count > 0)
+    {
+        data->point = s_tm.pts[0];
+        data->state = LV_INDEV_STATE_PRESSED;
+    }
+    else
+    {
+        data->state = LV_INDEV_STATE_RELEASED;
+    }
+}
+
+esp_err_t touch_multi_init(void)
+{
+    lv_indev_t *indev = bsp_display_get_input_dev();
+    if (!indev)
+        return ESP_ERR_INVALID_STATE;
+
+    bsp_display_lock(portMAX_DELAY);
+    port_touch_ctx_t *ctx = (port_touch_ctx_t *)lv_indev_get_driver_data(indev);
+    if (!ctx || !ctx->handle || ctx->indev != indev)
+    {
+        bsp_display_unlock();
+        ESP_LOGW(TAG, "unexpected touch driver data, pinch disabled");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    s_tm.port = ctx;
+    lv_indev_set_read_cb(indev, touch_multi_read);
+    bsp_display_unlock();
+    return ESP_OK;
+}
+
+int touch_multi_get(lv_point_t pts[TOUCH_MULTI_MAX])
+{
+    for (int i = 0; i < s_tm.count; i++)
+        pts[i] = s_tm.pts[i];
+    return s_tm.count;
+}
@@ -5,22 +5,26 @@
 #include "esp_err.h"
 #include "esp_check.h"
 #include "esp_memory_utils.h"
+#include "esp_timer.h"
 
 #include "lvgl.h"
 #include "bsp/esp-bsp.h"
 #include "bsp/display.h"
 #include "bsp_board_extra.h"
 #include "lv_demos.h"
-#include "esp_jpeg_dec.h"
 #include "avi_player.h"
 
-#include <dirent.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
 #include <ctype.h>
 
 #include "ui.h"
+#include "video_pipeline.h"
+#include "flash_clips.h"
+#include "audio_out.h"
+#include "media_index.h"
+#include "frame_prof.h"
 
 static const char *TAG = "video_audio";
 
@@ -28,13 +32,10 @@ static const char *TAG = "video_audio";
 #define DISP_HEIGHT 200
 
 static lv_obj_t *canvas = NULL;
-static lv_color_t *canvas_buf[2] = {NULL};
-static int current_buf_idx = 0;
+static int canvas_w = 0, canvas_h = 0;
 static bool loop_playback = true;
 static bool is_playing = false;
 
-static jpeg_dec_handle_t jpeg_handle = NULL;
-
 static char **avi_file_list = NULL;
 static int avi_file_count = 0;
 
@@ -57,6 +58,11 @@ static volatile bool s_video_task_exited = false;
 static volatile int s_cur_idx = 0;
 static bool s_sd_mounted = false;
 
+// clips 分区里的片段：映射后整段交给 avi_player，帧数据不拷贝直接送解码
+static flash_clip_t s_clip = {0};
+static volatile bool s_clip_playing = false;
+static volatile bool s_player_ended = true;
+
 static esp_err_t sd_mount_once(void)
 {
     if (s_sd_mounted)
@@ -92,8 +98,35 @@ typedef enum
 
 static volatile video_cmd_t s_video_cmd = CMD_NONE;
 
+static avi_player_handle_t s_avi_handle = NULL; // 播放中有效，换页/退出前清空
+static lv_obj_t *s_seek_slider = NULL;
+
 static void video_back_btn_cb(lv_event_t *e);
 
+// 拖动进度条松手后跳转（千分比 -> 毫秒）
+static void video_seek_slider_cb(lv_event_t *e)
+{
+    if (lv_event_get_code(e) != LV_EVENT_RELEASED || !s_avi_handle)
+        return;
+    uint32_t duration = 0;
+    if (avi_player_get_duration(s_avi_handle, &duration) != ESP_OK || duration == 0)
+        return;
+    int32_t v = lv_slider_get_value(lv_event_get_target(e));
+    avi_player_seek(s_avi_handle, (uint32_t)((uint64_t)duration * v / 1000));
+}
+
+// 显示端顺带刷新进度条（拖动中不刷新）
+static void video_seek_slider_update(void)
+{
+    if (!s_seek_slider || !s_avi_handle || lv_obj_has_state(s_seek_slider, LV_STATE_PRESSED))
+        return;
+    uint32_t pos = 0, duration = 0;
+    if (avi_player_get_position(s_avi_handle, &pos) != ESP_OK ||
+        avi_player_get_duration(s_avi_handle, &duration) != ESP_OK || duration == 0)
+        return;
+    lv_slider_set_value(s_seek_slider, (int32_t)((uint64_t)pos * 1000 / duration), LV_ANIM_OFF);
+}
+
 static void video_prev_btn_cb(lv_event_t *e)
 {
     if (lv_event_get_code(e) == LV_EVENT_CLICKED)
@@ -144,6 +177,13 @@ static lv_obj_t *create_video_page_and_get_status_label(void)
     lv_obj_center(lbl_next);
     lv_obj_add_event_cb(btn_next, video_next_btn_cb, LV_EVENT_CLICKED, NULL);
 
+    // 进度条：拖动跳转
+    s_seek_slider = lv_slider_create(s_video_page);
+    lv_obj_set_size(s_seek_slider, BSP_LCD_H_RES - 80, 10);
+    lv_obj_align(s_seek_slider, LV_ALIGN_BOTTOM_MID, 0, -70);
+    lv_slider_set_range(s_seek_slider, 0, 1000);
+    lv_obj_add_event_cb(s_seek_slider, video_seek_slider_cb, LV_EVENT_RELEASED, NULL);
+
     // 内容容器
     lv_obj_t *content = lv_obj_create(s_video_page);
     lv_obj_set_size(content, LV_PCT(100), BSP_LCD_V_RES - 60);
@@ -169,313 +209,353 @@ static lv_obj_t *create_video_page_and_get_status_label(void)
     return status;
 }
 
-static bool has_ext_ci(const char *name, const char *ext)
+// 没有 SD 卡或卡里没有视频时，播放 clips 分区里的片段
+static esp_err_t get_flash_clip_list(void)
 {
-    const char *p = strrchr(name, '.');
-    if (!p)
-        return false;
-    while (*p && *ext)
+    if (flash_clips_init() != ESP_OK)
+        return ESP_FAIL;
+
+    int count = flash_clips_count();
+    char **list = (char **)calloc(count, sizeof(char *));
+    if (!list)
+        return ESP_ERR_NO_MEM;
+    for (int i = 0; i < count; i++)
     {
-        char a = (char)tolower((unsigned char)*p++);
-        char b = (char)tolower((unsigned char)*ext++);
-        if (a != b)
-            return false;
+        const char *name = flash_clips_name(i);
+        size_t need = strlen(FLASH_CLIP_PREFIX) + strlen(name) + 1;
+        list[i] = (char *)malloc(need);
+        if (!list[i])
+        {
+            for (int k = 0; k < i; k++)
+                free(list[k]);
+            free(list);
+            return ESP_ERR_NO_MEM;
+        }
+        snprintf(list[i], need, "%s%s", FLASH_CLIP_PREFIX, name);
     }
-    return *p == '\0' && *ext == '\0';
+
+    avi_file_list = list;
+    avi_file_count = count;
+    s_cur_idx = 0;
+    s_video_cmd = CMD_NONE;
+    ESP_LOGI(TAG, "Found %d clips in flash", avi_file_count);
+    return ESP_OK;
 }
 
 static esp_err_t get_avi_file_list(const char *dir_path)
 {
-
-    DIR *dir = opendir(dir_path);
-    if (!dir)
+    // 目录走索引：时长/帧率在建索引时已从 avih 读出，这里不再打开文件
+    media_index_t *mi = NULL;
+    if (media_index_open(dir_path, MEDIA_AVI, &mi) != ESP_OK)
     {
         ESP_LOGE(TAG, "Failed to open directory: %s", dir_path);
         return ESP_FAIL;
     }
-
-    // 第一次遍历只数 .avi（不看 d_type）
-    struct dirent *entry;
-    int count = 0;
-    while ((entry = readdir(dir)) != NULL)
+    if (media_index_count(mi) == 0)
     {
-        if (entry->d_name[0] == '.')
-            continue; // 忽略隐藏项
-        if (has_ext_ci(entry->d_name, ".avi"))
-            count++;
-    }
-
-    if (count == 0)
-    {
-        closedir(dir);
+        media_index_release(mi);
         ESP_LOGW(TAG, "No AVI files found in directory %s", dir_path);
         return ESP_FAIL;
     }
 
-    char **list = (char **)malloc(sizeof(char *) * count);
-    if (!list)
+    char **list = NULL;
+    int count = 0;
+    if (media_index_paths(mi, &list, &count) != ESP_OK)
     {
-        closedir(dir);
+        media_index_release(mi);
         ESP_LOGE(TAG, "Failed to allocate memory for file list");
         return ESP_ERR_NO_MEM;
     }
 
-    // 第二次遍历填充完整路径
-    rewinddir(dir);
-    int idx = 0;
-    while ((entry = readdir(dir)) != NULL)
-    {
-        if (entry->d_name[0] == '.')
-            continue;
-        if (!has_ext_ci(entry->d_name, ".avi"))
-            continue;
-
-        size_t dlen = strlen(dir_path);
-        size_t flen = strlen(entry->d_name);
-        bool has_sep = (dlen > 0 && (dir_path[dlen - 1] == '/' || dir_path[dlen - 1] == '\\'));
-        size_t need = dlen + (has_sep ? 0 : 1) + flen + 1;
-
-        char *full = (char *)malloc(need);
-        if (!full)
-        {
-            ESP_LOGE(TAG, "Failed to allocate memory for file path");
-            for (int k = 0; k < idx; k++)
-                free(list[k]);
-            free(list);
-            closedir(dir);
-            return ESP_ERR_NO_MEM;
-        }
-        if (has_sep)
-            snprintf(full, need, "%s%s", dir_path, entry->d_name);
-        else
-            snprintf(full, need, "%s/%s", dir_path, entry->d_name);
-
-        // 可选：用 stat 过滤掉目录（保险）
-        struct stat st;
-        if (stat(full, &st) == 0 && S_ISDIR(st.st_mode))
-        {
-            free(full);
-            continue;
-        }
-
-        list[idx++] = full;
-        if (idx >= count)
-            break;
-    }
-    closedir(dir);
-
-    // 若中间因为 stat 过滤掉了一些，修正 avi_file_count
     avi_file_list = list;
-    avi_file_count = idx;
+    avi_file_count = count;
     s_cur_idx = 0; // ← 开始从第 0 个播
     s_video_cmd = CMD_NONE;
 
     ESP_LOGI(TAG, "Found %d AVI files in %s", avi_file_count, dir_path);
     for (int i = 0; i < avi_file_count; i++)
     {
-        ESP_LOGI(TAG, "AVI[%d/%d]: %s", i + 1, avi_file_count, avi_file_list[i]);
+        const media_entry_t *e = media_index_entry(mi, i);
+        ESP_LOGI(TAG, "AVI[%d/%d]: %s (%ux%u, %lu.%02lus, %u.%02u fps)", i + 1, avi_file_count, avi_file_list[i],
+                 e->width, e->height, (unsigned long)(e->duration_ms / 1000), (unsigned long)(e->duration_ms % 1000 / 10),
+                 e->fps_x100 / 100, e->fps_x100 % 100);
     }
+    media_index_release(mi);
 
-    return (avi_file_count > 0) ? ESP_OK : ESP_FAIL;
+    return ESP_OK;
 }
 
-static void init_canvas(void)
+// ---- 显示端：在 LVGL 任务里按节奏把解码好的帧交给画布 ----
+static video_frame_t s_shown;   // 画布当前引用的帧
+static bool s_has_shown = false;
+static video_frame_t s_pending; // 已取出但还没到显示时间的帧
+static bool s_has_pending = false;
+static lv_timer_t *s_present_timer = NULL;
+static uint32_t s_presented = 0;
+static uint32_t s_dropped_late = 0;
+
+// 帧在入队后固定延迟这么久再显示，用来吸收解码耗时抖动和 SD 卡的短暂卡顿
+#define VIDEO_PRESENT_DELAY_MS 50
+
+static void video_present_log(const video_frame_t *f)
+{
+    video_pipeline_stats_t st;
+    video_pipeline_get_stats(&st);
+    ESP_LOGI(TAG, "Frame %lu (%dx%d) comp %lu/%lu peak %lu, ready %lu/%lu, drop full %lu late %lu, dec %lums max %lums",
+             (unsigned long)s_presented, f->w, f->h,
+             (unsigned long)st.comp_queued, (unsigned long)st.comp_depth, (unsigned long)st.comp_peak,
+             (unsigned long)st.frames_ready, (unsigned long)st.frame_slots,
+             (unsigned long)st.dropped_full, (unsigned long)s_dropped_late,
+             (unsigned long)(st.last_decode_us / 1000), (unsigned long)(st.max_decode_us / 1000));
+
+    avi_player_sync_stats_t sync;
+    if (s_avi_handle && avi_player_get_sync_stats(s_avi_handle, &sync) == ESP_OK)
+    {
+        ESP_LOGI(TAG, "Sync %s clock: shown %lu, dropped %lu, drift %ldms max %ldms",
+                 sync.audio_master ? "audio" : "wall",
+                 (unsigned long)sync.frames_shown, (unsigned long)sync.frames_dropped,
+                 (long)sync.drift_ms, (long)sync.max_drift_ms);
+    }
+
+    avi_player_io_stats_t io;
+    if (s_avi_handle && avi_player_get_io_stats(s_avi_handle, &io) == ESP_OK)
+    {
+        ESP_LOGI(TAG, "SD read %lu KB in %lu reads, %lu KB/s, stall %lu/%lums, chunks in place %lu copied %lu",
+                 (unsigned long)(io.bytes_read / 1024), (unsigned long)io.read_calls, (unsigned long)io.read_kbps,
+                 (unsigned long)io.stalls, (unsigned long)io.stall_ms,
+                 (unsigned long)io.chunks_in_place, (unsigned long)io.chunks_copied);
+    }
+
+    audio_out_stats_t ao;
+    audio_out_get_stats(&ao);
+    ESP_LOGI(TAG, "Audio ring %lu/%lu peak %lu, underruns %lu, overruns %lu (%lu B dropped), max write %lums",
+             (unsigned long)ao.queued, (unsigned long)ao.capacity, (unsigned long)ao.peak,
+             (unsigned long)ao.underruns, (unsigned long)ao.overruns, (unsigned long)ao.dropped,
+             (unsigned long)(ao.max_write_us / 1000));
+}
+
+static void video_show_frame(const video_frame_t *f)
 {
-    if (canvas != NULL)
-        return;
     if (!s_video_page || !lv_obj_is_valid(s_video_page))
     {
-        ESP_LOGW("init_canvas", "video page not ready");
+        video_pipeline_release(f);
         return;
     }
 
-    int w = frame_w > 0 ? frame_w : DISP_WIDTH;
-    int h = frame_h > 0 ? frame_h : DISP_HEIGHT;
-
-    for (int i = 0; i < 2; i++)
+    if (canvas == NULL)
     {
-        if (!canvas_buf[i])
-        {
-            canvas_buf[i] = (lv_color_t *)jpeg_calloc_align(w * h * sizeof(lv_color_t), 16);
-            if (!canvas_buf[i])
-            {
-                ESP_LOGE("init_canvas", "alloc buf%d fail", i);
-                // 简单释放已分配的
-                for (int j = 0; j < i; j++)
-                {
-                    if (canvas_buf[j])
-                    {
-                        jpeg_free_align(canvas_buf[j]);
-                        canvas_buf[j] = NULL;
-                    }
-                }
-                return;
-            }
-        }
+        canvas = lv_canvas_create(s_video_page);
+        lv_obj_move_foreground(canvas); // 确保在最上层
+        canvas_w = canvas_h = 0;
     }
+    lv_canvas_set_buffer(canvas, f->buf, f->w, f->h, LV_COLOR_FORMAT_RGB565);
+    if (canvas_w != f->w || canvas_h != f->h)
+    {
+        lv_obj_set_size(canvas, f->w, f->h);
+        lv_obj_center(canvas);
+        canvas_w = f->w;
+        canvas_h = f->h;
+    }
+    lv_obj_invalidate(canvas);
 
-    canvas = lv_canvas_create(s_video_page);
-    lv_canvas_set_buffer(canvas, canvas_buf[0], w, h, LV_COLOR_FORMAT_RGB565);
-    lv_obj_set_size(canvas, w, h);
-    lv_obj_center(canvas);
-    lv_obj_move_foreground(canvas); // 确保在最上层
-}
+    // 画布已切到新帧，旧帧归还给解码任务
+    if (s_has_shown)
+        video_pipeline_release(&s_shown);
+    s_shown = *f;
+    s_has_shown = true;
+    frame_prof_tick(FRAME_PROF_VIDEO_PRESENT);
+    frame_prof_record(FRAME_PROF_VIDEO_LATENCY, (uint32_t)(esp_timer_get_time() - f->arrive_us));
 
-static esp_err_t init_jpeg_decoder(void)
-{
-    if (jpeg_handle != NULL)
+    if ((s_presented++ % 30) == 0)
     {
-        return ESP_OK;
+        video_present_log(f);
+        video_seek_slider_update();
     }
+}
 
-    jpeg_dec_config_t config = DEFAULT_JPEG_DEC_CONFIG();
-    config.output_type = JPEG_PIXEL_FORMAT_RGB565_LE;
+static void video_present_timer_cb(lv_timer_t *t)
+{
+    int64_t now = esp_timer_get_time();
+    video_frame_t cand;
+    bool has_cand = false;
 
-    jpeg_error_t err = jpeg_dec_open(&config, &jpeg_handle);
-    if (err != JPEG_ERR_OK)
+    // 取出所有已到时间的帧，只显示最新的那一帧，其余算作过期丢弃
+    while (1)
     {
-        ESP_LOGE("init_jpeg_decoder", "JPEG decoder initialization failed: %d", err);
-        return ESP_FAIL;
+        if (!s_has_pending)
+        {
+            if (!video_pipeline_acquire(&s_pending))
+                break;
+            s_has_pending = true;
+        }
+        if (s_pending.arrive_us + VIDEO_PRESENT_DELAY_MS * 1000 > now)
+            break;
+
+        if (has_cand)
+        {
+            video_pipeline_release(&cand);
+            s_dropped_late++;
+        }
+        cand = s_pending;
+        has_cand = true;
+        s_has_pending = false;
     }
 
-    return ESP_OK;
+    if (has_cand)
+        video_show_frame(&cand);
 }
 
-static void deinit_jpeg_decoder(void)
+// 清掉显示端对帧环的所有引用（调用方持有显示锁）
+static void video_present_reset(void)
 {
-    if (jpeg_handle != NULL)
+    if (canvas)
     {
-        jpeg_dec_close(jpeg_handle);
-        jpeg_handle = NULL;
+        lv_obj_del(canvas);
+        canvas = NULL;
     }
+    s_has_shown = false;
+    s_has_pending = false;
 }
 
-static void video_cb(frame_data_t *data, void *arg)
-{
-    static uint32_t frame_no = 0;
-    if (s_video_stop_req)
-        return;
-    if (!data || !data->data || data->data_bytes == 0)
-        return;
+// ---- 直出模式：播放中暂停 LVGL，解码条带直接送屏；一碰屏幕就回到 LVGL 显示控件 ----
+#define VIDEO_OVERLAY_IDLE_MS 3000 // 控件无操作这么久后重新进入直出
 
-    if (init_jpeg_decoder() != ESP_OK)
+static bool s_direct = false;
+static uint32_t s_direct_polls = 0;
+
+// 以下两个函数调用方持有显示锁
+static void video_direct_enter(void)
+{
+    if (s_direct || frame_w == 0)
         return;
 
-    // 先解析 JPEG 头，拿到真实宽高
-    jpeg_dec_io_t io = {
-        .inbuf = data->data,
-        .inbuf_len = data->data_bytes,
-        .outbuf = NULL, // 稍后指定
+    video_direct_config_t dcfg = {
+        .disp_w = BSP_LCD_H_RES,
+        .disp_h = BSP_LCD_V_RES,
+        .present_delay_ms = VIDEO_PRESENT_DELAY_MS,
     };
-    jpeg_dec_header_info_t hi;
-    jpeg_error_t err = jpeg_dec_parse_header(jpeg_handle, &io, &hi);
-    if (err != JPEG_ERR_OK)
-    {
-        ESP_LOGE("video_cb", "parse hdr=%d", err);
+    if (bsp_display_get_panel(&dcfg.panel, &dcfg.io) != ESP_OK)
         return;
-    }
-
-    int w = hi.width;
-    int h = hi.height;
-
-    // 需要时重建画布和双缓冲（帧尺寸变化或首次）
-    bool need_recreate = (canvas == NULL) || (w != frame_w) || (h != frame_h);
-    if (need_recreate)
+    // LVGL 最后一块可能还在总线上，等它传完再把面板 IO 的完成回调交给直出
+    if (bsp_display_take_panel(100) != ESP_OK)
+        return;
+    if (video_pipeline_direct_enable(&dcfg) != ESP_OK)
     {
-        // 释放旧画布与缓冲
-        bsp_display_lock(0);
-        if (canvas)
-        {
-            lv_obj_del(canvas);
-            canvas = NULL;
-        }
-        bsp_display_unlock();
-        for (int i = 0; i < 2; i++)
-        {
-            if (canvas_buf[i])
-            {
-                jpeg_free_align(canvas_buf[i]);
-                canvas_buf[i] = NULL;
-            }
-        }
-        frame_w = w;
-        frame_h = h;
-        current_buf_idx = 0;
-        init_canvas(); // 重新用新尺寸建画布
-        if (!canvas)
-            return;
+        bsp_display_give_panel();
+        return; // 尺寸不合适就一直走 LVGL
     }
+    lvgl_port_stop();
+    // 触摸中断照样会唤醒 LVGL 任务去读 indev，直出期间关掉，只由 video_direct_poll 读
+    lv_indev_enable(bsp_display_get_input_dev(), false);
+    s_direct = true;
+}
 
-    int next = (current_buf_idx + 1) % 2;
-
-    int out_len = 0;
-    err = jpeg_dec_get_outbuf_len(jpeg_handle, &out_len);
-    if (err != JPEG_ERR_OK)
-    {
-        ESP_LOGE("video_cb", "get out len=%d", err);
+static void video_direct_leave(void)
+{
+    if (!s_direct)
         return;
+    video_present_reset(); // 退出时帧环会清空，先放掉显示端的引用
+    video_pipeline_direct_disable();
+    bsp_display_give_panel(); // 直出摘掉了回调，LVGL 的送屏完成要接回来
+    lv_indev_enable(bsp_display_get_input_dev(), true);
+    lvgl_port_resume();
+    lv_obj_invalidate(lv_screen_active()); // 控件已被视频盖掉，整屏重画
+    s_direct = false;
+}
+
+// 播放任务里每轮调用一次
+static void video_direct_poll(void)
+{
+    bsp_display_lock(0);
+    if (s_direct)
+    {
+        // indev 直出期间是关着的，持锁时 LVGL 任务读不了，这里临时打开自己读一次；
+        // 按下就退出直出（退出时保持打开），这次按下照常交给控件
+        lv_indev_t *indev = bsp_display_get_input_dev();
+        lv_indev_enable(indev, true);
+        lv_indev_read(indev);
+        if (lv_indev_get_state(indev) == LV_INDEV_STATE_PRESSED)
+            video_direct_leave();
+        else
+            lv_indev_enable(indev, false);
     }
-    int need = w * h * 2; // RGB565
-    if (out_len > need)
+    else if (lv_display_get_inactive_time(NULL) > VIDEO_OVERLAY_IDLE_MS &&
+             !(s_seek_slider && lv_obj_has_state(s_seek_slider, LV_STATE_PRESSED)))
     {
-        ESP_LOGE("video_cb", "decoder reports %d > need %d (w=%d h=%d)", out_len, need, w, h);
-        // 继续按 need 解码
+        video_direct_enter();
     }
+    bsp_display_unlock();
 
-    // 真正把像素“解码到 next 缓冲”
-    io.outbuf = (uint8_t *)canvas_buf[next];
-    err = jpeg_dec_process(jpeg_handle, &io);
-    if (err != JPEG_ERR_OK)
+    if (s_direct && (s_direct_polls++ % 50) == 0)
     {
-        ESP_LOGE("video_cb", "decode=%d", err);
-        return;
+        video_pipeline_stats_t st;
+        video_pipeline_get_stats(&st);
+        ESP_LOGI(TAG, "Direct %lu frames, dec+tx %lums, comp peak %lu, drop full %lu, errors %lu",
+                 (unsigned long)st.direct_frames, (unsigned long)(st.last_direct_us / 1000),
+                 (unsigned long)st.comp_peak, (unsigned long)st.dropped_full, (unsigned long)st.decode_errors);
     }
+}
 
-    if (!s_video_page || !lv_obj_is_valid(s_video_page))
+static void video_cb(frame_data_t *data, void *arg)
+{
+    if (s_video_stop_req)
+        return;
+    if (!data || !data->data || data->data_bytes == 0)
         return;
 
-    // 切换显示到 next 缓冲
-    bsp_display_lock(0);
-    if (canvas)
+    // 首帧或换集后尺寸变化：按 AVI 头里的尺寸重建解码帧环
+    int w = data->video_info.width;
+    int h = data->video_info.height;
+    if (w != frame_w || h != frame_h)
     {
-        if (need_recreate)
-        {
-            lv_canvas_set_buffer(canvas, canvas_buf[next], w, h, LV_COLOR_FORMAT_RGB565);
-            lv_obj_set_size(canvas, w, h);
-            lv_obj_center(canvas);
-        }
-        else
+        bsp_display_lock(0);
+        video_direct_leave(); // 新尺寸不一定能直出，先回到 LVGL，空闲后再进
+        video_present_reset();
+        esp_err_t err = video_pipeline_set_frame_size(w, h);
+        bsp_display_unlock();
+        if (err != ESP_OK)
         {
-            lv_canvas_set_buffer(canvas, canvas_buf[next], frame_w, frame_h, LV_COLOR_FORMAT_RGB565);
+            ESP_LOGE("video_cb", "frame ring %dx%d: %s", w, h, esp_err_to_name(err));
+            frame_w = frame_h = 0;
+            return;
         }
-        current_buf_idx = next;
-        lv_obj_invalidate(canvas);
+        frame_w = w;
+        frame_h = h;
     }
-    bsp_display_unlock();
 
-    if ((frame_no++ % 30) == 0)
-    {
-        ESP_LOGI("video_cb", "Frame %lu (%dx%d)", (unsigned long)frame_no, w, h);
-    }
+    // 只做一次拷贝入队，解码交给 core 1 上的解码任务；flash 片段连这次拷贝也省了
+    if (s_clip_playing)
+        video_pipeline_push_ref(data->data, data->data_bytes);
+    else
+        video_pipeline_push(data->data, data->data_bytes);
 }
 
+// 环满说明音频已经领先很多，稍等一下写入任务腾位置，再满就丢
+#define AUDIO_WRITE_TIMEOUT_MS 100
+
 static void audio_cb(frame_data_t *data, void *arg)
 {
     if (data && data->type == FRAME_TYPE_AUDIO && data->data && data->data_bytes > 0)
     {
-        size_t bytes_written = 0;
-        esp_err_t err = bsp_extra_i2s_write(data->data, data->data_bytes, &bytes_written, portMAX_DELAY);
-        if (err != ESP_OK)
-        {
-            ESP_LOGE(TAG, "Audio write failed: %s", esp_err_to_name(err));
-        }
-        else if (bytes_written != data->data_bytes)
+        // 只拷进 PCM 环，写 I2S 交给 audio_out 的写入任务，解析不再等 DMA
+        size_t queued = audio_out_write(data->data, data->data_bytes, AUDIO_WRITE_TIMEOUT_MS);
+        if (queued != data->data_bytes)
         {
-            ESP_LOGW(TAG, "Incomplete audio data (wrote %d/%d bytes)", bytes_written, data->data_bytes);
+            ESP_LOGW(TAG, "Audio ring full (queued %d/%d bytes)", queued, data->data_bytes);
         }
     }
 }
 
+static size_t audio_queued_callback(void *arg)
+{
+    return audio_out_queued();
+}
+
+static void audio_flush_callback(void *arg)
+{
+    audio_out_flush();
+}
+
 static void audio_set_clock_callback(uint32_t rate, uint32_t bits_cfg, uint32_t ch, void *arg)
 {
     if (rate == 0)
@@ -490,8 +570,8 @@ static void audio_set_clock_callback(uint32_t rate, uint32_t bits_cfg, uint32_t
     }
 
     ESP_LOGI(TAG, "Setting I2S clock: sample rate=%u, bit width=%u, channels=%u", rate, bits_cfg, ch);
-    i2s_slot_mode_t slot_mode = (ch == 2) ? I2S_SLOT_MODE_STEREO : I2S_SLOT_MODE_MONO;
-    esp_err_t err = bsp_extra_codec_set_fs(rate, bits_cfg, slot_mode);
+    // 环里上一集的尾巴先按旧格式播完
+    esp_err_t err = audio_out_set_format(rate, bits_cfg, ch);
     if (err != ESP_OK)
     {
         ESP_LOGE(TAG, "Failed to set codec parameters: %s", esp_err_to_name(err));
@@ -502,6 +582,89 @@ static void avi_end_cb(void *arg)
 {
     ESP_LOGI(TAG, "AVI playback finished");
     is_playing = false;
+    s_player_ended = true;
+}
+
+static volatile bool s_next_started = false;
+
+static void avi_next_cb(void *arg)
+{
+    // 预先打开的下一集已经无缝接上，播放任务里再排下一集
+    s_next_started = true;
+}
+
+static bool is_flash_clip(const char *path)
+{
+    return strncmp(path, FLASH_CLIP_PREFIX, strlen(FLASH_CLIP_PREFIX)) == 0;
+}
+
+// 趁当前这集还在播，提前打开并解析下一集，播完直接接上，不停播放器、不重配 codec
+static void video_queue_next(avi_player_handle_t handle)
+{
+    int next = (s_cur_idx + 1) % avi_file_count;
+    // flash 片段映射即播，不需要预开；也不能和 SD 文件无缝衔接（映射要等播放器停下才能释放）
+    if (s_clip_playing || is_flash_clip(avi_file_list[next]))
+        return;
+    if (avi_player_set_next_file(handle, avi_file_list[next]) != ESP_OK)
+    {
+        ESP_LOGW(TAG, "Cannot queue %s, will stop between episodes", avi_file_list[next]);
+    }
+}
+
+// 等播放器的结束回调；avi_player_play_stop 只是发个事件，播放任务处理完才会回调
+static bool video_wait_player_end(uint32_t timeout_ms)
+{
+    for (uint32_t t = 0; t < timeout_ms && !s_player_ended; t += 10)
+        vTaskDelay(pdMS_TO_TICKS(10));
+    return s_player_ended;
+}
+
+// 播放器停下后才能解除映射，解码队列里引用映射的帧也要先丢掉。
+// 还在播就先叫停；等不到结束回调时映射留着不还（漏掉这段地址空间），不能让播放器去读已解除的映射
+static void video_release_clip(avi_player_handle_t handle)
+{
+    if (!s_clip.data)
+        return;
+    if (!s_player_ended && handle)
+        avi_player_play_stop(handle);
+    s_clip_playing = false;
+    if (!video_wait_player_end(2000))
+    {
+        ESP_LOGE(TAG, "player did not stop, leaving clip mapped");
+        s_clip = (flash_clip_t){0};
+        return;
+    }
+    video_pipeline_flush();
+    flash_clips_unmap(&s_clip);
+}
+
+// "flash:" 开头的条目从 clips 分区映射播放，其余是 SD 卡上的文件
+static esp_err_t video_play_entry(avi_player_handle_t handle, const char *path)
+{
+    video_release_clip(handle);
+    if (!is_flash_clip(path))
+    {
+        s_player_ended = false;
+        esp_err_t err = avi_player_play_from_file(handle, path);
+        s_player_ended = err != ESP_OK;
+        return err;
+    }
+
+    esp_err_t err = flash_clips_map(path + strlen(FLASH_CLIP_PREFIX), &s_clip);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "map %s: %s", path, esp_err_to_name(err));
+        return err;
+    }
+    s_clip_playing = true;
+    s_player_ended = false;
+    err = avi_player_play_from_memory(handle, (uint8_t *)s_clip.data, s_clip.size);
+    if (err != ESP_OK)
+    {
+        s_player_ended = true;
+        video_release_clip(handle);
+    }
+    return err;
 }
 
 static void avi_play_task(void *arg)
@@ -514,21 +677,44 @@ static void avi_play_task(void *arg)
         .video_cb = video_cb,
         .audio_cb = audio_cb,
         .audio_set_clock_cb = audio_set_clock_callback,
+        .audio_queued_cb = audio_queued_callback,
+        .audio_flush_cb = audio_flush_callback,
         .avi_play_end_cb = avi_end_cb,
+        .avi_play_next_cb = avi_next_cb,
         .priority = 7,
         .coreID = 0,
         .user_data = NULL,
         .stack_size = 12 * 1024,
+        // PCM 环里的存量由 audio_queued_cb 扣掉；再加上 I2S 默认 6 个 DMA 描述符 x 240 帧，约 32ms 还在 DMA 里
+        .audio_latency_ms = 32,
+        // 帧交给 video_cb 后还要解码，再等呈现延时才上屏
+        .video_latency_ms = VIDEO_PRESENT_DELAY_MS,
+        // SD 卡按 64KB 对齐整块预读到 PSRAM 环里，帧数据大多直接在环里交给回调
+        .read_block_size = 64 * 1024,
+        .read_block_count = 4,
 #if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 1, 0)
         .stack_in_psram = false,
 #endif
     };
 
+    // 解码任务放到 core 1，avi_player 任务（core 0）只负责读文件和写音频
+    video_pipeline_config_t pl_cfg = VIDEO_PIPELINE_DEFAULT_CONFIG();
+    pl_cfg.frame_slots = 4;
+    ESP_ERROR_CHECK(video_pipeline_start(&pl_cfg));
+    frame_w = frame_h = 0;
+
     bsp_display_lock(0);
-    init_canvas();
+    s_presented = 0;
+    s_dropped_late = 0;
+    s_present_timer = lv_timer_create(video_present_timer_cb, 5, NULL);
     bsp_display_unlock();
 
+    // 音频写入任务和 avi_player 同在 core 0，优先级更高，DMA 一有空位就补上
+    audio_out_config_t ao_cfg = AUDIO_OUT_DEFAULT_CONFIG();
+    ESP_ERROR_CHECK(audio_out_start(&ao_cfg));
+
     ESP_ERROR_CHECK(avi_player_init(cfg, &handle));
+    s_avi_handle = handle;
 
     while (loop_playback && !s_video_stop_req)
     { // ← 关键改动
@@ -553,7 +739,8 @@ static void avi_play_task(void *arg)
             break;
 
         is_playing = true;
-        esp_err_t err = avi_player_play_from_file(handle, path);
+        s_next_started = false;
+        esp_err_t err = video_play_entry(handle, path);
         if (err != ESP_OK)
         {
             is_playing = false;
@@ -561,14 +748,26 @@ static void avi_play_task(void *arg)
             s_cur_idx = (s_cur_idx + 1) % avi_file_count;
             continue;
         }
+        video_queue_next(handle);
 
         // 播放中轮询命令/停止
         while (!s_video_stop_req && is_playing)
         {
+            video_direct_poll();
+            if (s_next_started)
+            {
+                s_next_started = false;
+                s_cur_idx = (s_cur_idx + 1) % avi_file_count;
+                ESP_LOGI(TAG, "Gapless to AVI[%d/%d]", s_cur_idx + 1, avi_file_count);
+                video_queue_next(handle);
+            }
             if (s_video_cmd == CMD_NEXT || s_video_cmd == CMD_PREV)
             {
-                // 中断当前播放
+                // 中断当前播放，环里没播完的音频一起丢掉。停止是异步的，等结束回调之后播放器不会再往环里写，
+                // 这时再清才清得干净
                 avi_player_play_stop(handle);
+                video_wait_player_end(2000);
+                audio_out_flush();
                 is_playing = false;
                 int delta = (s_video_cmd == CMD_NEXT) ? +1 : -1;
                 s_cur_idx = (s_cur_idx + delta + avi_file_count) % avi_file_count;
@@ -586,25 +785,28 @@ static void avi_play_task(void *arg)
     }
 
     // —— 收尾清理不变 —— //
+    bsp_display_lock(0);
+    s_avi_handle = NULL;
+    bsp_display_unlock();
     avi_player_play_stop(handle);
-    avi_player_deinit(handle);
-    deinit_jpeg_decoder();
+    // 反初始化超时说明播放任务还在，s_player_ended 不能硬置，映射交给 video_release_clip 决定
+    if (avi_player_deinit(handle) == ESP_OK)
+        s_player_ended = true;
+    audio_out_stop();
+    video_release_clip(NULL);
 
+    // 先让显示端放手，再释放帧环
     bsp_display_lock(0);
-    for (int i = 0; i < 2; i++)
-    {
-        if (canvas_buf[i])
-        {
-            jpeg_free_align(canvas_buf[i]);
-            canvas_buf[i] = NULL;
-        }
-    }
-    if (canvas)
+    video_direct_leave();
+    if (s_present_timer)
     {
-        lv_obj_del(canvas);
-        canvas = NULL;
+        lv_timer_del(s_present_timer);
+        s_present_timer = NULL;
     }
+    video_present_reset();
     bsp_display_unlock();
+    video_pipeline_stop();
+    frame_w = frame_h = 0;
 
     if (avi_file_list)
     {
@@ -641,6 +843,7 @@ static void wait_exit_then_switch_cb(lv_timer_t *t)
     lv_obj_t *page = page_main_create();
     lv_scr_load_anim(page, LV_SCR_LOAD_ANIM_MOVE_RIGHT, 200, 0, true);
     s_video_page = NULL;
+    s_seek_slider = NULL;
     lv_timer_del(t);
 }
 
@@ -742,31 +945,29 @@ static void video_start_worker(void *arg)
     esp_err_t mount_err = sd_mount_once();   // ← 只挂载一次
     if (s_video_stop_req) goto EXIT;
 
-    if (mount_err != ESP_OK)
-    {
-        bsp_display_lock(0);
-        if (status_label) {
-            lv_label_set_text(status_label, "SD card mount failed");
-            lv_obj_set_style_text_color(status_label, lv_color_hex(0xFF0000), 0);
-        }
-        bsp_display_unlock();
-        goto EXIT;   // 允许返回键退出
-    }
-
     // —— 读取 AVI 列表 —— 
     const char *dir = "/sdcard/am_nr";   // 按你的目录
-    esp_err_t list_err = get_avi_file_list(dir);
+    esp_err_t list_err = mount_err == ESP_OK ? get_avi_file_list(dir) : mount_err;
     if (s_video_stop_req) goto EXIT;
 
+    if (list_err != ESP_OK || avi_file_count == 0)
+    {
+        // 没卡或卡里没有视频：改播 flash 里的片段
+        list_err = get_flash_clip_list();
+    }
+
     if (list_err != ESP_OK || avi_file_count == 0)
     {
         bsp_display_lock(0);
         if (status_label) {
-            lv_label_set_text_fmt(status_label, "No AVI files found\nin %s", dir);
+            if (mount_err != ESP_OK)
+                lv_label_set_text(status_label, "SD card mount failed");
+            else
+                lv_label_set_text_fmt(status_label, "No AVI files found\nin %s", dir);
             lv_obj_set_style_text_color(status_label, lv_color_hex(0xFF0000), 0);
         }
         bsp_display_unlock();
-        goto EXIT;
+        goto EXIT;   // 允许返回键退出
     }
 
     // 删除提示，开始播放
@@ -777,7 +978,7 @@ static void video_start_worker(void *arg)
     }
     bsp_display_unlock();
 
-    ESP_LOGI(TAG, "SD mounted, found %d AVI files", avi_file_count);
+    ESP_LOGI(TAG, "found %d AVI files", avi_file_count);
 
     // 把页面指针传给 avi_play_task（用于在该页面显示视频）
     xTaskCreatePinnedToCore(avi_play_task, "avi_play_task", 12288,
@@ -0,0 +1,702 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_err.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "esp_attr.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_ops.h"
+
+#include "esp_jpeg_dec.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "video_pipeline.h"
+#include "frame_prof.h"
+
+static const char *TAG = "video_pipeline";
+
+#define DIRECT_STRIPS 2       // 一条在传，一条在解
+#define DIRECT_STRIP_LINES 16 // 块模式每次输出一个 MCU 行，8 或 16 行
+
+// 压缩帧槽：读取端写入，解码任务读取
+typedef struct
+{
+    uint8_t *buf;
+    size_t cap;
+    const uint8_t *data; // 待解码数据：指向 buf，或 push_ref 时调用方的缓冲
+    size_t len;
+    uint32_t seq;
+    int64_t arrive_us;
+} comp_slot_t;
+
+// 解码帧槽：解码任务写入，显示端读取
+typedef struct
+{
+    uint8_t *buf;
+    uint16_t w;
+    uint16_t h;
+    uint32_t seq;
+    int64_t arrive_us;
+} frame_slot_t;
+
+// 直出模式：块解码成屏幕字节序的条带，条带缓冲放内部 DMA 内存
+typedef struct
+{
+    video_direct_config_t cfg;
+    volatile bool active;
+    jpeg_dec_handle_t jpeg; // RGB565_BE 块模式，和帧环用的解码器分开
+    uint8_t *strip[DIRECT_STRIPS];
+    size_t strip_cap;
+    SemaphoreHandle_t strip_free; // 空闲条带数，传输完成回调里归还
+} direct_t;
+
+typedef struct
+{
+    video_pipeline_config_t cfg;
+
+    comp_slot_t *comp;
+    frame_slot_t *frames;
+    size_t frame_cap; // 每帧字节数（w*h*2）
+    int frame_w;
+    int frame_h;
+
+    QueueHandle_t comp_free;   // 空闲压缩槽索引
+    QueueHandle_t comp_full;   // 待解码压缩槽索引
+    QueueHandle_t frame_free;  // 空闲帧索引
+    QueueHandle_t frame_ready; // 已解码帧索引（按顺序）
+
+    SemaphoreHandle_t mux;  // 解码一帧期间持有；重建帧环时用来等解码任务空闲
+    SemaphoreHandle_t done; // 解码任务退出信号
+    TaskHandle_t task;
+    volatile bool running;
+
+    jpeg_dec_handle_t jpeg;
+    uint32_t seq;
+
+    direct_t direct;
+    video_pipeline_stats_t st;
+} pipeline_t;
+
+static pipeline_t s_pl;
+
+static void drain_queue(QueueHandle_t q)
+{
+    int idx;
+    while (xQueueReceive(q, &idx, 0) == pdTRUE)
+    {
+    }
+}
+
+// 把所有槽位放回空闲队列（调用方持有 mux）
+static void reset_queues(void)
+{
+    drain_queue(s_pl.comp_full);
+    drain_queue(s_pl.comp_free);
+    drain_queue(s_pl.frame_ready);
+    drain_queue(s_pl.frame_free);
+
+    for (int i = 0; i < s_pl.cfg.comp_slots; i++)
+        xQueueSend(s_pl.comp_free, &i, 0);
+    if (s_pl.frame_cap > 0)
+    {
+        for (int i = 0; i < s_pl.cfg.frame_slots; i++)
+            xQueueSend(s_pl.frame_free, &i, 0);
+    }
+}
+
+static void free_frames(void)
+{
+    if (!s_pl.frames)
+        return;
+    for (int i = 0; i < s_pl.cfg.frame_slots; i++)
+    {
+        if (s_pl.frames[i].buf)
+        {
+            jpeg_free_align(s_pl.frames[i].buf);
+            s_pl.frames[i].buf = NULL;
+        }
+    }
+    s_pl.frame_cap = 0;
+}
+
+static bool decode_one(comp_slot_t *cs, frame_slot_t *fs)
+{
+    jpeg_dec_io_t io = {
+        .inbuf = (uint8_t *)cs->data,
+        .inbuf_len = (int)cs->len,
+    };
+    jpeg_dec_header_info_t hi;
+    jpeg_error_t err = jpeg_dec_parse_header(s_pl.jpeg, &io, &hi);
+    if (err != JPEG_ERR_OK)
+    {
+        ESP_LOGE(TAG, "parse hdr=%d", err);
+        return false;
+    }
+
+    size_t need = (size_t)hi.width * hi.height * 2; // RGB565
+    if (need > s_pl.frame_cap)
+    {
+        ESP_LOGE(TAG, "frame %dx%d > ring %u bytes", hi.width, hi.height, (unsigned)s_pl.frame_cap);
+        return false;
+    }
+
+    io.outbuf = fs->buf;
+    err = jpeg_dec_process(s_pl.jpeg, &io);
+    if (err != JPEG_ERR_OK)
+    {
+        ESP_LOGE(TAG, "decode=%d", err);
+        return false;
+    }
+
+    fs->w = hi.width;
+    fs->h = hi.height;
+    fs->seq = cs->seq;
+    fs->arrive_us = cs->arrive_us;
+    return true;
+}
+
+static IRAM_ATTR bool direct_trans_done(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
+{
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(s_pl.direct.strip_free, &woken);
+    return woken == pdTRUE;
+}
+
+// 按块解码，每块一条送屏；面板按顺序传完，所以最早送出的那条先空出来
+static bool decode_direct(comp_slot_t *cs)
+{
+    direct_t *d = &s_pl.direct;
+    jpeg_dec_io_t io = {
+        .inbuf = (uint8_t *)cs->data,
+        .inbuf_len = (int)cs->len,
+    };
+    jpeg_dec_header_info_t hi;
+    jpeg_error_t err = jpeg_dec_parse_header(d->jpeg, &io, &hi);
+    if (err != JPEG_ERR_OK)
+    {
+        ESP_LOGE(TAG, "parse hdr=%d", err);
+        return false;
+    }
+    if (hi.width > d->cfg.disp_w || hi.height > d->cfg.disp_h || (hi.width % 8) || (hi.height % 8))
+    {
+        ESP_LOGE(TAG, "direct: frame %dx%d not supported", hi.width, hi.height);
+        return false;
+    }
+
+    int count = 0;
+    int block_len = 0;
+    jpeg_dec_get_process_count(d->jpeg, &count);
+    jpeg_dec_get_outbuf_len(d->jpeg, &block_len);
+    if (block_len > (int)d->strip_cap)
+    {
+        ESP_LOGE(TAG, "direct: block %d > strip %u bytes", block_len, (unsigned)d->strip_cap);
+        return false;
+    }
+
+    // 居中；SH8601 要求起点对齐到偶数像素，宽高已是 8 的倍数
+    int x = ((d->cfg.disp_w - hi.width) / 2) & ~1;
+    int y = ((d->cfg.disp_h - hi.height) / 2) & ~1;
+    for (int i = 0; i < count; i++)
+    {
+        if (xSemaphoreTake(d->strip_free, pdMS_TO_TICKS(100)) != pdTRUE)
+        {
+            ESP_LOGE(TAG, "direct: strip transfer timeout");
+            return false;
+        }
+        uint8_t *strip = d->strip[i % DIRECT_STRIPS];
+        io.outbuf = strip;
+        err = jpeg_dec_process(d->jpeg, &io);
+        if (err != JPEG_ERR_OK)
+        {
+            xSemaphoreGive(d->strip_free);
+            ESP_LOGE(TAG, "decode=%d", err);
+            return false;
+        }
+        int lines = io.out_size / (hi.width * 2);
+        if (esp_lcd_panel_draw_bitmap(d->cfg.panel, x, y, x + hi.width, y + lines, strip) != ESP_OK)
+        {
+            xSemaphoreGive(d->strip_free);
+            return false;
+        }
+        y += lines;
+    }
+    return true;
+}
+
+// 直出模式下不等帧环，按“入队时间 + 呈现延时 - 上一帧耗时”踩点开始解码
+static bool direct_wait_due(int ci)
+{
+    int64_t start = s_pl.comp[ci].arrive_us + (int64_t)s_pl.direct.cfg.present_delay_ms * 1000 - s_pl.st.last_direct_us;
+    int64_t wait_ms = (start - esp_timer_get_time()) / 1000;
+    if (wait_ms <= 0)
+        return true;
+    vTaskDelay(pdMS_TO_TICKS(wait_ms > 50 ? 50 : wait_ms));
+    return false;
+}
+
+static void decoder_task(void *arg)
+{
+    while (s_pl.running)
+    {
+        int ci, fi;
+
+        // 先不持锁地等“有输入 + 有空闲帧”，避免重建帧环时互相等死
+        if (xQueuePeek(s_pl.comp_full, &ci, pdMS_TO_TICKS(50)) != pdTRUE)
+            continue;
+        if (s_pl.direct.active)
+        {
+            if (!direct_wait_due(ci))
+                continue; // 醒来后重新检查队列和模式
+        }
+        else if (xQueuePeek(s_pl.frame_free, &fi, pdMS_TO_TICKS(50)) != pdTRUE)
+            continue;
+
+        xSemaphoreTake(s_pl.mux, portMAX_DELAY);
+        if (xQueueReceive(s_pl.comp_full, &ci, 0) != pdTRUE)
+        {
+            xSemaphoreGive(s_pl.mux);
+            continue; // 被清空了
+        }
+
+        if (s_pl.direct.active)
+        {
+            int64_t t0 = esp_timer_get_time();
+            int64_t arrive = s_pl.comp[ci].arrive_us;
+            bool ok = decode_direct(&s_pl.comp[ci]);
+            xQueueSend(s_pl.comp_free, &ci, 0);
+            if (ok)
+            {
+                int64_t now = esp_timer_get_time();
+                s_pl.st.decoded++;
+                s_pl.st.direct_frames++;
+                s_pl.st.last_direct_us = (uint32_t)(now - t0);
+                // 最后一条还在传，按送完算上屏
+                frame_prof_record(FRAME_PROF_VIDEO_DECODE, s_pl.st.last_direct_us);
+                frame_prof_record(FRAME_PROF_VIDEO_LATENCY, (uint32_t)(now - arrive));
+                frame_prof_tick(FRAME_PROF_VIDEO_PRESENT);
+            }
+            else
+            {
+                s_pl.st.decode_errors++;
+            }
+            xSemaphoreGive(s_pl.mux);
+            continue;
+        }
+
+        if (xQueueReceive(s_pl.frame_free, &fi, 0) != pdTRUE)
+        {
+            xQueueSendToFront(s_pl.comp_full, &ci, 0);
+            xSemaphoreGive(s_pl.mux);
+            continue;
+        }
+
+        int64_t t0 = esp_timer_get_time();
+        bool ok = decode_one(&s_pl.comp[ci], &s_pl.frames[fi]);
+        uint32_t cost = (uint32_t)(esp_timer_get_time() - t0);
+
+        xQueueSend(s_pl.comp_free, &ci, 0);
+        if (ok)
+        {
+            s_pl.st.decoded++;
+            s_pl.st.last_decode_us = cost;
+            if (cost > s_pl.st.max_decode_us)
+                s_pl.st.max_decode_us = cost;
+            frame_prof_record(FRAME_PROF_VIDEO_DECODE, cost);
+            xQueueSend(s_pl.frame_ready, &fi, 0);
+        }
+        else
+        {
+            s_pl.st.decode_errors++;
+            xQueueSend(s_pl.frame_free, &fi, 0);
+        }
+        xSemaphoreGive(s_pl.mux);
+    }
+
+    xSemaphoreGive(s_pl.done);
+    vTaskDelete(NULL);
+}
+
+esp_err_t video_pipeline_start(const video_pipeline_config_t *cfg)
+{
+    if (s_pl.running)
+        return ESP_OK;
+
+    video_pipeline_config_t def = VIDEO_PIPELINE_DEFAULT_CONFIG();
+    memset(&s_pl, 0, sizeof(s_pl));
+    s_pl.cfg = cfg ? *cfg : def;
+    if (s_pl.cfg.comp_slots <= 0)
+        s_pl.cfg.comp_slots = def.comp_slots;
+    if (s_pl.cfg.frame_slots <= 1)
+        s_pl.cfg.frame_slots = def.frame_slots; // 至少一帧显示 + 一帧解码
+    if (s_pl.cfg.comp_slot_size == 0)
+        s_pl.cfg.comp_slot_size = def.comp_slot_size;
+    if (s_pl.cfg.decoder_stack == 0)
+        s_pl.cfg.decoder_stack = def.decoder_stack;
+
+    jpeg_dec_config_t jcfg = DEFAULT_JPEG_DEC_CONFIG();
+    jcfg.output_type = JPEG_PIXEL_FORMAT_RGB565_LE;
+    if (jpeg_dec_open(&jcfg, &s_pl.jpeg) != JPEG_ERR_OK)
+    {
+        ESP_LOGE(TAG, "JPEG decoder open failed");
+        return ESP_FAIL;
+    }
+
+    s_pl.comp = calloc(s_pl.cfg.comp_slots, sizeof(comp_slot_t));
+    s_pl.frames = calloc(s_pl.cfg.frame_slots, sizeof(frame_slot_t));
+    s_pl.comp_free = xQueueCreate(s_pl.cfg.comp_slots, sizeof(int));
+    s_pl.comp_full = xQueueCreate(s_pl.cfg.comp_slots, sizeof(int));
+    s_pl.frame_free = xQueueCreate(s_pl.cfg.frame_slots, sizeof(int));
+    s_pl.frame_ready = xQueueCreate(s_pl.cfg.frame_slots, sizeof(int));
+    s_pl.mux = xSemaphoreCreateMutex();
+    s_pl.done = xSemaphoreCreateBinary();
+    if (!s_pl.comp || !s_pl.frames || !s_pl.comp_free || !s_pl.comp_full ||
+        !s_pl.frame_free || !s_pl.frame_ready || !s_pl.mux || !s_pl.done)
+    {
+        ESP_LOGE(TAG, "no mem for pipeline");
+        video_pipeline_stop();
+        return ESP_ERR_NO_MEM;
+    }
+
+    // 压缩槽放 PSRAM，单帧 MJPEG 通常几十 KB
+    for (int i = 0; i < s_pl.cfg.comp_slots; i++)
+    {
+        s_pl.comp[i].buf = heap_caps_malloc(s_pl.cfg.comp_slot_size, MALLOC_CAP_SPIRAM);
+        if (!s_pl.comp[i].buf)
+        {
+            ESP_LOGE(TAG, "alloc comp slot %d fail", i);
+            video_pipeline_stop();
+            return ESP_ERR_NO_MEM;
+        }
+        s_pl.comp[i].cap = s_pl.cfg.comp_slot_size;
+    }
+    reset_queues();
+
+    s_pl.st.comp_depth = s_pl.cfg.comp_slots;
+    s_pl.st.frame_slots = s_pl.cfg.frame_slots;
+
+    s_pl.running = true;
+    if (xTaskCreatePinnedToCore(decoder_task, "video_dec", s_pl.cfg.decoder_stack, NULL,
+                                s_pl.cfg.decoder_priority, &s_pl.task, s_pl.cfg.decoder_core) != pdPASS)
+    {
+        ESP_LOGE(TAG, "create decoder task fail");
+        s_pl.running = false;
+        video_pipeline_stop();
+        return ESP_FAIL;
+    }
+
+    ESP_LOGI(TAG, "started: %d comp slots x %u B, %d frames, decoder on core %d",
+             s_pl.cfg.comp_slots, (unsigned)s_pl.cfg.comp_slot_size, s_pl.cfg.frame_slots, s_pl.cfg.decoder_core);
+    return ESP_OK;
+}
+
+static void free_direct(void)
+{
+    direct_t *d = &s_pl.direct;
+    for (int i = 0; i < DIRECT_STRIPS; i++)
+    {
+        heap_caps_free(d->strip[i]);
+        d->strip[i] = NULL;
+    }
+    d->strip_cap = 0;
+    if (d->jpeg)
+    {
+        jpeg_dec_close(d->jpeg);
+        d->jpeg = NULL;
+    }
+    if (d->strip_free)
+    {
+        vSemaphoreDelete(d->strip_free);
+        d->strip_free = NULL;
+    }
+}
+
+void video_pipeline_stop(void)
+{
+    video_pipeline_direct_disable();
+    if (s_pl.running)
+    {
+        s_pl.running = false;
+        xSemaphoreTake(s_pl.done, portMAX_DELAY);
+        s_pl.task = NULL;
+    }
+
+    free_direct();
+
+    free_frames();
+    if (s_pl.frames)
+    {
+        free(s_pl.frames);
+        s_pl.frames = NULL;
+    }
+    if (s_pl.comp)
+    {
+        for (int i = 0; i < s_pl.cfg.comp_slots; i++)
+            free(s_pl.comp[i].buf);
+        free(s_pl.comp);
+        s_pl.comp = NULL;
+    }
+    if (s_pl.jpeg)
+    {
+        jpeg_dec_close(s_pl.jpeg);
+        s_pl.jpeg = NULL;
+    }
+    if (s_pl.comp_free)
+        vQueueDelete(s_pl.comp_free);
+    if (s_pl.comp_full)
+        vQueueDelete(s_pl.comp_full);
+    if (s_pl.frame_free)
+        vQueueDelete(s_pl.frame_free);
+    if (s_pl.frame_ready)
+        vQueueDelete(s_pl.frame_ready);
+    if (s_pl.mux)
+        vSemaphoreDelete(s_pl.mux);
+    if (s_pl.done)
+        vSemaphoreDelete(s_pl.done);
+    memset(&s_pl, 0, sizeof(s_pl));
+}
+
+esp_err_t video_pipeline_set_frame_size(int w, int h)
+{
+    if (!s_pl.running || w <= 0 || h <= 0)
+        return ESP_ERR_INVALID_STATE;
+
+    size_t need = (size_t)w * h * 2;
+
+    // 拿到 mux 说明解码任务不在解码中，且下一轮会重新检查队列
+    xSemaphoreTake(s_pl.mux, portMAX_DELAY);
+    esp_err_t ret = ESP_OK;
+    if (need != s_pl.frame_cap)
+    {
+        free_frames();
+        for (int i = 0; i < s_pl.cfg.frame_slots; i++)
+        {
+            s_pl.frames[i].buf = jpeg_calloc_align(need, 16);
+            if (!s_pl.frames[i].buf)
+            {
+                ESP_LOGE(TAG, "alloc frame %d (%dx%d) fail", i, w, h);
+                free_frames();
+                ret = ESP_ERR_NO_MEM;
+                break;
+            }
+        }
+        if (ret == ESP_OK)
+            s_pl.frame_cap = need;
+    }
+    s_pl.frame_w = ret == ESP_OK ? w : 0;
+    s_pl.frame_h = ret == ESP_OK ? h : 0;
+    reset_queues();
+    xSemaphoreGive(s_pl.mux);
+
+    if (ret == ESP_OK)
+        ESP_LOGI(TAG, "frame ring %d x %dx%d", s_pl.cfg.frame_slots, w, h);
+    return ret;
+}
+
+static bool push_slot(const uint8_t *data, size_t len, bool copy)
+{
+    if (!s_pl.running || !data || len == 0)
+        return false;
+
+    int ci;
+    if (xQueueReceive(s_pl.comp_free, &ci, 0) != pdTRUE)
+    {
+        s_pl.st.dropped_full++; // 解码跟不上，丢掉这帧（MJPEG 帧间无依赖）
+        return false;
+    }
+
+    comp_slot_t *cs = &s_pl.comp[ci];
+    if (copy)
+    {
+        if (len > cs->cap)
+        {
+            uint8_t *nb = heap_caps_realloc(cs->buf, len, MALLOC_CAP_SPIRAM);
+            if (!nb)
+            {
+                ESP_LOGW(TAG, "grow comp slot to %u fail", (unsigned)len);
+                xQueueSend(s_pl.comp_free, &ci, 0);
+                s_pl.st.dropped_full++;
+                return false;
+            }
+            cs->buf = nb;
+            cs->cap = len;
+        }
+        memcpy(cs->buf, data, len);
+        cs->data = cs->buf;
+    }
+    else
+    {
+        cs->data = data;
+        s_pl.st.pushed_ref++;
+    }
+    cs->len = len;
+    cs->seq = s_pl.seq++;
+    cs->arrive_us = esp_timer_get_time();
+    xQueueSend(s_pl.comp_full, &ci, 0);
+
+    s_pl.st.pushed++;
+    uint32_t q = uxQueueMessagesWaiting(s_pl.comp_full);
+    if (q > s_pl.st.comp_peak)
+        s_pl.st.comp_peak = q;
+    return true;
+}
+
+bool video_pipeline_push(const uint8_t *data, size_t len)
+{
+    return push_slot(data, len, true);
+}
+
+bool video_pipeline_push_ref(const uint8_t *data, size_t len)
+{
+    return push_slot(data, len, false);
+}
+
+void video_pipeline_flush(void)
+{
+    if (!s_pl.running)
+        return;
+    // 拿到 mux 时解码任务不在解码中，排队的压缩帧直接放回空闲队列
+    xSemaphoreTake(s_pl.mux, portMAX_DELAY);
+    int ci;
+    while (xQueueReceive(s_pl.comp_full, &ci, 0) == pdTRUE)
+        xQueueSend(s_pl.comp_free, &ci, 0);
+    xSemaphoreGive(s_pl.mux);
+}
+
+bool video_pipeline_acquire(video_frame_t *out)
+{
+    if (!s_pl.running || !out)
+        return false;
+
+    int fi;
+    if (xQueueReceive(s_pl.frame_ready, &fi, 0) != pdTRUE)
+        return false;
+
+    frame_slot_t *fs = &s_pl.frames[fi];
+    out->buf = fs->buf;
+    out->w = fs->w;
+    out->h = fs->h;
+    out->seq = fs->seq;
+    out->arrive_us = fs->arrive_us;
+    out->idx = fi;
+    return true;
+}
+
+void video_pipeline_release(const video_frame_t *frame)
+{
+    if (!s_pl.running || !frame || frame->idx < 0 || frame->idx >= s_pl.cfg.frame_slots)
+        return;
+    xQueueSend(s_pl.frame_free, &frame->idx, 0);
+}
+
+void video_pipeline_get_stats(video_pipeline_stats_t *st)
+{
+    if (!st)
+        return;
+    *st = s_pl.st;
+    if (s_pl.running)
+    {
+        st->comp_queued = uxQueueMessagesWaiting(s_pl.comp_full);
+        st->frames_ready = uxQueueMessagesWaiting(s_pl.frame_ready);
+        st->frames_free = uxQueueMessagesWaiting(s_pl.frame_free);
+    }
+}
+
+esp_err_t video_pipeline_direct_enable(const video_direct_config_t *cfg)
+{
+    if (!s_pl.running)
+        return ESP_ERR_INVALID_STATE;
+    if (!cfg || !cfg->panel || !cfg->io || cfg->disp_w <= 0 || cfg->disp_h <= 0)
+        return ESP_ERR_INVALID_ARG;
+    if (s_pl.frame_w <= 0 || (s_pl.frame_w % 8) || (s_pl.frame_h % 8) ||
+        s_pl.frame_w > cfg->disp_w || s_pl.frame_h > cfg->disp_h)
+        return ESP_ERR_NOT_SUPPORTED;
+
+    direct_t *d = &s_pl.direct;
+    if (d->active)
+        return ESP_OK;
+
+    xSemaphoreTake(s_pl.mux, portMAX_DELAY);
+    esp_err_t ret = ESP_OK;
+    if (!d->jpeg)
+    {
+        jpeg_dec_config_t jcfg = DEFAULT_JPEG_DEC_CONFIG();
+        jcfg.output_type = JPEG_PIXEL_FORMAT_RGB565_BE; // 面板字节序，省掉送屏前的交换
+        jcfg.block_enable = true;
+        if (jpeg_dec_open(&jcfg, &d->jpeg) != JPEG_ERR_OK)
+        {
+            d->jpeg = NULL;
+            ret = ESP_FAIL;
+        }
+    }
+    size_t need = (size_t)cfg->disp_w * DIRECT_STRIP_LINES * 2;
+    if (ret == ESP_OK && need > d->strip_cap)
+    {
+        for (int i = 0; i < DIRECT_STRIPS; i++)
+        {
+            heap_caps_free(d->strip[i]);
+            d->strip[i] = heap_caps_aligned_alloc(16, need, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+            if (!d->strip[i])
+                ret = ESP_ERR_NO_MEM;
+        }
+        d->strip_cap = ret == ESP_OK ? need : 0;
+    }
+    if (ret == ESP_OK && !d->strip_free)
+    {
+        d->strip_free = xSemaphoreCreateCounting(DIRECT_STRIPS, DIRECT_STRIPS);
+        if (!d->strip_free)
+            ret = ESP_ERR_NO_MEM;
+    }
+    if (ret == ESP_OK)
+    {
+        const esp_lcd_panel_io_callbacks_t cbs = {
+            .on_color_trans_done = direct_trans_done,
+        };
+        ret = esp_lcd_panel_io_register_event_callbacks(cfg->io, &cbs, NULL);
+    }
+    if (ret == ESP_OK)
+    {
+        d->cfg = *cfg;
+        d->active = true;
+    }
+    xSemaphoreGive(s_pl.mux);
+
+    if (ret == ESP_OK)
+        ESP_LOGI(TAG, "direct on: %dx%d, %d strips x %u B", s_pl.frame_w, s_pl.frame_h, DIRECT_STRIPS, (unsigned)d->strip_cap);
+    else
+        ESP_LOGE(TAG, "direct on failed: %s", esp_err_to_name(ret));
+    return ret;
+}
+
+void video_pipeline_direct_disable(void)
+{
+    direct_t *d = &s_pl.direct;
+    if (!d->active)
+        return;
+
+    // 拿到 mux 说明没有帧在解码
+    xSemaphoreTake(s_pl.mux, portMAX_DELAY);
+    d->active = false;
+
+    // 等在途条带传完，再把完成回调摘掉
+    for (int i = 0; i < DIRECT_STRIPS; i++)
+        xSemaphoreTake(d->strip_free, pdMS_TO_TICKS(100));
+    const esp_lcd_panel_io_callbacks_t cbs = {0};
+    esp_lcd_panel_io_register_event_callbacks(d->cfg.io, &cbs, NULL);
+    for (int i = 0; i < DIRECT_STRIPS; i++)
+        xSemaphoreGive(d->strip_free);
+
+    // 帧环里是切换前解码的旧帧，清掉让显示端从新帧开始
+    reset_queues();
+    xSemaphoreGive(s_pl.mux);
+    ESP_LOGI(TAG, "direct off after %lu frames", (unsigned long)s_pl.st.direct_frames);
+}
+
+bool video_pipeline_direct_active(void)
+{
+    return s_pl.direct.active;
+}
@@ -1,4 +1,9 @@
 #include "ui.h"
+#include "img_cache.h"
+#include "img_loader.h"
+#include "touch_multi.h"
+#include "media_index.h"
+#include "frame_prof.h"
 
 #include "bsp/esp-bsp.h"
 #include "bsp/display.h"
@@ -47,7 +52,14 @@ void app_main(void)
     {
         ESP_LOGE("main", "spiffs failed");
     }
+    img_cache_init(IMG_CACHE_DEFAULT_BUDGET);
+    img_loader_init(IMG_LOADER_DEFAULT_WORKERS);
+    media_index_init(); // 开机后台核对媒体目录索引
     my_lv_start();
+    bsp_display_lock(0);
+    frame_prof_init(lv_display_get_default()); // 帧耗时剖析，面板在设置页打开
+    bsp_display_unlock();
+    touch_multi_init(); // 双指缩放要第二个触点
 
     page_lock_create();
     // solid_test();
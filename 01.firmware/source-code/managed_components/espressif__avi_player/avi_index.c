@@ -0,0 +1,318 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "avi_index.h"
+
+static const char *TAG = "avi index";
+
+#define INDEX_READ_ENTRIES 256  /*!< Index entries read from the file at once */
+
+static uint32_t _REV(uint32_t value)
+{
+    return (value & 0x000000FFU) << 24 | (value & 0x0000FF00U) << 8 |
+           (value & 0x00FF0000U) >> 8 | (value & 0xFF000000U) >> 24;
+}
+
+typedef struct {
+    avi_index_t *index;
+    uint32_t video_cap;
+    uint32_t audio_cap;
+    uint32_t audio_total;
+    uint32_t movi_end;      /*!< Chunks past the first movi list are not reachable by the player */
+} index_builder_t;
+
+static void *index_realloc(void *ptr, size_t size)
+{
+    void *p = heap_caps_realloc(ptr, size, MALLOC_CAP_SPIRAM);
+    if (p == NULL) {
+        p = heap_caps_realloc(ptr, size, MALLOC_CAP_DEFAULT);
+    }
+    return p;
+}
+
+/**
+ * @brief Append one chunk, skipping it unless it lies whole inside the movi list
+ *
+ * The offset and the bound math are 64-bit so that a corrupt offset or size cannot wrap past the check.
+ */
+static esp_err_t index_push(index_builder_t *b, uint32_t fourcc, uint64_t offset, uint32_t size)
+{
+    avi_index_t *index = b->index;
+    if (offset + sizeof(AVI_CHUNK_HEAD) + size > b->movi_end) {
+        return ESP_OK;
+    }
+
+    if ((fourcc & 0xFFFF0000) == DC_ID) {
+        if (index->video_count == b->video_cap) {
+            uint32_t cap = b->video_cap ? b->video_cap * 2 : 1024;
+            avi_index_entry_t *p = index_realloc(index->video, cap * sizeof(avi_index_entry_t));
+            if (p == NULL) {
+                return ESP_ERR_NO_MEM;
+            }
+            index->video = p;
+            b->video_cap = cap;
+        }
+        index->video[index->video_count++] = (avi_index_entry_t) {
+            .offset = (uint32_t)offset, .size = size
+        };
+    } else if ((fourcc & 0xFFFF0000) == WB_ID) {
+        if (index->audio_count == b->audio_cap) {
+            uint32_t cap = b->audio_cap ? b->audio_cap * 2 : 1024;
+            avi_index_entry_t *p = index_realloc(index->audio, cap * sizeof(avi_index_entry_t));
+            if (p == NULL) {
+                return ESP_ERR_NO_MEM;
+            }
+            index->audio = p;
+            uint32_t *q = index_realloc(index->audio_bytes, cap * sizeof(uint32_t));
+            if (q == NULL) {
+                return ESP_ERR_NO_MEM;
+            }
+            index->audio_bytes = q;
+            b->audio_cap = cap;
+        }
+        index->audio[index->audio_count] = (avi_index_entry_t) {
+            .offset = (uint32_t)offset, .size = size
+        };
+        index->audio_bytes[index->audio_count] = b->audio_total;
+        index->audio_count++;
+        b->audio_total += size;
+    }
+    return ESP_OK;
+}
+
+static void index_reset(index_builder_t *b)
+{
+    avi_index_free(b->index);
+    b->video_cap = 0;
+    b->audio_cap = 0;
+    b->audio_total = 0;
+}
+
+/**
+ * @brief Read one OpenDML standard index ("ix##") and append its chunks
+ */
+static esp_err_t parse_odml_std_index(index_builder_t *b, avi_index_read_t read, void *ctx, uint32_t offset, AVI_ODML_STD_ENTRY *buf)
+{
+    AVI_ODML_INDEX_HEAD head;
+    if (read(ctx, offset, &head, sizeof(head)) != sizeof(head)) {
+        return ESP_FAIL;
+    }
+    if (head.index_type != AVI_INDEX_OF_CHUNKS || head.longs_per_entry != 2 || head.base_offset_high != 0) {
+        ESP_LOGW(TAG, "unsupported ix chunk at %"PRIu32"", offset);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    uint32_t pos = offset + sizeof(head);
+    for (uint32_t done = 0; done < head.entries_in_use;) {
+        uint32_t n = head.entries_in_use - done;
+        n = n > INDEX_READ_ENTRIES ? INDEX_READ_ENTRIES : n;
+        if (read(ctx, pos, buf, n * sizeof(AVI_ODML_STD_ENTRY)) != n * sizeof(AVI_ODML_STD_ENTRY)) {
+            return ESP_FAIL;
+        }
+        for (uint32_t i = 0; i < n; i++) {
+            /*!< the entry points to the chunk data, step back over the chunk head */
+            uint64_t chunk = (uint64_t)head.base_offset_low + buf[i].offset - sizeof(AVI_CHUNK_HEAD);
+            esp_err_t ret = index_push(b, head.chunk_id, chunk, buf[i].size & 0x7FFFFFFF);
+            if (ret != ESP_OK) {
+                return ret;
+            }
+        }
+        pos += n * sizeof(AVI_ODML_STD_ENTRY);
+        done += n;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t parse_odml_super_index(index_builder_t *b, avi_index_read_t read, void *ctx, uint32_t offset, void *buf)
+{
+    AVI_ODML_INDEX_HEAD head;
+    if (read(ctx, offset, &head, sizeof(head)) != sizeof(head) || head.FourCC != INDX_ID) {
+        return ESP_FAIL;
+    }
+    if (head.index_type != AVI_INDEX_OF_INDEXES || head.longs_per_entry != 4) {
+        ESP_LOGW(TAG, "unsupported indx type %d", head.index_type);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    for (uint32_t i = 0; i < head.entries_in_use; i++) {
+        AVI_ODML_SUPER_ENTRY entry;
+        uint32_t pos = offset + sizeof(head) + i * sizeof(entry);
+        if (read(ctx, pos, &entry, sizeof(entry)) != sizeof(entry)) {
+            return ESP_FAIL;
+        }
+        if (entry.offset_high != 0) {
+            break;  /*!< beyond 4 GB, not reachable on FAT anyway */
+        }
+        esp_err_t ret = parse_odml_std_index(b, read, ctx, entry.offset_low, buf);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+    return ESP_OK;
+}
+
+static esp_err_t parse_idx1(index_builder_t *b, const avi_typedef *avi, avi_index_read_t read, void *ctx, uint32_t file_size, AVI_IDX1 *buf)
+{
+    uint32_t movi_fourcc = avi->movi_start - 4;
+    uint64_t idx1 = (uint64_t)movi_fourcc + avi->movi_size + (avi->movi_size & 1);
+    AVI_CHUNK_HEAD head;
+    if (idx1 + sizeof(head) > file_size) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    uint32_t pos = (uint32_t)idx1;
+    if (read(ctx, pos, &head, sizeof(head)) != sizeof(head) || head.FourCC != IDX1_ID) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    pos += sizeof(head);
+
+    uint32_t total = head.size / sizeof(AVI_IDX1);
+    uint32_t base = 0;
+    bool base_known = false;
+    for (uint32_t done = 0; done < total;) {
+        uint32_t n = total - done;
+        n = n > INDEX_READ_ENTRIES ? INDEX_READ_ENTRIES : n;
+        if (read(ctx, pos, buf, n * sizeof(AVI_IDX1)) != n * sizeof(AVI_IDX1)) {
+            return ESP_FAIL;
+        }
+        for (uint32_t i = 0; i < n; i++) {
+            if (!base_known) {
+                /*!< offsets are relative to the "movi" FourCC in most files, absolute in some */
+                uint32_t fourcc = 0;
+                read(ctx, movi_fourcc + buf[i].chunkoffset, &fourcc, sizeof(fourcc));
+                base = (fourcc == buf[i].FourCC) ? movi_fourcc : 0;
+                base_known = true;
+            }
+            esp_err_t ret = index_push(b, buf[i].FourCC, (uint64_t)base + buf[i].chunkoffset, buf[i].chunklength);
+            if (ret != ESP_OK) {
+                return ret;
+            }
+        }
+        pos += n * sizeof(AVI_IDX1);
+        done += n;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief No index in the file, walk the chunk heads of the movi list once
+ */
+static esp_err_t walk_movi(index_builder_t *b, const avi_typedef *avi, avi_index_read_t read, void *ctx)
+{
+    uint32_t pos = avi->movi_start;
+    while ((uint64_t)pos + sizeof(AVI_CHUNK_HEAD) <= b->movi_end) {
+        AVI_CHUNK_HEAD head;
+        if (read(ctx, pos, &head, sizeof(head)) != sizeof(head)) {
+            break;
+        }
+        if (head.FourCC == LIST_ID) {
+            pos += sizeof(AVI_LIST_HEAD);   /*!< descend into "rec " lists */
+            continue;
+        }
+        esp_err_t ret = index_push(b, head.FourCC, pos, head.size);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        /*!< a corrupt size must neither wrap pos back nor run past the movi list */
+        uint64_t next = (uint64_t)pos + sizeof(head) + head.size + (head.size & 1);
+        if (next <= pos || next > b->movi_end) {
+            break;
+        }
+        pos = (uint32_t)next;
+    }
+    return ESP_OK;
+}
+
+esp_err_t avi_index_build(avi_index_t *index, const avi_typedef *avi, avi_index_read_t read, void *ctx, uint32_t file_size)
+{
+    memset(index, 0, sizeof(avi_index_t));
+    uint64_t movi_end = (uint64_t)avi->movi_start - 4 + avi->movi_size;
+    index_builder_t b = {
+        .index = index,
+        .movi_end = movi_end < file_size ? (uint32_t)movi_end : file_size,
+    };
+
+    void *buf = malloc(INDEX_READ_ENTRIES * sizeof(AVI_IDX1));
+    if (buf == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    const char *source = "OpenDML";
+    esp_err_t ret = ESP_ERR_NOT_FOUND;
+    if (avi->vids_indx) {
+        ret = parse_odml_super_index(&b, read, ctx, avi->vids_indx, buf);
+        if (ret == ESP_OK && avi->auds_indx) {
+            ret = parse_odml_super_index(&b, read, ctx, avi->auds_indx, buf);
+        }
+    }
+    if (ret != ESP_OK || index->video_count == 0) {
+        index_reset(&b);
+        source = "idx1";
+        ret = parse_idx1(&b, avi, read, ctx, file_size, buf);
+    }
+    if (ret != ESP_OK || index->video_count == 0) {
+        index_reset(&b);
+        source = "movi walk";
+        ret = walk_movi(&b, avi, read, ctx);
+    }
+    free(buf);
+
+    if (ret == ESP_OK && index->video_count == 0) {
+        ret = ESP_ERR_NOT_FOUND;
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "build index failed (%s)", esp_err_to_name(ret));
+        avi_index_free(index);
+        return ret;
+    }
+
+    index->valid = true;
+    ESP_LOGI(TAG, "%s index: %"PRIu32" video, %"PRIu32" audio chunks", source, index->video_count, index->audio_count);
+    return ESP_OK;
+}
+
+void avi_index_free(avi_index_t *index)
+{
+    heap_caps_free(index->video);
+    heap_caps_free(index->audio);
+    heap_caps_free(index->audio_bytes);
+    memset(index, 0, sizeof(avi_index_t));
+}
+
+uint32_t avi_index_count_before(const avi_index_entry_t *entries, uint32_t count, uint32_t offset)
+{
+    uint32_t lo = 0, hi = count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (entries[mid].offset < offset) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+uint32_t avi_index_audio_at(const avi_index_t *index, uint32_t audio_bytes)
+{
+    if (index->audio_count == 0) {
+        return 0;
+    }
+    uint32_t lo = 0, hi = index->audio_count;
+    while (hi - lo > 1) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (index->audio_bytes[mid] <= audio_bytes) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
@@ -0,0 +1,81 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "avifile.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief One chunk of the movi list
+ */
+typedef struct {
+    uint32_t offset;    /*!< File offset of the chunk head (FourCC + size) */
+    uint32_t size;      /*!< Size of the chunk data */
+} avi_index_entry_t;
+
+/**
+ * @brief Chunk offset table of one AVI file, kept in PSRAM when available
+ */
+typedef struct {
+    avi_index_entry_t *video;   /*!< Video chunks in file order */
+    uint32_t video_count;       /*!< Number of video chunks */
+    avi_index_entry_t *audio;   /*!< Audio chunks in file order */
+    uint32_t *audio_bytes;      /*!< Audio bytes before each audio chunk, used to map time to audio chunk */
+    uint32_t audio_count;       /*!< Number of audio chunks */
+    bool valid;                 /*!< Table has been built */
+} avi_index_t;
+
+/**
+ * @brief Random access read used to build the index
+ *
+ * @return Number of bytes read
+ */
+typedef size_t (*avi_index_read_t)(void *ctx, uint32_t offset, void *buffer, size_t length);
+
+/**
+ * @brief Build the chunk offset table
+ *
+ * The OpenDML "indx"/"ix##" indexes are used first, then the legacy "idx1" index. If the file has
+ * neither, the chunk heads of the movi list are walked once (without reading any chunk data).
+ *
+ * @param[out] index     Index to fill
+ * @param[in]  avi       Parsed AVI header
+ * @param[in]  read      Random access read function
+ * @param[in]  ctx       Context of the read function
+ * @param[in]  file_size Size of the AVI file
+ *
+ * @return
+ *      - ESP_OK: Success
+ *      - ESP_ERR_NO_MEM: Cannot allocate the table
+ *      - ESP_ERR_NOT_FOUND: No video chunk found
+ */
+esp_err_t avi_index_build(avi_index_t *index, const avi_typedef *avi, avi_index_read_t read, void *ctx, uint32_t file_size);
+
+/**
+ * @brief Free the chunk offset table
+ */
+void avi_index_free(avi_index_t *index);
+
+/**
+ * @brief Number of entries whose chunk starts before the file offset
+ */
+uint32_t avi_index_count_before(const avi_index_entry_t *entries, uint32_t count, uint32_t offset);
+
+/**
+ * @brief Audio chunk that contains the given audio byte position
+ */
+uint32_t avi_index_audio_at(const avi_index_t *index, uint32_t audio_bytes);
+
+#ifdef __cplusplus
+}
+#endif
@@ -9,6 +9,7 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/event_groups.h"
+#include "freertos/semphr.h"
 #include "freertos/idf_additions.h"
 #include "esp_timer.h"
 #include "esp_log.h"
@@ -17,6 +18,8 @@
 #include "esp_idf_version.h"
 
 #include "avifile.h"
+#include "avi_index.h"
+#include "avi_reader.h"
 #include "avi_player.h"
 
 static const char *TAG = "avi player";
@@ -28,8 +31,15 @@ static const char *TAG = "avi player";
 #define EVENT_DEINIT_DONE     ((1 << 4))
 #define EVENT_VIDEO_BUF_READY ((1 << 5))
 #define EVENT_AUDIO_BUF_READY ((1 << 6))
+#define EVENT_SEEK            ((1 << 7))
 
-#define EVENT_ALL          (EVENT_FPS_TIME_UP | EVENT_START_PLAY | EVENT_STOP_PLAY | EVENT_DEINIT)
+#define EVENT_ALL          (EVENT_FPS_TIME_UP | EVENT_START_PLAY | EVENT_STOP_PLAY | EVENT_DEINIT | EVENT_SEEK)
+
+#define SYNC_EARLY_US         (1000)    /*!< Frames due within this are handed over right away */
+#define SYNC_MAX_DROP_RUN     (30)      /*!< Show one frame after this many drops in a row, even if late */
+
+#define READ_BLOCK_SIZE       (64 * 1024)   /*!< Default read-ahead block, two 32 KB FAT clusters */
+#define READ_BLOCK_COUNT      (4)
 
 typedef enum {
     PLAY_FILE,
@@ -52,20 +62,58 @@ typedef struct {
             uint32_t read_offset;
         } memory;
         struct {
-            FILE *avi_file;
+            avi_reader_handle_t reader;
         } file;
     };
     uint8_t *pbuffer;
+    uint8_t *pdata;             /*!< Data of the current chunk, pbuffer or the chunk in place in the read-ahead ring */
     uint32_t str_size;
     avi_play_state_t state;
     avi_typedef AVI_file;
+    avi_index_t index;          /*!< Chunk offset table, built on the first seek */
+    uint32_t video_pos;         /*!< Number of video chunks passed so far */
+    uint32_t audio_pos;         /*!< Number of audio chunks passed so far */
+    uint32_t video_skip;        /*!< Video chunks before this one are skipped after a seek */
+    uint32_t audio_skip;        /*!< Audio chunks before this one are skipped after a seek */
+    AVI_CHUNK_HEAD pending;     /*!< Video chunk head read but not due yet, its data is next in the stream */
+    bool has_pending;           /*!< pending is valid */
+    uint32_t frame_us;          /*!< Video frame period */
+    uint32_t chunks_in_place;   /*!< Chunks handed to the callbacks straight from the read-ahead ring */
+    uint32_t chunks_copied;     /*!< Chunks copied to pbuffer */
 } avi_data_t;
 
+typedef struct {
+    bool audio_master;          /*!< Clock follows the audio handed to audio_cb, otherwise the wall clock */
+    uint32_t bytes_per_sec;     /*!< Audio byte rate */
+    uint64_t audio_bytes;       /*!< Audio bytes handed to audio_cb since the start of the stream */
+    int64_t base_us;            /*!< Stream time at set_at */
+    int64_t set_at;             /*!< esp_timer time the clock was last set */
+    uint32_t drop_run;          /*!< Frames dropped in a row */
+    avi_player_sync_stats_t stats;
+} avi_clock_t;
+
+typedef struct {
+    avi_reader_handle_t reader; /*!< Opened and read ahead, NULL if no file is queued */
+    avi_typedef AVI_file;       /*!< Header parsed when the file was queued */
+} avi_next_t;
+
+typedef struct {
+    bool valid;                 /*!< audio_set_clock_cb has been called */
+    uint32_t rate;
+    uint32_t bits;
+    uint32_t channels;
+} avi_audio_format_t;
+
 typedef struct {
     EventGroupHandle_t event_group;
     esp_timer_handle_t timer_handle;
     avi_player_config_t config;
     avi_data_t avi_data;
+    avi_clock_t clock;
+    volatile uint32_t seek_ms;  /*!< Target of the pending seek */
+    SemaphoreHandle_t next_lock;
+    avi_next_t next;            /*!< File that takes over when the current one ends */
+    avi_audio_format_t audio_format;    /*!< Format last passed to audio_set_clock_cb */
 } avi_player_t;
 
 static uint32_t _REV(uint32_t value)
@@ -74,46 +122,338 @@ static uint32_t _REV(uint32_t value)
            (value & 0x00FF0000U) >> 8 | (value & 0xFF000000U) >> 24;
 }
 
-static uint32_t read_frame(avi_data_t *avi, uint8_t *buffer, uint32_t length, uint32_t *fourcc)
+static bool read_chunk_head(avi_data_t *avi, AVI_CHUNK_HEAD *head)
 {
-    AVI_CHUNK_HEAD head;
-
     if (avi->mode == PLAY_MEMORY) {
         if (sizeof(AVI_CHUNK_HEAD) > (avi->memory.size - avi->memory.read_offset)) {
             ESP_LOGE(TAG, "not enough data for chunk head");
-            return 0;
+            return false;
         }
-        memcpy(&head, avi->memory.data + avi->memory.read_offset, sizeof(AVI_CHUNK_HEAD));
+        memcpy(head, avi->memory.data + avi->memory.read_offset, sizeof(AVI_CHUNK_HEAD));
         avi->memory.read_offset += sizeof(AVI_CHUNK_HEAD);
     } else if (avi->mode == PLAY_FILE) {
-        fread(&head, sizeof(AVI_CHUNK_HEAD), 1, avi->file.avi_file);
+        if (avi_reader_read(avi->file.reader, head, sizeof(AVI_CHUNK_HEAD)) != sizeof(AVI_CHUNK_HEAD)) {
+            return false;
+        }
     }
+    return true;
+}
 
-    if (head.FourCC) {
-        /* handle FourCC if needed */
+/**
+ * @brief Read the data of the current chunk
+ *
+ * From memory, the chunk is always used in place. From a file, the chunk is used in place in the
+ * read-ahead ring when it does not wrap around the end of the ring, and copied to pbuffer otherwise.
+ *
+ * @return The chunk data, NULL if nothing was consumed
+ */
+static uint8_t *read_chunk_data(avi_data_t *avi, uint32_t length, uint32_t size)
+{
+    if (avi->mode == PLAY_MEMORY) {
+        if (size > (avi->memory.size - avi->memory.read_offset)) {
+            ESP_LOGE(TAG, "frame size %"PRIu32" exceeds available data", size);
+            return NULL;
+        }
+        uint8_t *data = avi->memory.data + avi->memory.read_offset;
+        avi->memory.read_offset += size;
+        avi->chunks_in_place++;
+        return data;
+    } else if (avi->mode == PLAY_FILE) {
+        uint8_t *data = avi_reader_view(avi->file.reader, size);
+        if (data != NULL) {
+            avi->chunks_in_place++;
+            return data;
+        }
+        if (length < size) {
+            ESP_LOGE(TAG, "frame size %"PRIu32" exceeds available data", size);
+            return NULL;
+        }
+        if (avi_reader_read(avi->file.reader, avi->pbuffer, size) != size) {
+            return NULL;
+        }
     }
-    *fourcc = head.FourCC;
+    avi->chunks_copied++;
+    return avi->pbuffer;
+}
 
-    if (head.size % 2) {
-        head.size++;    /*!< add a byte if size is odd */
+static void skip_chunk_data(avi_data_t *avi, uint32_t size)
+{
+    if (avi->mode == PLAY_MEMORY) {
+        uint32_t left = avi->memory.size - avi->memory.read_offset;
+        avi->memory.read_offset += size < left ? size : left;
+    } else if (avi->mode == PLAY_FILE) {
+        avi_reader_skip(avi->file.reader, size);
     }
+}
 
+static size_t index_read(void *ctx, uint32_t offset, void *buffer, size_t length)
+{
+    avi_data_t *avi = (avi_data_t *)ctx;
     if (avi->mode == PLAY_MEMORY) {
-        if (head.size > (avi->memory.size - avi->memory.read_offset) || length < head.size) {
-            ESP_LOGE(TAG, "frame size %"PRIu32" exceeds available data", head.size);
+        if (offset >= avi->memory.size) {
             return 0;
         }
-        memcpy(buffer, avi->memory.data + avi->memory.read_offset, head.size);
-        avi->memory.read_offset += head.size;
-    } else if (avi->mode == PLAY_FILE) {
-        if (length < head.size) {
-            ESP_LOGE(TAG, "frame size %"PRIu32" exceeds available data", head.size);
-            return 0;
+        if (length > avi->memory.size - offset) {
+            length = avi->memory.size - offset;
         }
-        fread(buffer, head.size, 1, avi->file.avi_file);
+        memcpy(buffer, avi->memory.data + offset, length);
+        return length;
+    }
+    /*!< bypasses the read-ahead ring, the play position is not moved */
+    return avi_reader_pread(avi->file.reader, offset, buffer, length);
+}
+
+static int64_t frame_to_us(const avi_typedef *avi, uint32_t frame)
+{
+    if (avi->vids_scale && avi->vids_rate) {
+        return (int64_t)frame * avi->vids_scale * 1000000 / avi->vids_rate;
+    }
+    return avi->vids_fps ? (int64_t)frame * 1000000 / avi->vids_fps : 0;
+}
+
+static uint32_t frame_to_ms(const avi_typedef *avi, uint32_t frame)
+{
+    return frame_to_us(avi, frame) / 1000;
+}
+
+static uint32_t audio_bytes_per_sec(const avi_typedef *avi)
+{
+    if (avi->auds_bytes_per_sec) {
+        return avi->auds_bytes_per_sec;
     }
+    return avi->auds_sample_rate * avi->auds_channels * avi->auds_bits / 8;
+}
 
-    return head.size;
+static void clock_set(avi_clock_t *clock, int64_t stream_us)
+{
+    clock->base_us = stream_us;
+    clock->set_at = esp_timer_get_time();
+}
+
+/**
+ * @brief Current stream time
+ *
+ * With audio the clock is re-anchored each time audio_cb returns, to the audio handed over minus what
+ * is still queued in the output. In between, and for files without audio, it runs on the wall clock.
+ */
+static int64_t clock_now(const avi_clock_t *clock)
+{
+    return clock->base_us + (esp_timer_get_time() - clock->set_at);
+}
+
+static void clock_audio_done(avi_player_t *player, uint32_t bytes)
+{
+    avi_clock_t *clock = &player->clock;
+    clock->audio_bytes += bytes;
+    if (clock->audio_master) {
+        int64_t consumed = clock->audio_bytes;
+        if (player->config.audio_queued_cb) {
+            /*!< goes below zero while the tail of the previous file is still queued */
+            consumed -= player->config.audio_queued_cb(player->config.user_data);
+        }
+        int64_t played = consumed * 1000000 / clock->bytes_per_sec;
+        clock_set(clock, played - (int64_t)player->config.audio_latency_ms * 1000);
+    }
+}
+
+static void clock_reset(avi_player_t *player, uint32_t video, uint32_t audio_bytes)
+{
+    avi_clock_t *clock = &player->clock;
+    clock->audio_bytes = audio_bytes;
+    clock->drop_run = SYNC_MAX_DROP_RUN;    /*!< always show the first frame after a start or seek */
+    clock_set(clock, frame_to_us(&player->avi_data.AVI_file, video));
+}
+
+static uint32_t ms_to_frame(const avi_typedef *avi, uint32_t ms)
+{
+    if (avi->vids_scale && avi->vids_rate) {
+        return (uint64_t)ms * avi->vids_rate / ((uint64_t)avi->vids_scale * 1000);
+    }
+    return (uint64_t)ms * avi->vids_fps / 1000;
+}
+
+static esp_err_t avi_player_do_seek(avi_player_t *player, size_t *BytesRD)
+{
+    avi_data_t *avi = &player->avi_data;
+    const avi_typedef *file = &avi->AVI_file;
+    ESP_RETURN_ON_FALSE(avi->state == AVI_PARSER_DATA, ESP_ERR_INVALID_STATE, TAG, "AVI player not playing");
+
+    if (!avi->index.valid) {
+        uint32_t file_size = avi->mode == PLAY_FILE ? avi_reader_size(avi->file.reader) : avi->memory.size;
+        int64_t start = esp_timer_get_time();
+        esp_err_t ret = avi_index_build(&avi->index, file, index_read, avi, file_size);
+        ESP_LOGI(TAG, "index built in %"PRIu32"ms", (uint32_t)((esp_timer_get_time() - start) / 1000));
+        if (ret != ESP_OK) {
+            /*!< keep playing from where we were */
+            return ret;
+        }
+    }
+
+    uint32_t video = ms_to_frame(file, player->seek_ms);
+    if (video >= avi->index.video_count) {
+        video = avi->index.video_count - 1;
+    }
+    uint32_t target = avi->index.video[video].offset;
+
+    uint32_t audio = 0;
+    if (avi->index.audio_count > 0) {
+        uint32_t bytes_per_sec = audio_bytes_per_sec(file);
+        uint64_t audio_bytes = (uint64_t)frame_to_ms(file, video) * bytes_per_sec / 1000;
+        audio = avi_index_audio_at(&avi->index, audio_bytes > UINT32_MAX ? UINT32_MAX : (uint32_t)audio_bytes);
+        if (avi->index.audio[audio].offset < target) {
+            target = avi->index.audio[audio].offset;
+        }
+    }
+
+    /*!< restart reading at whichever chunk comes first, skip the other stream until its target */
+    avi->video_pos = avi_index_count_before(avi->index.video, avi->index.video_count, target);
+    avi->audio_pos = avi_index_count_before(avi->index.audio, avi->index.audio_count, target);
+    avi->video_skip = video;
+    avi->audio_skip = audio;
+    if (avi->mode == PLAY_MEMORY) {
+        avi->memory.read_offset = target;
+    } else {
+        avi_reader_seek(avi->file.reader, target);
+    }
+    *BytesRD = target - file->movi_start;
+
+    /*!< a frame waiting for its time belongs to the old position, and so does the queued audio */
+    esp_timer_stop(player->timer_handle);
+    avi->has_pending = false;
+    if (player->config.audio_flush_cb) {
+        player->config.audio_flush_cb(player->config.user_data);
+    }
+    clock_reset(player, video, avi->index.audio_count ? avi->index.audio_bytes[audio] : 0);
+    ESP_LOGI(TAG, "seek %"PRIu32"ms -> video %"PRIu32", audio %"PRIu32"", player->seek_ms, video, audio);
+    return ESP_OK;
+}
+
+/**
+ * @brief Parse the header of a file in place in the read-ahead ring
+ *
+ * @return The avi_parser() result
+ */
+static int parse_file_header(avi_player_t *player, avi_reader_handle_t reader, avi_typedef *avi)
+{
+    /*!< the header is normally in the first block, look through the whole ring only if "movi" is not there */
+    uint32_t lengths[] = {
+        player->config.read_block_size,
+        player->config.read_block_size * player->config.read_block_count,
+    };
+    uint32_t file_size = avi_reader_size(reader);
+    int ret = -1;
+    for (int i = 0; i < sizeof(lengths) / sizeof(lengths[0]) && 0 > ret; i++) {
+        uint32_t length = lengths[i] < file_size ? lengths[i] : file_size;
+        avi_reader_seek(reader, 0);
+        uint8_t *header = avi_reader_view(reader, length);
+        if (header == NULL) {
+            break;
+        }
+        ret = avi_parser(avi, header, length);
+    }
+    return ret;
+}
+
+static void set_audio_clock(avi_player_t *player)
+{
+    const avi_typedef *avi = &player->avi_data.AVI_file;
+    avi_audio_format_t *format = &player->audio_format;
+    if (player->config.audio_set_clock_cb == NULL) {
+        return;
+    }
+    if (format->valid && format->rate == avi->auds_sample_rate && format->bits == avi->auds_bits &&
+            format->channels == avi->auds_channels) {
+        /*!< reconfiguring the output would only cause a gap */
+        ESP_LOGD(TAG, "audio format unchanged");
+        return;
+    }
+    player->config.audio_set_clock_cb(avi->auds_sample_rate, avi->auds_bits, avi->auds_channels, player->config.user_data);
+    *format = (avi_audio_format_t) {
+        .valid = true,
+        .rate = avi->auds_sample_rate,
+        .bits = avi->auds_bits,
+        .channels = avi->auds_channels,
+    };
+}
+
+/**
+ * @brief Start reading the movi list of the parsed header
+ */
+static void stream_start(avi_player_t *player)
+{
+    avi_data_t *avi = &player->avi_data;
+    set_audio_clock(player);
+
+    avi->frame_us = frame_to_us(&avi->AVI_file, 1);
+    if (avi->frame_us == 0) {
+        avi->frame_us = 1000 * 1000 / 30;
+    }
+    ESP_LOGD(TAG, "vids_fps=%d, frame %"PRIu32"us", avi->AVI_file.vids_fps, avi->frame_us);
+
+    memset(&player->clock, 0, sizeof(avi_clock_t));
+    player->clock.bytes_per_sec = audio_bytes_per_sec(&avi->AVI_file);
+    player->clock.audio_master = player->config.audio_cb && player->clock.bytes_per_sec;
+    player->clock.stats.audio_master = player->clock.audio_master;
+    clock_reset(player, 0, 0);
+
+    if (avi->mode == PLAY_MEMORY) {
+        avi->memory.read_offset = avi->AVI_file.movi_start;
+    } else {
+        /*!< usually still in the read-ahead ring */
+        avi_reader_seek(avi->file.reader, avi->AVI_file.movi_start);
+    }
+
+    avi->video_pos = 0;
+    avi->audio_pos = 0;
+    avi->video_skip = 0;
+    avi->audio_skip = 0;
+    avi->has_pending = false;
+    avi->chunks_in_place = 0;
+    avi->chunks_copied = 0;
+    avi->state = AVI_PARSER_DATA;
+}
+
+static avi_reader_handle_t take_next(avi_player_t *player, avi_typedef *avi)
+{
+    xSemaphoreTake(player->next_lock, portMAX_DELAY);
+    avi_reader_handle_t reader = player->next.reader;
+    if (avi != NULL) {
+        *avi = player->next.AVI_file;
+    }
+    player->next.reader = NULL;
+    xSemaphoreGive(player->next_lock);
+    return reader;
+}
+
+/**
+ * @brief Go on with the queued file, if any, without stopping
+ *
+ * @return true if the queued file took over
+ */
+static bool stream_next(avi_player_t *player, size_t *BytesRD)
+{
+    avi_data_t *avi = &player->avi_data;
+    avi_typedef header;
+    avi_reader_handle_t reader = take_next(player, &header);
+    if (reader == NULL) {
+        return false;
+    }
+
+    if (avi->mode == PLAY_FILE) {
+        avi_reader_close(avi->file.reader);
+    }
+    avi_index_free(&avi->index);
+    avi->mode = PLAY_FILE;
+    avi->file.reader = reader;
+    avi->AVI_file = header;
+    stream_start(player);
+    *BytesRD = 0;
+    ESP_LOGI(TAG, "play next file");
+
+    if (player->config.avi_play_next_cb) {
+        player->config.avi_play_next_cb(player->config.user_data);
+    }
+    return true;
 }
 
 static esp_err_t avi_player(avi_player_handle_t handle, size_t *BytesRD, uint32_t *Strtype)
@@ -125,61 +465,107 @@ static esp_err_t avi_player(avi_player_handle_t handle, size_t *BytesRD, uint32_
     switch (player->avi_data.state) {
     case AVI_PARSER_HEADER: {
         if (player->avi_data.mode == PLAY_MEMORY) {
-            memcpy(player->avi_data.pbuffer, player->avi_data.memory.data, buffer_size);
-            *BytesRD = buffer_size;
+            ret = avi_parser(&player->avi_data.AVI_file, player->avi_data.memory.data, player->avi_data.memory.size);
         } else {
-            *BytesRD = fread(player->avi_data.pbuffer, buffer_size, 1, player->avi_data.file.avi_file);
+            ret = parse_file_header(player, player->avi_data.file.reader, &player->avi_data.AVI_file);
         }
-
-        ret = avi_parser(&player->avi_data.AVI_file, player->avi_data.pbuffer, *BytesRD);
         if (0 > ret) {
             ESP_LOGE(TAG, "parse failed (%d)", ret);
             xEventGroupSetBits(player->event_group, EVENT_STOP_PLAY);
             return ESP_FAIL;
         }
 
-        /*!< Set the video callback */
-        if (player->config.audio_set_clock_cb) {
-            player->config.audio_set_clock_cb(
-                              player->avi_data.AVI_file.auds_sample_rate,
-                              player->avi_data.AVI_file.auds_bits,
-                              player->avi_data.AVI_file.auds_channels,
-                              player->config.user_data);
-        }
-
-        uint32_t fps_time = 1000 * 1000 / player->avi_data.AVI_file.vids_fps;
-        ESP_LOGD(TAG, "vids_fps=%d", player->avi_data.AVI_file.vids_fps);
-        esp_timer_start_periodic(player->timer_handle, fps_time);
-
-        if (player->avi_data.mode == PLAY_MEMORY) {
-            player->avi_data.memory.read_offset = player->avi_data.AVI_file.movi_start;
-        } else {
-            fseek(player->avi_data.file.avi_file, player->avi_data.AVI_file.movi_start, SEEK_SET);
-        }
-
-        player->avi_data.state = AVI_PARSER_DATA;
+        stream_start(player);
         *BytesRD = 0;
     }
     case AVI_PARSER_DATA: {
         /*!< clear event */
         xEventGroupClearBits(player->event_group, EVENT_AUDIO_BUF_READY | EVENT_VIDEO_BUF_READY);
         while (1) {
-            player->avi_data.str_size = read_frame(&player->avi_data, player->avi_data.pbuffer, buffer_size, Strtype);
-            ESP_LOGD(TAG, "type=%"PRIu32", size=%"PRIu32"", *Strtype, player->avi_data.str_size);
-            *BytesRD += player->avi_data.str_size + 8;
+            AVI_CHUNK_HEAD head;
+            if (player->avi_data.has_pending) {
+                /*!< the frame we were waiting for, its data follows */
+                head = player->avi_data.pending;
+                player->avi_data.has_pending = false;
+            } else {
+                /*!< movi_size counts the "movi" FourCC itself */
+                if (*BytesRD + 4 >= player->avi_data.AVI_file.movi_size || !read_chunk_head(&player->avi_data, &head)) {
+                    if (stream_next(player, BytesRD)) {
+                        continue;
+                    }
+                    ESP_LOGI(TAG, "play end");
+                    player->avi_data.state = AVI_PARSER_END;
+                    xEventGroupSetBits(player->event_group, EVENT_STOP_PLAY);
+                    return ESP_OK;
+                }
+                *BytesRD += sizeof(AVI_CHUNK_HEAD);
 
-            if (*BytesRD >= player->avi_data.AVI_file.movi_size) {
-                ESP_LOGI(TAG, "play end");
-                player->avi_data.state = AVI_PARSER_END;
-                xEventGroupSetBits(player->event_group, EVENT_STOP_PLAY);
-                return ESP_OK;
+                if (head.FourCC == LIST_ID) {
+                    /*!< "rec " list, step into it and read its chunks */
+                    skip_chunk_data(&player->avi_data, 4);
+                    *BytesRD += 4;
+                    continue;
+                }
+            }
+            *Strtype = head.FourCC;
+
+            uint32_t size = head.size + (head.size & 1);    /*!< add a byte if size is odd */
+            bool is_video = (*Strtype & 0xFFFF0000) == DC_ID;
+            bool is_audio = (*Strtype & 0xFFFF0000) == WB_ID;
+            bool wanted = false;
+            if (is_video) {
+                wanted = player->avi_data.video_pos >= player->avi_data.video_skip;
+            } else if (is_audio) {
+                wanted = player->avi_data.audio_pos >= player->avi_data.audio_skip;
+            } else {
+                ESP_LOGD(TAG, "skip chunk %"PRIx32"", *Strtype);   /*!< JUNK, ix##, ... */
             }
 
-            if ((*Strtype & 0xFFFF0000) == DC_ID) { // Display frame
+            int64_t drift = 0;
+            if (is_video && wanted) {
+                /*!< hand the frame over video_latency_ms before it is due on screen */
+                int64_t due = frame_to_us(&player->avi_data.AVI_file, player->avi_data.video_pos)
+                              - (int64_t)player->config.video_latency_ms * 1000;
+                drift = clock_now(&player->clock) - due;
+                if (drift < -SYNC_EARLY_US) {
+                    /*!< too early, keep the head and come back when it is due */
+                    player->avi_data.pending = head;
+                    player->avi_data.has_pending = true;
+                    esp_timer_stop(player->timer_handle);
+                    esp_timer_start_once(player->timer_handle, -drift);
+                    return ESP_OK;
+                }
+                if (drift > player->avi_data.frame_us && player->clock.drop_run < SYNC_MAX_DROP_RUN) {
+                    /*!< more than a frame late, skip it without reading it */
+                    player->clock.drop_run++;
+                    player->clock.stats.frames_dropped++;
+                    wanted = false;
+                }
+            }
+
+            *BytesRD += size;
+            if (is_video) {
+                player->avi_data.video_pos++;
+            } else if (is_audio) {
+                player->avi_data.audio_pos++;
+            }
+            player->avi_data.pdata = wanted ? read_chunk_data(&player->avi_data, buffer_size, size) : NULL;
+            if (player->avi_data.pdata == NULL) {
+                if (wanted) {
+                    /*!< read_chunk_data() consumed nothing, step over the chunk */
+                    ESP_LOGW(TAG, "drop chunk %"PRIx32" of %"PRIu32" bytes", *Strtype, size);
+                }
+                skip_chunk_data(&player->avi_data, size);
+                continue;
+            }
+            player->avi_data.str_size = head.size;
+            ESP_LOGD(TAG, "type=%"PRIu32", size=%"PRIu32"", *Strtype, player->avi_data.str_size);
+
+            if (is_video) { // Display frame
                 int64_t fr_end = esp_timer_get_time();
                 if (player->config.video_cb) {
                     frame_data_t data = {
-                        .data = player->avi_data.pbuffer,
+                        .data = player->avi_data.pdata,
                         .data_bytes = player->avi_data.str_size,
                         .type = FRAME_TYPE_VIDEO,
                         .video_info.width = player->avi_data.AVI_file.vids_width,
@@ -190,11 +576,22 @@ static esp_err_t avi_player(avi_player_handle_t handle, size_t *BytesRD, uint32_
                 }
                 xEventGroupSetBits(player->event_group, EVENT_VIDEO_BUF_READY);
                 ESP_LOGD(TAG, "Draw %"PRIu32"ms", (uint32_t)((esp_timer_get_time() - fr_end) / 1000));
+
+                avi_player_sync_stats_t *stats = &player->clock.stats;
+                player->clock.drop_run = 0;
+                stats->frames_shown++;
+                stats->drift_ms = drift / 1000;
+                int32_t abs_drift = stats->drift_ms < 0 ? -stats->drift_ms : stats->drift_ms;
+                if (abs_drift > stats->max_drift_ms) {
+                    stats->max_drift_ms = abs_drift;
+                }
+                /*!< go on with the next chunks, the next frame decides when to wait */
+                xEventGroupSetBits(player->event_group, EVENT_FPS_TIME_UP);
                 break;
-            } else if ((*Strtype & 0xFFFF0000) == WB_ID) { // Audio output
+            } else { // Audio output
                 if (player->config.audio_cb) {
                     frame_data_t data = {
-                        .data = player->avi_data.pbuffer,
+                        .data = player->avi_data.pdata,
                         .data_bytes = player->avi_data.str_size,
                         .type = FRAME_TYPE_AUDIO,
                         .audio_info.channel = player->avi_data.AVI_file.auds_channels,
@@ -204,11 +601,8 @@ static esp_err_t avi_player(avi_player_handle_t handle, size_t *BytesRD, uint32_
                     };
                     player->config.audio_cb(&data, player->config.user_data);
                 }
+                clock_audio_done(player, player->avi_data.str_size);
                 xEventGroupSetBits(player->event_group, EVENT_AUDIO_BUF_READY);
-            } else {
-                ESP_LOGE(TAG, "unknown frame %"PRIx32"", *Strtype);
-                xEventGroupSetBits(player->event_group, EVENT_STOP_PLAY);
-                return ESP_FAIL;
             }
         }
         break;
@@ -216,8 +610,11 @@ static esp_err_t avi_player(avi_player_handle_t handle, size_t *BytesRD, uint32_
     case AVI_PARSER_END:
         esp_timer_stop(player->timer_handle);
         if (player->avi_data.mode == PLAY_FILE) {
-            fclose(player->avi_data.file.avi_file);
+            avi_reader_close(player->avi_data.file.reader);
+            player->avi_data.file.reader = NULL;
         }
+        avi_reader_close(take_next(player, NULL));
+        avi_index_free(&player->avi_data.index);
 
         player->avi_data.state = AVI_PARSER_NONE;
         if (player->config.avi_play_end_cb) {
@@ -256,6 +653,15 @@ static void avi_player_task(void *args)
             }
         }
 
+        if ((uxBits & EVENT_SEEK) && player->avi_data.state == AVI_PARSER_DATA) {
+            esp_err_t ret = avi_player_do_seek(player, &BytesRD);
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG, "AVI seek failed");
+            } else {
+                xEventGroupSetBits(player->event_group, EVENT_FPS_TIME_UP);
+            }
+        }
+
         if (uxBits & EVENT_FPS_TIME_UP) {
             esp_err_t ret = avi_player(player, &BytesRD, &Strtype);
             if (ret != ESP_OK) {
@@ -295,7 +701,7 @@ esp_err_t avi_player_get_video_buffer(avi_player_handle_t handle, void **buffer,
         return ESP_ERR_NO_MEM;
     }
 
-    memcpy(*buffer, player->avi_data.pbuffer, player->avi_data.str_size);
+    memcpy(*buffer, player->avi_data.pdata, player->avi_data.str_size);
     *buffer_size = player->avi_data.str_size;
     info->width = player->avi_data.AVI_file.vids_width;
     info->height = player->avi_data.AVI_file.vids_height;
@@ -321,7 +727,7 @@ esp_err_t avi_player_get_audio_buffer(avi_player_handle_t handle, void **buffer,
         return ESP_ERR_NO_MEM;
     }
 
-    memcpy(*buffer, player->avi_data.pbuffer, player->avi_data.str_size);
+    memcpy(*buffer, player->avi_data.pdata, player->avi_data.str_size);
     *buffer_size = player->avi_data.str_size;
     info->channel = player->avi_data.AVI_file.auds_channels;
     info->bits_per_sample = player->avi_data.AVI_file.auds_bits;
@@ -342,21 +748,56 @@ esp_err_t avi_player_play_from_memory(avi_player_handle_t handle, uint8_t *avi_d
     return ESP_OK;
 }
 
+static esp_err_t open_reader(avi_player_t *player, const char *filename, avi_reader_handle_t *reader)
+{
+    /*!< the reader task only waits for the card, run it above the player so the ring is refilled right away */
+    avi_reader_config_t reader_config = {
+        .block_size = player->config.read_block_size,
+        .block_count = player->config.read_block_count,
+        .priority = player->config.priority + 1 < configMAX_PRIORITIES ? player->config.priority + 1 : player->config.priority,
+        .core_id = player->config.coreID,
+    };
+    return avi_reader_open(filename, &reader_config, reader);
+}
+
 esp_err_t  avi_player_play_from_file(avi_player_handle_t handle, const char *filename)
 {
     avi_player_t *player = (avi_player_t *)handle;
     ESP_RETURN_ON_FALSE(player->avi_data.state == AVI_PARSER_NONE, ESP_ERR_INVALID_STATE, TAG, "AVI player not ready");
 
+    avi_reader_close(take_next(player, NULL));  /*!< queued after the last file ended */
     player->avi_data.mode = PLAY_FILE;
-    player->avi_data.file.avi_file = fopen(filename, "rb");
-    if (player->avi_data.file.avi_file == NULL) {
+    if (open_reader(player, filename, &player->avi_data.file.reader) != ESP_OK) {
         ESP_LOGE(TAG, "Cannot open %s", filename);
+        player->avi_data.file.reader = NULL;
         return ESP_FAIL;
     }
     xEventGroupSetBits(player->event_group, EVENT_START_PLAY);
     return ESP_OK;
 }
 
+esp_err_t avi_player_set_next_file(avi_player_handle_t handle, const char *filename)
+{
+    avi_player_t *player = (avi_player_t *)handle;
+    ESP_RETURN_ON_FALSE(player != NULL && filename != NULL, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    avi_next_t next = {0};
+    ESP_RETURN_ON_FALSE(open_reader(player, filename, &next.reader) == ESP_OK, ESP_FAIL, TAG, "Cannot open %s", filename);
+    int ret = parse_file_header(player, next.reader, &next.AVI_file);
+    if (0 > ret) {
+        ESP_LOGE(TAG, "%s: parse failed (%d)", filename, ret);
+        avi_reader_close(next.reader);
+        return ESP_FAIL;
+    }
+
+    xSemaphoreTake(player->next_lock, portMAX_DELAY);
+    avi_reader_handle_t old = player->next.reader;
+    player->next = next;
+    xSemaphoreGive(player->next_lock);
+    avi_reader_close(old);
+    return ESP_OK;
+}
+
 esp_err_t avi_player_play_stop(avi_player_handle_t handle)
 {
     avi_player_t *player = (avi_player_t *)handle;
@@ -366,6 +807,68 @@ esp_err_t avi_player_play_stop(avi_player_handle_t handle)
     return ESP_OK;
 }
 
+esp_err_t avi_player_seek(avi_player_handle_t handle, uint32_t position_ms)
+{
+    avi_player_t *player = (avi_player_t *)handle;
+    ESP_RETURN_ON_FALSE(player != NULL, ESP_ERR_INVALID_ARG, TAG, "handle can’t be NULL");
+    ESP_RETURN_ON_FALSE(player->avi_data.state == AVI_PARSER_HEADER || player->avi_data.state == AVI_PARSER_DATA,
+                        ESP_ERR_INVALID_STATE, TAG, "AVI player not playing");
+    player->seek_ms = position_ms;
+    xEventGroupSetBits(player->event_group, EVENT_SEEK);
+    return ESP_OK;
+}
+
+esp_err_t avi_player_get_position(avi_player_handle_t handle, uint32_t *position_ms)
+{
+    avi_player_t *player = (avi_player_t *)handle;
+    ESP_RETURN_ON_FALSE(player != NULL && position_ms != NULL, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(player->avi_data.state == AVI_PARSER_DATA, ESP_ERR_INVALID_STATE, TAG, "AVI player not playing");
+    uint32_t frame = player->avi_data.video_pos;
+    *position_ms = frame_to_ms(&player->avi_data.AVI_file, frame ? frame - 1 : 0);
+    return ESP_OK;
+}
+
+esp_err_t avi_player_get_duration(avi_player_handle_t handle, uint32_t *duration_ms)
+{
+    avi_player_t *player = (avi_player_t *)handle;
+    ESP_RETURN_ON_FALSE(player != NULL && duration_ms != NULL, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(player->avi_data.state == AVI_PARSER_DATA, ESP_ERR_INVALID_STATE, TAG, "AVI player not playing");
+    uint32_t frames = player->avi_data.index.valid ? player->avi_data.index.video_count : player->avi_data.AVI_file.vids_length;
+    *duration_ms = frame_to_ms(&player->avi_data.AVI_file, frames);
+    return ESP_OK;
+}
+
+esp_err_t avi_player_get_sync_stats(avi_player_handle_t handle, avi_player_sync_stats_t *stats)
+{
+    avi_player_t *player = (avi_player_t *)handle;
+    ESP_RETURN_ON_FALSE(player != NULL && stats != NULL, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(player->avi_data.state == AVI_PARSER_DATA, ESP_ERR_INVALID_STATE, TAG, "AVI player not playing");
+    *stats = player->clock.stats;
+    return ESP_OK;
+}
+
+esp_err_t avi_player_get_io_stats(avi_player_handle_t handle, avi_player_io_stats_t *stats)
+{
+    avi_player_t *player = (avi_player_t *)handle;
+    ESP_RETURN_ON_FALSE(player != NULL && stats != NULL, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(player->avi_data.state == AVI_PARSER_DATA, ESP_ERR_INVALID_STATE, TAG, "AVI player not playing");
+    ESP_RETURN_ON_FALSE(player->avi_data.mode == PLAY_FILE, ESP_ERR_NOT_SUPPORTED, TAG, "not playing from a file");
+
+    avi_reader_stats_t reader;
+    avi_reader_get_stats(player->avi_data.file.reader, &reader);
+    *stats = (avi_player_io_stats_t) {
+        .bytes_read = reader.bytes,
+        .read_calls = reader.reads,
+        .read_kbps = reader.read_us ? (uint32_t)(reader.bytes * 1000000 / 1024 / reader.read_us) : 0,
+        .stalls = reader.stalls,
+        .stall_ms = reader.stall_us / 1000,
+        .chunks_in_place = player->avi_data.chunks_in_place,
+        .chunks_copied = player->avi_data.chunks_copied,
+        .read_restarts = reader.restarts,
+    };
+    return ESP_OK;
+}
+
 static void esp_timer_cb(void *arg)
 {
     avi_player_t *player = (avi_player_t *)arg;
@@ -388,6 +891,13 @@ esp_err_t avi_player_init(avi_player_config_t config, avi_player_handle_t *handl
     if (player->config.stack_size == 0) {
         player->config.stack_size = 4096;
     }
+    if (player->config.read_block_size == 0) {
+        player->config.read_block_size = READ_BLOCK_SIZE;
+    }
+    player->config.read_block_size = (player->config.read_block_size + 511) & ~511;
+    if (player->config.read_block_count < 2) {
+        player->config.read_block_count = READ_BLOCK_COUNT;
+    }
 
     player->avi_data.pbuffer = malloc(player->config.buffer_size);
     ESP_RETURN_ON_FALSE(player->avi_data.pbuffer != NULL, ESP_ERR_NO_MEM, TAG, "Cannot alloc memory for player");
@@ -402,6 +912,8 @@ esp_err_t avi_player_init(avi_player_config_t config, avi_player_handle_t *handl
     player->event_group = xEventGroupCreate();
     assert(player->event_group);
     ESP_RETURN_ON_FALSE(player->event_group != NULL, ESP_ERR_NO_MEM, TAG, "Cannot create event group");
+    player->next_lock = xSemaphoreCreateMutex();
+    ESP_RETURN_ON_FALSE(player->next_lock != NULL, ESP_ERR_NO_MEM, TAG, "Cannot create mutex");
 
     *handle = (avi_player_handle_t *)player;
 
@@ -436,6 +948,14 @@ esp_err_t avi_player_deinit(avi_player_handle_t handle)
     if (player->avi_data.pbuffer != NULL) {
         free(player->avi_data.pbuffer);
     }
+    avi_index_free(&player->avi_data.index);
+    if (player->avi_data.mode == PLAY_FILE && player->avi_data.file.reader != NULL) {
+        avi_reader_close(player->avi_data.file.reader);
+    }
+    avi_reader_close(player->next.reader);
+    if (player->next_lock != NULL) {
+        vSemaphoreDelete(player->next_lock);
+    }
 
     if (player->event_group != NULL) {
         vEventGroupDelete(player->event_group);
@@ -0,0 +1,321 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "avi_reader.h"
+
+static const char *TAG = "avi reader";
+
+#define READER_ALIGN        (64)    /*!< Cache line, lets the SDMMC host DMA straight into PSRAM */
+#define READER_STACK_SIZE   (3072)
+
+struct avi_reader {
+    int fd;
+    uint32_t file_size;
+    uint32_t block_size;
+    uint32_t block_count;
+    uint8_t *ring;              /*!< block_count blocks back to back, so data across blocks is contiguous unless it wraps */
+
+    /*!< Ring state, protected by lock. Blocks head .. head + count - 1 hold the file from base on. */
+    uint32_t head;
+    uint32_t count;
+    uint32_t base;
+    uint32_t gen;               /*!< Bumped when the ring is dropped, a read in flight for an older gen is discarded */
+    bool error;
+    avi_reader_stats_t stats;
+
+    uint32_t pos;               /*!< Read position, only touched by the consumer */
+
+    SemaphoreHandle_t lock;
+    SemaphoreHandle_t io_lock;  /*!< Serializes lseek + read between the reader task and avi_reader_pread() */
+    SemaphoreHandle_t data_ready;
+    SemaphoreHandle_t exited;
+    TaskHandle_t task;
+    volatile bool exit;
+};
+
+static ssize_t file_read(avi_reader_handle_t r, uint32_t offset, void *buffer, size_t length)
+{
+    ssize_t n = -1;
+    xSemaphoreTake(r->io_lock, portMAX_DELAY);
+    if (lseek(r->fd, offset, SEEK_SET) == (off_t)offset) {
+        n = read(r->fd, buffer, length);
+    }
+    xSemaphoreGive(r->io_lock);
+    return n;
+}
+
+static void reader_task(void *arg)
+{
+    avi_reader_handle_t r = (avi_reader_handle_t)arg;
+    while (!r->exit) {
+        xSemaphoreTake(r->lock, portMAX_DELAY);
+        uint32_t offset = r->base + r->count * r->block_size;
+        uint32_t slot = (r->head + r->count) % r->block_count;
+        uint32_t gen = r->gen;
+        bool fill = r->count < r->block_count && offset < r->file_size && !r->error;
+        xSemaphoreGive(r->lock);
+
+        if (!fill) {
+            /*!< ring full or file done, wait for the consumer to free a block or seek */
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        size_t length = r->file_size - offset;
+        length = length > r->block_size ? r->block_size : length;
+        int64_t start = esp_timer_get_time();
+        ssize_t n = file_read(r, offset, r->ring + slot * r->block_size, length);
+        int64_t spent = esp_timer_get_time() - start;
+
+        xSemaphoreTake(r->lock, portMAX_DELAY);
+        r->stats.reads++;
+        r->stats.read_us += spent;
+        if (n > 0) {
+            r->stats.bytes += n;
+        }
+        if (gen == r->gen) {
+            if (n == (ssize_t)length) {
+                r->count++;
+            } else {
+                ESP_LOGE(TAG, "read %"PRIu32" bytes at %"PRIu32" failed (%d)", (uint32_t)length, offset, (int)n);
+                r->error = true;
+            }
+        }
+        xSemaphoreGive(r->lock);
+        xSemaphoreGive(r->data_ready);
+    }
+    xSemaphoreGive(r->exited);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Drop the blocks the read position has passed, lock held
+ */
+static void ring_drop(avi_reader_handle_t r)
+{
+    bool dropped = false;
+    while (r->count > 0 && r->pos >= r->base + r->block_size) {
+        r->head = (r->head + 1) % r->block_count;
+        r->base += r->block_size;
+        r->count--;
+        dropped = true;
+    }
+    if (r->count == 0 && r->pos >= r->base + r->block_size) {
+        /*!< skipped past everything read so far, restart at the block of the read position */
+        r->gen++;
+        r->base = r->pos - r->pos % r->block_size;
+        dropped = true;
+    }
+    if (dropped) {
+        xTaskNotifyGive(r->task);
+    }
+}
+
+/**
+ * @brief Wait until length bytes from the read position are in the ring
+ *
+ * @return Bytes available from the read position, at most length. Less at the end of the file, on a read
+ *         error, or if the request cannot fit in the ring.
+ */
+static size_t ring_wait(avi_reader_handle_t r, size_t length)
+{
+    int64_t start = 0;
+    size_t avail;
+    xSemaphoreTake(r->lock, portMAX_DELAY);
+    while (1) {
+        ring_drop(r);
+        uint32_t end = r->base + r->count * r->block_size;
+        end = end > r->file_size ? r->file_size : end;
+        avail = end > r->pos ? end - r->pos : 0;
+        if (avail >= length || end >= r->file_size || r->error ||
+                r->pos - r->base + length > r->block_count * r->block_size) {
+            break;
+        }
+        xSemaphoreGive(r->lock);
+        if (start == 0) {
+            start = esp_timer_get_time();
+        }
+        xSemaphoreTake(r->data_ready, pdMS_TO_TICKS(100));
+        xSemaphoreTake(r->lock, portMAX_DELAY);
+    }
+    if (start) {
+        r->stats.stalls++;
+        r->stats.stall_us += esp_timer_get_time() - start;
+    }
+    xSemaphoreGive(r->lock);
+    return avail > length ? length : avail;
+}
+
+/**
+ * @brief Ring offset of the read position, the blocks up to it cannot be dropped by the reader task
+ */
+static uint32_t ring_offset(avi_reader_handle_t r)
+{
+    uint32_t from_head = r->pos - r->base;
+    uint32_t slot = (r->head + from_head / r->block_size) % r->block_count;
+    return slot * r->block_size + from_head % r->block_size;
+}
+
+esp_err_t avi_reader_open(const char *path, const avi_reader_config_t *config, avi_reader_handle_t *ret_reader)
+{
+    ESP_RETURN_ON_FALSE(config->block_size >= 512 && config->block_size % 512 == 0 && config->block_count >= 2,
+                        ESP_ERR_INVALID_ARG, TAG, "invalid read-ahead config");
+    esp_err_t ret = ESP_OK;
+    avi_reader_handle_t r = calloc(1, sizeof(struct avi_reader));
+    ESP_RETURN_ON_FALSE(r != NULL, ESP_ERR_NO_MEM, TAG, "Cannot alloc reader");
+    r->block_size = config->block_size;
+    r->block_count = config->block_count;
+
+    r->fd = open(path, O_RDONLY);
+    ESP_GOTO_ON_FALSE(r->fd >= 0, ESP_ERR_NOT_FOUND, err, TAG, "Cannot open %s", path);
+    struct stat st;
+    ESP_GOTO_ON_FALSE(fstat(r->fd, &st) == 0, ESP_ERR_NOT_FOUND, err, TAG, "Cannot stat %s", path);
+    r->file_size = st.st_size;
+
+    size_t ring_size = r->block_size * r->block_count;
+    r->ring = heap_caps_aligned_alloc(READER_ALIGN, ring_size, MALLOC_CAP_SPIRAM);
+    if (r->ring == NULL) {
+        r->ring = heap_caps_aligned_alloc(READER_ALIGN, ring_size, MALLOC_CAP_DEFAULT);
+    }
+    ESP_GOTO_ON_FALSE(r->ring != NULL, ESP_ERR_NO_MEM, err, TAG, "Cannot alloc %d bytes read-ahead", (int)ring_size);
+
+    r->lock = xSemaphoreCreateMutex();
+    r->io_lock = xSemaphoreCreateMutex();
+    r->data_ready = xSemaphoreCreateBinary();
+    r->exited = xSemaphoreCreateBinary();
+    ESP_GOTO_ON_FALSE(r->lock && r->io_lock && r->data_ready && r->exited, ESP_ERR_NO_MEM, err, TAG, "Cannot create semaphores");
+
+    ESP_GOTO_ON_FALSE(xTaskCreatePinnedToCore(reader_task, "avi_reader", READER_STACK_SIZE, r, config->priority, &r->task, config->core_id) == pdPASS,
+                      ESP_ERR_NO_MEM, err, TAG, "Cannot create reader task");
+    *ret_reader = r;
+    return ESP_OK;
+
+err:
+    avi_reader_close(r);
+    return ret;
+}
+
+void avi_reader_close(avi_reader_handle_t r)
+{
+    if (r == NULL) {
+        return;
+    }
+    if (r->task) {
+        r->exit = true;
+        xTaskNotifyGive(r->task);
+        xSemaphoreTake(r->exited, portMAX_DELAY);
+        ESP_LOGD(TAG, "%"PRIu32" reads, %"PRIu64" bytes in %"PRIu32"ms, %"PRIu32" stalls for %"PRIu32"ms",
+                 r->stats.reads, r->stats.bytes, (uint32_t)(r->stats.read_us / 1000), r->stats.stalls, (uint32_t)(r->stats.stall_us / 1000));
+    }
+    if (r->lock) {
+        vSemaphoreDelete(r->lock);
+    }
+    if (r->io_lock) {
+        vSemaphoreDelete(r->io_lock);
+    }
+    if (r->data_ready) {
+        vSemaphoreDelete(r->data_ready);
+    }
+    if (r->exited) {
+        vSemaphoreDelete(r->exited);
+    }
+    heap_caps_free(r->ring);
+    if (r->fd >= 0) {
+        close(r->fd);
+    }
+    free(r);
+}
+
+uint32_t avi_reader_size(avi_reader_handle_t r)
+{
+    return r->file_size;
+}
+
+uint32_t avi_reader_tell(avi_reader_handle_t r)
+{
+    return r->pos;
+}
+
+size_t avi_reader_read(avi_reader_handle_t r, void *buffer, size_t length)
+{
+    uint32_t ring_size = r->block_size * r->block_count;
+    size_t done = 0;
+    while (done < length) {
+        size_t want = length - done;
+        size_t n = ring_wait(r, want > r->block_size ? r->block_size : want);
+        if (n == 0) {
+            break;
+        }
+        uint32_t at = ring_offset(r);
+        if (at + n > ring_size) {
+            n = ring_size - at;
+        }
+        memcpy((uint8_t *)buffer + done, r->ring + at, n);
+        r->pos += n;
+        done += n;
+    }
+    return done;
+}
+
+uint8_t *avi_reader_view(avi_reader_handle_t r, size_t length)
+{
+    if (ring_wait(r, length) < length) {
+        return NULL;
+    }
+    uint32_t at = ring_offset(r);
+    if (at + length > r->block_size * r->block_count) {
+        return NULL;
+    }
+    r->pos += length;
+    return r->ring + at;
+}
+
+void avi_reader_skip(avi_reader_handle_t r, size_t length)
+{
+    r->pos += length;
+}
+
+void avi_reader_seek(avi_reader_handle_t r, uint32_t offset)
+{
+    xSemaphoreTake(r->lock, portMAX_DELAY);
+    r->pos = offset;
+    if (r->count == 0 || offset < r->base || offset >= r->base + r->count * r->block_size) {
+        r->gen++;
+        r->stats.restarts++;
+        r->head = 0;
+        r->count = 0;
+        r->base = offset - offset % r->block_size;
+        r->error = false;
+        xTaskNotifyGive(r->task);
+    }
+    xSemaphoreGive(r->lock);
+}
+
+size_t avi_reader_pread(avi_reader_handle_t r, uint32_t offset, void *buffer, size_t length)
+{
+    ssize_t n = file_read(r, offset, buffer, length);
+    return n > 0 ? n : 0;
+}
+
+void avi_reader_get_stats(avi_reader_handle_t r, avi_reader_stats_t *stats)
+{
+    xSemaphoreTake(r->lock, portMAX_DELAY);
+    *stats = r->stats;
+    xSemaphoreGive(r->lock);
+}
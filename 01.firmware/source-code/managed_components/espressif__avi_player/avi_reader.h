@@ -0,0 +1,121 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Read-ahead configuration
+ */
+typedef struct {
+    uint32_t block_size;        /*!< Size of one read, a multiple of 512 bytes. Reads start at multiples of it */
+    uint32_t block_count;       /*!< Number of blocks in the ring, at least 2 */
+    UBaseType_t priority;       /*!< Priority of the reader task */
+    BaseType_t core_id;         /*!< Core of the reader task */
+} avi_reader_config_t;
+
+/**
+ * @brief Read-ahead counters
+ */
+typedef struct {
+    uint64_t bytes;             /*!< Bytes read from the file */
+    uint32_t reads;             /*!< read() calls */
+    uint64_t read_us;           /*!< Time spent in read() */
+    uint32_t stalls;            /*!< Requests that had to wait for the reader */
+    uint64_t stall_us;          /*!< Time spent waiting for the reader */
+    uint32_t restarts;          /*!< Seeks outside the ring that dropped it and restarted reading */
+} avi_reader_stats_t;
+
+typedef struct avi_reader *avi_reader_handle_t;
+
+/**
+ * @brief Open a file and start reading it ahead
+ *
+ * A reader task reads the file sequentially into a ring of block_count blocks of block_size bytes in
+ * PSRAM. Every read is one read() call of a whole block at a block aligned offset, so FATFS can move
+ * whole clusters straight into the ring instead of going through its sector buffer.
+ *
+ * @param[in]  path       File to open
+ * @param[in]  config     Read-ahead configuration
+ * @param[out] ret_reader Reader handle
+ *
+ * @return
+ *      - ESP_OK: Success
+ *      - ESP_ERR_NOT_FOUND: Cannot open the file
+ *      - ESP_ERR_NO_MEM: Cannot allocate the ring or the task
+ */
+esp_err_t avi_reader_open(const char *path, const avi_reader_config_t *config, avi_reader_handle_t *ret_reader);
+
+/**
+ * @brief Stop the reader task, close the file and free the ring
+ */
+void avi_reader_close(avi_reader_handle_t reader);
+
+/**
+ * @brief Size of the file
+ */
+uint32_t avi_reader_size(avi_reader_handle_t reader);
+
+/**
+ * @brief Read position
+ */
+uint32_t avi_reader_tell(avi_reader_handle_t reader);
+
+/**
+ * @brief Copy data at the read position and advance it
+ *
+ * The read, view, skip and seek functions are meant to be called from a single task.
+ *
+ * @return Number of bytes copied, less than length at the end of the file or on a read error
+ */
+size_t avi_reader_read(avi_reader_handle_t reader, void *buffer, size_t length);
+
+/**
+ * @brief Get data at the read position in place and advance it
+ *
+ * The data stays valid until the next call on the reader.
+ *
+ * @return Pointer into the ring, or NULL if the data wraps around the end of the ring, does not fit in
+ *         it, or runs past the end of the file. The read position is not moved in that case.
+ */
+uint8_t *avi_reader_view(avi_reader_handle_t reader, size_t length);
+
+/**
+ * @brief Advance the read position without reading the data
+ */
+void avi_reader_skip(avi_reader_handle_t reader, size_t length);
+
+/**
+ * @brief Move the read position
+ *
+ * Data already in the ring is kept if the position is inside it, otherwise the ring is dropped and
+ * reading restarts at the block containing the position.
+ */
+void avi_reader_seek(avi_reader_handle_t reader, uint32_t offset);
+
+/**
+ * @brief Random access read that bypasses the ring, used to build the index
+ *
+ * @return Number of bytes read
+ */
+size_t avi_reader_pread(avi_reader_handle_t reader, uint32_t offset, void *buffer, size_t length);
+
+/**
+ * @brief Get the read-ahead counters
+ */
+void avi_reader_get_stats(avi_reader_handle_t reader, avi_reader_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
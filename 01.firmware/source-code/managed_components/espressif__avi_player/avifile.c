@@ -34,12 +34,37 @@ static int search_fourcc(uint32_t fourcc, const uint8_t *buffer, uint32_t length
     return -1;
 }
 
+/**
+ * @brief Walk the sub-chunks of a stream list (strh, strf, strd, indx, ...) and find the OpenDML "indx" chunk.
+ *
+ * @return File offset of the "indx" chunk, or 0 if the stream has none.
+ */
+static uint32_t find_indx(const uint8_t *strl, uint32_t list_length, uint32_t length, uint32_t offset)
+{
+    uint32_t end = list_length < length ? list_length : length;
+    uint32_t pos = sizeof(AVI_LIST_HEAD);
+    while (pos + sizeof(AVI_CHUNK_HEAD) <= end) {
+        const AVI_CHUNK_HEAD *chunk = (const AVI_CHUNK_HEAD *)(strl + pos);
+        if (chunk->FourCC == INDX_ID) {
+            return offset + pos;
+        }
+        /*!< 64-bit so that a corrupt size cannot wrap pos back into the list */
+        uint64_t next = (uint64_t)pos + sizeof(AVI_CHUNK_HEAD) + chunk->size + (chunk->size & 1);
+        if (next <= pos || next > end) {
+            break;
+        }
+        pos = (uint32_t)next;
+    }
+    return 0;
+}
+
 /**
  * @brief Parse the AVI stream list (strl) from the AVI file buffer.
  *
  * @param AVI_file Pointer to the AVI file structure.
  * @param buffer Pointer to the AVI file buffer.
  * @param length Length of the AVI file buffer.
+ * @param offset File offset of the list, used to locate the OpenDML "indx" chunk.
  * @param list_length Pointer to store the length of the parsed list.
  *
  * @return
@@ -47,7 +72,7 @@ static int search_fourcc(uint32_t fourcc, const uint8_t *buffer, uint32_t length
  *     - -1: Invalid list or FourCC
  *     - -5: Invalid size or FourCC for strh or strf
  */
-static int strl_parser(avi_typedef *AVI_file, const uint8_t *buffer, uint32_t length, uint32_t *list_length)
+static int strl_parser(avi_typedef *AVI_file, const uint8_t *buffer, uint32_t length, uint32_t offset, uint32_t *list_length)
 {
     /**
      * TODO: how to deal with the list is not complete in the buffer
@@ -117,8 +142,12 @@ static int strl_parser(avi_typedef *AVI_file, const uint8_t *buffer, uint32_t le
         printf("Number of important colors:%"PRIu32"\r\n\n", strf->imp_colors);
 #endif
         AVI_file->vids_fps = strh->rate / strh->scale;
+        AVI_file->vids_scale = strh->scale;
+        AVI_file->vids_rate = strh->rate;
+        AVI_file->vids_length = strh->length;
         AVI_file->vids_width = strf->width;
         AVI_file->vids_height = strf->height;
+        AVI_file->vids_indx = find_indx(buffer, *list_length, length, offset);
         pdata += sizeof(AVI_VIDS_STRF_CHUNK);
     } else if (AUDS_ID == strh->fourcc_type) {
         ESP_LOGI(TAG, "Find a audio stream");
@@ -140,6 +169,8 @@ static int strl_parser(avi_typedef *AVI_file, const uint8_t *buffer, uint32_t le
         AVI_file->auds_channels = strf->channels;
         AVI_file->auds_sample_rate = strf->samples_per_sec;
         AVI_file->auds_bits = strf->bits_per_sample;
+        AVI_file->auds_bytes_per_sec = strf->avg_bytes_per_sec;
+        AVI_file->auds_indx = find_indx(buffer, *list_length, length, offset);
         pdata += sizeof(AVI_AUDS_STRF_CHUNK);
     } else {
         ESP_LOGW(TAG, "Unsupported stream 0x%"PRIu32"", strh->fourcc_type);
@@ -150,6 +181,7 @@ static int strl_parser(avi_typedef *AVI_file, const uint8_t *buffer, uint32_t le
 int avi_parser(avi_typedef *AVI_file, const uint8_t *buffer, uint32_t length)
 {
     const uint8_t *pdata = buffer;
+    memset(AVI_file, 0, sizeof(avi_typedef));
     AVI_LIST_HEAD *riff = (AVI_LIST_HEAD*)pdata;
     if (riff->List != RIFF_ID || riff->FourCC != AVI_ID) {
         return -1;
@@ -193,7 +225,7 @@ int avi_parser(avi_typedef *AVI_file, const uint8_t *buffer, uint32_t length)
     /*!< process all streams in turn */
     for (size_t i = 0; i < avih->streams; i++) {
         uint32_t strl_size = 0;
-        int ret = strl_parser(AVI_file, pdata, length - (pdata - buffer), &strl_size);
+        int ret = strl_parser(AVI_file, pdata, length - (pdata - buffer), pdata - buffer, &strl_size);
         if (0 > ret) {
             ESP_LOGE(TAG, "strl of stream%d prase failed", i);
             break;
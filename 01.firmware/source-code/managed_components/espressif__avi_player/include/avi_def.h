@@ -117,4 +117,35 @@ typedef struct {
     uint32_t chunklength;
 } __attribute__((packed)) AVI_IDX1;
 
+#define AVI_INDEX_OF_INDEXES 0x00  /*!< bIndexType of an OpenDML super index */
+#define AVI_INDEX_OF_CHUNKS  0x01  /*!< bIndexType of an OpenDML standard index */
+
+/*!< OpenDML index header, shared by the super index "indx" and the standard index "ix##" */
+typedef struct {
+    uint32_t FourCC;            /*!< Chunk ID, "indx" or "ix##" */
+    uint32_t size;              /*!< Size of the chunk */
+    uint16_t longs_per_entry;   /*!< Size of each entry in 4-byte units, 4 for "indx", 2 for "ix##" */
+    uint8_t  index_sub_type;    /*!< Must be 0 */
+    uint8_t  index_type;        /*!< AVI_INDEX_OF_INDEXES or AVI_INDEX_OF_CHUNKS */
+    uint32_t entries_in_use;    /*!< Number of valid entries */
+    uint32_t chunk_id;          /*!< Chunk ID of the indexed stream, such as "00dc" */
+    uint32_t base_offset_low;   /*!< "ix##": low 32 bits of the base offset. "indx": reserved */
+    uint32_t base_offset_high;  /*!< "ix##": high 32 bits of the base offset. "indx": reserved */
+    uint32_t reserved;
+} __attribute__((packed)) AVI_ODML_INDEX_HEAD;
+
+/*!< Entry of an OpenDML super index, points to one "ix##" chunk */
+typedef struct {
+    uint32_t offset_low;        /*!< File offset of the "ix##" chunk, low 32 bits */
+    uint32_t offset_high;       /*!< File offset of the "ix##" chunk, high 32 bits */
+    uint32_t size;              /*!< Size of the "ix##" chunk */
+    uint32_t duration;          /*!< Time span covered by the "ix##" chunk, in stream ticks */
+} __attribute__((packed)) AVI_ODML_SUPER_ENTRY;
+
+/*!< Entry of an OpenDML standard index */
+typedef struct {
+    uint32_t offset;            /*!< Offset of the chunk data relative to the base offset */
+    uint32_t size;              /*!< Size of the chunk data, bit 31 set means not a key frame */
+} __attribute__((packed)) AVI_ODML_STD_ENTRY;
+
 #endif
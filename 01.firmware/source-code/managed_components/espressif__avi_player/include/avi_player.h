@@ -82,7 +82,10 @@ typedef struct {
 typedef void (*video_write_cb)(frame_data_t *data, void *arg);
 typedef void (*audio_write_cb)(frame_data_t *data, void *arg);
 typedef void (*audio_set_clock_cb)(uint32_t rate, uint32_t bits_cfg, uint32_t ch, void *arg);
+typedef size_t (*audio_queued_cb)(void *arg);
+typedef void (*audio_flush_cb)(void *arg);
 typedef void (*avi_play_end_cb)(void *arg);
+typedef void (*avi_play_next_cb)(void *arg);
 
 typedef void *avi_player_handle_t;
 
@@ -95,20 +98,56 @@ typedef struct {
     video_write_cb video_cb;                 /*!< Video frame callback */
     audio_write_cb audio_cb;                 /*!< Audio frame callback */
     audio_set_clock_cb audio_set_clock_cb;   /*!< Audio set clock callback */
+    audio_queued_cb audio_queued_cb;         /*!< Optional, audio bytes taken by audio_cb but not written to the output yet (e.g. in a PCM ring) */
+    audio_flush_cb audio_flush_cb;           /*!< Optional, drop the audio queued by audio_cb, called on seek */
     avi_play_end_cb avi_play_end_cb;         /*!< AVI play end callback */
+    avi_play_next_cb avi_play_next_cb;       /*!< The file set by avi_player_set_next_file() took over, avi_play_end_cb is not called */
     UBaseType_t priority;                    /*!< FreeRTOS task priority */
     BaseType_t coreID;                       /*!< ESP32 core ID */
     void *user_data;                         /*!< User data */
     int stack_size;                          /*!< Stack size for the player task */
+    uint32_t audio_latency_ms;               /*!< Audio still queued in the output (e.g. I2S DMA) when audio_cb returns, on top of audio_queued_cb */
+    uint32_t video_latency_ms;               /*!< Time from video_cb to the frame being on screen, frames are handed over this much earlier */
+    uint32_t read_block_size;                /*!< File read-ahead block, rounded up to 512 bytes, 0 for 64 KB. Best a multiple of the FAT cluster */
+    uint32_t read_block_count;               /*!< Number of read-ahead blocks in PSRAM, 0 for 4 */
 #if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 1, 0)
     bool stack_in_psram;                     /*!< If you read file/data from flash, do not set true*/
 #endif
 } avi_player_config_t;
 
+/**
+ * @brief A/V sync counters
+ *
+ */
+typedef struct {
+    uint32_t frames_shown;                   /*!< Video frames passed to the video callback */
+    uint32_t frames_dropped;                 /*!< Late video frames skipped without being read */
+    int32_t drift_ms;                        /*!< Clock minus due time of the last frame shown, positive when video is late */
+    int32_t max_drift_ms;                    /*!< Largest absolute drift since the file started */
+    bool audio_master;                       /*!< The clock follows the audio consumed, otherwise the wall clock */
+} avi_player_sync_stats_t;
+
+/**
+ * @brief File read-ahead counters
+ *
+ */
+typedef struct {
+    uint64_t bytes_read;                     /*!< Bytes read from the file */
+    uint32_t read_calls;                     /*!< read() calls on the file */
+    uint32_t read_kbps;                      /*!< Throughput while reading, KB/s */
+    uint32_t stalls;                         /*!< Times the player task had to wait for the reader */
+    uint32_t stall_ms;                       /*!< Total time the player task waited for the reader */
+    uint32_t chunks_in_place;                /*!< Chunks handed to the callbacks straight from the read-ahead ring */
+    uint32_t chunks_copied;                  /*!< Chunks copied to the internal buffer because they wrap around the ring */
+    uint32_t read_restarts;                  /*!< Seeks outside the ring that dropped it and restarted the read-ahead */
+} avi_player_io_stats_t;
+
 /**
  * @brief Plays an AVI file from memory. The buffer of the AVI will be passed through the set callback function.
  *
- * This function initializes and plays an AVI file from a memory buffer.
+ * This function initializes and plays an AVI file from a memory buffer. Chunks are passed to the
+ * callbacks in place, without copying, so the buffer can be a memory mapped flash partition. It must
+ * stay valid until the play end callback.
  *
  * @param[in] handle AVI player handle
  * @param[in] avi_data Pointer to the AVI file data in memory.
@@ -162,6 +201,25 @@ esp_err_t avi_player_get_video_buffer(avi_player_handle_t handle, void **buffer,
  */
 esp_err_t avi_player_get_audio_buffer(avi_player_handle_t handle, void **buffer, size_t *buffer_size, audio_frame_info_t *info, TickType_t ticks_to_wait);
 
+/**
+ * @brief Queue a file to play right after the one playing
+ *
+ * The file is opened, read ahead and its header parsed in the calling task, so when the current file
+ * ends the player goes straight on with its first chunk instead of stopping. audio_set_clock_cb is only
+ * called again if the audio format differs. avi_play_next_cb is called once the queued file has taken
+ * over, the next file can be queued from then on. A file already queued is replaced. Call it after
+ * avi_player_play_from_file(), which drops a file left queued when the player stopped.
+ *
+ * @param[in] handle AVI player handle
+ * @param[in] filename Path to the AVI file on the filesystem
+ *
+ * @return
+ *      - ESP_OK: File queued
+ *      - ESP_ERR_INVALID_ARG: NULL arguments
+ *      - ESP_FAIL: Cannot open or parse the file
+ */
+esp_err_t avi_player_set_next_file(avi_player_handle_t handle, const char *filename);
+
 /**
  * @brief Stop AVI player
  *
@@ -172,6 +230,87 @@ esp_err_t avi_player_get_audio_buffer(avi_player_handle_t handle, void **buffer,
  */
 esp_err_t avi_player_play_stop(avi_player_handle_t handle);
 
+/**
+ * @brief Jump to a position of the AVI being played
+ *
+ * Playback continues from the video chunk at or before the position, together with the audio chunk
+ * that covers the same time. The chunk offset table ("indx"/"ix##" OpenDML index, "idx1" index, or a
+ * walk over the chunk heads if the file has no index) is built in PSRAM on the first seek of each file.
+ *
+ * @note The seek is executed asynchronously by the player task.
+ *
+ * @param[in] handle AVI player handle
+ * @param[in] position_ms Target position in milliseconds, clamped to the last video frame
+ *
+ * @return
+ *      - ESP_OK: Seek request accepted
+ *      - ESP_ERR_INVALID_STATE: AVI player not playing
+ */
+esp_err_t avi_player_seek(avi_player_handle_t handle, uint32_t position_ms);
+
+/**
+ * @brief Get the presentation time of the last video frame read
+ *
+ * @param[in] handle AVI player handle
+ * @param[out] position_ms Position in milliseconds
+ *
+ * @return
+ *      - ESP_OK: Success
+ *      - ESP_ERR_INVALID_ARG: NULL arguments
+ *      - ESP_ERR_INVALID_STATE: AVI player not playing
+ */
+esp_err_t avi_player_get_position(avi_player_handle_t handle, uint32_t *position_ms);
+
+/**
+ * @brief Get the duration of the AVI being played
+ *
+ * @param[in] handle AVI player handle
+ * @param[out] duration_ms Duration in milliseconds, taken from the index if built, otherwise from the stream header
+ *
+ * @return
+ *      - ESP_OK: Success
+ *      - ESP_ERR_INVALID_ARG: NULL arguments
+ *      - ESP_ERR_INVALID_STATE: AVI player not playing
+ */
+esp_err_t avi_player_get_duration(avi_player_handle_t handle, uint32_t *duration_ms);
+
+/**
+ * @brief Get the A/V sync counters of the AVI being played
+ *
+ * Video frames are scheduled on their presentation time (frame number x strh scale / rate). With an audio
+ * stream and an audio callback, the clock is the audio consumed: bytes handed to audio_cb, minus what
+ * audio_queued_cb reports still queued, minus audio_latency_ms. Otherwise it is the wall clock. Frames
+ * more than one frame period late are skipped before their data is read.
+ *
+ * @param[in] handle AVI player handle
+ * @param[out] stats Sync counters
+ *
+ * @return
+ *      - ESP_OK: Success
+ *      - ESP_ERR_INVALID_ARG: NULL arguments
+ *      - ESP_ERR_INVALID_STATE: AVI player not playing
+ */
+esp_err_t avi_player_get_sync_stats(avi_player_handle_t handle, avi_player_sync_stats_t *stats);
+
+/**
+ * @brief Get the read-ahead counters of the AVI file being played
+ *
+ * Files are read by a separate task, one block aligned read() of read_block_size bytes at a time, into a
+ * ring of read_block_count blocks. The player task takes chunk heads and data from the ring, and hands
+ * chunks to the callbacks in place unless they wrap around the end of the ring. The data passed to the
+ * callbacks is only valid until they return.
+ *
+ * @param[in] handle AVI player handle
+ * @param[out] stats Read-ahead counters
+ *
+ * @return
+ *      - ESP_OK: Success
+ *      - ESP_ERR_INVALID_ARG: NULL arguments
+ *      - ESP_ERR_INVALID_STATE: AVI player not playing
+ *      - ESP_ERR_NOT_SUPPORTED: Playing from memory
+ */
+esp_err_t avi_player_get_io_stats(avi_player_handle_t handle, avi_player_io_stats_t *stats);
+
 /**
  * @brief Initialize the AVI player
  *
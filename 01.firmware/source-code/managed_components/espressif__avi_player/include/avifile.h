@@ -24,6 +24,8 @@
 #define H264_ID     _REV(0x48323634)
 #define VIDS_ID     _REV(0x76696473)
 #define AUDS_ID     _REV(0x61756473)
+#define IDX1_ID     _REV(0x69647831)
+#define INDX_ID     _REV(0x696e6478)
 
 /**
 "db"：uncompressed video frame (RGB data stream);
@@ -51,10 +53,16 @@ typedef struct {
     uint16_t vids_width;
     uint16_t vids_height;
     video_frame_format vids_format;
+    uint32_t vids_scale;        /*!< strh.scale of the video stream, rate / scale = fps */
+    uint32_t vids_rate;         /*!< strh.rate of the video stream */
+    uint32_t vids_length;       /*!< strh.length of the video stream, in frames */
+    uint32_t vids_indx;         /*!< File offset of the OpenDML "indx" chunk of the video stream, 0 if absent */
 
     uint16_t auds_channels;
     uint16_t auds_sample_rate;
     uint16_t auds_bits;
+    uint32_t auds_bytes_per_sec; /*!< strf.avg_bytes_per_sec of the audio stream */
+    uint32_t auds_indx;          /*!< File offset of the OpenDML "indx" chunk of the audio stream, 0 if absent */
 } avi_typedef;
 
 /**
@@ -5,6 +5,7 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 #include <inttypes.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -15,6 +16,7 @@
 #include "esp_idf_version.h"
 #include "esp_spiffs.h"
 #include "avi_player.h"
+#include "avi_index.h"
 
 static const char *TAG = "avi_player_test";
 
@@ -74,6 +76,164 @@ TEST_CASE("avi_player_test", "[avi_player]")
     vTaskDelay(500 / portTICK_PERIOD_MS);
 }
 
+/*!< start p4_introduce.avi with the logging callbacks, read_block_* 0 keeps the defaults */
+static avi_player_handle_t test_play_start(uint32_t read_block_size, uint32_t read_block_count)
+{
+    end_play = false;
+    avi_player_config_t config = {
+        .buffer_size = 60 * 1024,
+        .audio_cb = audio_write,
+        .video_cb = video_write,
+        .audio_set_clock_cb = audio_set_clock,
+        .avi_play_end_cb = avi_play_end,
+        .stack_size = 4096,
+        .read_block_size = read_block_size,
+        .read_block_count = read_block_count,
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 1, 0)
+        .stack_in_psram = false,
+#endif
+    };
+
+    avi_player_handle_t handle;
+    TEST_ASSERT_EQUAL(ESP_OK, avi_player_init(config, &handle));
+    TEST_ASSERT_EQUAL(ESP_OK, avi_player_play_from_file(handle, "/spiffs/p4_introduce.avi"));
+    return handle;
+}
+
+static void test_play_stop(avi_player_handle_t handle)
+{
+    avi_player_play_stop(handle);
+    while (!end_play) {
+        vTaskDelay(100 / portTICK_PERIOD_MS);
+    }
+    avi_player_deinit(handle);
+    vTaskDelay(500 / portTICK_PERIOD_MS);
+}
+
+TEST_CASE("avi_player_seek_test", "[avi_player]")
+{
+    avi_player_handle_t handle = test_play_start(0, 0);
+    vTaskDelay(500 / portTICK_PERIOD_MS);
+
+    uint32_t duration = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, avi_player_get_duration(handle, &duration));
+    TEST_ASSERT_GREATER_THAN(0, duration);
+
+    /*!< jump forward to the middle, then back to the start */
+    uint32_t position = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, avi_player_seek(handle, duration / 2));
+    vTaskDelay(200 / portTICK_PERIOD_MS);
+    TEST_ASSERT_EQUAL(ESP_OK, avi_player_get_position(handle, &position));
+    ESP_LOGI(TAG, "seek %"PRIu32" -> %"PRIu32" ms", duration / 2, position);
+    TEST_ASSERT_GREATER_OR_EQUAL(duration / 2 - 500, position);
+
+    TEST_ASSERT_EQUAL(ESP_OK, avi_player_seek(handle, 0));
+    vTaskDelay(200 / portTICK_PERIOD_MS);
+    TEST_ASSERT_EQUAL(ESP_OK, avi_player_get_position(handle, &position));
+    TEST_ASSERT_LESS_THAN(duration / 2, position);
+
+    test_play_stop(handle);
+}
+
+TEST_CASE("avi_player_sync_test", "[avi_player]")
+{
+    avi_player_handle_t handle = test_play_start(0, 0);
+    vTaskDelay(1000 / portTICK_PERIOD_MS);
+
+    /*!< the callbacks only log, so every frame should be on time */
+    avi_player_sync_stats_t stats;
+    TEST_ASSERT_EQUAL(ESP_OK, avi_player_get_sync_stats(handle, &stats));
+    ESP_LOGI(TAG, "shown %"PRIu32", dropped %"PRIu32", drift %"PRId32" ms, max %"PRId32" ms",
+             stats.frames_shown, stats.frames_dropped, stats.drift_ms, stats.max_drift_ms);
+    TEST_ASSERT_GREATER_THAN(0, stats.frames_shown);
+    TEST_ASSERT_TRUE(stats.audio_master);
+
+    test_play_stop(handle);
+}
+
+TEST_CASE("avi_player_io_test", "[avi_player]")
+{
+    avi_player_handle_t handle = test_play_start(16 * 1024, 3);
+    vTaskDelay(1000 / portTICK_PERIOD_MS);
+
+    /*!< whole blocks are read ahead, so there are far fewer reads than chunks */
+    avi_player_io_stats_t stats;
+    TEST_ASSERT_EQUAL(ESP_OK, avi_player_get_io_stats(handle, &stats));
+    ESP_LOGI(TAG, "%"PRIu32" reads, %"PRIu32" KB/s, %"PRIu32" stalls %"PRIu32" ms, %"PRIu32" in place, %"PRIu32" copied",
+             stats.read_calls, stats.read_kbps, stats.stalls, stats.stall_ms, stats.chunks_in_place, stats.chunks_copied);
+    TEST_ASSERT_GREATER_THAN(0, stats.read_calls);
+    TEST_ASSERT_GREATER_THAN(0, stats.chunks_in_place);
+    TEST_ASSERT_LESS_THAN(stats.chunks_in_place + stats.chunks_copied, stats.read_calls);
+
+    /*!< a second in, the first frame is behind the ring, so seeking back to it restarts the read-ahead */
+    TEST_ASSERT_EQUAL(ESP_OK, avi_player_seek(handle, 0));
+    vTaskDelay(200 / portTICK_PERIOD_MS);
+    avi_player_io_stats_t after;
+    TEST_ASSERT_EQUAL(ESP_OK, avi_player_get_io_stats(handle, &after));
+    ESP_LOGI(TAG, "after seek: %"PRIu32" reads, %"PRIu32" restarts", after.read_calls, after.read_restarts);
+    TEST_ASSERT_GREATER_THAN(stats.read_restarts, after.read_restarts);
+    TEST_ASSERT_GREATER_THAN(stats.read_calls, after.read_calls);
+
+    test_play_stop(handle);
+}
+
+typedef struct {
+    const uint8_t *data;
+    uint32_t size;
+} mem_file_t;
+
+static size_t mem_read(void *ctx, uint32_t offset, void *buffer, size_t length)
+{
+    mem_file_t *f = (mem_file_t *)ctx;
+    if (offset >= f->size) {
+        return 0;
+    }
+    length = length < f->size - offset ? length : f->size - offset;
+    memcpy(buffer, f->data + offset, length);
+    return length;
+}
+
+static void put_chunk(uint8_t *p, const char *fourcc, uint32_t size)
+{
+    memcpy(p, fourcc, 4);
+    memcpy(p + 4, &size, 4);
+}
+
+/**
+ * @brief Walk a movi list without an index whose second chunk has the given size
+ *
+ * Layout: "LIST" size "movi", a 4-byte "00dc" chunk at 12, the bad chunk at 24, 48 bytes in total.
+ */
+static void test_index_bad_chunk(const char *fourcc, uint32_t size)
+{
+    uint8_t data[48] = {0};
+    put_chunk(data, "LIST", sizeof(data) - 8);
+    memcpy(data + 8, "movi", 4);
+    put_chunk(data + 12, "00dc", 4);
+    put_chunk(data + 24, fourcc, size);
+    mem_file_t file = { .data = data, .size = sizeof(data) };
+    avi_typedef avi = { .movi_start = 12, .movi_size = sizeof(data) - 8 };
+
+    avi_index_t index;
+    TEST_ASSERT_EQUAL(ESP_OK, avi_index_build(&index, &avi, mem_read, &file, file.size));
+    TEST_ASSERT_EQUAL(1, index.video_count);
+    TEST_ASSERT_EQUAL(12, index.video[0].offset);
+    TEST_ASSERT_EQUAL(4, index.video[0].size);
+    TEST_ASSERT_EQUAL(0, index.audio_count);
+    avi_index_free(&index);
+}
+
+TEST_CASE("avi_player_index_corrupt_test", "[avi_player]")
+{
+    /*!< pos + 8 + size wraps back to the same chunk in 32 bits */
+    test_index_bad_chunk("JUNK", 0xFFFFFFF8);
+    /*!< pos + 8 + size wraps to the start of the movi list */
+    test_index_bad_chunk("00dc", 0xFFFFFFEC);
+    /*!< truncated file, the chunk runs past the end */
+    test_index_bad_chunk("00dc", 1000);
+    test_index_bad_chunk("01wb", 1000);
+}
+
 static size_t before_free_8bit;
 static size_t before_free_32bit;
 
@@ -55,6 +55,15 @@ typedef struct {
     int timer_period_ms;    /*!< LVGL timer tick period in ms */
 } lvgl_port_cfg_t;
 
+/**
+ * @brief Called when the LVGL mutex is released by its outermost holder
+ *
+ * @param caller  Code address the mutex was taken from (see `lvgl_port_lock_caller()`)
+ * @param wait_us Time spent waiting for the mutex, in microseconds
+ * @param hold_us Time the mutex was held, in microseconds
+ */
+typedef void (*lvgl_port_lock_hook_t)(const void *caller, uint32_t wait_us, uint32_t hold_us);
+
 /**
  * @brief LVGL port configuration structure
  *
@@ -103,12 +112,34 @@ esp_err_t lvgl_port_deinit(void);
  */
 bool lvgl_port_lock(uint32_t timeout_ms);
 
+/**
+ * @brief Take LVGL mutex on behalf of a caller
+ *
+ * @note Same as `lvgl_port_lock()`, for wrappers that want the lock hook to see their caller instead of themselves.
+ *
+ * @param timeout_ms Timeout in [ms]. 0 will block indefinitely.
+ * @param caller     Code address reported to the lock hook (usually `__builtin_return_address(0)`)
+ * @return
+ *      - true  Mutex was taken
+ *      - false Mutex was NOT taken
+ */
+bool lvgl_port_lock_caller(uint32_t timeout_ms, const void *caller);
+
 /**
  * @brief Give LVGL mutex
  *
  */
 void lvgl_port_unlock(void);
 
+/**
+ * @brief Set a hook that gets the wait and hold time of each outermost LVGL mutex hold
+ *
+ * @note The hook runs in the releasing task right before the mutex is given back, so it must be short.
+ *
+ * @param hook Hook function, NULL to remove it
+ */
+void lvgl_port_set_lock_hook(lvgl_port_lock_hook_t hook);
+
 /**
  * @brief Notify LVGL, that data was flushed to LCD display
  *
@@ -33,6 +33,11 @@ typedef struct lvgl_port_ctx_s {
     bool                running;
     int                 task_max_sleep_ms;
     int                 timer_period_ms;
+    lvgl_port_lock_hook_t lock_hook;
+    int                 lock_depth;     /* Only touched by the mutex holder */
+    const void          *lock_caller;
+    int64_t             lock_taken_us;
+    uint32_t            lock_wait_us;
 } lvgl_port_ctx_t;
 
 /*******************************************************************************
@@ -143,19 +148,45 @@ esp_err_t lvgl_port_deinit(void)
 }
 
 bool lvgl_port_lock(uint32_t timeout_ms)
+{
+    return lvgl_port_lock_caller(timeout_ms, __builtin_return_address(0));
+}
+
+bool lvgl_port_lock_caller(uint32_t timeout_ms, const void *caller)
 {
     assert(lvgl_port_ctx.lvgl_mux && "lvgl_port_init must be called first");
 
     const TickType_t timeout_ticks = (timeout_ms == 0) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
-    return xSemaphoreTakeRecursive(lvgl_port_ctx.lvgl_mux, timeout_ticks) == pdTRUE;
+    int64_t start = esp_timer_get_time();
+    if (xSemaphoreTakeRecursive(lvgl_port_ctx.lvgl_mux, timeout_ticks) != pdTRUE) {
+        return false;
+    }
+    if (lvgl_port_ctx.lock_depth++ == 0) {
+        lvgl_port_ctx.lock_taken_us = esp_timer_get_time();
+        lvgl_port_ctx.lock_wait_us = (uint32_t)(lvgl_port_ctx.lock_taken_us - start);
+        lvgl_port_ctx.lock_caller = caller;
+    }
+    return true;
 }
 
 void lvgl_port_unlock(void)
 {
     assert(lvgl_port_ctx.lvgl_mux && "lvgl_port_init must be called first");
+    if (lvgl_port_ctx.lock_depth > 0 && --lvgl_port_ctx.lock_depth == 0) {
+        lvgl_port_lock_hook_t hook = lvgl_port_ctx.lock_hook;
+        if (hook) {
+            hook(lvgl_port_ctx.lock_caller, lvgl_port_ctx.lock_wait_us,
+                 (uint32_t)(esp_timer_get_time() - lvgl_port_ctx.lock_taken_us));
+        }
+    }
     xSemaphoreGiveRecursive(lvgl_port_ctx.lvgl_mux);
 }
 
+void lvgl_port_set_lock_hook(lvgl_port_lock_hook_t hook)
+{
+    lvgl_port_ctx.lock_hook = hook;
+}
+
 esp_err_t lvgl_port_task_wake(lvgl_port_event_type_t event, void *param)
 {
     ESP_LOGE(TAG, "Task wake is not supported, when used LVGL8!");
@@ -179,8 +179,11 @@ void lv_draw_dispatch(void)
     while(disp) {
         lv_layer_t * layer = disp->layer_head;
         while(layer) {
-            /* If there are no tasks in the layer, skip it */
-            if(layer->draw_task_head && lv_draw_dispatch_layer(disp, layer))
+            /* If there are no tasks in the layer, skip it. A finished child layer can be empty too
+             * (nothing of it was in the clip area) but it still has to release its blending task in the parent,
+             * otherwise that task waits forever. */
+            bool empty_child = layer->draw_task_head == NULL && layer->parent && layer->all_tasks_added;
+            if((layer->draw_task_head || empty_child) && lv_draw_dispatch_layer(disp, layer))
                 task_dispatched = true;
             layer = layer->next;
         }
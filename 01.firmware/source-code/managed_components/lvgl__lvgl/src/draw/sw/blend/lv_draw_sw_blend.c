@@ -95,6 +95,11 @@ void lv_draw_sw_blend(lv_draw_unit_t * draw_unit, const lv_draw_sw_blend_dsc_t *
                 lv_draw_sw_blend_color_to_rgb565(&fill_dsc);
                 break;
 #endif
+#if LV_DRAW_SW_SUPPORT_RGB565_SWAPPED
+            case LV_COLOR_FORMAT_RGB565_SWAPPED:
+                lv_draw_sw_blend_color_to_rgb565_swapped(&fill_dsc);
+                break;
+#endif
 #if LV_DRAW_SW_SUPPORT_ARGB8888
             case LV_COLOR_FORMAT_ARGB8888:
                 lv_draw_sw_blend_color_to_argb8888(&fill_dsc);
@@ -184,6 +189,11 @@ void lv_draw_sw_blend(lv_draw_unit_t * draw_unit, const lv_draw_sw_blend_dsc_t *
                 lv_draw_sw_blend_image_to_rgb565(&image_dsc);
                 break;
 #endif
+#if LV_DRAW_SW_SUPPORT_RGB565_SWAPPED
+            case LV_COLOR_FORMAT_RGB565_SWAPPED:
+                lv_draw_sw_blend_image_to_rgb565_swapped(&image_dsc);
+                break;
+#endif
 #if LV_DRAW_SW_SUPPORT_ARGB8888
             case LV_COLOR_FORMAT_ARGB8888:
                 lv_draw_sw_blend_image_to_argb8888(&image_dsc);
@@ -18,9 +18,17 @@
 #include "../../../misc/lv_color.h"
 #include "../../../stdlib/lv_string.h"
 
-#if LV_USE_DRAW_SW_ASM == LV_DRAW_SW_ASM_NEON
+/*lv_draw_sw_blend_to_rgb565_swapped.c includes this file with LV_DRAW_SW_BLEND_RGB565_SWAPPED 1
+ *to build the same blenders for a destination in swapped byte order*/
+#ifndef LV_DRAW_SW_BLEND_RGB565_SWAPPED
+    #define LV_DRAW_SW_BLEND_RGB565_SWAPPED 0
+#endif
+
+/*The NEON and Helium kernels write normal byte order, so the swapped variant doesn't use them.
+ *A custom include is used for both variants; its macros can check LV_DRAW_SW_BLEND_RGB565_SWAPPED*/
+#if LV_USE_DRAW_SW_ASM == LV_DRAW_SW_ASM_NEON && LV_DRAW_SW_BLEND_RGB565_SWAPPED == 0
     #include "neon/lv_blend_neon.h"
-#elif LV_USE_DRAW_SW_ASM == LV_DRAW_SW_ASM_HELIUM
+#elif LV_USE_DRAW_SW_ASM == LV_DRAW_SW_ASM_HELIUM && LV_DRAW_SW_BLEND_RGB565_SWAPPED == 0
     #include "helium/lv_blend_helium.h"
 #elif LV_USE_DRAW_SW_ASM == LV_DRAW_SW_ASM_CUSTOM
     #include LV_DRAW_SW_ASM_CUSTOM_INCLUDE
@@ -30,6 +38,21 @@
  *      DEFINES
  *********************/
 
+/*TO_DEST/FROM_DEST convert a pixel between the blending math's normal RGB565 and the destination's byte order*/
+#if LV_DRAW_SW_BLEND_RGB565_SWAPPED
+    #define BLEND_COLOR_TO_RGB565   lv_draw_sw_blend_color_to_rgb565_swapped
+    #define BLEND_IMAGE_TO_RGB565   lv_draw_sw_blend_image_to_rgb565_swapped
+    #define TO_DEST(c)              swap16(c)
+    #define FROM_DEST(c)            swap16(c)
+    #define FROM_DEST_C16(c)        swap_c16(c)
+#else
+    #define BLEND_COLOR_TO_RGB565   lv_draw_sw_blend_color_to_rgb565
+    #define BLEND_IMAGE_TO_RGB565   lv_draw_sw_blend_image_to_rgb565
+    #define TO_DEST(c)              (c)
+    #define FROM_DEST(c)            (c)
+    #define FROM_DEST_C16(c)        (c)
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -71,6 +94,14 @@ static inline uint16_t /* LV_ATTRIBUTE_FAST_MEM */ lv_color_24_16_mix(const uint
 
 static inline void * /* LV_ATTRIBUTE_FAST_MEM */ drawbuf_next_row(const void * buf, uint32_t stride);
 
+#if LV_DRAW_SW_BLEND_RGB565_SWAPPED
+    static inline uint16_t /* LV_ATTRIBUTE_FAST_MEM */ swap16(uint16_t c);
+
+    static inline lv_color16_t /* LV_ATTRIBUTE_FAST_MEM */ swap_c16(lv_color16_t c);
+
+    static inline void /* LV_ATTRIBUTE_FAST_MEM */ copy_swapped(uint16_t * dest, const uint16_t * src, int32_t w);
+#endif
+
 /**********************
  *  STATIC VARIABLES
  **********************/
@@ -208,7 +239,7 @@ static inline void * /* LV_ATTRIBUTE_FAST_MEM */ drawbuf_next_row(const void * b
  * @param mask
  * @param mask_stride
  */
-void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_color_to_rgb565(lv_draw_sw_blend_fill_dsc_t * dsc)
+void LV_ATTRIBUTE_FAST_MEM BLEND_COLOR_TO_RGB565(lv_draw_sw_blend_fill_dsc_t * dsc)
 {
     int32_t w = dsc->dest_w;
     int32_t h = dsc->dest_h;
@@ -236,6 +267,7 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_color_to_rgb565(lv_draw_sw_blend_fil
     /*Simple fill*/
     if(mask == NULL && opa >= LV_OPA_MAX)  {
         if(LV_RESULT_INVALID == LV_DRAW_SW_COLOR_BLEND_TO_RGB565(dsc)) {
+            color16 = TO_DEST(color16);
             for(y = 0; y < h; y++) {
                 uint16_t * dest_end_final = dest_buf_u16 + w;
                 uint32_t * dest_end_mid = (uint32_t *)((uint16_t *) dest_buf_u16 + ((w - 1) & ~(0xF)));
@@ -280,14 +312,14 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_color_to_rgb565(lv_draw_sw_blend_fil
             for(y = 0; y < h; y++) {
                 x = 0;
                 if((lv_uintptr_t)&dest_buf_u16[0] & 0x3) {
-                    dest_buf_u16[0] = lv_color_16_16_mix(color16, dest_buf_u16[0], opa);
+                    dest_buf_u16[0] = TO_DEST(lv_color_16_16_mix(color16, FROM_DEST(dest_buf_u16[0]), opa));
                     x = 1;
                 }
 
                 for(; x < w - 2; x += 2) {
                     if(dest_buf_u16[x] != dest_buf_u16[x + 1]) {
-                        dest_buf_u16[x + 0] = lv_color_16_16_mix(color16, dest_buf_u16[x + 0], opa);
-                        dest_buf_u16[x + 1] = lv_color_16_16_mix(color16, dest_buf_u16[x + 1], opa);
+                        dest_buf_u16[x + 0] = TO_DEST(lv_color_16_16_mix(color16, FROM_DEST(dest_buf_u16[x + 0]), opa));
+                        dest_buf_u16[x + 1] = TO_DEST(lv_color_16_16_mix(color16, FROM_DEST(dest_buf_u16[x + 1]), opa));
                     }
                     else {
                         volatile uint32_t * dest32 = (uint32_t *)&dest_buf_u16[x];
@@ -297,7 +329,7 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_color_to_rgb565(lv_draw_sw_blend_fil
                         else {
                             last_dest32_color =  *dest32;
 
-                            dest_buf_u16[x] = lv_color_16_16_mix(color16, dest_buf_u16[x + 0], opa);
+                            dest_buf_u16[x] = TO_DEST(lv_color_16_16_mix(color16, FROM_DEST(dest_buf_u16[x + 0]), opa));
                             dest_buf_u16[x + 1] = dest_buf_u16[x];
 
                             last_res32_color = *dest32;
@@ -306,7 +338,7 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_color_to_rgb565(lv_draw_sw_blend_fil
                 }
 
                 for(; x < w ; x++) {
-                    dest_buf_u16[x] = lv_color_16_16_mix(color16, dest_buf_u16[x], opa);
+                    dest_buf_u16[x] = TO_DEST(lv_color_16_16_mix(color16, FROM_DEST(dest_buf_u16[x]), opa));
                 }
                 dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
             }
@@ -320,24 +352,24 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_color_to_rgb565(lv_draw_sw_blend_fil
             for(y = 0; y < h; y++) {
                 x = 0;
                 if((lv_uintptr_t)(mask) & 0x1) {
-                    dest_buf_u16[x] = lv_color_16_16_mix(color16, dest_buf_u16[x], mask[x]);
+                    dest_buf_u16[x] = TO_DEST(lv_color_16_16_mix(color16, FROM_DEST(dest_buf_u16[x]), mask[x]));
                     x++;
                 }
 
                 for(; x <= w - 2; x += 2) {
                     uint16_t mask16 = *((uint16_t *)&mask[x]);
                     if(mask16 == 0xFFFF) {
-                        dest_buf_u16[x + 0] = color16;
-                        dest_buf_u16[x + 1] = color16;
+                        dest_buf_u16[x + 0] = TO_DEST(color16);
+                        dest_buf_u16[x + 1] = TO_DEST(color16);
                     }
                     else if(mask16 != 0) {
-                        dest_buf_u16[x + 0] = lv_color_16_16_mix(color16, dest_buf_u16[x + 0], mask[x + 0]);
-                        dest_buf_u16[x + 1] = lv_color_16_16_mix(color16, dest_buf_u16[x + 1], mask[x + 1]);
+                        dest_buf_u16[x + 0] = TO_DEST(lv_color_16_16_mix(color16, FROM_DEST(dest_buf_u16[x + 0]), mask[x + 0]));
+                        dest_buf_u16[x + 1] = TO_DEST(lv_color_16_16_mix(color16, FROM_DEST(dest_buf_u16[x + 1]), mask[x + 1]));
                     }
                 }
 
                 for(; x < w ; x++) {
-                    dest_buf_u16[x] = lv_color_16_16_mix(color16, dest_buf_u16[x], mask[x]);
+                    dest_buf_u16[x] = TO_DEST(lv_color_16_16_mix(color16, FROM_DEST(dest_buf_u16[x]), mask[x]));
                 }
                 dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
                 mask += mask_stride;
@@ -350,7 +382,7 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_color_to_rgb565(lv_draw_sw_blend_fil
         if(LV_RESULT_INVALID == LV_DRAW_SW_COLOR_BLEND_TO_RGB565_MIX_MASK_OPA(dsc)) {
             for(y = 0; y < h; y++) {
                 for(x = 0; x < w; x++) {
-                    dest_buf_u16[x] = lv_color_16_16_mix(color16, dest_buf_u16[x], LV_OPA_MIX2(mask[x], opa));
+                    dest_buf_u16[x] = TO_DEST(lv_color_16_16_mix(color16, FROM_DEST(dest_buf_u16[x]), LV_OPA_MIX2(mask[x], opa)));
                 }
                 dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
                 mask += mask_stride;
@@ -359,7 +391,7 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_color_to_rgb565(lv_draw_sw_blend_fil
     }
 }
 
-void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_image_to_rgb565(lv_draw_sw_blend_image_dsc_t * dsc)
+void LV_ATTRIBUTE_FAST_MEM BLEND_IMAGE_TO_RGB565(lv_draw_sw_blend_image_dsc_t * dsc)
 {
     switch(dsc->src_color_format) {
         case LV_COLOR_FORMAT_RGB565:
@@ -428,7 +460,7 @@ static void LV_ATTRIBUTE_FAST_MEM i1_image_blend(lv_draw_sw_blend_image_dsc_t *
                 for(y = 0; y < h; y++) {
                     for(dest_x = 0, src_x = 0; dest_x < w; dest_x++, src_x++) {
                         uint8_t chan_val = get_bit(src_buf_i1, src_x) * 255;
-                        dest_buf_u16[dest_x] = l8_to_rgb565(chan_val);
+                        dest_buf_u16[dest_x] = TO_DEST(l8_to_rgb565(chan_val));
                     }
                     dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
                     src_buf_i1 = drawbuf_next_row(src_buf_i1, src_stride);
@@ -440,7 +472,7 @@ static void LV_ATTRIBUTE_FAST_MEM i1_image_blend(lv_draw_sw_blend_image_dsc_t *
                 for(y = 0; y < h; y++) {
                     for(dest_x = 0, src_x = 0; dest_x < w; dest_x++, src_x++) {
                         uint8_t chan_val = get_bit(src_buf_i1, src_x) * 255;
-                        dest_buf_u16[dest_x] = lv_color_8_16_mix(chan_val, dest_buf_u16[dest_x], opa);
+                        dest_buf_u16[dest_x] = TO_DEST(lv_color_8_16_mix(chan_val, FROM_DEST(dest_buf_u16[dest_x]), opa));
                     }
                     dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
                     src_buf_i1 = drawbuf_next_row(src_buf_i1, src_stride);
@@ -453,7 +485,7 @@ static void LV_ATTRIBUTE_FAST_MEM i1_image_blend(lv_draw_sw_blend_image_dsc_t *
                 for(y = 0; y < h; y++) {
                     for(dest_x = 0, src_x = 0; dest_x < w; dest_x++, src_x++) {
                         uint8_t chan_val = get_bit(src_buf_i1, src_x) * 255;
-                        dest_buf_u16[dest_x] = lv_color_8_16_mix(chan_val, dest_buf_u16[dest_x], mask_buf[dest_x]);
+                        dest_buf_u16[dest_x] = TO_DEST(lv_color_8_16_mix(chan_val, FROM_DEST(dest_buf_u16[dest_x]), mask_buf[dest_x]));
                     }
                     dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
                     src_buf_i1 = drawbuf_next_row(src_buf_i1, src_stride);
@@ -466,7 +498,7 @@ static void LV_ATTRIBUTE_FAST_MEM i1_image_blend(lv_draw_sw_blend_image_dsc_t *
                 for(y = 0; y < h; y++) {
                     for(dest_x = 0, src_x = 0; dest_x < w; dest_x++, src_x++) {
                         uint8_t chan_val = get_bit(src_buf_i1, src_x) * 255;
-                        dest_buf_u16[dest_x] = lv_color_8_16_mix(chan_val, dest_buf_u16[dest_x], LV_OPA_MIX2(mask_buf[dest_x], opa));
+                        dest_buf_u16[dest_x] = TO_DEST(lv_color_8_16_mix(chan_val, FROM_DEST(dest_buf_u16[dest_x]), LV_OPA_MIX2(mask_buf[dest_x], opa)));
                     }
                     dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
                     src_buf_i1 = drawbuf_next_row(src_buf_i1, src_stride);
@@ -483,17 +515,17 @@ static void LV_ATTRIBUTE_FAST_MEM i1_image_blend(lv_draw_sw_blend_image_dsc_t *
                 switch(dsc->blend_mode) {
                     case LV_BLEND_MODE_ADDITIVE:
                         // Additive blending mode
-                        res = (LV_MIN(dest_buf_u16[dest_x] + l8_to_rgb565(chan_val), 0xFFFF));
+                        res = (LV_MIN(FROM_DEST(dest_buf_u16[dest_x]) + l8_to_rgb565(chan_val), 0xFFFF));
                         break;
                     case LV_BLEND_MODE_SUBTRACTIVE:
                         // Subtractive blending mode
-                        res = (LV_MAX(dest_buf_u16[dest_x] - l8_to_rgb565(chan_val), 0));
+                        res = (LV_MAX(FROM_DEST(dest_buf_u16[dest_x]) - l8_to_rgb565(chan_val), 0));
                         break;
                     case LV_BLEND_MODE_MULTIPLY:
                         // Multiply blending mode
-                        res = ((((dest_buf_u16[dest_x] >> 11) * (l8_to_rgb565(chan_val) >> 3)) & 0x1F) << 11) |
-                              ((((dest_buf_u16[dest_x] >> 5) & 0x3F) * ((l8_to_rgb565(chan_val) >> 2) & 0x3F) >> 6) << 5) |
-                              (((dest_buf_u16[dest_x] & 0x1F) * (l8_to_rgb565(chan_val) & 0x1F)) >> 5);
+                        res = ((((FROM_DEST(dest_buf_u16[dest_x]) >> 11) * (l8_to_rgb565(chan_val) >> 3)) & 0x1F) << 11) |
+                              ((((FROM_DEST(dest_buf_u16[dest_x]) >> 5) & 0x3F) * ((l8_to_rgb565(chan_val) >> 2) & 0x3F) >> 6) << 5) |
+                              (((FROM_DEST(dest_buf_u16[dest_x]) & 0x1F) * (l8_to_rgb565(chan_val) & 0x1F)) >> 5);
                         break;
                     default:
                         LV_LOG_WARN("Not supported blend mode: %d", dsc->blend_mode);
@@ -501,16 +533,16 @@ static void LV_ATTRIBUTE_FAST_MEM i1_image_blend(lv_draw_sw_blend_image_dsc_t *
                 }
 
                 if(mask_buf == NULL && opa >= LV_OPA_MAX) {
-                    dest_buf_u16[dest_x] = res;
+                    dest_buf_u16[dest_x] = TO_DEST(res);
                 }
                 else if(mask_buf == NULL && opa < LV_OPA_MAX) {
-                    dest_buf_u16[dest_x] = lv_color_16_16_mix(res, dest_buf_u16[dest_x], opa);
+                    dest_buf_u16[dest_x] = TO_DEST(lv_color_16_16_mix(res, FROM_DEST(dest_buf_u16[dest_x]), opa));
                 }
                 else {
                     if(opa >= LV_OPA_MAX)
-                        dest_buf_u16[dest_x] = lv_color_16_16_mix(res, dest_buf_u16[dest_x], mask_buf[dest_x]);
+                        dest_buf_u16[dest_x] = TO_DEST(lv_color_16_16_mix(res, FROM_DEST(dest_buf_u16[dest_x]), mask_buf[dest_x]));
                     else
-                        dest_buf_u16[dest_x] = lv_color_16_16_mix(res, dest_buf_u16[dest_x], LV_OPA_MIX2(mask_buf[dest_x], opa));
+                        dest_buf_u16[dest_x] = TO_DEST(lv_color_16_16_mix(res, FROM_DEST(dest_buf_u16[dest_x]), LV_OPA_MIX2(mask_buf[dest_x], opa)));
                 }
             }
 
@@ -544,7 +576,7 @@ static void LV_ATTRIBUTE_FAST_MEM al88_image_blend(lv_draw_sw_blend_image_dsc_t
             if(LV_RESULT_INVALID == LV_DRAW_SW_AL88_BLEND_NORMAL_TO_RGB565(dsc)) {
                 for(y = 0; y < h; y++) {
                     for(dest_x = 0, src_x = 0; dest_x < w; dest_x++, src_x++) {
-                        dest_buf_u16[dest_x] = lv_color_8_16_mix(src_buf_al88[src_x].lumi, dest_buf_u16[dest_x], src_buf_al88[src_x].alpha);
+                        dest_buf_u16[dest_x] = TO_DEST(lv_color_8_16_mix(src_buf_al88[src_x].lumi, FROM_DEST(dest_buf_u16[dest_x]), src_buf_al88[src_x].alpha));
                     }
                     dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
                     src_buf_al88 = drawbuf_next_row(src_buf_al88, src_stride);
@@ -555,8 +587,8 @@ static void LV_ATTRIBUTE_FAST_MEM al88_image_blend(lv_draw_sw_blend_image_dsc_t
             if(LV_RESULT_INVALID == LV_DRAW_SW_AL88_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc)) {
                 for(y = 0; y < h; y++) {
                     for(dest_x = 0, src_x = 0; dest_x < w; dest_x++, src_x++) {
-                        dest_buf_u16[dest_x] = lv_color_8_16_mix(src_buf_al88[src_x].lumi, dest_buf_u16[dest_x],
-                                                                 LV_OPA_MIX2(src_buf_al88[src_x].alpha, opa));
+                        dest_buf_u16[dest_x] = TO_DEST(lv_color_8_16_mix(src_buf_al88[src_x].lumi, FROM_DEST(dest_buf_u16[dest_x]),
+                                                                         LV_OPA_MIX2(src_buf_al88[src_x].alpha, opa)));
                     }
                     dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
                     src_buf_al88 = drawbuf_next_row(src_buf_al88, src_stride);
@@ -567,8 +599,8 @@ static void LV_ATTRIBUTE_FAST_MEM al88_image_blend(lv_draw_sw_blend_image_dsc_t
             if(LV_RESULT_INVALID == LV_DRAW_SW_AL88_BLEND_NORMAL_TO_RGB565_WITH_MASK(dsc)) {
                 for(y = 0; y < h; y++) {
                     for(dest_x = 0, src_x = 0; dest_x < w; dest_x++, src_x++) {
-                        dest_buf_u16[dest_x] = lv_color_8_16_mix(src_buf_al88[src_x].lumi, dest_buf_u16[dest_x],
-                                                                 LV_OPA_MIX2(src_buf_al88[src_x].alpha, mask_buf[dest_x]));
+                        dest_buf_u16[dest_x] = TO_DEST(lv_color_8_16_mix(src_buf_al88[src_x].lumi, FROM_DEST(dest_buf_u16[dest_x]),
+                                                                         LV_OPA_MIX2(src_buf_al88[src_x].alpha, mask_buf[dest_x])));
                     }
                     dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
                     src_buf_al88 = drawbuf_next_row(src_buf_al88, src_stride);
@@ -580,8 +612,8 @@ static void LV_ATTRIBUTE_FAST_MEM al88_image_blend(lv_draw_sw_blend_image_dsc_t
             if(LV_RESULT_INVALID == LV_DRAW_SW_AL88_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA(dsc)) {
                 for(y = 0; y < h; y++) {
                     for(dest_x = 0, src_x = 0; dest_x < w; dest_x++, src_x++) {
-                        dest_buf_u16[dest_x] = lv_color_8_16_mix(src_buf_al88[src_x].lumi, dest_buf_u16[dest_x],
-                                                                 LV_OPA_MIX3(src_buf_al88[src_x].alpha, mask_buf[dest_x], opa));
+                        dest_buf_u16[dest_x] = TO_DEST(lv_color_8_16_mix(src_buf_al88[src_x].lumi, FROM_DEST(dest_buf_u16[dest_x]),
+                                                                         LV_OPA_MIX3(src_buf_al88[src_x].alpha, mask_buf[dest_x], opa)));
                     }
                     dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
                     src_buf_al88 = drawbuf_next_row(src_buf_al88, src_stride);
@@ -599,34 +631,34 @@ static void LV_ATTRIBUTE_FAST_MEM al88_image_blend(lv_draw_sw_blend_image_dsc_t
                 uint8_t g = src_buf_al88[src_x].lumi >> 2;
                 switch(dsc->blend_mode) {
                     case LV_BLEND_MODE_ADDITIVE:
-                        res = (LV_MIN(dest_buf_c16[dest_x].red + rb, 31)) << 11;
-                        res += (LV_MIN(dest_buf_c16[dest_x].green + g, 63)) << 5;
-                        res += LV_MIN(dest_buf_c16[dest_x].blue + rb, 31);
+                        res = (LV_MIN(FROM_DEST_C16(dest_buf_c16[dest_x]).red + rb, 31)) << 11;
+                        res += (LV_MIN(FROM_DEST_C16(dest_buf_c16[dest_x]).green + g, 63)) << 5;
+                        res += LV_MIN(FROM_DEST_C16(dest_buf_c16[dest_x]).blue + rb, 31);
                         break;
                     case LV_BLEND_MODE_SUBTRACTIVE:
-                        res = (LV_MAX(dest_buf_c16[dest_x].red - rb, 0)) << 11;
-                        res += (LV_MAX(dest_buf_c16[dest_x].green - g, 0)) << 5;
-                        res += LV_MAX(dest_buf_c16[dest_x].blue - rb, 0);
+                        res = (LV_MAX(FROM_DEST_C16(dest_buf_c16[dest_x]).red - rb, 0)) << 11;
+                        res += (LV_MAX(FROM_DEST_C16(dest_buf_c16[dest_x]).green - g, 0)) << 5;
+                        res += LV_MAX(FROM_DEST_C16(dest_buf_c16[dest_x]).blue - rb, 0);
                         break;
                     case LV_BLEND_MODE_MULTIPLY:
-                        res = ((dest_buf_c16[dest_x].red * rb) >> 5) << 11;
-                        res += ((dest_buf_c16[dest_x].green * g) >> 6) << 5;
-                        res += (dest_buf_c16[dest_x].blue * rb) >> 5;
+                        res = ((FROM_DEST_C16(dest_buf_c16[dest_x]).red * rb) >> 5) << 11;
+                        res += ((FROM_DEST_C16(dest_buf_c16[dest_x]).green * g) >> 6) << 5;
+                        res += (FROM_DEST_C16(dest_buf_c16[dest_x]).blue * rb) >> 5;
                         break;
                     default:
                         LV_LOG_WARN("Not supported blend mode: %d", dsc->blend_mode);
                         return;
                 }
                 if(mask_buf == NULL && opa >= LV_OPA_MAX) {
-                    dest_buf_u16[dest_x] = lv_color_16_16_mix(res, dest_buf_u16[dest_x], src_buf_al88[src_x].alpha);
+                    dest_buf_u16[dest_x] = TO_DEST(lv_color_16_16_mix(res, FROM_DEST(dest_buf_u16[dest_x]), src_buf_al88[src_x].alpha));
                 }
                 else if(mask_buf == NULL && opa < LV_OPA_MAX) {
-                    dest_buf_u16[dest_x] = lv_color_16_16_mix(res, dest_buf_u16[dest_x], LV_OPA_MIX2(opa, src_buf_al88[src_x].alpha));
+                    dest_buf_u16[dest_x] = TO_DEST(lv_color_16_16_mix(res, FROM_DEST(dest_buf_u16[dest_x]), LV_OPA_MIX2(opa, src_buf_al88[src_x].alpha)));
                 }
                 else {
-                    if(opa >= LV_OPA_MAX) dest_buf_u16[dest_x] = lv_color_16_16_mix(res, dest_buf_u16[dest_x], mask_buf[dest_x]);
-                    else dest_buf_u16[dest_x] = lv_color_16_16_mix(res, dest_buf_u16[dest_x], LV_OPA_MIX3(mask_buf[dest_x], opa,
-                                                                                                              src_buf_al88[src_x].alpha));
+                    if(opa >= LV_OPA_MAX) dest_buf_u16[dest_x] = TO_DEST(lv_color_16_16_mix(res, FROM_DEST(dest_buf_u16[dest_x]), mask_buf[dest_x]));
+                    else dest_buf_u16[dest_x] = TO_DEST(lv_color_16_16_mix(res, FROM_DEST(dest_buf_u16[dest_x]), LV_OPA_MIX3(mask_buf[dest_x], opa,
+                                                                                                                      src_buf_al88[src_x].alpha)));
                 }
             }
 
@@ -662,7 +694,7 @@ static void LV_ATTRIBUTE_FAST_MEM l8_image_blend(lv_draw_sw_blend_image_dsc_t *
             if(LV_RESULT_INVALID == LV_DRAW_SW_L8_BLEND_NORMAL_TO_RGB565(dsc)) {
                 for(y = 0; y < h; y++) {
                     for(dest_x = 0, src_x = 0; dest_x < w; dest_x++, src_x++) {
-                        dest_buf_u16[dest_x] = l8_to_rgb565(src_buf_l8[src_x]);
+                        dest_buf_u16[dest_x] = TO_DEST(l8_to_rgb565(src_buf_l8[src_x]));
                     }
                     dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
                     src_buf_l8 += src_stride;
@@ -673,7 +705,7 @@ static void LV_ATTRIBUTE_FAST_MEM l8_image_blend(lv_draw_sw_blend_image_dsc_t *
             if(LV_RESULT_INVALID == LV_DRAW_SW_L8_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc)) {
                 for(y = 0; y < h; y++) {
                     for(dest_x = 0, src_x = 0; dest_x < w; dest_x++, src_x++) {
-                        dest_buf_u16[dest_x] = lv_color_8_16_mix(src_buf_l8[src_x], dest_buf_u16[dest_x], opa);
+                        dest_buf_u16[dest_x] = TO_DEST(lv_color_8_16_mix(src_buf_l8[src_x], FROM_DEST(dest_buf_u16[dest_x]), opa));
                     }
                     dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
                     src_buf_l8 += src_stride;
@@ -684,7 +716,7 @@ static void LV_ATTRIBUTE_FAST_MEM l8_image_blend(lv_draw_sw_blend_image_dsc_t *
             if(LV_RESULT_INVALID == LV_DRAW_SW_L8_BLEND_NORMAL_TO_RGB565_WITH_MASK(dsc)) {
                 for(y = 0; y < h; y++) {
                     for(dest_x = 0, src_x = 0; dest_x < w; dest_x++, src_x++) {
-                        dest_buf_u16[dest_x] = lv_color_8_16_mix(src_buf_l8[src_x], dest_buf_u16[dest_x], mask_buf[dest_x]);
+                        dest_buf_u16[dest_x] = TO_DEST(lv_color_8_16_mix(src_buf_l8[src_x], FROM_DEST(dest_buf_u16[dest_x]), mask_buf[dest_x]));
                     }
                     dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
                     src_buf_l8 += src_stride;
@@ -696,7 +728,7 @@ static void LV_ATTRIBUTE_FAST_MEM l8_image_blend(lv_draw_sw_blend_image_dsc_t *
             if(LV_RESULT_INVALID == LV_DRAW_SW_L8_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA(dsc)) {
                 for(y = 0; y < h; y++) {
                     for(dest_x = 0, src_x = 0; dest_x < w; dest_x++, src_x++) {
-                        dest_buf_u16[dest_x] = lv_color_8_16_mix(src_buf_l8[src_x], dest_buf_u16[dest_x], LV_OPA_MIX2(mask_buf[dest_x], opa));
+                        dest_buf_u16[dest_x] = TO_DEST(lv_color_8_16_mix(src_buf_l8[src_x], FROM_DEST(dest_buf_u16[dest_x]), LV_OPA_MIX2(mask_buf[dest_x], opa)));
                     }
                     dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
                     src_buf_l8 += src_stride;
@@ -714,19 +746,19 @@ static void LV_ATTRIBUTE_FAST_MEM l8_image_blend(lv_draw_sw_blend_image_dsc_t *
                 uint8_t g = src_buf_l8[src_x] >> 2;
                 switch(dsc->blend_mode) {
                     case LV_BLEND_MODE_ADDITIVE:
-                        res = (LV_MIN(dest_buf_c16[dest_x].red + rb, 31)) << 11;
-                        res += (LV_MIN(dest_buf_c16[dest_x].green + g, 63)) << 5;
-                        res += LV_MIN(dest_buf_c16[dest_x].blue + rb, 31);
+                        res = (LV_MIN(FROM_DEST_C16(dest_buf_c16[dest_x]).red + rb, 31)) << 11;
+                        res += (LV_MIN(FROM_DEST_C16(dest_buf_c16[dest_x]).green + g, 63)) << 5;
+                        res += LV_MIN(FROM_DEST_C16(dest_buf_c16[dest_x]).blue + rb, 31);
                         break;
                     case LV_BLEND_MODE_SUBTRACTIVE:
-                        res = (LV_MAX(dest_buf_c16[dest_x].red - rb, 0)) << 11;
-                        res += (LV_MAX(dest_buf_c16[dest_x].green - g, 0)) << 5;
-                        res += LV_MAX(dest_buf_c16[dest_x].blue - rb, 0);
+                        res = (LV_MAX(FROM_DEST_C16(dest_buf_c16[dest_x]).red - rb, 0)) << 11;
+                        res += (LV_MAX(FROM_DEST_C16(dest_buf_c16[dest_x]).green - g, 0)) << 5;
+                        res += LV_MAX(FROM_DEST_C16(dest_buf_c16[dest_x]).blue - rb, 0);
                         break;
                     case LV_BLEND_MODE_MULTIPLY:
-                        res = ((dest_buf_c16[dest_x].red * rb) >> 5) << 11;
-                        res += ((dest_buf_c16[dest_x].green * g) >> 6) << 5;
-                        res += (dest_buf_c16[dest_x].blue * rb) >> 5;
+                        res = ((FROM_DEST_C16(dest_buf_c16[dest_x]).red * rb) >> 5) << 11;
+                        res += ((FROM_DEST_C16(dest_buf_c16[dest_x]).green * g) >> 6) << 5;
+                        res += (FROM_DEST_C16(dest_buf_c16[dest_x]).blue * rb) >> 5;
                         break;
                     default:
                         LV_LOG_WARN("Not supported blend mode: %d", dsc->blend_mode);
@@ -734,14 +766,14 @@ static void LV_ATTRIBUTE_FAST_MEM l8_image_blend(lv_draw_sw_blend_image_dsc_t *
                 }
 
                 if(mask_buf == NULL && opa >= LV_OPA_MAX) {
-                    dest_buf_u16[dest_x] = res;
+                    dest_buf_u16[dest_x] = TO_DEST(res);
                 }
                 else if(mask_buf == NULL && opa < LV_OPA_MAX) {
-                    dest_buf_u16[dest_x] = lv_color_16_16_mix(res, dest_buf_u16[dest_x], opa);
+                    dest_buf_u16[dest_x] = TO_DEST(lv_color_16_16_mix(res, FROM_DEST(dest_buf_u16[dest_x]), opa));
                 }
                 else {
-                    if(opa >= LV_OPA_MAX) dest_buf_u16[dest_x] = lv_color_16_16_mix(res, dest_buf_u16[dest_x], mask_buf[dest_x]);
-                    else dest_buf_u16[dest_x] = lv_color_16_16_mix(res, dest_buf_u16[dest_x], LV_OPA_MIX2(mask_buf[dest_x], opa));
+                    if(opa >= LV_OPA_MAX) dest_buf_u16[dest_x] = TO_DEST(lv_color_16_16_mix(res, FROM_DEST(dest_buf_u16[dest_x]), mask_buf[dest_x]));
+                    else dest_buf_u16[dest_x] = TO_DEST(lv_color_16_16_mix(res, FROM_DEST(dest_buf_u16[dest_x]), LV_OPA_MIX2(mask_buf[dest_x], opa)));
                 }
             }
 
@@ -774,7 +806,12 @@ static void LV_ATTRIBUTE_FAST_MEM rgb565_image_blend(lv_draw_sw_blend_image_dsc_
             if(LV_RESULT_INVALID == LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565(dsc)) {
                 uint32_t line_in_bytes = w * 2;
                 for(y = 0; y < h; y++) {
+#if LV_DRAW_SW_BLEND_RGB565_SWAPPED
+                    LV_UNUSED(line_in_bytes);
+                    copy_swapped(dest_buf_u16, src_buf_u16, w);
+#else
                     lv_memcpy(dest_buf_u16, src_buf_u16, line_in_bytes);
+#endif
                     dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
                     src_buf_u16 = drawbuf_next_row(src_buf_u16, src_stride);
                 }
@@ -784,7 +821,7 @@ static void LV_ATTRIBUTE_FAST_MEM rgb565_image_blend(lv_draw_sw_blend_image_dsc_
             if(LV_RESULT_INVALID == LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc)) {
                 for(y = 0; y < h; y++) {
                     for(x = 0; x < w; x++) {
-                        dest_buf_u16[x] = lv_color_16_16_mix(src_buf_u16[x], dest_buf_u16[x], opa);
+                        dest_buf_u16[x] = TO_DEST(lv_color_16_16_mix(src_buf_u16[x], FROM_DEST(dest_buf_u16[x]), opa));
                     }
                     dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
                     src_buf_u16 = drawbuf_next_row(src_buf_u16, src_stride);
@@ -795,7 +832,7 @@ static void LV_ATTRIBUTE_FAST_MEM rgb565_image_blend(lv_draw_sw_blend_image_dsc_
             if(LV_RESULT_INVALID == LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_MASK(dsc)) {
                 for(y = 0; y < h; y++) {
                     for(x = 0; x < w; x++) {
-                        dest_buf_u16[x] = lv_color_16_16_mix(src_buf_u16[x], dest_buf_u16[x], mask_buf[x]);
+                        dest_buf_u16[x] = TO_DEST(lv_color_16_16_mix(src_buf_u16[x], FROM_DEST(dest_buf_u16[x]), mask_buf[x]));
                     }
                     dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
                     src_buf_u16 = drawbuf_next_row(src_buf_u16, src_stride);
@@ -807,7 +844,7 @@ static void LV_ATTRIBUTE_FAST_MEM rgb565_image_blend(lv_draw_sw_blend_image_dsc_
             if(LV_RESULT_INVALID == LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA(dsc)) {
                 for(y = 0; y < h; y++) {
                     for(x = 0; x < w; x++) {
-                        dest_buf_u16[x] = lv_color_16_16_mix(src_buf_u16[x], dest_buf_u16[x], LV_OPA_MIX2(mask_buf[x], opa));
+                        dest_buf_u16[x] = TO_DEST(lv_color_16_16_mix(src_buf_u16[x], FROM_DEST(dest_buf_u16[x]), LV_OPA_MIX2(mask_buf[x], opa)));
                     }
                     dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
                     src_buf_u16 = drawbuf_next_row(src_buf_u16, src_stride);
@@ -825,21 +862,21 @@ static void LV_ATTRIBUTE_FAST_MEM rgb565_image_blend(lv_draw_sw_blend_image_dsc_
                 switch(dsc->blend_mode) {
                     case LV_BLEND_MODE_ADDITIVE:
                         if(src_buf_u16[x] == 0x0000) continue;   /*Do not add pure black*/
-                        res = (LV_MIN(dest_buf_c16[x].red + src_buf_c16[x].red, 31)) << 11;
-                        res += (LV_MIN(dest_buf_c16[x].green + src_buf_c16[x].green, 63)) << 5;
-                        res += LV_MIN(dest_buf_c16[x].blue + src_buf_c16[x].blue, 31);
+                        res = (LV_MIN(FROM_DEST_C16(dest_buf_c16[x]).red + src_buf_c16[x].red, 31)) << 11;
+                        res += (LV_MIN(FROM_DEST_C16(dest_buf_c16[x]).green + src_buf_c16[x].green, 63)) << 5;
+                        res += LV_MIN(FROM_DEST_C16(dest_buf_c16[x]).blue + src_buf_c16[x].blue, 31);
                         break;
                     case LV_BLEND_MODE_SUBTRACTIVE:
                         if(src_buf_u16[x] == 0x0000) continue;   /*Do not subtract pure black*/
-                        res = (LV_MAX(dest_buf_c16[x].red - src_buf_c16[x].red, 0)) << 11;
-                        res += (LV_MAX(dest_buf_c16[x].green - src_buf_c16[x].green, 0)) << 5;
-                        res += LV_MAX(dest_buf_c16[x].blue - src_buf_c16[x].blue, 0);
+                        res = (LV_MAX(FROM_DEST_C16(dest_buf_c16[x]).red - src_buf_c16[x].red, 0)) << 11;
+                        res += (LV_MAX(FROM_DEST_C16(dest_buf_c16[x]).green - src_buf_c16[x].green, 0)) << 5;
+                        res += LV_MAX(FROM_DEST_C16(dest_buf_c16[x]).blue - src_buf_c16[x].blue, 0);
                         break;
                     case LV_BLEND_MODE_MULTIPLY:
                         if(src_buf_u16[x] == 0xffff) continue;   /*Do not multiply with pure white (considered as 1)*/
-                        res = ((dest_buf_c16[x].red * src_buf_c16[x].red) >> 5) << 11;
-                        res += ((dest_buf_c16[x].green * src_buf_c16[x].green) >> 6) << 5;
-                        res += (dest_buf_c16[x].blue * src_buf_c16[x].blue) >> 5;
+                        res = ((FROM_DEST_C16(dest_buf_c16[x]).red * src_buf_c16[x].red) >> 5) << 11;
+                        res += ((FROM_DEST_C16(dest_buf_c16[x]).green * src_buf_c16[x].green) >> 6) << 5;
+                        res += (FROM_DEST_C16(dest_buf_c16[x]).blue * src_buf_c16[x].blue) >> 5;
                         break;
                     default:
                         LV_LOG_WARN("Not supported blend mode: %d", dsc->blend_mode);
@@ -847,11 +884,11 @@ static void LV_ATTRIBUTE_FAST_MEM rgb565_image_blend(lv_draw_sw_blend_image_dsc_
                 }
 
                 if(mask_buf == NULL) {
-                    dest_buf_u16[x] = lv_color_16_16_mix(res, dest_buf_u16[x], opa);
+                    dest_buf_u16[x] = TO_DEST(lv_color_16_16_mix(res, FROM_DEST(dest_buf_u16[x]), opa));
                 }
                 else {
-                    if(opa >= LV_OPA_MAX) dest_buf_u16[x] = lv_color_16_16_mix(res, dest_buf_u16[x], mask_buf[x]);
-                    else dest_buf_u16[x] = lv_color_16_16_mix(res, dest_buf_u16[x], LV_OPA_MIX2(mask_buf[x], opa));
+                    if(opa >= LV_OPA_MAX) dest_buf_u16[x] = TO_DEST(lv_color_16_16_mix(res, FROM_DEST(dest_buf_u16[x]), mask_buf[x]));
+                    else dest_buf_u16[x] = TO_DEST(lv_color_16_16_mix(res, FROM_DEST(dest_buf_u16[x]), LV_OPA_MIX2(mask_buf[x], opa)));
                 }
             }
 
@@ -885,9 +922,9 @@ static void LV_ATTRIBUTE_FAST_MEM rgb888_image_blend(lv_draw_sw_blend_image_dsc_
             if(LV_RESULT_INVALID == LV_DRAW_SW_RGB888_BLEND_NORMAL_TO_RGB565(dsc, src_px_size)) {
                 for(y = 0; y < h; y++) {
                     for(dest_x = 0, src_x = 0; dest_x < w; dest_x++, src_x += src_px_size) {
-                        dest_buf_u16[dest_x]  = ((src_buf_u8[src_x + 2] & 0xF8) << 8) +
-                                                ((src_buf_u8[src_x + 1] & 0xFC) << 3) +
-                                                ((src_buf_u8[src_x + 0] & 0xF8) >> 3);
+                        dest_buf_u16[dest_x]  = TO_DEST(((src_buf_u8[src_x + 2] & 0xF8) << 8) +
+                                                        ((src_buf_u8[src_x + 1] & 0xFC) << 3) +
+                                                        ((src_buf_u8[src_x + 0] & 0xF8) >> 3));
                     }
                     dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
                     src_buf_u8 += src_stride;
@@ -898,7 +935,7 @@ static void LV_ATTRIBUTE_FAST_MEM rgb888_image_blend(lv_draw_sw_blend_image_dsc_
             if(LV_RESULT_INVALID == LV_DRAW_SW_RGB888_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc, src_px_size)) {
                 for(y = 0; y < h; y++) {
                     for(dest_x = 0, src_x = 0; dest_x < w; dest_x++, src_x += src_px_size) {
-                        dest_buf_u16[dest_x] = lv_color_24_16_mix(&src_buf_u8[src_x], dest_buf_u16[dest_x], opa);
+                        dest_buf_u16[dest_x] = TO_DEST(lv_color_24_16_mix(&src_buf_u8[src_x], FROM_DEST(dest_buf_u16[dest_x]), opa));
                     }
                     dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
                     src_buf_u8 += src_stride;
@@ -909,7 +946,7 @@ static void LV_ATTRIBUTE_FAST_MEM rgb888_image_blend(lv_draw_sw_blend_image_dsc_
             if(LV_RESULT_INVALID == LV_DRAW_SW_RGB888_BLEND_NORMAL_TO_RGB565_WITH_MASK(dsc, src_px_size)) {
                 for(y = 0; y < h; y++) {
                     for(dest_x = 0, src_x = 0; dest_x < w; dest_x++, src_x += src_px_size) {
-                        dest_buf_u16[dest_x] = lv_color_24_16_mix(&src_buf_u8[src_x], dest_buf_u16[dest_x], mask_buf[dest_x]);
+                        dest_buf_u16[dest_x] = TO_DEST(lv_color_24_16_mix(&src_buf_u8[src_x], FROM_DEST(dest_buf_u16[dest_x]), mask_buf[dest_x]));
                     }
                     dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
                     src_buf_u8 += src_stride;
@@ -921,7 +958,7 @@ static void LV_ATTRIBUTE_FAST_MEM rgb888_image_blend(lv_draw_sw_blend_image_dsc_
             if(LV_RESULT_INVALID == LV_DRAW_SW_RGB888_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA(dsc, src_px_size)) {
                 for(y = 0; y < h; y++) {
                     for(dest_x = 0, src_x = 0; dest_x < w; dest_x++, src_x += src_px_size) {
-                        dest_buf_u16[dest_x] = lv_color_24_16_mix(&src_buf_u8[src_x], dest_buf_u16[dest_x], LV_OPA_MIX2(mask_buf[dest_x], opa));
+                        dest_buf_u16[dest_x] = TO_DEST(lv_color_24_16_mix(&src_buf_u8[src_x], FROM_DEST(dest_buf_u16[dest_x]), LV_OPA_MIX2(mask_buf[dest_x], opa)));
                     }
                     dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
                     src_buf_u8 += src_stride;
@@ -937,19 +974,19 @@ static void LV_ATTRIBUTE_FAST_MEM rgb888_image_blend(lv_draw_sw_blend_image_dsc_
             for(dest_x = 0, src_x = 0; dest_x < w; dest_x++, src_x += src_px_size) {
                 switch(dsc->blend_mode) {
                     case LV_BLEND_MODE_ADDITIVE:
-                        res = (LV_MIN(dest_buf_c16[dest_x].red + (src_buf_u8[src_x + 2] >> 3), 31)) << 11;
-                        res += (LV_MIN(dest_buf_c16[dest_x].green + (src_buf_u8[src_x + 1] >> 2), 63)) << 5;
-                        res += LV_MIN(dest_buf_c16[dest_x].blue + (src_buf_u8[src_x + 0] >> 3), 31);
+                        res = (LV_MIN(FROM_DEST_C16(dest_buf_c16[dest_x]).red + (src_buf_u8[src_x + 2] >> 3), 31)) << 11;
+                        res += (LV_MIN(FROM_DEST_C16(dest_buf_c16[dest_x]).green + (src_buf_u8[src_x + 1] >> 2), 63)) << 5;
+                        res += LV_MIN(FROM_DEST_C16(dest_buf_c16[dest_x]).blue + (src_buf_u8[src_x + 0] >> 3), 31);
                         break;
                     case LV_BLEND_MODE_SUBTRACTIVE:
-                        res = (LV_MAX(dest_buf_c16[dest_x].red - (src_buf_u8[src_x + 2] >> 3), 0)) << 11;
-                        res += (LV_MAX(dest_buf_c16[dest_x].green - (src_buf_u8[src_x + 1] >> 2), 0)) << 5;
-                        res += LV_MAX(dest_buf_c16[dest_x].blue - (src_buf_u8[src_x + 0] >> 3), 0);
+                        res = (LV_MAX(FROM_DEST_C16(dest_buf_c16[dest_x]).red - (src_buf_u8[src_x + 2] >> 3), 0)) << 11;
+                        res += (LV_MAX(FROM_DEST_C16(dest_buf_c16[dest_x]).green - (src_buf_u8[src_x + 1] >> 2), 0)) << 5;
+                        res += LV_MAX(FROM_DEST_C16(dest_buf_c16[dest_x]).blue - (src_buf_u8[src_x + 0] >> 3), 0);
                         break;
                     case LV_BLEND_MODE_MULTIPLY:
-                        res = ((dest_buf_c16[dest_x].red * (src_buf_u8[src_x + 2] >> 3)) >> 5) << 11;
-                        res += ((dest_buf_c16[dest_x].green * (src_buf_u8[src_x + 1] >> 2)) >> 6) << 5;
-                        res += (dest_buf_c16[dest_x].blue * (src_buf_u8[src_x + 0] >> 3)) >> 5;
+                        res = ((FROM_DEST_C16(dest_buf_c16[dest_x]).red * (src_buf_u8[src_x + 2] >> 3)) >> 5) << 11;
+                        res += ((FROM_DEST_C16(dest_buf_c16[dest_x]).green * (src_buf_u8[src_x + 1] >> 2)) >> 6) << 5;
+                        res += (FROM_DEST_C16(dest_buf_c16[dest_x]).blue * (src_buf_u8[src_x + 0] >> 3)) >> 5;
                         break;
                     default:
                         LV_LOG_WARN("Not supported blend mode: %d", dsc->blend_mode);
@@ -957,11 +994,11 @@ static void LV_ATTRIBUTE_FAST_MEM rgb888_image_blend(lv_draw_sw_blend_image_dsc_
                 }
 
                 if(mask_buf == NULL) {
-                    dest_buf_u16[dest_x] = lv_color_16_16_mix(res, dest_buf_u16[dest_x], opa);
+                    dest_buf_u16[dest_x] = TO_DEST(lv_color_16_16_mix(res, FROM_DEST(dest_buf_u16[dest_x]), opa));
                 }
                 else {
-                    if(opa >= LV_OPA_MAX) dest_buf_u16[dest_x] = lv_color_16_16_mix(res, dest_buf_u16[dest_x], mask_buf[dest_x]);
-                    else dest_buf_u16[dest_x] = lv_color_16_16_mix(res, dest_buf_u16[dest_x], LV_OPA_MIX2(mask_buf[dest_x], opa));
+                    if(opa >= LV_OPA_MAX) dest_buf_u16[dest_x] = TO_DEST(lv_color_16_16_mix(res, FROM_DEST(dest_buf_u16[dest_x]), mask_buf[dest_x]));
+                    else dest_buf_u16[dest_x] = TO_DEST(lv_color_16_16_mix(res, FROM_DEST(dest_buf_u16[dest_x]), LV_OPA_MIX2(mask_buf[dest_x], opa)));
                 }
             }
             dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
@@ -997,7 +1034,7 @@ static void LV_ATTRIBUTE_FAST_MEM argb8888_image_blend(lv_draw_sw_blend_image_ds
             if(LV_RESULT_INVALID == LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565(dsc)) {
                 for(y = 0; y < h; y++) {
                     for(dest_x = 0, src_x = 0; dest_x < w; dest_x++, src_x += 4) {
-                        dest_buf_u16[dest_x] = lv_color_24_16_mix(&src_buf_u8[src_x], dest_buf_u16[dest_x], src_buf_u8[src_x + 3]);
+                        dest_buf_u16[dest_x] = TO_DEST(lv_color_24_16_mix(&src_buf_u8[src_x], FROM_DEST(dest_buf_u16[dest_x]), src_buf_u8[src_x + 3]));
                     }
                     dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
                     src_buf_u8 += src_stride;
@@ -1008,8 +1045,8 @@ static void LV_ATTRIBUTE_FAST_MEM argb8888_image_blend(lv_draw_sw_blend_image_ds
             if(LV_RESULT_INVALID == LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc)) {
                 for(y = 0; y < h; y++) {
                     for(dest_x = 0, src_x = 0; dest_x < w; dest_x++, src_x += 4) {
-                        dest_buf_u16[dest_x] = lv_color_24_16_mix(&src_buf_u8[src_x], dest_buf_u16[dest_x], LV_OPA_MIX2(src_buf_u8[src_x + 3],
-                                                                                                                        opa));
+                        dest_buf_u16[dest_x] = TO_DEST(lv_color_24_16_mix(&src_buf_u8[src_x], FROM_DEST(dest_buf_u16[dest_x]), LV_OPA_MIX2(src_buf_u8[src_x + 3],
+                                                                                                                                opa)));
                     }
                     dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
                     src_buf_u8 += src_stride;
@@ -1020,8 +1057,8 @@ static void LV_ATTRIBUTE_FAST_MEM argb8888_image_blend(lv_draw_sw_blend_image_ds
             if(LV_RESULT_INVALID == LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_WITH_MASK(dsc)) {
                 for(y = 0; y < h; y++) {
                     for(dest_x = 0, src_x = 0; dest_x < w; dest_x++, src_x += 4) {
-                        dest_buf_u16[dest_x] = lv_color_24_16_mix(&src_buf_u8[src_x], dest_buf_u16[dest_x],
-                                                                  LV_OPA_MIX2(src_buf_u8[src_x + 3], mask_buf[dest_x]));
+                        dest_buf_u16[dest_x] = TO_DEST(lv_color_24_16_mix(&src_buf_u8[src_x], FROM_DEST(dest_buf_u16[dest_x]),
+                                                                          LV_OPA_MIX2(src_buf_u8[src_x + 3], mask_buf[dest_x])));
                     }
                     dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
                     src_buf_u8 += src_stride;
@@ -1033,8 +1070,8 @@ static void LV_ATTRIBUTE_FAST_MEM argb8888_image_blend(lv_draw_sw_blend_image_ds
             if(LV_RESULT_INVALID == LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA(dsc)) {
                 for(y = 0; y < h; y++) {
                     for(dest_x = 0, src_x = 0; dest_x < w; dest_x++, src_x += 4) {
-                        dest_buf_u16[dest_x] = lv_color_24_16_mix(&src_buf_u8[src_x], dest_buf_u16[dest_x],
-                                                                  LV_OPA_MIX3(src_buf_u8[src_x + 3], mask_buf[dest_x], opa));
+                        dest_buf_u16[dest_x] = TO_DEST(lv_color_24_16_mix(&src_buf_u8[src_x], FROM_DEST(dest_buf_u16[dest_x]),
+                                                                          LV_OPA_MIX3(src_buf_u8[src_x + 3], mask_buf[dest_x], opa)));
                     }
                     dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
                     src_buf_u8 += src_stride;
@@ -1050,19 +1087,19 @@ static void LV_ATTRIBUTE_FAST_MEM argb8888_image_blend(lv_draw_sw_blend_image_ds
             for(dest_x = 0, src_x = 0; dest_x < w; dest_x++, src_x += 4) {
                 switch(dsc->blend_mode) {
                     case LV_BLEND_MODE_ADDITIVE:
-                        res = (LV_MIN(dest_buf_c16[dest_x].red + (src_buf_u8[src_x + 2] >> 3), 31)) << 11;
-                        res += (LV_MIN(dest_buf_c16[dest_x].green + (src_buf_u8[src_x + 1] >> 2), 63)) << 5;
-                        res += LV_MIN(dest_buf_c16[dest_x].blue + (src_buf_u8[src_x + 0] >> 3), 31);
+                        res = (LV_MIN(FROM_DEST_C16(dest_buf_c16[dest_x]).red + (src_buf_u8[src_x + 2] >> 3), 31)) << 11;
+                        res += (LV_MIN(FROM_DEST_C16(dest_buf_c16[dest_x]).green + (src_buf_u8[src_x + 1] >> 2), 63)) << 5;
+                        res += LV_MIN(FROM_DEST_C16(dest_buf_c16[dest_x]).blue + (src_buf_u8[src_x + 0] >> 3), 31);
                         break;
                     case LV_BLEND_MODE_SUBTRACTIVE:
-                        res = (LV_MAX(dest_buf_c16[dest_x].red - (src_buf_u8[src_x + 2] >> 3), 0)) << 11;
-                        res += (LV_MAX(dest_buf_c16[dest_x].green - (src_buf_u8[src_x + 1] >> 2), 0)) << 5;
-                        res += LV_MAX(dest_buf_c16[dest_x].blue - (src_buf_u8[src_x + 0] >> 3), 0);
+                        res = (LV_MAX(FROM_DEST_C16(dest_buf_c16[dest_x]).red - (src_buf_u8[src_x + 2] >> 3), 0)) << 11;
+                        res += (LV_MAX(FROM_DEST_C16(dest_buf_c16[dest_x]).green - (src_buf_u8[src_x + 1] >> 2), 0)) << 5;
+                        res += LV_MAX(FROM_DEST_C16(dest_buf_c16[dest_x]).blue - (src_buf_u8[src_x + 0] >> 3), 0);
                         break;
                     case LV_BLEND_MODE_MULTIPLY:
-                        res = ((dest_buf_c16[dest_x].red * (src_buf_u8[src_x + 2] >> 3)) >> 5) << 11;
-                        res += ((dest_buf_c16[dest_x].green * (src_buf_u8[src_x + 1] >> 2)) >> 6) << 5;
-                        res += (dest_buf_c16[dest_x].blue * (src_buf_u8[src_x + 0] >> 3)) >> 5;
+                        res = ((FROM_DEST_C16(dest_buf_c16[dest_x]).red * (src_buf_u8[src_x + 2] >> 3)) >> 5) << 11;
+                        res += ((FROM_DEST_C16(dest_buf_c16[dest_x]).green * (src_buf_u8[src_x + 1] >> 2)) >> 6) << 5;
+                        res += (FROM_DEST_C16(dest_buf_c16[dest_x]).blue * (src_buf_u8[src_x + 0] >> 3)) >> 5;
                         break;
                     default:
                         LV_LOG_WARN("Not supported blend mode: %d", dsc->blend_mode);
@@ -1070,15 +1107,15 @@ static void LV_ATTRIBUTE_FAST_MEM argb8888_image_blend(lv_draw_sw_blend_image_ds
                 }
 
                 if(mask_buf == NULL && opa >= LV_OPA_MAX) {
-                    dest_buf_u16[dest_x] = lv_color_16_16_mix(res, dest_buf_u16[dest_x], src_buf_u8[src_x + 3]);
+                    dest_buf_u16[dest_x] = TO_DEST(lv_color_16_16_mix(res, FROM_DEST(dest_buf_u16[dest_x]), src_buf_u8[src_x + 3]));
                 }
                 else if(mask_buf == NULL && opa < LV_OPA_MAX) {
-                    dest_buf_u16[dest_x] = lv_color_16_16_mix(res, dest_buf_u16[dest_x], LV_OPA_MIX2(opa, src_buf_u8[src_x + 3]));
+                    dest_buf_u16[dest_x] = TO_DEST(lv_color_16_16_mix(res, FROM_DEST(dest_buf_u16[dest_x]), LV_OPA_MIX2(opa, src_buf_u8[src_x + 3])));
                 }
                 else {
-                    if(opa >= LV_OPA_MAX) dest_buf_u16[dest_x] = lv_color_16_16_mix(res, dest_buf_u16[dest_x], mask_buf[dest_x]);
-                    else dest_buf_u16[dest_x] = lv_color_16_16_mix(res, dest_buf_u16[dest_x], LV_OPA_MIX3(mask_buf[dest_x], opa,
-                                                                                                              src_buf_u8[src_x + 3]));
+                    if(opa >= LV_OPA_MAX) dest_buf_u16[dest_x] = TO_DEST(lv_color_16_16_mix(res, FROM_DEST(dest_buf_u16[dest_x]), mask_buf[dest_x]));
+                    else dest_buf_u16[dest_x] = TO_DEST(lv_color_16_16_mix(res, FROM_DEST(dest_buf_u16[dest_x]), LV_OPA_MIX3(mask_buf[dest_x], opa,
+                                                                                                                      src_buf_u8[src_x + 3])));
                 }
             }
 
@@ -1145,6 +1182,62 @@ static inline void * LV_ATTRIBUTE_FAST_MEM drawbuf_next_row(const void * buf, ui
     return (void *)((uint8_t *)buf + stride);
 }
 
+#if LV_DRAW_SW_BLEND_RGB565_SWAPPED
+
+static inline uint16_t LV_ATTRIBUTE_FAST_MEM swap16(uint16_t c)
+{
+    return (uint16_t)((c >> 8) | (c << 8));
+}
+
+static inline lv_color16_t LV_ATTRIBUTE_FAST_MEM swap_c16(lv_color16_t c)
+{
+    union {
+        lv_color16_t c16;
+        uint16_t u16;
+    } v;
+    v.c16 = c;
+    v.u16 = swap16(v.u16);
+    return v.c16;
+}
+
+static inline void LV_ATTRIBUTE_FAST_MEM copy_swapped(uint16_t * dest, const uint16_t * src, int32_t w)
+{
+    /*Swap 2 pixels at a time if both rows can be word aligned*/
+    if((((lv_uintptr_t)dest ^ (lv_uintptr_t)src) & 0x3) == 0) {
+        if(((lv_uintptr_t)dest & 0x3) && w > 0) {
+            *dest++ = swap16(*src++);
+            w--;
+        }
+
+        uint32_t * dest32 = (uint32_t *)dest;
+        const uint32_t * src32 = (const uint32_t *)src;
+        while(w >= 8) {
+            dest32[0] = ((src32[0] & 0xff00ff00) >> 8) | ((src32[0] & 0x00ff00ff) << 8);
+            dest32[1] = ((src32[1] & 0xff00ff00) >> 8) | ((src32[1] & 0x00ff00ff) << 8);
+            dest32[2] = ((src32[2] & 0xff00ff00) >> 8) | ((src32[2] & 0x00ff00ff) << 8);
+            dest32[3] = ((src32[3] & 0xff00ff00) >> 8) | ((src32[3] & 0x00ff00ff) << 8);
+            dest32 += 4;
+            src32 += 4;
+            w -= 8;
+        }
+        while(w >= 2) {
+            *dest32 = ((*src32 & 0xff00ff00) >> 8) | ((*src32 & 0x00ff00ff) << 8);
+            dest32++;
+            src32++;
+            w -= 2;
+        }
+        dest = (uint16_t *)dest32;
+        src = (const uint16_t *)src32;
+    }
+
+    while(w > 0) {
+        *dest++ = swap16(*src++);
+        w--;
+    }
+}
+
+#endif
+
 #endif
 
 #endif
@@ -20,6 +20,11 @@ extern "C" {
  *      DEFINES
  *********************/
 
+/*Render target in the byte order of SPI/QSPI panels (`LV_COLOR_FORMAT_RGB565_SWAPPED`)*/
+#ifndef LV_DRAW_SW_SUPPORT_RGB565_SWAPPED
+#define LV_DRAW_SW_SUPPORT_RGB565_SWAPPED LV_DRAW_SW_SUPPORT_RGB565
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -32,6 +37,21 @@ void /* LV_ATTRIBUTE_FAST_MEM */ lv_draw_sw_blend_color_to_rgb565(lv_draw_sw_ble
 
 void /* LV_ATTRIBUTE_FAST_MEM */ lv_draw_sw_blend_image_to_rgb565(lv_draw_sw_blend_image_dsc_t * dsc);
 
+#if LV_DRAW_SW_SUPPORT_RGB565_SWAPPED
+
+/**
+ * Same as `lv_draw_sw_blend_color_to_rgb565` but `dest_buf` holds RGB565 with the 2 bytes swapped
+ */
+void /* LV_ATTRIBUTE_FAST_MEM */ lv_draw_sw_blend_color_to_rgb565_swapped(lv_draw_sw_blend_fill_dsc_t * dsc);
+
+/**
+ * Same as `lv_draw_sw_blend_image_to_rgb565` but `dest_buf` holds RGB565 with the 2 bytes swapped.
+ * The source image is in normal byte order.
+ */
+void /* LV_ATTRIBUTE_FAST_MEM */ lv_draw_sw_blend_image_to_rgb565_swapped(lv_draw_sw_blend_image_dsc_t * dsc);
+
+#endif
+
 /**********************
  *      MACROS
  **********************/
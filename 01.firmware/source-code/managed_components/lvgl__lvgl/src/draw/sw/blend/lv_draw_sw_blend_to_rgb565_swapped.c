@@ -0,0 +1,17 @@
+/**
+ * @file lv_draw_sw_blend_to_rgb565_swapped.c
+ *
+ * Blenders for an RGB565 destination in swapped byte order (`LV_COLOR_FORMAT_RGB565_SWAPPED`).
+ * The display buffer is rendered in the order SPI panels expect, so it can be sent without a swap pass.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_draw_sw_blend_to_rgb565.h"
+#if LV_USE_DRAW_SW && LV_DRAW_SW_SUPPORT_RGB565_SWAPPED
+
+#define LV_DRAW_SW_BLEND_RGB565_SWAPPED 1
+#include "lv_draw_sw_blend_to_rgb565.c"
+
+#endif
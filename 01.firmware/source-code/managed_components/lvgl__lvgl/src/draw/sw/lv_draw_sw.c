@@ -152,6 +152,7 @@ static void rotate270_l8(const uint8_t * src, uint8_t * dst, int32_t src_width,
  *  STATIC VARIABLES
  **********************/
 #define _draw_info LV_GLOBAL_DEFAULT()->draw_info
+static lv_draw_sw_task_cb_t task_cb;
 
 /**********************
  *      MACROS
@@ -197,6 +198,11 @@ void lv_draw_sw_deinit(void)
 #endif
 }
 
+void lv_draw_sw_set_task_cb(lv_draw_sw_task_cb_t cb)
+{
+    task_cb = cb;
+}
+
 static int32_t lv_draw_sw_delete(lv_draw_unit_t * draw_unit)
 {
 #if LV_USE_OS
@@ -293,6 +299,7 @@ void lv_draw_sw_rotate(const void * src, void * dest, int32_t src_width, int32_t
 #endif
 #if LV_DRAW_SW_SUPPORT_RGB565
             case LV_COLOR_FORMAT_RGB565:
+            case LV_COLOR_FORMAT_RGB565_SWAPPED:
                 rotate90_rgb565(src, dest, src_width, src_height, src_stride, dest_stride);
                 break;
 #endif
@@ -323,6 +330,7 @@ void lv_draw_sw_rotate(const void * src, void * dest, int32_t src_width, int32_t
 #endif
 #if LV_DRAW_SW_SUPPORT_RGB565
             case LV_COLOR_FORMAT_RGB565:
+            case LV_COLOR_FORMAT_RGB565_SWAPPED:
                 rotate180_rgb565(src, dest, src_width, src_height, src_stride, dest_stride);
                 break;
 #endif
@@ -353,6 +361,7 @@ void lv_draw_sw_rotate(const void * src, void * dest, int32_t src_width, int32_t
 #endif
 #if LV_DRAW_SW_SUPPORT_RGB565
             case LV_COLOR_FORMAT_RGB565:
+            case LV_COLOR_FORMAT_RGB565_SWAPPED:
                 rotate270_rgb565(src, dest, src_width, src_height, src_stride, dest_stride);
                 break;
 #endif
@@ -380,8 +389,14 @@ void lv_draw_sw_rotate(const void * src, void * dest, int32_t src_width, int32_t
  **********************/
 static inline void execute_drawing_unit(lv_draw_sw_unit_t * u)
 {
+    lv_draw_sw_task_cb_t cb = task_cb;
+    lv_draw_task_type_t type = u->task_act->type;
+    if(cb) cb(u->idx, type, false);
+
     execute_drawing(u);
 
+    if(cb) cb(u->idx, type, true);
+
     u->task_act->state = LV_DRAW_TASK_STATE_READY;
     u->task_act = NULL;
 
@@ -32,6 +32,19 @@ extern "C" {
  *      DEFINES
  *********************/
 
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * Called by a SW draw unit right before (`done == false`) and after (`done == true`) it executes a draw task.
+ * It runs in the draw unit's render thread, so it must be short and thread safe.
+ * @param unit_idx      index of the SW draw unit (0 ... LV_DRAW_SW_DRAW_UNIT_CNT - 1)
+ * @param type          type of the draw task
+ * @param done          false before, true after executing the task
+ */
+typedef void (*lv_draw_sw_task_cb_t)(uint32_t unit_idx, lv_draw_task_type_t type, bool done);
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -47,6 +60,12 @@ void lv_draw_sw_init(void);
  */
 void lv_draw_sw_deinit(void);
 
+/**
+ * Set a callback to be notified around each draw task the SW draw units execute, e.g. for profiling.
+ * @param cb            the callback, or NULL to remove it
+ */
+void lv_draw_sw_set_task_cb(lv_draw_sw_task_cb_t cb);
+
 /**
  * Fill an area using SW render. Handle gradient and radius.
  * @param draw_unit     pointer to a draw unit
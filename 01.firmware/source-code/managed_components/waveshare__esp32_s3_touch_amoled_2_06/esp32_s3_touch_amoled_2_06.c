@@ -11,6 +11,8 @@
 #include "driver/ledc.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
 
 #include "esp_lcd_sh8601.h"
 #include "esp_lcd_touch_ft5x06.h"
@@ -360,6 +362,8 @@ esp_err_t bsp_display_brightness_set(int brightness_percent)
     lcd_cmd |= 0x02 << 24;
     uint8_t param = brightness;
     esp_lcd_panel_io_tx_param(io_handle, lcd_cmd, &param, 1);
+    /* The command bypassed the panel driver, so the next flush starts again with RAMWR */
+    esp_lcd_sh8601_restart_write(panel_handle);
 
     return ESP_OK;
 }
@@ -438,6 +442,7 @@ esp_err_t bsp_display_new(const bsp_display_config_t *config, esp_lcd_panel_hand
     sh8601_vendor_config_t vendor_config = {
         .init_cmds = lcd_init_cmds,
         .init_cmds_size = sizeof(lcd_init_cmds) / sizeof(lcd_init_cmds[0]),
+        .v_res = BSP_LCD_V_RES,
         .flags = {
             .use_qspi_interface = 1,
         },
@@ -494,29 +499,140 @@ esp_err_t bsp_touch_new(const bsp_touch_config_t *config, esp_lcd_touch_handle_t
     return esp_lcd_touch_new_i2c_ft5x06(tp_io_handle, &tp_cfg, ret_touch);
 }
 
+/*
+ * LVGL flush path: two internal DMA draw buffers, LVGL renders into one while the other is on the QSPI bus.
+ * The transfer-done ISR only timestamps and signals a semaphore; LVGL blocks on it in flush_wait_cb instead of
+ * spinning on the flushing flag.
+ */
+#define BSP_FLUSH_WAIT_TIMEOUT_MS 100
+
+static struct
+{
+    SemaphoreHandle_t done;
+    volatile bool inflight;
+    volatile int64_t tx_done_us;
+    int64_t tx_start_us;
+    int64_t refr_start_us;
+    int64_t wait_start_us;
+    uint32_t frame_wait_us;
+    uint32_t frame_flushes;
+    bsp_display_flush_stats_t st;
+} s_flush;
+
+static IRAM_ATTR bool bsp_flush_trans_done(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
+{
+    BaseType_t woken = pdFALSE;
+    s_flush.tx_done_us = esp_timer_get_time();
+    s_flush.inflight = false;
+    xSemaphoreGiveFromISR(s_flush.done, &woken);
+    return woken == pdTRUE;
+}
+
+/* The semaphore may hold a stale give from a transfer nobody waited for, so re-check the flag after each take */
+static bool bsp_flush_wait_idle(uint32_t timeout_ms)
+{
+    while (s_flush.inflight)
+    {
+        if (xSemaphoreTake(s_flush.done, pdMS_TO_TICKS(timeout_ms)) != pdTRUE)
+        {
+            return !s_flush.inflight;
+        }
+    }
+    return true;
+}
+
+static void bsp_flush_wait_cb(lv_display_t *disp)
+{
+    if (!bsp_flush_wait_idle(BSP_FLUSH_WAIT_TIMEOUT_MS))
+    {
+        /* A transfer that never completes (e.g. draw_bitmap failed) must not hang LVGL */
+        s_flush.inflight = false;
+        s_flush.st.wait_timeouts++;
+        ESP_LOGW(TAG, "Flush transfer timeout");
+    }
+}
+
+static void bsp_flush_event_cb(lv_event_t *e)
+{
+    int64_t now = esp_timer_get_time();
+
+    switch (lv_event_get_code(e))
+    {
+    case LV_EVENT_REFR_START:
+        s_flush.refr_start_us = now;
+        s_flush.frame_wait_us = 0;
+        s_flush.frame_flushes = 0;
+        break;
+    case LV_EVENT_FLUSH_WAIT_START:
+        s_flush.wait_start_us = now;
+        break;
+    case LV_EVENT_FLUSH_WAIT_FINISH:
+        s_flush.frame_wait_us += (uint32_t)(now - s_flush.wait_start_us);
+        break;
+    case LV_EVENT_FLUSH_START:
+        /* LVGL has waited for the previous transfer before starting this one, so its end time is final */
+        if (s_flush.st.flushes && s_flush.tx_done_us > s_flush.tx_start_us)
+        {
+            s_flush.st.tx_us += s_flush.tx_done_us - s_flush.tx_start_us;
+        }
+        s_flush.tx_start_us = now;
+        s_flush.inflight = true;
+        s_flush.frame_flushes++;
+        s_flush.st.flushes++;
+        break;
+    case LV_EVENT_REFR_READY:
+        if (s_flush.frame_flushes)
+        {
+            uint32_t total = (uint32_t)(now - s_flush.refr_start_us);
+            uint32_t wait = s_flush.frame_wait_us;
+            s_flush.st.frames++;
+            s_flush.st.last_render_us = total > wait ? total - wait : 0;
+            s_flush.st.last_wait_us = wait;
+            s_flush.st.last_flushes = s_flush.frame_flushes;
+            s_flush.st.render_us += s_flush.st.last_render_us;
+            s_flush.st.wait_us += wait;
+            if (wait > s_flush.st.max_wait_us)
+            {
+                s_flush.st.max_wait_us = wait;
+            }
+            ESP_LOGD(TAG, "frame %lu: render %lu us, wait %lu us, %lu areas", (unsigned long)s_flush.st.frames,
+                     (unsigned long)s_flush.st.last_render_us, (unsigned long)wait, (unsigned long)s_flush.frame_flushes);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static esp_err_t bsp_flush_attach_io(void)
+{
+    const esp_lcd_panel_io_callbacks_t cbs = {
+        .on_color_trans_done = bsp_flush_trans_done,
+    };
+    return esp_lcd_panel_io_register_event_callbacks(io_handle, &cbs, NULL);
+}
+
 static lv_display_t *bsp_display_lcd_init()
 {
     bsp_display_config_t disp_config = {0};
 
     BSP_ERROR_CHECK_RETURN_NULL(bsp_display_new(&disp_config, &panel_handle, &io_handle));
 
-    int buffer_size = 0;
-#if CONFIG_BSP_DISPLAY_LVGL_AVOID_TEAR
-    buffer_size = BSP_LCD_H_RES * BSP_LCD_V_RES;
-#else
-    buffer_size = BSP_LCD_H_RES * LVGL_BUFFER_HEIGHT;
-#endif /* CONFIG_BSP_DISPLAY_LVGL_AVOID_TEAR */
+    s_flush.done = xSemaphoreCreateBinary();
+    BSP_NULL_CHECK(s_flush.done, NULL);
 
-    const lvgl_port_display_cfg_t disp_cfg = {
+    lvgl_port_display_cfg_t disp_cfg = {
         .io_handle = io_handle,
         .panel_handle = panel_handle,
-        .buffer_size = buffer_size,
+        .buffer_size = BSP_LCD_DRAW_BUFF_SIZE,
+        .double_buffer = BSP_LCD_DRAW_BUFF_DOUBLE,
 
         .monochrome = false,
         .hres = BSP_LCD_H_RES,
         .vres = BSP_LCD_V_RES,
 #if LVGL_VERSION_MAJOR >= 9
-        .color_format = LV_COLOR_FORMAT_RGB565,
+        /* LVGL renders straight into the SH8601's byte order, so flushes are sent without a swap pass */
+        .color_format = LV_COLOR_FORMAT_RGB565_SWAPPED,
 #endif
 
         .rotation = {
@@ -525,44 +641,38 @@ static lv_display_t *bsp_display_lcd_init()
             .mirror_y = false,
         },
         .flags = {
-            .sw_rotate = true,
-            .buff_dma = false,
-#if CONFIG_BSP_DISPLAY_LVGL_PSRAM
+            .buff_dma = true,
             .buff_spiram = false,
-#endif
-#if CONFIG_BSP_DISPLAY_LVGL_FULL_REFRESH
-            .full_refresh = 1,
-#elif CONFIG_BSP_DISPLAY_LVGL_DIRECT_MODE
-            .direct_mode = 1,
-#endif
 #if LVGL_VERSION_MAJOR >= 9
-            .swap_bytes = true,
+            .swap_bytes = false,
 #endif
         }};
-    const lvgl_port_display_rgb_cfg_t rgb_cfg = {
-        .flags = {
-#if CONFIG_BSP_LCD_RGB_BOUNCE_BUFFER_MODE
-            .bb_mode = 1,
-#else
-            .bb_mode = 0,
-#endif
-#if CONFIG_BSP_DISPLAY_LVGL_AVOID_TEAR
-            .avoid_tearing = true,
-#else
-            .avoid_tearing = false,
-#endif
-        }};
-
-#if CONFIG_BSP_LCD_RGB_BOUNCE_BUFFER_MODE
-    ESP_LOGW(TAG, "CONFIG_BSP_LCD_RGB_BOUNCE_BUFFER_MODE");
-#endif
 
-    lv_display_t *disp = lvgl_port_add_disp_rgb(&disp_cfg, &rgb_cfg);
+    /* QSPI panel: the SPI display path, not the RGB one (no frame buffers, completion comes from the panel IO) */
+    lv_display_t *disp = lvgl_port_add_disp(&disp_cfg);
+    if (!disp)
+    {
+        /* Not enough internal DMA memory: fall back to one PSRAM buffer, the SPI driver then copies each flush */
+        ESP_LOGW(TAG, "No internal DMA memory for 2 x %d lines, using a single PSRAM buffer", LVGL_BUFFER_HEIGHT);
+        disp_cfg.double_buffer = false;
+        disp_cfg.flags.buff_dma = false;
+        disp_cfg.flags.buff_spiram = true;
+        disp = lvgl_port_add_disp(&disp_cfg);
+    }
     if (!disp)
     {
         return NULL;
     }
 
+    bsp_display_lock(0);
+    /* Replaces the port's done callback, which only marks the flush ready */
+    ESP_ERROR_CHECK(bsp_flush_attach_io());
+    lv_display_set_flush_wait_cb(disp, bsp_flush_wait_cb);
+    lv_display_add_event_cb(disp, bsp_flush_event_cb, LV_EVENT_REFR_START, NULL);
+    lv_display_add_event_cb(disp, bsp_flush_event_cb, LV_EVENT_REFR_READY, NULL);
+    lv_display_add_event_cb(disp, bsp_flush_event_cb, LV_EVENT_FLUSH_START, NULL);
+    lv_display_add_event_cb(disp, bsp_flush_event_cb, LV_EVENT_FLUSH_WAIT_START, NULL);
+    lv_display_add_event_cb(disp, bsp_flush_event_cb, LV_EVENT_FLUSH_WAIT_FINISH, NULL);
 #if LVGL_VERSION_MAJOR >= 9
     lv_display_add_event_cb(disp, rounder_event_cb, LV_EVENT_INVALIDATE_AREA, NULL);
 #else
@@ -571,6 +681,7 @@ static lv_display_t *bsp_display_lcd_init()
         disp_v8->driver->rounder_cb = bsp_lvgl_rounder_cb;
     }
 #endif
+    bsp_display_unlock();
 
     return disp;
 }
@@ -601,8 +712,8 @@ lv_display_t *bsp_display_start(void)
         .buffer_size = BSP_LCD_DRAW_BUFF_SIZE,
         .double_buffer = BSP_LCD_DRAW_BUFF_DOUBLE,
         .flags = {
-            .buff_dma = false,
-            .buff_spiram = true,
+            .buff_dma = true,
+            .buff_spiram = false,
         }};
     return bsp_display_start_with_config(&cfg);
 }
@@ -628,6 +739,57 @@ lv_indev_t *bsp_display_get_input_dev(void)
     return disp_indev;
 }
 
+esp_err_t bsp_display_get_panel(esp_lcd_panel_handle_t *panel, esp_lcd_panel_io_handle_t *io)
+{
+    if (panel_handle == NULL || io_handle == NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (panel)
+    {
+        *panel = panel_handle;
+    }
+    if (io)
+    {
+        *io = io_handle;
+    }
+    return ESP_OK;
+}
+
+esp_err_t bsp_display_take_panel(uint32_t timeout_ms)
+{
+    if (io_handle == NULL || s_flush.done == NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!bsp_flush_wait_idle(timeout_ms))
+    {
+        return ESP_ERR_TIMEOUT;
+    }
+    return ESP_OK;
+}
+
+void bsp_display_give_panel(void)
+{
+    if (io_handle == NULL || s_flush.done == NULL)
+    {
+        return;
+    }
+    bsp_flush_attach_io();
+}
+
+esp_err_t bsp_display_get_flush_stats(bsp_display_flush_stats_t *stats)
+{
+    if (stats == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    bsp_display_lock(0);
+    *stats = s_flush.st;
+    bsp_display_unlock();
+    return ESP_OK;
+}
+
 void bsp_display_rotate(lv_display_t *disp, lv_disp_rotation_t rotation)
 {
     lv_disp_set_rotation(disp, rotation);
@@ -635,7 +797,8 @@ void bsp_display_rotate(lv_display_t *disp, lv_disp_rotation_t rotation)
 
 bool bsp_display_lock(uint32_t timeout_ms)
 {
-    return lvgl_port_lock(timeout_ms);
+    /* Report our caller to the port's lock hook, not this wrapper */
+    return lvgl_port_lock_caller(timeout_ms, __builtin_return_address(0));
 }
 
 void bsp_display_unlock(void)
@@ -242,8 +242,8 @@ esp_err_t bsp_sdcard_unmount(void);
 #define BSP_LCD_SPI_NUM            (SPI2_HOST)
 
 #if (BSP_CONFIG_NO_GRAPHIC_LIB == 0)
-#define BSP_LCD_DRAW_BUFF_SIZE     (BSP_LCD_H_RES * CONFIG_BSP_LCD_RGB_BOUNCE_BUFFER_HEIGHT)
-#define BSP_LCD_DRAW_BUFF_DOUBLE   (0)
+#define BSP_LCD_DRAW_BUFF_SIZE     (BSP_LCD_H_RES * LVGL_BUFFER_HEIGHT)
+#define BSP_LCD_DRAW_BUFF_DOUBLE   (1)
 
 /**
  * @brief BSP display configuration structure
@@ -289,6 +289,68 @@ lv_display_t *bsp_display_start_with_config(const bsp_display_cfg_t *cfg);
  */
 lv_indev_t *bsp_display_get_input_dev(void);
 
+/**
+ * @brief Get the esp_lcd handles of the display
+ *
+ * @note The handles are created in bsp_display_start() function. Drawing to the panel directly is only
+ *       safe between bsp_display_take_panel() and bsp_display_give_panel().
+ *
+ * @param[out] panel Panel handle, can be NULL
+ * @param[out] io    Panel IO handle, can be NULL
+ * @return
+ *      - ESP_OK                On success
+ *      - ESP_ERR_INVALID_STATE Display not initialized
+ */
+esp_err_t bsp_display_get_panel(esp_lcd_panel_handle_t *panel, esp_lcd_panel_io_handle_t *io);
+
+/**
+ * @brief Wait for LVGL's last flush to leave the bus and hand the panel IO over to the caller
+ *
+ * @note Call with the LVGL mutex held and LVGL stopped (lvgl_port_stop()). Afterwards the caller may draw to the
+ *       panel and register its own panel IO callbacks; bsp_display_give_panel() must be called before LVGL resumes.
+ *
+ * @param timeout_ms Timeout in [ms]
+ * @return
+ *      - ESP_OK                On success
+ *      - ESP_ERR_TIMEOUT       LVGL's transfer did not finish in time
+ *      - ESP_ERR_INVALID_STATE Display not initialized
+ */
+esp_err_t bsp_display_take_panel(uint32_t timeout_ms);
+
+/**
+ * @brief Re-attach LVGL's transfer-done callback to the panel IO after bsp_display_take_panel()
+ */
+void bsp_display_give_panel(void);
+
+/**
+ * @brief LVGL flush timing
+ *
+ * A frame is one LVGL refresh that sent at least one area. Render time is the refresh time minus the time
+ * LVGL spent blocked on a draw buffer that was still being transferred, so render + wait is the frame cost.
+ */
+typedef struct {
+    uint32_t frames;         /*!< Frames flushed */
+    uint32_t flushes;        /*!< Areas sent to the panel */
+    uint32_t last_render_us; /*!< Last frame: rendering time */
+    uint32_t last_wait_us;   /*!< Last frame: time waiting for a buffer to come back from the bus */
+    uint32_t last_flushes;   /*!< Last frame: areas sent */
+    uint32_t max_wait_us;    /*!< Longest wait within a frame */
+    uint32_t wait_timeouts;  /*!< Transfers that never signalled completion */
+    uint64_t render_us;      /*!< Total rendering time */
+    uint64_t wait_us;        /*!< Total waiting time */
+    uint64_t tx_us;          /*!< Total bus time of finished transfers, overlapped with rendering or not */
+} bsp_display_flush_stats_t;
+
+/**
+ * @brief Get LVGL flush timing since start
+ *
+ * @param[out] stats Statistics
+ * @return
+ *      - ESP_OK                On success
+ *      - ESP_ERR_INVALID_ARG   stats is NULL
+ */
+esp_err_t bsp_display_get_flush_stats(bsp_display_flush_stats_t *stats);
+
 /**
  * @brief Take LVGL mutex
  *
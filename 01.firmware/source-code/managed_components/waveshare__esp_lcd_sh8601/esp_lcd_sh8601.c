@@ -24,6 +24,10 @@
 #define LCD_OPCODE_READ_CMD         (0x03ULL)
 #define LCD_OPCODE_WRITE_COLOR      (0x32ULL)
 
+#ifndef LCD_CMD_RAMWRC
+#define LCD_CMD_RAMWRC              0x3C // Memory write continue
+#endif
+
 static const char *TAG = "sh8601";
 
 static esp_err_t panel_sh8601_del(esp_lcd_panel_t *panel);
@@ -47,10 +51,21 @@ typedef struct {
     uint8_t colmod_val; // save surrent value of LCD_CMD_COLMOD register
     const sh8601_lcd_init_cmd_t *init_cmds;
     uint16_t init_cmds_size;
+    uint16_t v_res;
     struct {
         unsigned int use_qspi_interface: 1;
         unsigned int reset_level: 1;
     } flags;
+    // Last CASET/RASET sent (gap applied, end exclusive) and the row the write pointer stands at after the last
+    // transfer (-1 if unknown), so that unchanged window commands can be skipped and the band below continued
+    struct {
+        bool valid;
+        int x_start;
+        int x_end;
+        int y_start;
+        int y_end;
+        int next_y;
+    } win;
 } sh8601_panel_t;
 
 esp_err_t esp_lcd_new_panel_sh8601(const esp_lcd_panel_io_handle_t io, const esp_lcd_panel_dev_config_t *panel_dev_config, esp_lcd_panel_handle_t *ret_panel)
@@ -110,7 +125,9 @@ esp_err_t esp_lcd_new_panel_sh8601(const esp_lcd_panel_io_handle_t io, const esp
         sh8601->init_cmds = vendor_config->init_cmds;
         sh8601->init_cmds_size = vendor_config->init_cmds_size;
         sh8601->flags.use_qspi_interface = vendor_config->flags.use_qspi_interface;
+        sh8601->v_res = vendor_config->v_res;
     }
+    sh8601->win.next_y = -1;
     sh8601->flags.reset_level = panel_dev_config->flags.reset_active_high;
     sh8601->base.del = panel_sh8601_del;
     sh8601->base.reset = panel_sh8601_reset;
@@ -159,6 +176,12 @@ static esp_err_t tx_color(sh8601_panel_t *sh8601, esp_lcd_panel_io_handle_t io,
     return esp_lcd_panel_io_tx_color(io, lcd_cmd, param, param_size);
 }
 
+static void forget_window(sh8601_panel_t *sh8601)
+{
+    sh8601->win.valid = false;
+    sh8601->win.next_y = -1;
+}
+
 static esp_err_t panel_sh8601_del(esp_lcd_panel_t *panel)
 {
     sh8601_panel_t *sh8601 = __containerof(panel, sh8601_panel_t, base);
@@ -176,6 +199,8 @@ static esp_err_t panel_sh8601_reset(esp_lcd_panel_t *panel)
     sh8601_panel_t *sh8601 = __containerof(panel, sh8601_panel_t, base);
     esp_lcd_panel_io_handle_t io = sh8601->io;
 
+    forget_window(sh8601);
+
     // Perform hardware reset
     if (sh8601->reset_gpio_num >= 0) {
         gpio_set_level(sh8601->reset_gpio_num, sh8601->flags.reset_level);
@@ -205,6 +230,7 @@ static esp_err_t panel_sh8601_init(esp_lcd_panel_t *panel)
     uint16_t init_cmds_size = 0;
     bool is_cmd_overwritten = false;
 
+    forget_window(sh8601);
     ESP_RETURN_ON_ERROR(tx_param(sh8601, io, LCD_CMD_MADCTL, (uint8_t[]) {
         sh8601->madctl_val,
     }, 1), TAG, "send command failed");
@@ -251,35 +277,138 @@ static esp_err_t panel_sh8601_init(esp_lcd_panel_t *panel)
     return ESP_OK;
 }
 
+// Send CASET/RASET only where they differ from what the controller already has
+static esp_err_t set_window(sh8601_panel_t *sh8601, int x_start, int x_end, int y_start, int y_end)
+{
+    esp_lcd_panel_io_handle_t io = sh8601->io;
+    esp_err_t ret = ESP_OK;
+
+    if (!sh8601->win.valid || x_start != sh8601->win.x_start || x_end != sh8601->win.x_end) {
+        ESP_GOTO_ON_ERROR(tx_param(sh8601, io, LCD_CMD_CASET, (uint8_t[]) {
+            (x_start >> 8) & 0xFF,
+            x_start & 0xFF,
+            ((x_end - 1) >> 8) & 0xFF,
+            (x_end - 1) & 0xFF,
+        }, 4), err, TAG, "send command failed");
+    }
+    if (!sh8601->win.valid || y_start != sh8601->win.y_start || y_end != sh8601->win.y_end) {
+        ESP_GOTO_ON_ERROR(tx_param(sh8601, io, LCD_CMD_RASET, (uint8_t[]) {
+            (y_start >> 8) & 0xFF,
+            y_start & 0xFF,
+            ((y_end - 1) >> 8) & 0xFF,
+            (y_end - 1) & 0xFF,
+        }, 4), err, TAG, "send command failed");
+    }
+    sh8601->win.valid = true;
+    sh8601->win.x_start = x_start;
+    sh8601->win.x_end = x_end;
+    sh8601->win.y_start = y_start;
+    sh8601->win.y_end = y_end;
+    return ESP_OK;
+
+err:
+    forget_window(sh8601);
+    return ret;
+}
+
+// Draw rectangles that share columns and follow each other row by row. They are written in one window: the first
+// with RAMWR (or RAMWRC if the write pointer already stands on its first row), the rest with RAMWRC, and rectangles
+// whose data is contiguous in memory go out as a single transfer.
+static esp_err_t draw_run(sh8601_panel_t *sh8601, const esp_lcd_sh8601_rect_t *rects, size_t count, size_t *trans)
+{
+    esp_lcd_panel_io_handle_t io = sh8601->io;
+    esp_err_t ret = ESP_OK;
+    int x_start = rects[0].x_start + sh8601->x_gap;
+    int x_end = rects[0].x_end + sh8601->x_gap;
+    int y_start = rects[0].y_start + sh8601->y_gap;
+    int y_end = rects[count - 1].y_end + sh8601->y_gap;
+    size_t row_bytes = (size_t)(x_end - x_start) * sh8601->fb_bits_per_pixel / 8;
+    int cmd = LCD_CMD_RAMWR;
+
+    if (sh8601->win.valid && sh8601->win.next_y == y_start && x_start == sh8601->win.x_start &&
+            x_end == sh8601->win.x_end && y_end <= sh8601->win.y_end) {
+        cmd = LCD_CMD_RAMWRC;
+    } else {
+        // With the panel height known, keep the rows open to the bottom so that the next band can continue
+        int win_y_end = y_end;
+        if (sh8601->v_res && sh8601->v_res + sh8601->y_gap > y_end) {
+            win_y_end = sh8601->v_res + sh8601->y_gap;
+        }
+        sh8601->win.next_y = -1;
+        ESP_RETURN_ON_ERROR(set_window(sh8601, x_start, x_end, y_start, win_y_end), TAG, "set window failed");
+    }
+
+    const uint8_t *data = rects[0].color_data;
+    size_t len = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (len && (const uint8_t *)rects[i].color_data != data + len) {
+            ESP_GOTO_ON_ERROR(tx_color(sh8601, io, cmd, data, len), err, TAG, "send color failed");
+            (*trans)++;
+            cmd = LCD_CMD_RAMWRC;
+            data = rects[i].color_data;
+            len = 0;
+        }
+        len += row_bytes * (rects[i].y_end - rects[i].y_start);
+    }
+    ESP_GOTO_ON_ERROR(tx_color(sh8601, io, cmd, data, len), err, TAG, "send color failed");
+    (*trans)++;
+    sh8601->win.next_y = y_end;
+    return ESP_OK;
+
+err:
+    forget_window(sh8601);
+    return ret;
+}
+
 static esp_err_t panel_sh8601_draw_bitmap(esp_lcd_panel_t *panel, int x_start, int y_start, int x_end, int y_end, const void *color_data)
 {
     sh8601_panel_t *sh8601 = __containerof(panel, sh8601_panel_t, base);
     assert((x_start < x_end) && (y_start < y_end) && "start position must be smaller than end position");
-    esp_lcd_panel_io_handle_t io = sh8601->io;
+    const esp_lcd_sh8601_rect_t rect = {
+        .x_start = x_start,
+        .y_start = y_start,
+        .x_end = x_end,
+        .y_end = y_end,
+        .color_data = color_data,
+    };
+    size_t trans = 0;
+
+    return draw_run(sh8601, &rect, 1, &trans);
+}
 
-    x_start += sh8601->x_gap;
-    x_end += sh8601->x_gap;
-    y_start += sh8601->y_gap;
-    y_end += sh8601->y_gap;
-
-    // define an area of frame memory where MCU can access
-    ESP_RETURN_ON_ERROR(tx_param(sh8601, io, LCD_CMD_CASET, (uint8_t[]) {
-        (x_start >> 8) & 0xFF,
-        x_start & 0xFF,
-        ((x_end - 1) >> 8) & 0xFF,
-        (x_end - 1) & 0xFF,
-    }, 4), TAG, "send command failed");
-    ESP_RETURN_ON_ERROR(tx_param(sh8601, io, LCD_CMD_RASET, (uint8_t[]) {
-        (y_start >> 8) & 0xFF,
-        y_start & 0xFF,
-        ((y_end - 1) >> 8) & 0xFF,
-        (y_end - 1) & 0xFF,
-    }, 4), TAG, "send command failed");
-    // transfer frame buffer
-    size_t len = (x_end - x_start) * (y_end - y_start) * sh8601->fb_bits_per_pixel / 8;
-    tx_color(sh8601, io, LCD_CMD_RAMWR, color_data, len);
+esp_err_t esp_lcd_sh8601_draw_rects(esp_lcd_panel_handle_t panel, const esp_lcd_sh8601_rect_t *rects, size_t count, size_t *ret_trans)
+{
+    ESP_RETURN_ON_FALSE(panel && (rects || count == 0), ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    sh8601_panel_t *sh8601 = __containerof(panel, sh8601_panel_t, base);
+    esp_err_t ret = ESP_OK;
+    size_t trans = 0;
+    size_t i = 0;
+
+    while (i < count) {
+        // Gather the run of rectangles stacked directly below each other in the same columns
+        size_t n = 0;
+        do {
+            const esp_lcd_sh8601_rect_t *r = &rects[i + n];
+            ESP_GOTO_ON_FALSE(r->x_start < r->x_end && r->y_start < r->y_end && r->color_data, ESP_ERR_INVALID_ARG, out,
+                              TAG, "invalid rectangle %u", (unsigned)(i + n));
+            n++;
+        } while (i + n < count && rects[i + n].x_start == rects[i].x_start && rects[i + n].x_end == rects[i].x_end &&
+                 rects[i + n].y_start == rects[i + n - 1].y_end);
+        ESP_GOTO_ON_ERROR(draw_run(sh8601, &rects[i], n, &trans), out, TAG, "draw rectangles failed");
+        i += n;
+    }
 
-    return ESP_OK;
+out:
+    if (ret_trans) {
+        *ret_trans = trans;
+    }
+    return ret;
+}
+
+void esp_lcd_sh8601_restart_write(esp_lcd_panel_handle_t panel)
+{
+    sh8601_panel_t *sh8601 = __containerof(panel, sh8601_panel_t, base);
+    sh8601->win.next_y = -1;
 }
 
 static esp_err_t panel_sh8601_invert_color(esp_lcd_panel_t *panel, bool invert_color_data)
@@ -292,6 +421,7 @@ static esp_err_t panel_sh8601_invert_color(esp_lcd_panel_t *panel, bool invert_c
     } else {
         command = LCD_CMD_INVOFF;
     }
+    sh8601->win.next_y = -1;
     ESP_RETURN_ON_ERROR(tx_param(sh8601, io, command, NULL, 0), TAG, "send command failed");
     return ESP_OK;
 }
@@ -311,6 +441,7 @@ static esp_err_t panel_sh8601_mirror(esp_lcd_panel_t *panel, bool mirror_x, bool
         ESP_LOGE(TAG, "mirror_y is not supported by this panel");
         ret = ESP_ERR_NOT_SUPPORTED;
     }
+    forget_window(sh8601);
     ESP_RETURN_ON_ERROR(tx_param(sh8601, io, LCD_CMD_MADCTL, (uint8_t[]) {
         sh8601->madctl_val
     }, 1), TAG, "send command failed");
@@ -342,6 +473,7 @@ static esp_err_t panel_sh8601_disp_on_off(esp_lcd_panel_t *panel, bool on_off)
     } else {
         command = LCD_CMD_DISPOFF;
     }
+    sh8601->win.next_y = -1;
     ESP_RETURN_ON_ERROR(tx_param(sh8601, io, command, NULL, 0), TAG, "send command failed");
     return ESP_OK;
 }
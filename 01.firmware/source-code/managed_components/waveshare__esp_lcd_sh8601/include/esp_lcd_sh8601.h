@@ -38,6 +38,8 @@ typedef struct {
                                                  *  Please refer to `vendor_specific_init_default` in source file
                                                  */
     uint16_t init_cmds_size;    /*<! Number of commands in above array */
+    uint16_t v_res;             /*<! Vertical resolution of the panel. If set, the row window of a draw is left open to
+                                 *   the bottom so that the band below can continue with RAMWRC, 0 to close it at the draw */
     struct {
         unsigned int use_qspi_interface: 1;     /*<! Set to 1 if use QSPI interface, default is SPI interface */
     } flags;
@@ -55,6 +57,47 @@ typedef struct {
  */
 esp_err_t esp_lcd_new_panel_sh8601(const esp_lcd_panel_io_handle_t io, const esp_lcd_panel_dev_config_t *panel_dev_config, esp_lcd_panel_handle_t *ret_panel);
 
+/**
+ * @brief Rectangle of color data for `esp_lcd_sh8601_draw_rects()`.
+ *
+ */
+typedef struct {
+    int x_start;            /*<! Start column, included */
+    int y_start;            /*<! Start row, included */
+    int x_end;              /*<! End column, excluded */
+    int y_end;              /*<! End row, excluded */
+    const void *color_data; /*<! Color data of the rectangle, row by row */
+} esp_lcd_sh8601_rect_t;
+
+/**
+ * @brief Draw several rectangles with as few window commands and transfers as possible
+ *
+ * @note  Rectangles in the same columns and stacked directly below each other are written into one window.
+ *        CASET/RASET are only sent when they differ from the last ones, and a rectangle that starts at the row
+ *        the previous write stopped at continues with RAMWRC. Data of such a run that is contiguous in memory goes out as one transfer.
+ * @note  Like `esp_lcd_panel_draw_bitmap()`, the transfers are queued and the data must stay valid until they are done.
+ *        The panel IO's `on_color_trans_done` callback fires once per transfer.
+ *
+ * @param[in]  panel LCD panel handle returned by `esp_lcd_new_panel_sh8601()`
+ * @param[in]  rects Rectangles to draw
+ * @param[in]  count Number of rectangles
+ * @param[out] ret_trans Number of transfers queued (also set on failure), can be NULL
+ * @return
+ *      - ESP_OK: Success
+ *      - ESP_ERR_INVALID_ARG: Invalid argument or rectangle
+ *      - Otherwise: Fail
+ */
+esp_err_t esp_lcd_sh8601_draw_rects(esp_lcd_panel_handle_t panel, const esp_lcd_sh8601_rect_t *rects, size_t count, size_t *ret_trans);
+
+/**
+ * @brief Make the next draw start with RAMWR
+ *
+ * @note  Call this after sending commands to the panel IO directly (e.g. brightness), since those may move the write pointer.
+ *
+ * @param[in]  panel LCD panel handle returned by `esp_lcd_new_panel_sh8601()`
+ */
+void esp_lcd_sh8601_restart_write(esp_lcd_panel_handle_t panel);
+
 /**
  * @brief LCD panel bus configuration structure
  *
@@ -36,6 +36,7 @@
 #define TEST_PIN_NUM_LCD_DC         (GPIO_NUM_8)
 
 #define TEST_DELAY_TIME_MS          (3000)
+#define TEST_RECT_NUM               (4)
 
 static char *TAG = "sh8601_test";
 static SemaphoreHandle_t refresh_finish = NULL;
@@ -82,6 +83,55 @@ static void test_draw_bitmap(esp_lcd_panel_handle_t panel_handle)
     vTaskDelay(pdMS_TO_TICKS(TEST_DELAY_TIME_MS));
 }
 
+static void test_draw_rects(esp_lcd_panel_handle_t panel_handle)
+{
+    refresh_finish = xSemaphoreCreateCounting(TEST_RECT_NUM, 0);
+    TEST_ASSERT_NOT_NULL(refresh_finish);
+
+    uint16_t row_line = TEST_LCD_V_RES / TEST_LCD_BIT_PER_PIXEL;
+    uint8_t byte_per_pixel = TEST_LCD_BIT_PER_PIXEL / 8;
+    size_t bar_size = row_line * TEST_LCD_H_RES * byte_per_pixel;
+    uint8_t *color = (uint8_t *)heap_caps_calloc(TEST_RECT_NUM, bar_size, MALLOC_CAP_DMA);
+    TEST_ASSERT_NOT_NULL(color);
+    esp_lcd_sh8601_rect_t rects[TEST_RECT_NUM];
+
+    for (int j = 0; j < TEST_RECT_NUM; j++) {
+        uint8_t *bar = color + j * bar_size;
+        for (int i = 0; i < row_line * TEST_LCD_H_RES; i++) {
+            for (int k = 0; k < byte_per_pixel; k++) {
+                bar[i * byte_per_pixel + k] = (SPI_SWAP_DATA_TX(BIT(j * 5), TEST_LCD_BIT_PER_PIXEL) >> (k * 8)) & 0xff;
+            }
+        }
+        rects[j] = (esp_lcd_sh8601_rect_t) {
+            .x_start = 0,
+            .y_start = j * row_line,
+            .x_end = TEST_LCD_H_RES,
+            .y_end = (j + 1) * row_line,
+            .color_data = bar,
+        };
+    }
+
+    // All bars are contiguous in memory, so they go out as one transfer
+    size_t trans = 0;
+    TEST_ESP_OK(esp_lcd_sh8601_draw_rects(panel_handle, rects, TEST_RECT_NUM, &trans));
+    TEST_ASSERT_EQUAL(1, trans);
+    xSemaphoreTake(refresh_finish, portMAX_DELAY);
+    vTaskDelay(pdMS_TO_TICKS(TEST_DELAY_TIME_MS));
+
+    // Reversed colors: every bar continues the previous one with RAMWRC
+    for (int j = 0; j < TEST_RECT_NUM; j++) {
+        rects[j].color_data = color + (TEST_RECT_NUM - 1 - j) * bar_size;
+    }
+    TEST_ESP_OK(esp_lcd_sh8601_draw_rects(panel_handle, rects, TEST_RECT_NUM, &trans));
+    TEST_ASSERT_EQUAL(TEST_RECT_NUM, trans);
+    for (size_t j = 0; j < trans; j++) {
+        xSemaphoreTake(refresh_finish, portMAX_DELAY);
+    }
+    free(color);
+    vSemaphoreDelete(refresh_finish);
+    vTaskDelay(pdMS_TO_TICKS(TEST_DELAY_TIME_MS));
+}
+
 TEST_CASE("test sh8601 to draw color bar with SPI interface", "[sh8601][spi]")
 {
     ESP_LOGI(TAG, "Initialize SPI bus");
@@ -160,6 +210,52 @@ TEST_CASE("test sh8601 to draw color bar with QSPI interface", "[sh8601][qspi]")
     TEST_ESP_OK(spi_bus_free(TEST_LCD_HOST));
 }
 
+TEST_CASE("test sh8601 to draw color bar rectangles with QSPI interface", "[sh8601][qspi]")
+{
+    ESP_LOGI(TAG, "Initialize SPI bus");
+    const spi_bus_config_t buscfg = SH8601_PANEL_BUS_QSPI_CONFIG(TEST_PIN_NUM_LCD_PCLK,
+                                                                TEST_PIN_NUM_LCD_DATA0,
+                                                                TEST_PIN_NUM_LCD_DATA1,
+                                                                TEST_PIN_NUM_LCD_DATA2,
+                                                                TEST_PIN_NUM_LCD_DATA3,
+                                                                TEST_LCD_H_RES * TEST_LCD_V_RES * TEST_LCD_BIT_PER_PIXEL / 8);
+    TEST_ESP_OK(spi_bus_initialize(TEST_LCD_HOST, &buscfg, SPI_DMA_CH_AUTO));
+
+    ESP_LOGI(TAG, "Install panel IO");
+    esp_lcd_panel_io_handle_t io_handle = NULL;
+    const esp_lcd_panel_io_spi_config_t io_config = SH8601_PANEL_IO_QSPI_CONFIG(TEST_PIN_NUM_LCD_CS, test_notify_refresh_ready, NULL);
+    // Attach the LCD to the SPI bus
+    TEST_ESP_OK(esp_lcd_new_panel_io_spi((esp_lcd_spi_bus_handle_t)TEST_LCD_HOST, &io_config, &io_handle));
+
+    ESP_LOGI(TAG, "Install LCD driver of sh8601");
+    esp_lcd_panel_handle_t panel_handle = NULL;
+    const sh8601_vendor_config_t vendor_config = {
+        .init_cmds = lcd_init_cmds,
+        .init_cmds_size = sizeof(lcd_init_cmds) / sizeof(lcd_init_cmds[0]),
+        .v_res = TEST_LCD_V_RES,
+        .flags = {
+            .use_qspi_interface = 1,
+        },
+    };
+    const esp_lcd_panel_dev_config_t panel_config = {
+        .reset_gpio_num = TEST_PIN_NUM_LCD_RST,
+        .rgb_ele_order = LCD_RGB_ELEMENT_ORDER_RGB,
+        .bits_per_pixel = TEST_LCD_BIT_PER_PIXEL,
+        .vendor_config = (void *)&vendor_config,
+    };
+    TEST_ESP_OK(esp_lcd_new_panel_sh8601(io_handle, &panel_config, &panel_handle));
+    esp_lcd_panel_reset(panel_handle);
+    esp_lcd_panel_init(panel_handle);
+    esp_lcd_panel_disp_on_off(panel_handle, true);
+
+    test_draw_bitmap(panel_handle);
+    test_draw_rects(panel_handle);
+
+    TEST_ESP_OK(esp_lcd_panel_del(panel_handle));
+    TEST_ESP_OK(esp_lcd_panel_io_del(io_handle));
+    TEST_ESP_OK(spi_bus_free(TEST_LCD_HOST));
+}
+
 // Some resources are lazy allocated in the LCD driver, the threadhold is left for that case
 #define TEST_MEMORY_LEAK_THRESHOLD  (300)
 
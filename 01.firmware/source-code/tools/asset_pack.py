@@ -0,0 +1,221 @@
+#!/usr/bin/env python3
+# 把 spiffs 里的 JPEG 按清单预转成 LVGL 原生 bin 图片，运行时直接读像素，不再解码 JPEG
+# （见 main/lvgl_port/img_asset.c）
+#
+# 输出目录 = 源目录的完整拷贝 + 每张转换过的图旁边一个同名 .bin：
+#   btns/photo.jpg -> btns/photo.bin（fit 时 btns/photo.fit.bin）
+# bin 格式和 LVGL v9 一致（小端）：
+#   lv_image_header_t  magic 0x19, cf, flags, w, h, stride, reserved
+#   [压缩时] method(LZ4=2), compressed_size, decompressed_size，后面是 LZ4 块数据
+#   RGB565 像素；RGB565A8 先是 RGB565 平面，后跟 A8 平面
+# 取景规则和 show_jpg_as_img 一样：只缩小不放大；默认 JPG_FILL（缩到刚好盖满视口再居中裁剪），
+# fit 对应 JPG_FIT（缩到整张放得下，四周补黑）。离线用 Lanczos 缩放，比运行时的最近邻好
+#
+# 清单每行：路径(相对源目录，可用通配符)  宽x高  格式(RGB565/RGB565A8)  [lz4] [radius=N] [fit]
+import argparse
+import glob
+import os
+import shutil
+import struct
+import sys
+
+try:
+    from PIL import Image, ImageDraw
+except ImportError:
+    sys.exit('asset_pack.py needs Pillow: pip install pillow')
+
+MAGIC = 0x19
+CF_RGB565 = 0x12
+CF_RGB565A8 = 0x14
+FLAG_COMPRESSED = 0x0008
+COMPRESS_LZ4 = 2
+HEAD_FMT = '<BBHHHHH'
+COMP_FMT = '<III'
+
+FORMATS = {'RGB565': CF_RGB565, 'RGB565A8': CF_RGB565A8}
+
+
+def parse_manifest(path):
+    rules = []
+    with open(path, encoding='utf-8') as f:
+        for no, line in enumerate(f, 1):
+            line = line.split('#', 1)[0].strip()
+            if not line:
+                continue
+            parts = line.split()
+            if len(parts) < 3:
+                sys.exit('%s:%d: expected "<glob> <W>x<H> <format> [options]"' % (path, no))
+            try:
+                w, h = (int(v) for v in parts[1].lower().split('x'))
+            except ValueError:
+                sys.exit('%s:%d: bad size %s' % (path, no, parts[1]))
+            fmt = parts[2].upper()
+            if fmt not in FORMATS:
+                sys.exit('%s:%d: unknown format %s' % (path, no, parts[2]))
+            rule = {'glob': parts[0], 'w': w, 'h': h, 'cf': FORMATS[fmt], 'lz4': False, 'radius': 0,
+                    'fit': False}
+            for opt in parts[3:]:
+                if opt == 'lz4':
+                    rule['lz4'] = True
+                elif opt == 'fit':
+                    rule['fit'] = True
+                elif opt.startswith('radius='):
+                    rule['radius'] = int(opt[7:])
+                else:
+                    sys.exit('%s:%d: unknown option %s' % (path, no, opt))
+            rules.append(rule)
+    return rules
+
+
+def scale_to_view(img, w, h, fit):
+    # 和 plan_scale 一致：fill 取两个方向比例的大者，fit 取小者；比例不小于 1 时原样返回
+    iw, ih = img.size
+    r = min(w / iw, h / ih) if fit else max(w / iw, h / ih)
+    if r >= 1:
+        return img
+    tw, th = max(1, int(iw * r + 0.5)), max(1, int(ih * r + 0.5))
+    return img.resize((tw, th), Image.LANCZOS)
+
+
+def crop_to_view(img, w, h):
+    # 和 calc_crop 一致：大于视口的方向居中裁剪，小于的方向居中补黑
+    iw, ih = img.size
+    sx = (iw - w) // 2 if iw > w else 0
+    sy = (ih - h) // 2 if ih > h else 0
+    dx = (w - iw) // 2 if iw < w else 0
+    dy = (h - ih) // 2 if ih < h else 0
+    part = img.crop((sx, sy, sx + min(iw, w), sy + min(ih, h)))
+    view = Image.new('RGB', (w, h))
+    view.paste(part, (dx, dy))
+    return view
+
+
+def to_rgb565(img):
+    rgb = img.tobytes()
+    out = bytearray(len(rgb) // 3 * 2)
+    o = 0
+    for i in range(0, len(rgb), 3):
+        v = ((rgb[i] & 0xF8) << 8) | ((rgb[i + 1] & 0xFC) << 3) | (rgb[i + 2] >> 3)
+        out[o] = v & 0xFF
+        out[o + 1] = v >> 8
+        o += 2
+    return bytes(out)
+
+
+def round_mask(w, h, radius):
+    # 4 倍超采样画圆角矩形再缩小，边缘有抗锯齿
+    s = 4
+    big = Image.new('L', (w * s, h * s), 0)
+    ImageDraw.Draw(big).rounded_rectangle((0, 0, w * s - 1, h * s - 1), radius * s, fill=255)
+    return big.resize((w, h), Image.LANCZOS).tobytes()
+
+
+def lz4_compress(src):
+    # LZ4 块格式的贪心压缩：4 字节哈希找最近一次匹配，够用且不依赖 lz4 模块
+    n = len(src)
+    out = bytearray()
+    table = {}
+    anchor = 0
+    i = 0
+    limit = n - 12  # 最后 5 字节必须是字面量，最后一个匹配要在结尾 12 字节之前开始
+
+    def emit(lit_end, match_len, offset):
+        lit = lit_end - anchor
+        token_pos = len(out)
+        out.append(0)
+        tok = (15 if lit >= 15 else lit) << 4
+        if lit >= 15:
+            r = lit - 15
+            while r >= 255:
+                out.append(255)
+                r -= 255
+            out.append(r)
+        out.extend(src[anchor:lit_end])
+        if match_len:
+            out.extend(struct.pack('<H', offset))
+            m = match_len - 4
+            tok |= 15 if m >= 15 else m
+            if m >= 15:
+                r = m - 15
+                while r >= 255:
+                    out.append(255)
+                    r -= 255
+                out.append(r)
+        out[token_pos] = tok
+
+    while i < limit:
+        key = src[i:i + 4]
+        ref = table.get(key)
+        table[key] = i
+        if ref is None or i - ref > 65535:
+            i += 1
+            continue
+        m = 4
+        end = n - 5
+        while i + m < end and src[ref + m] == src[i + m]:
+            m += 1
+        emit(i, m, i - ref)
+        i += m
+        anchor = i
+        if i - 2 > 0 and i - 2 < limit:
+            table[src[i - 2:i + 2]] = i - 2
+    emit(n, 0, 0)
+    return bytes(out)
+
+
+def convert(src_path, dst_path, rule):
+    w, h = rule['w'], rule['h']
+    with Image.open(src_path) as img:
+        view = crop_to_view(scale_to_view(img.convert('RGB'), w, h, rule['fit']), w, h)
+    data = to_rgb565(view)
+    if rule['cf'] == CF_RGB565A8:
+        data += round_mask(w, h, rule['radius'])
+
+    flags = 0
+    body = data
+    comp = b''
+    if rule['lz4']:
+        packed = lz4_compress(data)
+        # 压不下来就存原始数据，省得运行时白解压
+        if len(packed) < len(data):
+            flags |= FLAG_COMPRESSED
+            comp = struct.pack(COMP_FMT, COMPRESS_LZ4, len(packed), len(data))
+            body = packed
+
+    with open(dst_path, 'wb') as out:
+        out.write(struct.pack(HEAD_FMT, MAGIC, rule['cf'], flags, w, h, w * 2, 0))
+        out.write(comp)
+        out.write(body)
+    return len(data), len(body)
+
+
+def main():
+    ap = argparse.ArgumentParser(description='Convert SPIFFS JPEGs into LVGL binary images')
+    ap.add_argument('src', help='spiffs source directory')
+    ap.add_argument('-m', '--manifest', required=True, help='asset list')
+    ap.add_argument('-o', '--output', required=True, help='directory to write (replaced)')
+    args = ap.parse_args()
+
+    rules = parse_manifest(args.manifest)
+    if os.path.isdir(args.output):
+        shutil.rmtree(args.output)
+    shutil.copytree(args.src, args.output)
+
+    done = set()
+    for rule in rules:
+        matches = sorted(glob.glob(os.path.join(args.src, rule['glob'])))
+        if not matches:
+            print('warning: %s matches nothing' % rule['glob'])
+        for path in matches:
+            rel = os.path.relpath(path, args.src)
+            if (rel, rule['fit']) in done:
+                continue  # 前面的规则优先
+            done.add((rel, rule['fit']))
+            dst = os.path.join(args.output, os.path.splitext(rel)[0] + ('.fit.bin' if rule['fit'] else '.bin'))
+            raw, stored = convert(path, dst, rule)
+            print('%-28s %4dx%-4d %-8s %7d -> %7d bytes' % (rel, rule['w'], rule['h'],
+                  'RGB565A8' if rule['cf'] == CF_RGB565A8 else 'RGB565', raw, stored))
+
+
+if __name__ == '__main__':
+    main()
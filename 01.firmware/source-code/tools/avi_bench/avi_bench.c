@@ -0,0 +1,502 @@
+// 主机上的 AVI/MJPEG 播放基准：用固件里同一份 avi_player（avifile/avi_index/avi_reader/avi_player）
+// 把片段从头播到尾，视频帧同步解码再贴到一块屏幕大小的缓冲上，统计各阶段耗时。
+// 每个片段每跑一遍，在 stdout 输出一行 JSON，日志都在 stderr，可以直接重定向后对比两个版本。
+//
+//   avi_bench [-m frame|direct] [-n runs] [--mem] [-b block_kb] [-c blocks] [-v] clip.avi ...
+//
+// 定时器在主机上启动即触发（见 port/include/esp_timer.h），不会等帧的显示时间，
+// 播放尽可能快地跑完；丢帧数只在单帧解码慢于帧间隔时才会出现。
+
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+
+#include "avi_player.h"
+#include "esp_jpeg_dec.h"
+
+static const char *TAG = "avi_bench";
+
+#define DISP_W 410 // 和 SH8601 面板一致
+#define DISP_H 502
+#define MAX_SAMPLES (64 * 1024)
+#define BENCH_SCHEMA 1
+
+int bench_log_level = 1;
+
+typedef enum
+{
+    MODE_FRAME,  // 整帧解码成 RGB565_LE 再拷到画布，对应 LVGL 画布路径
+    MODE_DIRECT, // 按 MCU 行块解码成 RGB565_BE 条带直接贴到屏上，对应直出模式
+} bench_mode_t;
+
+typedef struct
+{
+    uint32_t *us;
+    uint32_t count;
+    uint64_t total;
+    uint32_t max;
+} samples_t;
+
+typedef struct
+{
+    bench_mode_t mode;
+    jpeg_dec_handle_t jpeg;
+    uint8_t *frame; // 整帧解码输出
+    size_t frame_cap;
+    uint8_t *strip; // 块模式输出
+    size_t strip_cap;
+    uint8_t *panel; // 屏幕大小的 RGB565 缓冲，代替面板/画布
+
+    uint16_t width;
+    uint16_t height;
+    uint32_t frames;
+    uint32_t decode_errors;
+    uint64_t audio_bytes;
+    int64_t audio_us;
+    samples_t decode;
+    samples_t blit;
+
+    avi_player_handle_t player;
+    bool from_memory;
+    avi_player_io_stats_t io;
+    avi_player_sync_stats_t sync;
+    bool has_io;
+    SemaphoreHandle_t ended;
+
+    // codec 替身按采样率在播放任务的时钟上消耗音频，avi_player 的音频时钟和设备上一样往前走
+    uint32_t audio_bytes_per_sec;
+    int64_t audio_start_us;
+} bench_t;
+
+static bench_t s_b;
+
+static void sample_add(samples_t *s, uint32_t us)
+{
+    if (s->count < MAX_SAMPLES)
+        s->us[s->count] = us;
+    s->count++;
+    s->total += us;
+    if (us > s->max)
+        s->max = us;
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static uint32_t sample_pct(samples_t *s, int pct)
+{
+    uint32_t n = s->count < MAX_SAMPLES ? s->count : MAX_SAMPLES;
+    if (n == 0)
+        return 0;
+    return s->us[(uint64_t)(n - 1) * pct / 100];
+}
+
+// 按偶数像素居中，和直出模式的对齐要求一致
+static void place(int w, int h, int *x, int *y)
+{
+    *x = w < DISP_W ? ((DISP_W - w) / 2) & ~1 : 0;
+    *y = h < DISP_H ? ((DISP_H - h) / 2) & ~1 : 0;
+}
+
+static bool ensure(uint8_t **buf, size_t *cap, size_t need)
+{
+    if (need <= *cap)
+        return true;
+    jpeg_free_align(*buf);
+    *buf = jpeg_calloc_align(need, 16);
+    *cap = *buf ? need : 0;
+    return *buf != NULL;
+}
+
+// 整帧模式的“贴图”：LE 帧交换字节后拷到屏幕缓冲，超出屏幕的部分裁掉
+static void blit_frame(const uint8_t *src, int w, int h)
+{
+    int x0, y0;
+    place(w, h, &x0, &y0);
+    int cw = w < DISP_W - x0 ? w : DISP_W - x0;
+    int ch = h < DISP_H - y0 ? h : DISP_H - y0;
+    for (int y = 0; y < ch; y++)
+    {
+        const uint8_t *s = src + (size_t)y * w * 2;
+        uint8_t *d = s_b.panel + ((size_t)(y0 + y) * DISP_W + x0) * 2;
+        for (int x = 0; x < cw; x++)
+        {
+            d[2 * x] = s[2 * x + 1];
+            d[2 * x + 1] = s[2 * x];
+        }
+    }
+}
+
+// 直出模式的“送屏”：条带已是屏幕字节序，按行拷贝
+static void blit_strip(const uint8_t *src, int w, int lines, int x0, int y0)
+{
+    for (int y = 0; y < lines && y0 + y < DISP_H; y++)
+        memcpy(s_b.panel + ((size_t)(y0 + y) * DISP_W + x0) * 2, src + (size_t)y * w * 2, (size_t)w * 2);
+}
+
+static bool decode_frame(uint8_t *data, size_t len)
+{
+    jpeg_dec_io_t io = {
+        .inbuf = data,
+        .inbuf_len = (int)len,
+    };
+    jpeg_dec_header_info_t hi;
+    int64_t t0 = bench_real_time_us();
+    if (jpeg_dec_parse_header(s_b.jpeg, &io, &hi) != JPEG_ERR_OK)
+        return false;
+    s_b.width = hi.width;
+    s_b.height = hi.height;
+
+    if (s_b.mode == MODE_FRAME)
+    {
+        if (!ensure(&s_b.frame, &s_b.frame_cap, (size_t)hi.width * hi.height * 2))
+            return false;
+        io.outbuf = s_b.frame;
+        if (jpeg_dec_process(s_b.jpeg, &io) != JPEG_ERR_OK)
+            return false;
+        int64_t t1 = bench_real_time_us();
+        blit_frame(s_b.frame, hi.width, hi.height);
+        sample_add(&s_b.decode, (uint32_t)(t1 - t0));
+        sample_add(&s_b.blit, (uint32_t)(bench_real_time_us() - t1));
+        return true;
+    }
+
+    if (hi.width > DISP_W || hi.height > DISP_H || (hi.width % 8) || (hi.height % 8))
+    {
+        ESP_LOGE(TAG, "direct: frame %dx%d not supported", hi.width, hi.height);
+        return false;
+    }
+    int count = 0, block_len = 0;
+    jpeg_dec_get_process_count(s_b.jpeg, &count);
+    jpeg_dec_get_outbuf_len(s_b.jpeg, &block_len);
+    if (!ensure(&s_b.strip, &s_b.strip_cap, block_len))
+        return false;
+    int x, y;
+    place(hi.width, hi.height, &x, &y);
+    uint32_t blit_us = 0;
+    for (int i = 0; i < count; i++)
+    {
+        io.outbuf = s_b.strip;
+        if (jpeg_dec_process(s_b.jpeg, &io) != JPEG_ERR_OK)
+            return false;
+        int64_t b0 = bench_real_time_us();
+        int lines = io.out_size / (hi.width * 2);
+        blit_strip(s_b.strip, hi.width, lines, x, y);
+        y += lines;
+        blit_us += (uint32_t)(bench_real_time_us() - b0);
+    }
+    sample_add(&s_b.decode, (uint32_t)(bench_real_time_us() - t0) - blit_us);
+    sample_add(&s_b.blit, blit_us);
+    return true;
+}
+
+static void video_cb(frame_data_t *data, void *arg)
+{
+    if (data->type != FRAME_TYPE_VIDEO || !data->data || data->data_bytes == 0)
+        return;
+    if (decode_frame(data->data, data->data_bytes))
+        s_b.frames++;
+    else
+        s_b.decode_errors++;
+
+    // 播完后 reader 就关了，统计只能在播放中取
+    if (!s_b.from_memory)
+        s_b.has_io = avi_player_get_io_stats(s_b.player, &s_b.io) == ESP_OK;
+    avi_player_get_sync_stats(s_b.player, &s_b.sync);
+}
+
+// codec 替身：只计字节数和回调耗时，不阻塞
+static void audio_cb(frame_data_t *data, void *arg)
+{
+    int64_t t0 = bench_real_time_us();
+    if (data->type == FRAME_TYPE_AUDIO && data->data)
+    {
+        if (s_b.audio_bytes == 0)
+            s_b.audio_start_us = esp_timer_get_time();
+        s_b.audio_bytes += data->data_bytes;
+    }
+    s_b.audio_us += bench_real_time_us() - t0;
+}
+
+// 交进来但按采样率还没“播”到的字节，在播放任务上调用，用的是它被定时器拨快的时钟
+static size_t audio_queued_callback(void *arg)
+{
+    if (s_b.audio_bytes == 0 || s_b.audio_bytes_per_sec == 0)
+        return 0;
+    uint64_t played = (uint64_t)(esp_timer_get_time() - s_b.audio_start_us) * s_b.audio_bytes_per_sec / 1000000;
+    return played < s_b.audio_bytes ? (size_t)(s_b.audio_bytes - played) : 0;
+}
+
+static void audio_set_clock_callback(uint32_t rate, uint32_t bits_cfg, uint32_t ch, void *arg)
+{
+    ESP_LOGI(TAG, "audio %" PRIu32 " Hz, %" PRIu32 " bits, %" PRIu32 " ch", rate, bits_cfg, ch);
+    s_b.audio_bytes_per_sec = rate * (bits_cfg / 8) * ch;
+}
+
+static void play_end_cb(void *arg)
+{
+    xSemaphoreGive(s_b.ended);
+}
+
+static uint8_t *load_file(const char *path, size_t *size)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return NULL;
+    struct stat st;
+    uint8_t *buf = NULL;
+    if (fstat(fileno(f), &st) == 0 && st.st_size > 0)
+        buf = malloc(st.st_size);
+    if (buf && fread(buf, 1, st.st_size, f) != (size_t)st.st_size)
+    {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+    *size = buf ? (size_t)st.st_size : 0;
+    return buf;
+}
+
+static void print_samples(const char *name, samples_t *s)
+{
+    uint32_t n = s->count < MAX_SAMPLES ? s->count : MAX_SAMPLES;
+    qsort(s->us, n, sizeof(uint32_t), cmp_u32);
+    printf("\"%s\":{\"avg\":%" PRIu64 ",\"p50\":%" PRIu32 ",\"p95\":%" PRIu32 ",\"max\":%" PRIu32 "}",
+           name, s->count ? s->total / s->count : 0, sample_pct(s, 50), sample_pct(s, 95), s->max);
+}
+
+static void print_json_str(const char *s)
+{
+    putchar('"');
+    for (; *s; s++)
+    {
+        if (*s == '"' || *s == '\\')
+            putchar('\\');
+        if ((unsigned char)*s < 0x20)
+            printf("\\u%04x", *s);
+        else
+            putchar(*s);
+    }
+    putchar('"');
+}
+
+static int run_clip(const char *path, int run, const avi_player_config_t *base, bool from_memory)
+{
+    uint32_t *decode_us = s_b.decode.us, *blit_us = s_b.blit.us;
+    bench_mode_t mode = s_b.mode;
+    SemaphoreHandle_t ended = s_b.ended;
+    memset(&s_b, 0, sizeof(s_b));
+    s_b.decode.us = decode_us;
+    s_b.blit.us = blit_us;
+    s_b.mode = mode;
+    s_b.ended = ended;
+    s_b.from_memory = from_memory;
+
+    size_t mem_size = 0;
+    uint8_t *mem = NULL;
+    if (from_memory)
+    {
+        // 文件先整个读进来（对应 flash 片段映射），不计入峰值
+        mem = load_file(path, &mem_size);
+        if (!mem)
+        {
+            ESP_LOGE(TAG, "cannot read %s", path);
+            return -1;
+        }
+    }
+
+    bench_heap_stats_t before;
+    bench_heap_get_stats(&before);
+    bench_heap_reset_peak();
+
+    // 解码器和屏幕缓冲每遍重新创建，计入这一遍的峰值
+    jpeg_dec_config_t jcfg = DEFAULT_JPEG_DEC_CONFIG();
+    jcfg.output_type = mode == MODE_FRAME ? JPEG_PIXEL_FORMAT_RGB565_LE : JPEG_PIXEL_FORMAT_RGB565_BE;
+    jcfg.block_enable = mode == MODE_DIRECT;
+    s_b.panel = jpeg_calloc_align(DISP_W * DISP_H * 2, 16);
+    if (!s_b.panel || jpeg_dec_open(&jcfg, &s_b.jpeg) != JPEG_ERR_OK)
+    {
+        ESP_LOGE(TAG, "JPEG decoder open failed");
+        jpeg_free_align(s_b.panel);
+        free(mem);
+        return -1;
+    }
+
+    int64_t t0 = bench_real_time_us();
+    ESP_ERROR_CHECK(avi_player_init(*base, &s_b.player));
+    esp_err_t err = from_memory ? avi_player_play_from_memory(s_b.player, mem, mem_size)
+                                : avi_player_play_from_file(s_b.player, path);
+    if (err == ESP_OK)
+        xSemaphoreTake(s_b.ended, portMAX_DELAY);
+    int64_t wall_us = bench_real_time_us() - t0;
+    avi_player_deinit(s_b.player);
+
+    jpeg_dec_close(s_b.jpeg);
+    jpeg_free_align(s_b.frame);
+    jpeg_free_align(s_b.strip);
+    jpeg_free_align(s_b.panel);
+    s_b.frame = s_b.strip = s_b.panel = NULL;
+    bench_heap_stats_t after;
+    bench_heap_get_stats(&after);
+    free(mem);
+
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "%s: %s", path, esp_err_to_name(err));
+        return -1;
+    }
+
+    uint64_t stall_us = s_b.has_io ? (uint64_t)s_b.io.stall_ms * 1000 : 0;
+    uint64_t busy_us = s_b.decode.total + s_b.blit.total + s_b.audio_us + stall_us;
+    uint64_t parse_us = (uint64_t)wall_us > busy_us ? (uint64_t)wall_us - busy_us : 0;
+
+    printf("{\"schema\":%d,\"clip\":", BENCH_SCHEMA);
+    print_json_str(path);
+    printf(",\"run\":%d,\"mode\":\"%s\",\"source\":\"%s\",\"width\":%u,\"height\":%u",
+           run, s_b.mode == MODE_FRAME ? "frame" : "direct", from_memory ? "memory" : "file",
+           s_b.width, s_b.height);
+    printf(",\"frames\":%" PRIu32 ",\"dropped\":%" PRIu32 ",\"decode_errors\":%" PRIu32 ",\"audio_bytes\":%" PRIu64,
+           s_b.frames, s_b.sync.frames_dropped, s_b.decode_errors, s_b.audio_bytes);
+    printf(",\"wall_ms\":%.3f,\"fps\":%.2f", wall_us / 1000.0, wall_us ? s_b.frames * 1e6 / wall_us : 0.0);
+    printf(",\"stages_ms\":{\"read_stall\":%.3f,\"parse\":%.3f,\"decode\":%.3f,\"blit\":%.3f,\"audio\":%.3f}",
+           stall_us / 1000.0, parse_us / 1000.0, s_b.decode.total / 1000.0, s_b.blit.total / 1000.0, s_b.audio_us / 1000.0);
+    printf(",\"read\":{\"bytes\":%" PRIu64 ",\"calls\":%" PRIu32 ",\"kbps\":%" PRIu32 ",\"stalls\":%" PRIu32
+           ",\"in_place\":%" PRIu32 ",\"copied\":%" PRIu32 "},",
+           s_b.io.bytes_read, s_b.io.read_calls, s_b.io.read_kbps, s_b.io.stalls,
+           s_b.io.chunks_in_place, s_b.io.chunks_copied);
+    print_samples("decode_us", &s_b.decode);
+    putchar(',');
+    print_samples("blit_us", &s_b.blit);
+    printf(",\"heap\":{\"peak\":%zu,\"leaked\":%zd}}\n",
+           after.peak - before.current, (ssize_t)(after.current - before.current));
+    fflush(stdout);
+
+    ESP_LOGI(TAG, "%s: %" PRIu32 " frames %ux%u in %.1f ms, %.1f fps", path, s_b.frames, s_b.width, s_b.height,
+             wall_us / 1000.0, wall_us ? s_b.frames * 1e6 / wall_us : 0.0);
+    return s_b.decode_errors ? 1 : 0;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [options] clip.avi ...\n"
+            "  -m, --mode frame|direct   frame: whole-frame RGB565_LE decode + canvas copy (default)\n"
+            "                            direct: MCU-row blocks in RGB565_BE straight to the panel\n"
+            "  -n, --runs N              play every clip N times (default 1)\n"
+            "      --mem                 load the clip into memory first, like a mapped flash clip\n"
+            "  -b, --block-kb N          read-ahead block size in KB (default 64)\n"
+            "  -c, --blocks N            read-ahead block count (default 4)\n"
+            "  -v, --verbose             more logs on stderr, repeat for debug\n",
+            prog);
+}
+
+int main(int argc, char **argv)
+{
+    static const struct option opts[] = {
+        {"mode", required_argument, NULL, 'm'},
+        {"runs", required_argument, NULL, 'n'},
+        {"mem", no_argument, NULL, 'M'},
+        {"block-kb", required_argument, NULL, 'b'},
+        {"blocks", required_argument, NULL, 'c'},
+        {"verbose", no_argument, NULL, 'v'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0},
+    };
+    int runs = 1;
+    bool from_memory = false;
+    uint32_t block_kb = 64, blocks = 4;
+    bench_mode_t mode = MODE_FRAME;
+    int c;
+    while ((c = getopt_long(argc, argv, "m:n:b:c:vh", opts, NULL)) != -1)
+    {
+        switch (c)
+        {
+        case 'm':
+            if (strcmp(optarg, "frame") == 0)
+                mode = MODE_FRAME;
+            else if (strcmp(optarg, "direct") == 0)
+                mode = MODE_DIRECT;
+            else
+            {
+                usage(argv[0]);
+                return 2;
+            }
+            break;
+        case 'n':
+            runs = atoi(optarg) > 0 ? atoi(optarg) : 1;
+            break;
+        case 'M':
+            from_memory = true;
+            break;
+        case 'b':
+            block_kb = (uint32_t)atoi(optarg);
+            break;
+        case 'c':
+            blocks = (uint32_t)atoi(optarg);
+            break;
+        case 'v':
+            bench_log_level++;
+            break;
+        default:
+            usage(argv[0]);
+            return c == 'h' ? 0 : 2;
+        }
+    }
+    if (optind >= argc)
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    // 和 video_audio.c 里的播放器配置一致
+    avi_player_config_t cfg = {
+        .buffer_size = 256 * 1024,
+        .video_cb = video_cb,
+        .audio_cb = audio_cb,
+        .audio_set_clock_cb = audio_set_clock_callback,
+        .audio_queued_cb = audio_queued_callback,
+        .avi_play_end_cb = play_end_cb,
+        .priority = 7,
+        .coreID = 0,
+        .stack_size = 12 * 1024,
+        .audio_latency_ms = 32,
+        .video_latency_ms = 50,
+        .read_block_size = block_kb * 1024,
+        .read_block_count = blocks,
+    };
+
+    s_b.mode = mode;
+    s_b.ended = xSemaphoreCreateBinary();
+    s_b.decode.us = malloc(MAX_SAMPLES * sizeof(uint32_t));
+    s_b.blit.us = malloc(MAX_SAMPLES * sizeof(uint32_t));
+    if (!s_b.ended || !s_b.decode.us || !s_b.blit.us)
+        return 1;
+
+    int failed = 0;
+    for (int i = optind; i < argc; i++)
+    {
+        for (int r = 0; r < runs; r++)
+        {
+            if (run_clip(argv[i], r, &cfg, from_memory) != 0)
+                failed++;
+        }
+    }
+
+    free(s_b.decode.us);
+    free(s_b.blit.us);
+    vSemaphoreDelete(s_b.ended);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,22 @@
+#!/bin/sh
+# 用 README 里的 ffmpeg 命令，把一个源视频转成几种分辨率和画质的测试片段，给 avi_bench 跑：
+#   tools/avi_bench/make_clips.sh source.mp4 out_dir [seconds]
+# 文件名形如 320x200_q2.avi；direct 模式要求宽高是 8 的倍数
+set -e
+
+if [ $# -lt 2 ]; then
+    echo "usage: $0 source.mp4 out_dir [seconds]" >&2
+    exit 2
+fi
+src=$1
+out=$2
+secs=${3:-20}
+mkdir -p "$out"
+
+for size in 320x200 240x240 400x240 408x496; do
+    for q in 2 5 10; do
+        ffmpeg -loglevel error -y -t "$secs" -i "$src" -vcodec mjpeg -s "$size" -r 30 -q:v "$q" \
+            -acodec pcm_s16le -ar 44100 -ac 2 "$out/${size}_q${q}.avi"
+        echo "$out/${size}_q${q}.avi"
+    done
+done
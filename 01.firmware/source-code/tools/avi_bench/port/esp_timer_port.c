@@ -0,0 +1,57 @@
+#include <stdlib.h>
+#include <time.h>
+
+#include "esp_timer.h"
+
+struct bench_timer
+{
+    esp_timer_cb_t cb;
+    void *arg;
+};
+
+// 本线程被定时器拨快的时间，见 esp_timer.h
+static __thread int64_t s_skew_us;
+
+int64_t bench_real_time_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return bench_real_time_us() + s_skew_us;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *out_handle)
+{
+    if (!args || !args->callback || !out_handle)
+        return ESP_ERR_INVALID_ARG;
+    struct bench_timer *t = calloc(1, sizeof(*t));
+    if (!t)
+        return ESP_ERR_NO_MEM;
+    t->cb = args->callback;
+    t->arg = args->arg;
+    *out_handle = t;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    s_skew_us += (int64_t)timeout_us;
+    timer->cb(timer->arg);
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    // 启动即触发，没有还在等的定时器
+    return ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    free(timer);
+    return ESP_OK;
+}
@@ -0,0 +1,435 @@
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+#include "freertos/event_groups.h"
+#include "freertos/idf_additions.h"
+#include "esp_timer.h"
+
+struct bench_sem
+{
+    pthread_mutex_t m;
+    pthread_cond_t c;
+    UBaseType_t count;
+    UBaseType_t max;
+};
+
+struct bench_event_group
+{
+    pthread_mutex_t m;
+    pthread_cond_t c;
+    EventBits_t bits;
+};
+
+struct bench_queue
+{
+    pthread_mutex_t m;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t head;
+    UBaseType_t count;
+    uint8_t *items;
+};
+
+struct bench_task
+{
+    pthread_t thread;
+    TaskFunction_t fn;
+    void *arg;
+    struct bench_sem notify;
+    char name[configMAX_TASK_NAME_LEN];
+};
+
+static __thread struct bench_task *s_self;
+
+// 任务句柄由退出的线程自己释放，可能晚于 avi_player_deinit 返回，不计入基准的堆统计
+void *__real_calloc(size_t n, size_t size);
+void __real_free(void *ptr);
+
+// 绝对超时，portMAX_DELAY 返回 false 表示一直等
+static bool deadline(TickType_t ticks, struct timespec *ts)
+{
+    if (ticks == portMAX_DELAY)
+        return false;
+    clock_gettime(CLOCK_REALTIME, ts);
+    ts->tv_sec += ticks / 1000;
+    ts->tv_nsec += (long)(ticks % 1000) * 1000000L;
+    if (ts->tv_nsec >= 1000000000L)
+    {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+    return true;
+}
+
+static void sem_init(struct bench_sem *s, UBaseType_t max, UBaseType_t initial)
+{
+    pthread_mutex_init(&s->m, NULL);
+    pthread_cond_init(&s->c, NULL);
+    s->count = initial;
+    s->max = max;
+}
+
+static SemaphoreHandle_t sem_create(UBaseType_t max, UBaseType_t initial)
+{
+    struct bench_sem *s = calloc(1, sizeof(*s));
+    if (s)
+        sem_init(s, max, initial);
+    return s;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return sem_create(1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return sem_create(1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max, UBaseType_t initial)
+{
+    return sem_create(max, initial);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t ticks)
+{
+    struct timespec ts;
+    bool timed = deadline(ticks, &ts);
+    pthread_mutex_lock(&s->m);
+    while (s->count == 0)
+    {
+        if (!timed)
+            pthread_cond_wait(&s->c, &s->m);
+        else if (pthread_cond_timedwait(&s->c, &s->m, &ts) == ETIMEDOUT)
+            break;
+    }
+    BaseType_t ok = s->count > 0;
+    if (ok)
+        s->count--;
+    pthread_mutex_unlock(&s->m);
+    return ok ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t s)
+{
+    pthread_mutex_lock(&s->m);
+    BaseType_t ok = s->count < s->max;
+    if (ok)
+        s->count++;
+    pthread_cond_signal(&s->c);
+    pthread_mutex_unlock(&s->m);
+    return ok ? pdTRUE : pdFALSE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t s)
+{
+    pthread_mutex_destroy(&s->m);
+    pthread_cond_destroy(&s->c);
+    free(s);
+}
+
+EventGroupHandle_t xEventGroupCreate(void)
+{
+    struct bench_event_group *g = calloc(1, sizeof(*g));
+    if (g)
+    {
+        pthread_mutex_init(&g->m, NULL);
+        pthread_cond_init(&g->c, NULL);
+    }
+    return g;
+}
+
+void vEventGroupDelete(EventGroupHandle_t g)
+{
+    pthread_mutex_destroy(&g->m);
+    pthread_cond_destroy(&g->c);
+    free(g);
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t g, EventBits_t bits)
+{
+    pthread_mutex_lock(&g->m);
+    g->bits |= bits;
+    EventBits_t now = g->bits;
+    pthread_cond_broadcast(&g->c);
+    pthread_mutex_unlock(&g->m);
+    return now;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t g, EventBits_t bits)
+{
+    pthread_mutex_lock(&g->m);
+    EventBits_t before = g->bits;
+    g->bits &= ~bits;
+    pthread_mutex_unlock(&g->m);
+    return before;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t g)
+{
+    pthread_mutex_lock(&g->m);
+    EventBits_t now = g->bits;
+    pthread_mutex_unlock(&g->m);
+    return now;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t g, EventBits_t bits, BaseType_t clear,
+                                BaseType_t wait_all, TickType_t ticks)
+{
+    struct timespec ts;
+    bool timed = deadline(ticks, &ts);
+    pthread_mutex_lock(&g->m);
+    while (1)
+    {
+        EventBits_t hit = g->bits & bits;
+        if (wait_all ? hit == bits : hit != 0)
+            break;
+        if (!timed)
+            pthread_cond_wait(&g->c, &g->m);
+        else if (pthread_cond_timedwait(&g->c, &g->m, &ts) == ETIMEDOUT)
+            break;
+    }
+    // 和 FreeRTOS 一样返回清除前的位；超时不清
+    EventBits_t now = g->bits;
+    EventBits_t hit = now & bits;
+    if (clear && (wait_all ? hit == bits : hit != 0))
+        g->bits &= ~bits;
+    pthread_mutex_unlock(&g->m);
+    return now;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    struct bench_queue *q = calloc(1, sizeof(*q));
+    if (!q)
+        return NULL;
+    q->items = malloc((size_t)length * item_size);
+    if (!q->items)
+    {
+        free(q);
+        return NULL;
+    }
+    pthread_mutex_init(&q->m, NULL);
+    pthread_cond_init(&q->not_empty, NULL);
+    pthread_cond_init(&q->not_full, NULL);
+    q->length = length;
+    q->item_size = item_size;
+    return q;
+}
+
+void vQueueDelete(QueueHandle_t q)
+{
+    pthread_mutex_destroy(&q->m);
+    pthread_cond_destroy(&q->not_empty);
+    pthread_cond_destroy(&q->not_full);
+    free(q->items);
+    free(q);
+}
+
+static BaseType_t queue_send(QueueHandle_t q, const void *item, TickType_t ticks, bool front)
+{
+    struct timespec ts;
+    bool timed = deadline(ticks, &ts);
+    pthread_mutex_lock(&q->m);
+    while (q->count == q->length)
+    {
+        if (ticks == 0)
+            break;
+        if (!timed)
+            pthread_cond_wait(&q->not_full, &q->m);
+        else if (pthread_cond_timedwait(&q->not_full, &q->m, &ts) == ETIMEDOUT)
+            break;
+    }
+    BaseType_t ok = q->count < q->length;
+    if (ok)
+    {
+        UBaseType_t slot;
+        if (front)
+        {
+            q->head = (q->head + q->length - 1) % q->length;
+            slot = q->head;
+        }
+        else
+        {
+            slot = (q->head + q->count) % q->length;
+        }
+        memcpy(q->items + (size_t)slot * q->item_size, item, q->item_size);
+        q->count++;
+        pthread_cond_signal(&q->not_empty);
+    }
+    pthread_mutex_unlock(&q->m);
+    return ok ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xQueueSendToBack(QueueHandle_t q, const void *item, TickType_t ticks)
+{
+    return queue_send(q, item, ticks, false);
+}
+
+BaseType_t xQueueSendToFront(QueueHandle_t q, const void *item, TickType_t ticks)
+{
+    return queue_send(q, item, ticks, true);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t ticks)
+{
+    struct timespec ts;
+    bool timed = deadline(ticks, &ts);
+    pthread_mutex_lock(&q->m);
+    while (q->count == 0)
+    {
+        if (ticks == 0)
+            break;
+        if (!timed)
+            pthread_cond_wait(&q->not_empty, &q->m);
+        else if (pthread_cond_timedwait(&q->not_empty, &q->m, &ts) == ETIMEDOUT)
+            break;
+    }
+    BaseType_t ok = q->count > 0;
+    if (ok)
+    {
+        memcpy(item, q->items + (size_t)q->head * q->item_size, q->item_size);
+        q->head = (q->head + 1) % q->length;
+        q->count--;
+        pthread_cond_signal(&q->not_full);
+    }
+    pthread_mutex_unlock(&q->m);
+    return ok ? pdTRUE : pdFALSE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q)
+{
+    pthread_mutex_lock(&q->m);
+    UBaseType_t n = q->count;
+    pthread_mutex_unlock(&q->m);
+    return n;
+}
+
+BaseType_t xQueueReset(QueueHandle_t q)
+{
+    pthread_mutex_lock(&q->m);
+    q->head = 0;
+    q->count = 0;
+    pthread_cond_broadcast(&q->not_full);
+    pthread_mutex_unlock(&q->m);
+    return pdPASS;
+}
+
+static void *task_entry(void *arg)
+{
+    struct bench_task *t = arg;
+    s_self = t;
+    t->fn(t->arg);
+    return NULL;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                                   UBaseType_t prio, TaskHandle_t *ret_task, BaseType_t core)
+{
+    struct bench_task *t = __real_calloc(1, sizeof(*t));
+    if (!t)
+        return pdFAIL;
+    t->fn = fn;
+    t->arg = arg;
+    sem_init(&t->notify, UINT32_MAX, 0);
+    snprintf(t->name, sizeof(t->name), "%s", name ? name : "");
+    if (pthread_create(&t->thread, NULL, task_entry, t) != 0)
+    {
+        __real_free(t);
+        return pdFAIL;
+    }
+    pthread_detach(t->thread);
+    if (ret_task)
+        *ret_task = t;
+    return pdPASS;
+}
+
+BaseType_t xTaskCreatePinnedToCoreWithCaps(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                                           UBaseType_t prio, TaskHandle_t *ret_task, BaseType_t core, uint32_t caps)
+{
+    return xTaskCreatePinnedToCore(fn, name, stack, arg, prio, ret_task, core);
+}
+
+// 任务句柄在线程退出时释放；和 IDF 一样，删除之后不能再用句柄
+void vTaskDelete(TaskHandle_t task)
+{
+    struct bench_task *t = s_self;
+    if (task != NULL && task != t)
+        abort();
+    s_self = NULL;
+    if (t)
+    {
+        pthread_mutex_destroy(&t->notify.m);
+        pthread_cond_destroy(&t->notify.c);
+        __real_free(t);
+    }
+    pthread_exit(NULL);
+}
+
+void vTaskDeleteWithCaps(TaskHandle_t task)
+{
+    vTaskDelete(task);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    usleep((useconds_t)ticks * 1000);
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(bench_real_time_us() / 1000);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return s_self;
+}
+
+char *pcTaskGetName(TaskHandle_t task)
+{
+    static char main_name[] = "main";
+    struct bench_task *t = task ? task : s_self;
+    return t ? t->name : main_name;
+}
+
+void xTaskNotifyGive(TaskHandle_t t)
+{
+    struct bench_sem *s = &t->notify;
+    pthread_mutex_lock(&s->m);
+    s->count++;
+    pthread_cond_signal(&s->c);
+    pthread_mutex_unlock(&s->m);
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks)
+{
+    struct bench_sem *s = &s_self->notify;
+    struct timespec ts;
+    bool timed = deadline(ticks, &ts);
+    pthread_mutex_lock(&s->m);
+    while (s->count == 0)
+    {
+        if (!timed)
+            pthread_cond_wait(&s->c, &s->m);
+        else if (pthread_cond_timedwait(&s->c, &s->m, &ts) == ETIMEDOUT)
+            break;
+    }
+    uint32_t v = s->count;
+    if (v)
+        s->count = clear ? 0 : v - 1;
+    pthread_mutex_unlock(&s->m);
+    return v;
+}
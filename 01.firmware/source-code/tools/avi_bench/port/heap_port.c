@@ -0,0 +1,163 @@
+#include <malloc.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_heap_caps.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+// malloc/calloc/realloc/free 在链接时用 --wrap 接过来，组件里直接调 malloc 的缓冲也算进峰值。
+// 只统计本程序编译进来的代码；libjpeg 等共享库内部的分配不在里面。
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void __real_free(void *ptr);
+
+static atomic_size_t s_current;
+static atomic_size_t s_peak;
+static atomic_uint_fast64_t s_allocs;
+static atomic_uint_fast64_t s_frees;
+
+static void account_alloc(void *p)
+{
+    if (!p)
+        return;
+    size_t now = atomic_fetch_add(&s_current, malloc_usable_size(p)) + malloc_usable_size(p);
+    size_t peak = atomic_load(&s_peak);
+    while (now > peak && !atomic_compare_exchange_weak(&s_peak, &peak, now))
+        ;
+    atomic_fetch_add(&s_allocs, 1);
+}
+
+static void account_free(void *p)
+{
+    if (!p)
+        return;
+    atomic_fetch_sub(&s_current, malloc_usable_size(p));
+    atomic_fetch_add(&s_frees, 1);
+}
+
+void *__wrap_malloc(size_t size)
+{
+    void *p = __real_malloc(size);
+    account_alloc(p);
+    return p;
+}
+
+void *__wrap_calloc(size_t n, size_t size)
+{
+    void *p = __real_calloc(n, size);
+    account_alloc(p);
+    return p;
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    size_t old = ptr ? malloc_usable_size(ptr) : 0;
+    void *p = __real_realloc(ptr, size);
+    if (!p)
+        return NULL;
+    atomic_fetch_sub(&s_current, old);
+    if (ptr)
+        atomic_fetch_add(&s_frees, 1);
+    account_alloc(p);
+    return p;
+}
+
+void __wrap_free(void *ptr)
+{
+    account_free(ptr);
+    __real_free(ptr);
+}
+
+void *heap_caps_malloc(size_t size, uint32_t caps)
+{
+    return malloc(size);
+}
+
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps)
+{
+    return calloc(n, size);
+}
+
+void *heap_caps_realloc(void *ptr, size_t size, uint32_t caps)
+{
+    return realloc(ptr, size);
+}
+
+void *heap_caps_aligned_alloc(size_t alignment, size_t size, uint32_t caps)
+{
+    void *p = NULL;
+    if (posix_memalign(&p, alignment < sizeof(void *) ? sizeof(void *) : alignment, size) != 0)
+        return NULL;
+    account_alloc(p);
+    return p;
+}
+
+void *heap_caps_aligned_calloc(size_t alignment, size_t n, size_t size, uint32_t caps)
+{
+    void *p = heap_caps_aligned_alloc(alignment, n * size, caps);
+    if (p)
+        memset(p, 0, n * size);
+    return p;
+}
+
+void heap_caps_free(void *ptr)
+{
+    free(ptr);
+}
+
+#define BENCH_HEAP_SIZE (8 * 1024 * 1024)
+
+size_t heap_caps_get_free_size(uint32_t caps)
+{
+    size_t used = atomic_load(&s_current);
+    return used < BENCH_HEAP_SIZE ? BENCH_HEAP_SIZE - used : 0;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps)
+{
+    return heap_caps_get_free_size(caps);
+}
+
+void bench_heap_get_stats(bench_heap_stats_t *st)
+{
+    st->current = atomic_load(&s_current);
+    st->peak = atomic_load(&s_peak);
+    st->allocs = atomic_load(&s_allocs);
+    st->frees = atomic_load(&s_frees);
+}
+
+void bench_heap_reset_peak(void)
+{
+    atomic_store(&s_peak, atomic_load(&s_current));
+}
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code)
+    {
+    case ESP_OK:
+        return "ESP_OK";
+    case ESP_FAIL:
+        return "ESP_FAIL";
+    case ESP_ERR_NO_MEM:
+        return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG:
+        return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE:
+        return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE:
+        return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND:
+        return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_NOT_SUPPORTED:
+        return "ESP_ERR_NOT_SUPPORTED";
+    case ESP_ERR_TIMEOUT:
+        return "ESP_ERR_TIMEOUT";
+    default:
+        return "ERROR";
+    }
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+// 按固件实际使用的 IDF 5.4 走带 caps 的任务接口
+#define ESP_IDF_VERSION_VAL(major, minor, patch) (((major) << 16) | ((minor) << 8) | (patch))
+#define ESP_IDF_VERSION ESP_IDF_VERSION_VAL(5, 4, 0)
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdio.h>
+
+// 日志一律走 stderr，stdout 只留给机器可读的结果
+extern int bench_log_level; // 0 只有错误，1 加警告，2 加信息，3 加调试
+
+#define BENCH_LOG(lvl, ch, tag, fmt, ...)                                       \
+    do                                                                         \
+    {                                                                          \
+        if (bench_log_level >= (lvl))                                          \
+            fprintf(stderr, ch " (%s) " fmt "\n", tag, ##__VA_ARGS__);          \
+    } while (0)
+
+#define ESP_LOGE(tag, fmt, ...) BENCH_LOG(0, "E", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) BENCH_LOG(1, "W", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) BENCH_LOG(2, "I", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) BENCH_LOG(3, "D", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGV(tag, fmt, ...) BENCH_LOG(4, "V", tag, fmt, ##__VA_ARGS__)
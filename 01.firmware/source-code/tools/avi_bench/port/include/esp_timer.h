@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// 基准程序不想真的等帧的显示时间：单次定时器一启动就回调，并把启动它的线程的时钟
+// 往前拨 timeout。于是 avi_player 的时钟认为时间到了，而读文件、解码这些真实耗时照常计入。
+// 时钟按线程记偏移，读取任务测的 read() 耗时不会被播放任务的跳变污染。
+
+typedef struct bench_timer *esp_timer_handle_t;
+typedef void (*esp_timer_cb_t)(void *arg);
+
+typedef enum
+{
+    ESP_TIMER_TASK,
+} esp_timer_dispatch_t;
+
+typedef struct
+{
+    esp_timer_cb_t callback;
+    void *arg;
+    esp_timer_dispatch_t dispatch_method;
+    const char *name;
+    bool skip_unhandled_events;
+} esp_timer_create_args_t;
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *out_handle);
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us);
+esp_err_t esp_timer_stop(esp_timer_handle_t timer);
+esp_err_t esp_timer_delete(esp_timer_handle_t timer);
+int64_t esp_timer_get_time(void);
+
+// 真实的单调时钟（微秒），基准程序自己计时用
+int64_t bench_real_time_us(void);
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "freertos/task.h"
+#include "esp_heap_caps.h"
+
+// 主机上没有内存属性，caps 忽略
+BaseType_t xTaskCreatePinnedToCoreWithCaps(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                                           UBaseType_t prio, TaskHandle_t *ret_task, BaseType_t core, uint32_t caps);
+void vTaskDeleteWithCaps(TaskHandle_t task);
@@ -0,0 +1,270 @@
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <jpeglib.h>
+
+#include "esp_jpeg_dec.h"
+#include "esp_heap_caps.h"
+
+// esp_new_jpeg 只有 ESP 芯片的库，主机上用 libjpeg 实现同一套 jpeg_dec_* 接口。
+// 支持整帧和块模式、RGB565 LE/BE 和 RGB888 输出；整帧模式支持 scale（最近邻）和 clipper（保留左上角），
+// 旋转返回 JPEG_ERR_UNSUPPORT_FMT。
+// 绝对耗时和芯片上没有可比性，用来比较同一台机器上前后两个版本。
+
+typedef struct
+{
+    struct jpeg_error_mgr pub;
+    jmp_buf jmp;
+} dec_error_t;
+
+typedef struct
+{
+    jpeg_dec_config_t cfg;
+    struct jpeg_decompress_struct cinfo;
+    dec_error_t jerr;
+    bool created;
+    bool started; // 已 jpeg_start_decompress，块模式下跨多次 process
+    int bpp;
+    int block_lines;
+    int scale_w, scale_h; // 缩放后尺寸，不缩放时等于原图
+    int out_w, out_h;     // 裁剪后输出尺寸
+    uint8_t *row;         // 一行 RGB888
+    size_t row_cap;
+    uint8_t *scaled;      // 缩放后的一行 RGB888
+} dec_t;
+
+static void on_error(j_common_ptr cinfo)
+{
+    dec_error_t *e = (dec_error_t *)cinfo->err;
+    longjmp(e->jmp, 1);
+}
+
+static void on_message(j_common_ptr cinfo)
+{
+}
+
+void *jpeg_calloc_align(size_t size, int aligned)
+{
+    return heap_caps_aligned_calloc(aligned, 1, size, MALLOC_CAP_DEFAULT);
+}
+
+void jpeg_free_align(void *data)
+{
+    heap_caps_free(data);
+}
+
+jpeg_error_t jpeg_dec_open(jpeg_dec_config_t *config, jpeg_dec_handle_t *jpeg_dec)
+{
+    if (!config || !jpeg_dec)
+        return JPEG_ERR_INVALID_PARAM;
+    bool resize = config->scale.width || config->scale.height || config->clipper.width || config->clipper.height;
+    if (config->rotate != JPEG_ROTATE_0D || (resize && config->block_enable) ||
+        (config->scale.width | config->scale.height | config->clipper.width | config->clipper.height) % 8)
+        return JPEG_ERR_UNSUPPORT_FMT;
+
+    int bpp;
+    switch (config->output_type)
+    {
+    case JPEG_PIXEL_FORMAT_RGB565_BE:
+    case JPEG_PIXEL_FORMAT_RGB565_LE:
+        bpp = 2;
+        break;
+    case JPEG_PIXEL_FORMAT_RGB888:
+        bpp = 3;
+        break;
+    default:
+        return JPEG_ERR_UNSUPPORT_FMT;
+    }
+
+    dec_t *d = calloc(1, sizeof(dec_t));
+    if (!d)
+        return JPEG_ERR_NO_MEM;
+    d->cfg = *config;
+    d->bpp = bpp;
+    d->cinfo.err = jpeg_std_error(&d->jerr.pub);
+    d->jerr.pub.error_exit = on_error;
+    d->jerr.pub.output_message = on_message;
+    jpeg_create_decompress(&d->cinfo);
+    d->created = true;
+    *jpeg_dec = d;
+    return JPEG_ERR_OK;
+}
+
+jpeg_error_t jpeg_dec_parse_header(jpeg_dec_handle_t jpeg_dec, jpeg_dec_io_t *io, jpeg_dec_header_info_t *out_info)
+{
+    dec_t *d = jpeg_dec;
+    if (!d || !io || !io->inbuf || io->inbuf_len <= 0 || !out_info)
+        return JPEG_ERR_INVALID_PARAM;
+    if (setjmp(d->jerr.jmp))
+    {
+        jpeg_abort_decompress(&d->cinfo);
+        d->started = false;
+        return JPEG_ERR_BAD_DATA;
+    }
+    // 上一帧没解完（块模式中途退出）就丢掉
+    jpeg_abort_decompress(&d->cinfo);
+    d->started = false;
+    jpeg_mem_src(&d->cinfo, io->inbuf, (unsigned long)io->inbuf_len);
+    if (jpeg_read_header(&d->cinfo, TRUE) != JPEG_HEADER_OK)
+        return JPEG_ERR_BAD_DATA;
+    d->cinfo.out_color_space = JCS_RGB;
+    d->cinfo.dct_method = JDCT_ISLOW;
+
+    // 块模式每次出一个 MCU 行：4:2:0 是 16 行，其余 8 行。
+    // 宽高不是 8 的倍数时头照样能解析（调用者据此改用整帧模式），到 process 才报错
+    d->block_lines = d->cinfo.max_v_samp_factor * DCTSIZE;
+
+    int img_w = (int)d->cinfo.image_width, img_h = (int)d->cinfo.image_height;
+    d->scale_w = d->cfg.scale.width ? d->cfg.scale.width : img_w;
+    d->scale_h = d->cfg.scale.height ? d->cfg.scale.height : img_h;
+    d->out_w = d->cfg.clipper.width ? d->cfg.clipper.width : d->scale_w;
+    d->out_h = d->cfg.clipper.height ? d->cfg.clipper.height : d->scale_h;
+    // 和芯片库一样：只缩小，最多 1/8；裁剪不能超过缩放后的尺寸
+    if (d->scale_w > img_w || d->scale_h > img_h || d->scale_w * 8 < img_w || d->scale_h * 8 < img_h ||
+        d->out_w > d->scale_w || d->out_h > d->scale_h)
+        return JPEG_ERR_UNSUPPORT_FMT;
+
+    size_t need = (size_t)(img_w > d->scale_w ? img_w : d->scale_w) * 3;
+    if (need > d->row_cap)
+    {
+        free(d->row);
+        free(d->scaled);
+        d->row = malloc(need);
+        d->scaled = malloc(need);
+        if (!d->row || !d->scaled)
+        {
+            d->row_cap = 0;
+            return JPEG_ERR_NO_MEM;
+        }
+        d->row_cap = need;
+    }
+
+    out_info->width = d->cinfo.image_width;
+    out_info->height = d->cinfo.image_height;
+    io->inbuf_remain = (int)d->cinfo.src->bytes_in_buffer;
+    return JPEG_ERR_OK;
+}
+
+jpeg_error_t jpeg_dec_get_outbuf_len(jpeg_dec_handle_t jpeg_dec, int *outbuf_len)
+{
+    dec_t *d = jpeg_dec;
+    if (!d || !outbuf_len)
+        return JPEG_ERR_INVALID_PARAM;
+    if (d->cfg.block_enable)
+        *outbuf_len = (int)d->cinfo.image_width * d->block_lines * d->bpp;
+    else
+        *outbuf_len = d->out_w * d->out_h * d->bpp;
+    return JPEG_ERR_OK;
+}
+
+jpeg_error_t jpeg_dec_get_process_count(jpeg_dec_handle_t jpeg_dec, int *process_count)
+{
+    dec_t *d = jpeg_dec;
+    if (!d || !process_count)
+        return JPEG_ERR_INVALID_PARAM;
+    *process_count = d->cfg.block_enable ? (int)((d->cinfo.image_height + d->block_lines - 1) / d->block_lines) : 1;
+    return JPEG_ERR_OK;
+}
+
+static void convert_row(const dec_t *d, const uint8_t *rgb, uint8_t *out, int w)
+{
+    switch (d->cfg.output_type)
+    {
+    case JPEG_PIXEL_FORMAT_RGB888:
+        memcpy(out, rgb, (size_t)w * 3);
+        break;
+    case JPEG_PIXEL_FORMAT_RGB565_LE:
+        for (int x = 0; x < w; x++, rgb += 3)
+        {
+            uint16_t c = ((rgb[0] & 0xF8) << 8) | ((rgb[1] & 0xFC) << 3) | (rgb[2] >> 3);
+            out[2 * x] = c & 0xFF;
+            out[2 * x + 1] = c >> 8;
+        }
+        break;
+    default: // RGB565_BE
+        for (int x = 0; x < w; x++, rgb += 3)
+        {
+            uint16_t c = ((rgb[0] & 0xF8) << 8) | ((rgb[1] & 0xFC) << 3) | (rgb[2] >> 3);
+            out[2 * x] = c >> 8;
+            out[2 * x + 1] = c & 0xFF;
+        }
+        break;
+    }
+}
+
+jpeg_error_t jpeg_dec_process(jpeg_dec_handle_t jpeg_dec, jpeg_dec_io_t *io)
+{
+    dec_t *d = jpeg_dec;
+    if (!d || !io || !io->outbuf)
+        return JPEG_ERR_INVALID_PARAM;
+    if (setjmp(d->jerr.jmp))
+    {
+        jpeg_abort_decompress(&d->cinfo);
+        d->started = false;
+        return JPEG_ERR_BAD_DATA;
+    }
+    if (d->cfg.block_enable && ((d->cinfo.image_width % 8) || (d->cinfo.image_height % 8)))
+        return JPEG_ERR_UNSUPPORT_FMT;
+    if (!d->started)
+    {
+        jpeg_start_decompress(&d->cinfo);
+        d->started = true;
+    }
+
+    int img_w = (int)d->cinfo.output_width, img_h = (int)d->cinfo.output_height;
+    if (!d->cfg.block_enable && (d->scale_w != img_w || d->scale_h != img_h || d->out_w != img_w || d->out_h != img_h))
+    {
+        // 缩放/裁剪：输出行 oy 取源图第 oy * img_h / scale_h 行，列同理；裁剪只输出左上角 out_w x out_h
+        for (int oy = 0; oy < d->out_h; oy++)
+        {
+            int sy = (int)((int64_t)oy * img_h / d->scale_h);
+            while ((int)d->cinfo.output_scanline <= sy)
+            {
+                JSAMPROW rows[1] = {d->row};
+                jpeg_read_scanlines(&d->cinfo, rows, 1);
+            }
+            for (int ox = 0; ox < d->out_w; ox++)
+                memcpy(d->scaled + ox * 3, d->row + (int64_t)ox * img_w / d->scale_w * 3, 3);
+            convert_row(d, d->scaled, io->outbuf + (size_t)oy * d->out_w * d->bpp, d->out_w);
+        }
+        io->out_size = d->out_w * d->out_h * d->bpp;
+        jpeg_abort_decompress(&d->cinfo);
+        d->started = false;
+        return JPEG_ERR_OK;
+    }
+
+    int w = d->cinfo.output_width;
+    int lines = d->cfg.block_enable ? d->block_lines : (int)d->cinfo.output_height;
+    int n = 0;
+    while (n < lines && d->cinfo.output_scanline < d->cinfo.output_height)
+    {
+        JSAMPROW rows[1] = {d->row};
+        jpeg_read_scanlines(&d->cinfo, rows, 1);
+        convert_row(d, d->row, io->outbuf + (size_t)n * w * d->bpp, w);
+        n++;
+    }
+    io->out_size = n * w * d->bpp;
+
+    if (d->cinfo.output_scanline >= d->cinfo.output_height)
+    {
+        jpeg_finish_decompress(&d->cinfo);
+        d->started = false;
+    }
+    return JPEG_ERR_OK;
+}
+
+jpeg_error_t jpeg_dec_close(jpeg_dec_handle_t jpeg_dec)
+{
+    dec_t *d = jpeg_dec;
+    if (!d)
+        return JPEG_ERR_INVALID_PARAM;
+    if (d->created)
+        jpeg_destroy_decompress(&d->cinfo);
+    free(d->row);
+    free(d->scaled);
+    free(d);
+    return JPEG_ERR_OK;
+}
@@ -0,0 +1,418 @@
+// 主机上的 RGB565 混合对比：固件的 lv_blend_s3（components/lv_blend_s3 的 C 内核）和 LVGL 9.2 原来的
+// lv_draw_sw_blend_{color,image}_to_rgb565[_swapped] 逐位比较，再各跑一遍测每像素耗时。
+// 每个操作、每种目标字节序在 stdout 输出一行 JSON，日志都在 stderr。
+//
+//   blend_bench [--check] [-n reps] [-v]
+//
+// --check 只做校验：不一致时打印第一处差异并以 1 退出，改了内核之后先跑这个。
+
+#include <getopt.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "esp_log.h"
+#include "lvgl.h"
+#include "src/draw/sw/blend/lv_draw_sw_blend_private.h"
+#include "src/draw/sw/blend/lv_draw_sw_blend_to_rgb565.h"
+
+#include "blend_kern.h"
+#include "lv_blend_s3.h"
+
+static const char *TAG = "blend_bench";
+
+#define BENCH_SCHEMA 1
+#define CHECK_ROUNDS 20000
+#define MAX_W 130 // 随机用例的最大宽度，够覆盖若干个 16 像素块
+#define MAX_H 4
+#define PAD 16 // 每行前后的保护像素，写出界就会和 LVGL 的结果对不上
+#define STRIDE_PX (MAX_W + 2 * PAD)
+#define BUF_PX (STRIDE_PX * MAX_H)
+
+// 和 LVGL 的绘制缓冲一样：一整屏宽、40 行
+#define BENCH_W 410
+#define BENCH_H 40
+
+int bench_log_level = 1;
+
+static uint32_t s_rng = 0x9E3779B9;
+
+static uint32_t rnd(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+// 边界附近的 opa 最容易出错：LV_OPA_MIN / LV_OPA_MAX 两侧、(opa + 4) >> 3 的进位点
+static uint8_t rnd_opa(void)
+{
+    static const uint8_t edge[] = {0, 1, 2, 3, 4, 5, 11, 12, 127, 128, 251, 252, 253, 254, 255};
+    return (rnd() & 1) ? edge[rnd() % sizeof(edge)] : (uint8_t)rnd();
+}
+
+// 遮罩像文字和抗锯齿边缘那样：成段的 0 和 255，中间夹着过渡值
+static void rnd_mask(uint8_t *m, int n)
+{
+    int i = 0;
+    while (i < n)
+    {
+        int run = 1 + (int)(rnd() % 12);
+        uint32_t kind = rnd() % 5;
+        for (; run > 0 && i < n; run--, i++)
+            m[i] = kind < 2 ? 0 : kind < 4 ? 255 : (uint8_t)rnd();
+    }
+}
+
+static int report(const char *what, const uint16_t *a, const uint16_t *b, int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        if (a[i] != b[i])
+        {
+            ESP_LOGE(TAG, "%s: px %d (row %d col %d) lvgl %04x ours %04x", what, i, i / STRIDE_PX, i % STRIDE_PX - PAD,
+                     a[i], b[i]);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// blend_mix16 对所有通道值、所有 mix 和 lv_color_16_16_mix 一致；三个通道互不影响，
+// 所以让三个通道取同一组值，64 x 64 x 256 就覆盖了每个通道的全部组合
+static int check_mix(void)
+{
+    for (uint32_t a = 0; a < 64; a++)
+    {
+        for (uint32_t b = 0; b < 64; b++)
+        {
+            uint16_t fg = (uint16_t)(((a >> 1) << 11) | (a << 5) | ((63 - a) >> 1));
+            uint16_t bg = (uint16_t)(((b >> 1) << 11) | (b << 5) | ((63 - b) >> 1));
+            for (uint32_t mix = 0; mix < 256; mix++)
+            {
+                uint16_t want = lv_color_16_16_mix(fg, bg, (uint8_t)mix);
+                uint16_t got = blend_mix16(fg, bg, (uint8_t)mix);
+                if (want != got)
+                {
+                    ESP_LOGE(TAG, "mix %04x over %04x at %u: lvgl %04x ours %04x", fg, bg, (unsigned)mix, want, got);
+                    return 1;
+                }
+            }
+        }
+    }
+    for (int i = 0; i < 1000000; i++)
+    {
+        uint16_t fg = (uint16_t)rnd(), bg = (uint16_t)rnd();
+        uint8_t mix = (uint8_t)rnd();
+        if (lv_color_16_16_mix(fg, bg, mix) != blend_mix16(fg, bg, mix))
+        {
+            ESP_LOGE(TAG, "mix %04x over %04x at %u differs", fg, bg, mix);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+typedef struct
+{
+    uint16_t *lvgl, *ours, *src;
+    uint8_t *mask;
+} check_bufs_t;
+
+static void fill_rnd(const check_bufs_t *b)
+{
+    for (int i = 0; i < BUF_PX; i++)
+    {
+        b->lvgl[i] = b->ours[i] = (uint16_t)rnd();
+        b->src[i] = (uint16_t)rnd();
+    }
+    rnd_mask(b->mask, BUF_PX);
+}
+
+static int check_round(const check_bufs_t *b, bool image)
+{
+    fill_rnd(b);
+
+    int32_t w = 1 + (int32_t)(rnd() % MAX_W);
+    int32_t h = 1 + (int32_t)(rnd() % MAX_H);
+    int32_t off = (int32_t)(rnd() % (MAX_W + PAD - w + 1));
+    int32_t soff = (int32_t)(rnd() % (MAX_W + PAD - w + 1));
+    int32_t moff = (int32_t)(rnd() % (MAX_W + PAD - w + 1));
+    // 跨度不一定是 4 的倍数，每行的对齐情况都不一样
+    int32_t stride = (STRIDE_PX - (int32_t)(rnd() % 3)) * 2;
+    bool swapped = rnd() & 1;
+    bool masked = rnd() & 1;
+    uint8_t opa = rnd_opa();
+
+    lv_draw_sw_blend_fill_dsc_t fill = {
+        .dest_w = w,
+        .dest_h = h,
+        .dest_stride = stride,
+        .mask_buf = masked ? b->mask + moff : NULL,
+        .mask_stride = STRIDE_PX - (int32_t)(rnd() % 3),
+        .color = lv_color_make((uint8_t)rnd(), (uint8_t)rnd(), (uint8_t)rnd()),
+        .opa = opa,
+    };
+    lv_draw_sw_blend_image_dsc_t img = {
+        .dest_w = w,
+        .dest_h = h,
+        .dest_stride = stride,
+        .mask_buf = fill.mask_buf,
+        .mask_stride = fill.mask_stride,
+        .src_buf = b->src + PAD + soff,
+        .src_stride = (STRIDE_PX - (int32_t)(rnd() % 3)) * 2,
+        .src_color_format = LV_COLOR_FORMAT_RGB565,
+        .opa = opa,
+        .blend_mode = LV_BLEND_MODE_NORMAL,
+    };
+
+    if (image)
+    {
+        img.dest_buf = b->lvgl + PAD + off;
+        if (swapped)
+            lv_draw_sw_blend_image_to_rgb565_swapped(&img);
+        else
+            lv_draw_sw_blend_image_to_rgb565(&img);
+        img.dest_buf = b->ours + PAD + off;
+        lv_blend_s3_image(&img, swapped);
+    }
+    else
+    {
+        fill.dest_buf = b->lvgl + PAD + off;
+        if (swapped)
+            lv_draw_sw_blend_color_to_rgb565_swapped(&fill);
+        else
+            lv_draw_sw_blend_color_to_rgb565(&fill);
+        fill.dest_buf = b->ours + PAD + off;
+        lv_blend_s3_color(&fill, swapped);
+    }
+
+    if (memcmp(b->lvgl, b->ours, BUF_PX * 2) == 0)
+        return 0;
+    ESP_LOGE(TAG, "%s w %ld h %ld off %ld stride %ld opa %u mask %d swapped %d", image ? "image" : "color", (long)w,
+             (long)h, (long)off, (long)stride, opa, masked, swapped);
+    return report(image ? "image" : "color", b->lvgl, b->ours, BUF_PX);
+}
+
+static int check_all(void)
+{
+    if (check_mix())
+        return 1;
+    ESP_LOGI(TAG, "mix: ok");
+
+    check_bufs_t b = {
+        .lvgl = malloc(BUF_PX * 2),
+        .ours = malloc(BUF_PX * 2),
+        .src = malloc(BUF_PX * 2),
+        .mask = malloc(BUF_PX),
+    };
+    if (!b.lvgl || !b.ours || !b.src || !b.mask)
+    {
+        ESP_LOGE(TAG, "out of memory");
+        return 1;
+    }
+    int bad = 0;
+    for (int r = 0; !bad && r < CHECK_ROUNDS; r++)
+        bad = check_round(&b, r & 1);
+    free(b.lvgl);
+    free(b.ours);
+    free(b.src);
+    free(b.mask);
+    if (!bad)
+        ESP_LOGI(TAG, "%d random blends: ok", CHECK_ROUNDS);
+    return bad;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+typedef enum
+{
+    OP_FILL,
+    OP_FILL_OPA,
+    OP_FILL_MASK,
+    OP_COPY,
+    OP_IMG_OPA,
+    OP_IMG_MASK,
+    OP_COUNT,
+} bench_op_t;
+
+static const char *const s_op_names[OP_COUNT] = {"fill", "fill_opa", "fill_mask", "copy", "img_opa", "img_mask"};
+
+typedef struct
+{
+    uint16_t *dst;
+    const uint16_t *orig; // 每次混合前把 dst 恢复成这份随机内容，否则反复混合后 dst 收敛成纯色
+    const uint16_t *src;
+    const uint8_t *mask;
+} bench_bufs_t;
+
+static void run_op(const bench_bufs_t *b, bench_op_t op, bool swapped, bool ours)
+{
+    bool image = op >= OP_COPY;
+    bool masked = op == OP_FILL_MASK || op == OP_IMG_MASK;
+    lv_opa_t opa = (op == OP_FILL_OPA || op == OP_IMG_OPA) ? LV_OPA_50 : LV_OPA_COVER;
+
+    if (image)
+    {
+        lv_draw_sw_blend_image_dsc_t dsc = {
+            .dest_buf = b->dst,
+            .dest_w = BENCH_W,
+            .dest_h = BENCH_H,
+            .dest_stride = BENCH_W * 2,
+            .mask_buf = masked ? b->mask : NULL,
+            .mask_stride = BENCH_W,
+            .src_buf = b->src,
+            .src_stride = BENCH_W * 2,
+            .src_color_format = LV_COLOR_FORMAT_RGB565,
+            .opa = opa,
+            .blend_mode = LV_BLEND_MODE_NORMAL,
+        };
+        if (ours)
+            lv_blend_s3_image(&dsc, swapped);
+        else if (swapped)
+            lv_draw_sw_blend_image_to_rgb565_swapped(&dsc);
+        else
+            lv_draw_sw_blend_image_to_rgb565(&dsc);
+    }
+    else
+    {
+        lv_draw_sw_blend_fill_dsc_t dsc = {
+            .dest_buf = b->dst,
+            .dest_w = BENCH_W,
+            .dest_h = BENCH_H,
+            .dest_stride = BENCH_W * 2,
+            .mask_buf = masked ? b->mask : NULL,
+            .mask_stride = BENCH_W,
+            .color = lv_color_hex(0x3A7BD5),
+            .opa = opa,
+        };
+        if (ours)
+            lv_blend_s3_color(&dsc, swapped);
+        else if (swapped)
+            lv_draw_sw_blend_color_to_rgb565_swapped(&dsc);
+        else
+            lv_draw_sw_blend_color_to_rgb565(&dsc);
+    }
+}
+
+// 跑 5 批，每批 reps 次，取最快一批的每像素耗时；op 为 OP_COUNT 时只量恢复 dst 的开销
+static double time_op(const bench_bufs_t *b, bench_op_t op, bool swapped, bool ours, int reps)
+{
+    double best = 0;
+    for (int batch = 0; batch < 5; batch++)
+    {
+        double t0 = now_ns();
+        for (int r = 0; r < reps; r++)
+        {
+            memcpy(b->dst, b->orig, BENCH_W * BENCH_H * 2);
+            if (op < OP_COUNT)
+                run_op(b, op, swapped, ours);
+        }
+        double ns = (now_ns() - t0) / reps / (BENCH_W * BENCH_H);
+        if (batch == 0 || ns < best)
+            best = ns;
+    }
+    return best;
+}
+
+static int bench_all(int reps)
+{
+    bench_bufs_t b = {
+        .dst = malloc(BENCH_W * BENCH_H * 2),
+        .orig = malloc(BENCH_W * BENCH_H * 2),
+        .src = malloc(BENCH_W * BENCH_H * 2),
+        .mask = malloc(BENCH_W * BENCH_H),
+    };
+    if (!b.dst || !b.orig || !b.src || !b.mask)
+    {
+        ESP_LOGE(TAG, "out of memory");
+        return 1;
+    }
+    for (int i = 0; i < BENCH_W * BENCH_H; i++)
+    {
+        ((uint16_t *)b.orig)[i] = (uint16_t)rnd();
+        ((uint16_t *)b.src)[i] = (uint16_t)rnd();
+    }
+    rnd_mask((uint8_t *)b.mask, BENCH_W * BENCH_H);
+    double restore = time_op(&b, OP_COUNT, false, false, reps);
+
+    for (int sw = 0; sw < 2; sw++)
+    {
+        for (int op = 0; op < OP_COUNT; op++)
+        {
+            double ours = time_op(&b, op, sw, true, reps) - restore;
+            double lvgl = time_op(&b, op, sw, false, reps) - restore;
+            printf("{\"schema\":%d,\"op\":\"%s\",\"dest\":\"%s\",\"kernel\":\"%s\",\"w\":%d,\"h\":%d,"
+                   "\"lvgl_ns_px\":%.3f,\"ours_ns_px\":%.3f,\"speedup\":%.2f}\n",
+                   BENCH_SCHEMA, s_op_names[op], sw ? "rgb565_swapped" : "rgb565", lv_blend_s3_kernel_name(), BENCH_W,
+                   BENCH_H, lvgl, ours, ours > 0 ? lvgl / ours : 0.0);
+            fflush(stdout);
+            ESP_LOGI(TAG, "%-9s %-14s lvgl %.3f ns/px, ours %.3f ns/px", s_op_names[op], sw ? "rgb565_swapped" : "rgb565",
+                     lvgl, ours);
+        }
+    }
+    free(b.dst);
+    free((void *)b.orig);
+    free((void *)b.src);
+    free((void *)b.mask);
+    return 0;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "      --check               only compare against LVGL's blenders, exit 1 on the first difference\n"
+            "  -n, --reps N              blends per timing batch (default 200)\n"
+            "  -v, --verbose             more logs on stderr, repeat for debug\n",
+            prog);
+}
+
+int main(int argc, char **argv)
+{
+    static const struct option opts[] = {
+        {"check", no_argument, NULL, 'C'},
+        {"reps", required_argument, NULL, 'n'},
+        {"verbose", no_argument, NULL, 'v'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0},
+    };
+    bool check_only = false;
+    int reps = 200;
+    int c;
+    while ((c = getopt_long(argc, argv, "n:vh", opts, NULL)) != -1)
+    {
+        switch (c)
+        {
+        case 'C':
+            check_only = true;
+            break;
+        case 'n':
+            reps = atoi(optarg) > 0 ? atoi(optarg) : 1;
+            break;
+        case 'v':
+            bench_log_level++;
+            break;
+        default:
+            usage(argv[0]);
+            return c == 'h' ? 0 : 2;
+        }
+    }
+
+    lv_init();
+
+    // 结果不对的内核测速度没有意义，先校验
+    if (check_all())
+        return 1;
+    if (check_only)
+        return 0;
+    return bench_all(reps);
+}
@@ -0,0 +1,13 @@
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+// blend_bench 自己的最小 LVGL 配置：不读固件的 sdkconfig，LVGL 的混合函数保持原样（不接 lv_blend_s3），
+// 这样才能拿它当基准对比
+#define LV_COLOR_DEPTH 16
+#define LV_USE_OS LV_OS_NONE
+#define LV_USE_DRAW_SW 1
+#define LV_USE_DRAW_SW_ASM LV_DRAW_SW_ASM_NONE
+#define LV_DRAW_SW_DRAW_UNIT_CNT 1
+#define LV_USE_LOG 0
+
+#endif
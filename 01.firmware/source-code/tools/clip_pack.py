@@ -0,0 +1,65 @@
+#!/usr/bin/env python3
+# 把若干 AVI 打包成 clips 分区镜像，固件里用 esp_partition_mmap 直接映射播放（见 main/lvgl_port/flash_clips.c）
+#
+# 镜像布局（小端）：
+#   0x0000  头   magic "CLPK", version, count, reserved
+#   0x0010  目录 count 项，每项 name[48] offset size reserved[2]
+#   每个片段从 64KB（MMU 页）对齐处开始，这样可以单独映射
+import argparse
+import os
+import struct
+import sys
+
+MAGIC = b'CLPK'
+VERSION = 1
+HEAD_FMT = '<4sIII'
+ENTRY_FMT = '<48sIIII'
+NAME_LEN = 48
+PAGE = 64 * 1024
+
+
+def align(v, a):
+    return (v + a - 1) // a * a
+
+
+def main():
+    ap = argparse.ArgumentParser(description='Pack AVI clips into a raw flash partition image')
+    ap.add_argument('clips', nargs='+', help='AVI files, in play order')
+    ap.add_argument('-o', '--output', required=True, help='image to write')
+    ap.add_argument('--size', type=lambda s: int(s, 0), help='partition size, the image must fit')
+    args = ap.parse_args()
+
+    names = [os.path.basename(p) for p in args.clips]
+    for n in names:
+        if len(n.encode()) >= NAME_LEN:
+            sys.exit('clip name too long (max %d bytes): %s' % (NAME_LEN - 1, n))
+    if len(set(names)) != len(names):
+        sys.exit('duplicate clip names')
+
+    toc_size = struct.calcsize(HEAD_FMT) + struct.calcsize(ENTRY_FMT) * len(names)
+    offset = align(toc_size, PAGE)
+    entries = []
+    for path, name in zip(args.clips, names):
+        size = os.path.getsize(path)
+        entries.append((path, name, offset, size))
+        offset = align(offset + size, PAGE)
+    total = entries[-1][2] + entries[-1][3]
+    if args.size is not None and total > args.size:
+        sys.exit('clips need %d bytes, partition has %d' % (total, args.size))
+
+    with open(args.output, 'wb') as out:
+        out.write(struct.pack(HEAD_FMT, MAGIC, VERSION, len(entries), 0))
+        for _, name, off, size in entries:
+            out.write(struct.pack(ENTRY_FMT, name.encode(), off, size, 0, 0))
+        for path, name, off, size in entries:
+            # 页对齐的空隙填 0xFF，和擦除后的 flash 一样
+            out.write(b'\xff' * (off - out.tell()))
+            with open(path, 'rb') as f:
+                out.write(f.read())
+            print('%-48s @0x%06x %8d bytes' % (name, off, size))
+
+    print('%d clips, %d of %s bytes' % (len(entries), total, args.size if args.size is not None else '?'))
+
+
+if __name__ == '__main__':
+    main()
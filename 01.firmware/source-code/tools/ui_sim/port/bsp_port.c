@@ -0,0 +1,141 @@
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "bsp/esp-bsp.h"
+#include "sim_port.h"
+
+static const char *TAG = "sim_bsp";
+
+static struct
+{
+    pthread_mutex_t mux; // 可重入，和 port 的递归信号量一样
+    int depth;
+    const void *caller;
+    int64_t taken_us;
+    uint32_t wait_us;
+    lvgl_port_lock_hook_t hook;
+    int brightness;
+} s_bsp = {
+    .brightness = 100,
+};
+
+void sim_bsp_init(void)
+{
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&s_bsp.mux, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+bool lvgl_port_lock(uint32_t timeout_ms)
+{
+    return lvgl_port_lock_caller(timeout_ms, __builtin_return_address(0));
+}
+
+bool lvgl_port_lock_caller(uint32_t timeout_ms, const void *caller)
+{
+    int64_t start = esp_timer_get_time();
+    if (timeout_ms == 0)
+    {
+        pthread_mutex_lock(&s_bsp.mux);
+    }
+    else
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_sec += timeout_ms / 1000;
+        ts.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+        if (ts.tv_nsec >= 1000000000L)
+        {
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000L;
+        }
+        if (pthread_mutex_timedlock(&s_bsp.mux, &ts) != 0)
+            return false;
+    }
+    if (s_bsp.depth++ == 0)
+    {
+        s_bsp.taken_us = esp_timer_get_time();
+        s_bsp.wait_us = (uint32_t)(s_bsp.taken_us - start);
+        s_bsp.caller = caller;
+    }
+    return true;
+}
+
+void lvgl_port_unlock(void)
+{
+    if (s_bsp.depth > 0 && --s_bsp.depth == 0 && s_bsp.hook)
+        s_bsp.hook(s_bsp.caller, s_bsp.wait_us, (uint32_t)(esp_timer_get_time() - s_bsp.taken_us));
+    pthread_mutex_unlock(&s_bsp.mux);
+}
+
+void lvgl_port_set_lock_hook(lvgl_port_lock_hook_t hook)
+{
+    s_bsp.hook = hook;
+}
+
+bool bsp_display_lock(uint32_t timeout_ms)
+{
+    // 和板子的 BSP 一样把调用者传下去，锁统计按页面代码的调用点记
+    return lvgl_port_lock_caller(timeout_ms, __builtin_return_address(0));
+}
+
+void bsp_display_unlock(void)
+{
+    lvgl_port_unlock();
+}
+
+esp_err_t bsp_spiffs_mount(void)
+{
+    return sim_fs_mapped(BSP_SPIFFS_MOUNT_POINT) ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t bsp_spiffs_unmount(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t bsp_sdcard_mount(void)
+{
+    return sim_fs_mapped(BSP_SD_MOUNT_POINT) ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t bsp_sdcard_unmount(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t bsp_display_brightness_init(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t bsp_display_brightness_set(int brightness_percent)
+{
+    if (brightness_percent < 0)
+        brightness_percent = 0;
+    if (brightness_percent > 100)
+        brightness_percent = 100;
+    ESP_LOGI(TAG, "brightness %d%%", brightness_percent);
+    s_bsp.brightness = brightness_percent;
+    return ESP_OK;
+}
+
+int bsp_display_brightness_get(void)
+{
+    return s_bsp.brightness;
+}
+
+esp_err_t bsp_display_backlight_on(void)
+{
+    return bsp_display_brightness_set(100);
+}
+
+esp_err_t bsp_display_backlight_off(void)
+{
+    return bsp_display_brightness_set(0);
+}
@@ -0,0 +1,188 @@
+#include <dirent.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "esp_log.h"
+#include "sim_port.h"
+
+// 页面代码里写死的 /spiffs、/sdcard 路径在链接时用 --wrap 接过来，换成主机目录。
+// 每个挂载点两层：src 是只读的素材目录（如工程里的 spiffs/），overlay 收所有写入（媒体索引、缩略图缓存），
+// 读的时候 overlay 里有就用 overlay。这样跑模拟器不会往工程目录里写东西，换个 overlay 就是一张“新卡”。
+// opendir 不合并两层：src 里有这个目录就列 src（素材目录），否则列 overlay（索引、缩略图这些运行时建的目录）。
+
+static const char *TAG = "sim_fs";
+
+#define SIM_FS_MAX_MOUNTS 4
+
+typedef struct
+{
+    char mount[32];
+    char src[PATH_MAX];
+    char overlay[PATH_MAX];
+    bool present;
+} sim_mount_t;
+
+static sim_mount_t s_mounts[SIM_FS_MAX_MOUNTS];
+static int s_mount_count;
+
+FILE *__real_fopen(const char *path, const char *mode);
+int __real_stat(const char *path, struct stat *st);
+int __real_mkdir(const char *path, mode_t mode);
+DIR *__real_opendir(const char *path);
+int __real_remove(const char *path);
+int __real_rename(const char *from, const char *to);
+
+esp_err_t sim_fs_map(const char *mount, const char *src, const char *overlay)
+{
+    if (!mount || s_mount_count == SIM_FS_MAX_MOUNTS || strlen(mount) >= sizeof(s_mounts[0].mount))
+        return ESP_ERR_INVALID_ARG;
+    sim_mount_t *m = &s_mounts[s_mount_count];
+    memset(m, 0, sizeof(*m));
+    strcpy(m->mount, mount);
+    if (src)
+    {
+        if (!overlay || snprintf(m->src, sizeof(m->src), "%s", src) >= (int)sizeof(m->src) ||
+            snprintf(m->overlay, sizeof(m->overlay), "%s%s", overlay, mount) >= (int)sizeof(m->overlay))
+            return ESP_ERR_INVALID_ARG;
+        m->present = true;
+        ESP_LOGI(TAG, "%s -> %s (writes to %s)", mount, m->src, m->overlay);
+    }
+    s_mount_count++;
+    return ESP_OK;
+}
+
+bool sim_fs_mapped(const char *mount)
+{
+    for (int i = 0; i < s_mount_count; i++)
+        if (strcmp(s_mounts[i].mount, mount) == 0)
+            return s_mounts[i].present;
+    return false;
+}
+
+// 路径落在哪个挂载点下，返回挂载点内的相对部分（"" 或以 '/' 开头）
+static sim_mount_t *find_mount(const char *path, const char **rel)
+{
+    for (int i = 0; i < s_mount_count; i++)
+    {
+        size_t n = strlen(s_mounts[i].mount);
+        if (strncmp(path, s_mounts[i].mount, n) == 0 && (path[n] == '\0' || path[n] == '/'))
+        {
+            *rel = path + n;
+            return &s_mounts[i];
+        }
+    }
+    return NULL;
+}
+
+// overlay 里逐级建好 path 的上级目录
+static void make_parents(char *path)
+{
+    for (char *p = strchr(path + 1, '/'); p; p = strchr(p + 1, '/'))
+    {
+        *p = '\0';
+        __real_mkdir(path, 0775);
+        *p = '/';
+    }
+}
+
+typedef enum
+{
+    MAP_READ,  // overlay 有就用 overlay，否则 src
+    MAP_WRITE, // 只用 overlay，先建好上级目录
+    MAP_OWN,   // 只用 overlay（删除、改名不碰 src）
+    MAP_LIST,  // src 有就用 src，否则 overlay
+} map_mode_t;
+
+// 不在挂载点下的路径原样返回；挂载点没卡时返回 NULL（errno = ENOENT）
+static const char *map_path(const char *path, map_mode_t mode, char *buf, size_t len)
+{
+    const char *rel;
+    sim_mount_t *m = path ? find_mount(path, &rel) : NULL;
+    if (!m)
+        return path;
+    if (!m->present)
+    {
+        errno = ENOENT;
+        return NULL;
+    }
+
+    const char *first = mode == MAP_LIST ? m->src : m->overlay;
+    const char *second = mode == MAP_LIST ? m->overlay : m->src;
+    if (snprintf(buf, len, "%s%s", first, rel) >= (int)len)
+    {
+        errno = ENAMETOOLONG;
+        return NULL;
+    }
+    if (mode == MAP_WRITE)
+        make_parents(buf);
+    if (mode == MAP_WRITE || mode == MAP_OWN)
+        return buf;
+
+    struct stat st;
+    if (__real_stat(buf, &st) == 0)
+        return buf;
+    if (snprintf(buf, len, "%s%s", second, rel) >= (int)len)
+    {
+        errno = ENAMETOOLONG;
+        return NULL;
+    }
+    return buf;
+}
+
+FILE *__wrap_fopen(const char *path, const char *mode)
+{
+    char buf[PATH_MAX];
+    bool write = mode && (strchr(mode, 'w') || strchr(mode, 'a') || strchr(mode, '+'));
+    const char *p = map_path(path, write ? MAP_WRITE : MAP_READ, buf, sizeof(buf));
+    return p ? __real_fopen(p, mode) : NULL;
+}
+
+int __wrap_stat(const char *path, struct stat *st)
+{
+    char buf[PATH_MAX];
+    const char *p = map_path(path, MAP_READ, buf, sizeof(buf));
+    return p ? __real_stat(p, st) : -1;
+}
+
+int __wrap_mkdir(const char *path, mode_t mode)
+{
+    char buf[PATH_MAX];
+    const char *p = map_path(path, MAP_WRITE, buf, sizeof(buf));
+    if (!p)
+        return -1;
+    // src 里已有的目录也算已存在
+    struct stat st;
+    if (p == buf && __wrap_stat(path, &st) == 0)
+    {
+        __real_mkdir(p, mode);
+        errno = EEXIST;
+        return -1;
+    }
+    return __real_mkdir(p, mode);
+}
+
+DIR *__wrap_opendir(const char *path)
+{
+    char buf[PATH_MAX];
+    const char *p = map_path(path, MAP_LIST, buf, sizeof(buf));
+    return p ? __real_opendir(p) : NULL;
+}
+
+int __wrap_remove(const char *path)
+{
+    char buf[PATH_MAX];
+    const char *p = map_path(path, MAP_OWN, buf, sizeof(buf));
+    return p ? __real_remove(p) : -1;
+}
+
+int __wrap_rename(const char *from, const char *to)
+{
+    char a[PATH_MAX], b[PATH_MAX];
+    const char *pa = map_path(from, MAP_OWN, a, sizeof(a));
+    const char *pb = map_path(to, MAP_WRITE, b, sizeof(b));
+    return pa && pb ? __real_rename(pa, pb) : -1;
+}
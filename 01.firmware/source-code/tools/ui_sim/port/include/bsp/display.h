@@ -0,0 +1,15 @@
+#pragma once
+
+#include "esp_err.h"
+
+// 和板子的 bsp/display.h 一致的屏幕参数；亮度只记下来（见 port/bsp_port.c）
+
+#define BSP_LCD_BITS_PER_PIXEL (16)
+#define BSP_LCD_H_RES (410)
+#define BSP_LCD_V_RES (502)
+
+esp_err_t bsp_display_brightness_init(void);
+esp_err_t bsp_display_brightness_set(int brightness_percent);
+int bsp_display_brightness_get(void);
+esp_err_t bsp_display_backlight_on(void);
+esp_err_t bsp_display_backlight_off(void);
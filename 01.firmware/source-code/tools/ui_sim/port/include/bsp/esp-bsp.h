@@ -0,0 +1,33 @@
+#pragma once
+
+// 模拟器里的 BSP：只有页面代码用到的挂载、显示锁和输入设备，实现在 port/bsp_port.c。
+// 显示本身由 sim_display.c 建，参数和板子一样（缓冲高度、双缓冲、RGB565_SWAPPED、两像素对齐）
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sdkconfig.h"
+#include "esp_err.h"
+// 板子的 BSP 头文件经由驱动头文件带进 FreeRTOS，页面代码直接用 vTaskDelay、portMAX_DELAY
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "lvgl.h"
+#include "esp_lvgl_port.h"
+#include "bsp/display.h"
+
+#define BSP_SPIFFS_MOUNT_POINT CONFIG_BSP_SPIFFS_MOUNT_POINT
+#define BSP_SD_MOUNT_POINT CONFIG_BSP_SD_MOUNT_POINT
+
+#define LVGL_BUFFER_HEIGHT (CONFIG_BSP_DISPLAY_LVGL_BUF_HEIGHT)
+#define BSP_LCD_DRAW_BUFF_SIZE (BSP_LCD_H_RES * LVGL_BUFFER_HEIGHT)
+#define BSP_LCD_DRAW_BUFF_DOUBLE (1)
+
+// 挂载点映射到命令行给的目录（见 port/fs_port.c），没给目录的返回 ESP_FAIL
+esp_err_t bsp_spiffs_mount(void);
+esp_err_t bsp_spiffs_unmount(void);
+esp_err_t bsp_sdcard_mount(void);
+esp_err_t bsp_sdcard_unmount(void);
+
+lv_indev_t *bsp_display_get_input_dev(void);
+bool bsp_display_lock(uint32_t timeout_ms);
+void bsp_display_unlock(void);
@@ -0,0 +1,4 @@
+#pragma once
+
+// 页面代码只为显示锁包含它；音频在模拟器里没有
+#include "bsp/esp-bsp.h"
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+// 触摸芯片的替身：触点由脚本给（sim_touch_set），最多 SIM_TOUCH_MAX 个
+#define SIM_TOUCH_MAX 2
+
+typedef struct esp_lcd_touch_s *esp_lcd_touch_handle_t;
+
+esp_err_t esp_lcd_touch_read_data(esp_lcd_touch_handle_t tp);
+bool esp_lcd_touch_get_coordinates(esp_lcd_touch_handle_t tp, uint16_t *x, uint16_t *y, uint16_t *strength,
+                                   uint8_t *point_num, uint8_t max_point_num);
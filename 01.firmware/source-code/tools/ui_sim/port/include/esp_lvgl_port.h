@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "lvgl.h"
+
+// esp_lvgl_port 的显示锁部分，语义一样：可重入，最外层释放时把等待和持有时间交给钩子。
+// 模拟器主循环也按 port 的 LVGL 任务那样持锁调 lv_timer_handler
+
+typedef void (*lvgl_port_lock_hook_t)(const void *caller, uint32_t wait_us, uint32_t hold_us);
+
+bool lvgl_port_lock(uint32_t timeout_ms);
+bool lvgl_port_lock_caller(uint32_t timeout_ms, const void *caller);
+void lvgl_port_unlock(void);
+void lvgl_port_set_lock_hook(lvgl_port_lock_hook_t hook);
@@ -0,0 +1,12 @@
+#pragma once
+
+// 固件的 sdkconfig 由 CMake 生成为 sdkconfig_fw.h，LVGL 和页面代码看到的配置和固件一致，只改下面几项
+#include "sdkconfig_fw.h"
+
+// LVGL 的 OS 层换成 pthread，软件绘制单元照样按 CONFIG_LV_DRAW_SW_DRAW_UNIT_CNT 起线程
+#undef CONFIG_LV_OS_FREERTOS
+#undef CONFIG_LV_USE_OS
+#define CONFIG_LV_OS_PTHREAD 1
+#define CONFIG_LV_USE_OS 1
+
+#undef CONFIG_IDF_TARGET_ARCH_XTENSA
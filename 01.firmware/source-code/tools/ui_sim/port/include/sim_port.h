@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "lvgl.h"
+
+// 模拟器主程序和各个替身之间的接口，页面代码不用
+
+// 把挂载点（如 "/spiffs"）映射到主机目录 src：读先找 overlay 再找 src，写、建目录、删除和改名只落在 overlay。
+// src 为 NULL 表示没有这张卡（挂载失败）
+esp_err_t sim_fs_map(const char *mount, const char *src, const char *overlay);
+bool sim_fs_mapped(const char *mount);
+
+// 当前触点（n 为 0 表示抬起），esp_lcd_touch 替身下次读到
+void sim_touch_set(int n, const lv_point_t *pts);
+
+// 输入设备的 driver data 按 esp_lvgl_port 的布局放触摸句柄，touch_multi 接管时认得出来
+lv_indev_t *sim_touch_create_indev(lv_display_t *disp);
+
+// 显示锁的 mutex，sim_display 建显示之前调用
+void sim_bsp_init(void);
@@ -0,0 +1,124 @@
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "nvs_flash.h"
+
+#define NVS_MAX_NS 8
+#define NVS_MAX_KEYS 32
+#define NVS_KEY_LEN 16 // 和 NVS 一样，名字最多 15 个字符
+
+typedef struct
+{
+    char ns[NVS_KEY_LEN];
+    char key[NVS_KEY_LEN];
+    uint8_t value;
+} nvs_item_t;
+
+static struct
+{
+    pthread_mutex_t m;
+    bool inited;
+    char ns[NVS_MAX_NS][NVS_KEY_LEN]; // 句柄是下标 + 1
+    int ns_count;
+    nvs_item_t items[NVS_MAX_KEYS];
+    int count;
+} s_nvs = {
+    .m = PTHREAD_MUTEX_INITIALIZER,
+};
+
+esp_err_t nvs_flash_init(void)
+{
+    s_nvs.inited = true;
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_erase(void)
+{
+    pthread_mutex_lock(&s_nvs.m);
+    s_nvs.count = 0;
+    pthread_mutex_unlock(&s_nvs.m);
+    return ESP_OK;
+}
+
+esp_err_t nvs_open(const char *name, nvs_open_mode_t open_mode, nvs_handle_t *out_handle)
+{
+    if (!s_nvs.inited)
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    if (!name || !out_handle || strlen(name) >= NVS_KEY_LEN)
+        return ESP_ERR_INVALID_ARG;
+
+    esp_err_t ret = ESP_OK;
+    pthread_mutex_lock(&s_nvs.m);
+    int i;
+    for (i = 0; i < s_nvs.ns_count; i++)
+        if (strcmp(s_nvs.ns[i], name) == 0)
+            break;
+    if (i == s_nvs.ns_count)
+    {
+        // 只读打开不存在的命名空间，NVS 也是报找不到
+        if (open_mode == NVS_READONLY)
+            ret = ESP_ERR_NVS_NOT_FOUND;
+        else if (s_nvs.ns_count == NVS_MAX_NS)
+            ret = ESP_ERR_NO_MEM;
+        else
+            strcpy(s_nvs.ns[s_nvs.ns_count++], name);
+    }
+    if (ret == ESP_OK)
+        *out_handle = (nvs_handle_t)(i + 1);
+    pthread_mutex_unlock(&s_nvs.m);
+    return ret;
+}
+
+void nvs_close(nvs_handle_t handle)
+{
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    return ESP_OK;
+}
+
+static nvs_item_t *find_item(nvs_handle_t handle, const char *key)
+{
+    for (int i = 0; i < s_nvs.count; i++)
+        if (strcmp(s_nvs.items[i].ns, s_nvs.ns[handle - 1]) == 0 && strcmp(s_nvs.items[i].key, key) == 0)
+            return &s_nvs.items[i];
+    return NULL;
+}
+
+esp_err_t nvs_set_u8(nvs_handle_t handle, const char *key, uint8_t value)
+{
+    if (handle == 0 || handle > (nvs_handle_t)s_nvs.ns_count || !key || strlen(key) >= NVS_KEY_LEN)
+        return ESP_ERR_INVALID_ARG;
+
+    esp_err_t ret = ESP_OK;
+    pthread_mutex_lock(&s_nvs.m);
+    nvs_item_t *it = find_item(handle, key);
+    if (!it && s_nvs.count < NVS_MAX_KEYS)
+    {
+        it = &s_nvs.items[s_nvs.count++];
+        strcpy(it->ns, s_nvs.ns[handle - 1]);
+        strcpy(it->key, key);
+    }
+    if (it)
+        it->value = value;
+    else
+        ret = ESP_ERR_NVS_NO_FREE_PAGES;
+    pthread_mutex_unlock(&s_nvs.m);
+    return ret;
+}
+
+esp_err_t nvs_get_u8(nvs_handle_t handle, const char *key, uint8_t *out_value)
+{
+    if (handle == 0 || handle > (nvs_handle_t)s_nvs.ns_count || !key || !out_value)
+        return ESP_ERR_INVALID_ARG;
+
+    pthread_mutex_lock(&s_nvs.m);
+    nvs_item_t *it = find_item(handle, key);
+    if (it)
+        *out_value = it->value;
+    pthread_mutex_unlock(&s_nvs.m);
+    return it ? ESP_OK : ESP_ERR_NVS_NOT_FOUND;
+}
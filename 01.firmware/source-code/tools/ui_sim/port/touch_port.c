@@ -0,0 +1,111 @@
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "esp_lcd_touch.h"
+#include "bsp/esp-bsp.h"
+#include "sim_port.h"
+
+// 触摸芯片替身：脚本线程写触点，LVGL 读输入设备时取走。
+// 输入设备的 driver data 和 esp_lvgl_port_touch.c 的私有结构同布局，touch_multi_init 能照常接管读回调
+
+struct esp_lcd_touch_s
+{
+    pthread_mutex_t m;
+    int count;
+    lv_point_t pts[SIM_TOUCH_MAX];
+};
+
+typedef struct
+{
+    esp_lcd_touch_handle_t handle;
+    lv_indev_t *indev;
+    struct
+    {
+        float x;
+        float y;
+    } scale;
+} port_touch_ctx_t;
+
+static struct esp_lcd_touch_s s_touch = {
+    .m = PTHREAD_MUTEX_INITIALIZER,
+};
+static lv_indev_t *s_indev;
+
+void sim_touch_set(int n, const lv_point_t *pts)
+{
+    if (n > SIM_TOUCH_MAX)
+        n = SIM_TOUCH_MAX;
+    pthread_mutex_lock(&s_touch.m);
+    s_touch.count = n;
+    for (int i = 0; i < n; i++)
+        s_touch.pts[i] = pts[i];
+    pthread_mutex_unlock(&s_touch.m);
+}
+
+esp_err_t esp_lcd_touch_read_data(esp_lcd_touch_handle_t tp)
+{
+    return tp ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+bool esp_lcd_touch_get_coordinates(esp_lcd_touch_handle_t tp, uint16_t *x, uint16_t *y, uint16_t *strength,
+                                   uint8_t *point_num, uint8_t max_point_num)
+{
+    pthread_mutex_lock(&tp->m);
+    int n = tp->count < max_point_num ? tp->count : max_point_num;
+    for (int i = 0; i < n; i++)
+    {
+        x[i] = (uint16_t)tp->pts[i].x;
+        y[i] = (uint16_t)tp->pts[i].y;
+        if (strength)
+            strength[i] = 1;
+    }
+    pthread_mutex_unlock(&tp->m);
+    *point_num = (uint8_t)n;
+    return n > 0;
+}
+
+// 和 esp_lvgl_port 的 lvgl_port_touchpad_read 一样，只取第一个点
+static void sim_touch_read(lv_indev_t *indev, lv_indev_data_t *data)
+{
+    port_touch_ctx_t *ctx = (port_touch_ctx_t *)lv_indev_get_driver_data(indev);
+    uint16_t x = 0, y = 0;
+    uint8_t cnt = 0;
+
+    esp_lcd_touch_read_data(ctx->handle);
+    bool pressed = esp_lcd_touch_get_coordinates(ctx->handle, &x, &y, NULL, &cnt, 1);
+    if (pressed && cnt > 0)
+    {
+        data->point.x = (int32_t)(ctx->scale.x * x);
+        data->point.y = (int32_t)(ctx->scale.y * y);
+        data->state = LV_INDEV_STATE_PRESSED;
+    }
+    else
+    {
+        data->state = LV_INDEV_STATE_RELEASED;
+    }
+}
+
+lv_indev_t *sim_touch_create_indev(lv_display_t *disp)
+{
+    port_touch_ctx_t *ctx = calloc(1, sizeof(port_touch_ctx_t));
+    if (!ctx)
+        return NULL;
+    ctx->handle = &s_touch;
+    ctx->scale.x = 1.0f;
+    ctx->scale.y = 1.0f;
+
+    lv_indev_t *indev = lv_indev_create();
+    lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
+    lv_indev_set_mode(indev, LV_INDEV_MODE_TIMER);
+    lv_indev_set_read_cb(indev, sim_touch_read);
+    lv_indev_set_display(indev, disp);
+    lv_indev_set_driver_data(indev, ctx);
+    ctx->indev = indev;
+    s_indev = indev;
+    return indev;
+}
+
+lv_indev_t *bsp_display_get_input_dev(void)
+{
+    return s_indev;
+}
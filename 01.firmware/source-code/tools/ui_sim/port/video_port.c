@@ -0,0 +1,43 @@
+#include "esp_log.h"
+#include "bsp/esp-bsp.h"
+#include "ui.h"
+
+// 视频播放（avi_player、解码流水线、音频）不在模拟器里：主页的视频按钮打开一个同样布局的页面，
+// 只有返回键和一行提示，返回的切页方式和 video_audio.c 一样
+
+static const char *TAG = "sim_video";
+
+static void video_back_btn_cb(lv_event_t *e)
+{
+    if (lv_event_get_code(e) != LV_EVENT_CLICKED)
+        return;
+    lv_obj_t *page = page_main_create();
+    lv_scr_load_anim(page, LV_SCR_LOAD_ANIM_MOVE_RIGHT, 200, 0, true);
+}
+
+void video_audio_start_on_new_page(void)
+{
+    ESP_LOGI(TAG, "video page (playback not simulated)");
+
+    lv_obj_t *page = lv_obj_create(NULL);
+    lv_obj_set_size(page, BSP_LCD_H_RES, BSP_LCD_V_RES);
+    lv_obj_set_style_bg_color(page, lv_color_black(), 0);
+    lv_obj_set_style_bg_opa(page, LV_OPA_COVER, 0);
+
+    lv_obj_t *btn_back = lv_btn_create(page);
+    lv_obj_set_size(btn_back, 80, 40);
+    lv_obj_align(btn_back, LV_ALIGN_BOTTOM_LEFT, 120, -10);
+    lv_obj_add_event_cb(btn_back, video_back_btn_cb, LV_EVENT_CLICKED, NULL);
+    lv_obj_t *lbl = lv_label_create(btn_back);
+    lv_label_set_text(lbl, LV_SYMBOL_LEFT " Back");
+    lv_obj_center(lbl);
+
+    lv_obj_t *status = lv_label_create(page);
+    lv_obj_set_width(status, BSP_LCD_H_RES - 20);
+    lv_obj_set_style_text_align(status, LV_TEXT_ALIGN_CENTER, 0);
+    lv_obj_set_style_text_font(status, &lv_font_montserrat_20, 0);
+    lv_label_set_text(status, "Video playback\nis not simulated");
+    lv_obj_center(status);
+
+    lv_scr_load_anim(page, LV_SCR_LOAD_ANIM_FADE_ON, 200, 0, false);
+}
@@ -0,0 +1,268 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "bsp/esp-bsp.h"
+#include "sim_display.h"
+
+static const char *TAG = "sim_disp";
+
+// 和板子一致：SH8601 列地址偏移 0x16，命令/地址走单线，颜色数据走四线
+#define PANEL_X_GAP 0x16
+#define QSPI_CMD_CLKS 32 // 8 位操作码 + 24 位地址
+
+static struct
+{
+    sim_panel_cfg_t cfg;
+    sim_frame_cb_t cb;
+    void *arg;
+    lv_display_t *disp;
+    uint8_t *fb; // RGB565，和面板一样高字节在前
+
+    // SH8601 驱动的窗口缓存，加了 x_gap 之后的坐标、右/下边界不含
+    struct
+    {
+        bool valid;
+        int x_start, x_end, y_start, y_end;
+        int next_y;
+    } win;
+
+    // 板子时间轴（微秒，从虚拟时钟 0 开始）
+    double cpu_free; // LVGL 任务算完上一帧
+    double bus_free; // 上一块传完
+    double cpu;      // 这一帧 LVGL 任务走到哪了
+    double frame_start;
+    int64_t mark; // 主机时间，上一个计时点
+
+    uint64_t inv_px, round_px; // 攒到下一帧
+    sim_frame_t cur;
+    uint32_t frames;
+} s_disp;
+
+static double clk_us(uint32_t clks)
+{
+    return clks / s_disp.cfg.qspi_mhz;
+}
+
+// 参数命令（CASET/RASET）：全部单线
+static double tx_param_us(int n)
+{
+    s_disp.cur.win_cmds++;
+    return clk_us(QSPI_CMD_CLKS + 8 * n) + s_disp.cfg.txn_us;
+}
+
+// 颜色数据：四线，一个字节两个时钟
+static double tx_color_us(uint32_t bytes)
+{
+    s_disp.cur.bytes += bytes;
+    return clk_us(QSPI_CMD_CLKS + 2 * bytes) + s_disp.cfg.txn_us;
+}
+
+// 按 esp_lcd_sh8601 的 draw_bitmap -> draw_run 走一遍，返回这一块占总线的时间
+static double panel_draw_us(const lv_area_t *a)
+{
+    int x_start = a->x1 + PANEL_X_GAP;
+    int x_end = a->x2 + 1 + PANEL_X_GAP;
+    int y_start = a->y1;
+    int y_end = a->y2 + 1;
+    double us = 0;
+
+    if (s_disp.win.valid && s_disp.win.next_y == y_start && x_start == s_disp.win.x_start &&
+        x_end == s_disp.win.x_end && y_end <= s_disp.win.y_end)
+    {
+        s_disp.cur.ramwrc++;
+    }
+    else
+    {
+        // 窗口下边开到屏幕底，下一块能接着写
+        int win_y_end = BSP_LCD_V_RES > y_end ? BSP_LCD_V_RES : y_end;
+        if (!s_disp.win.valid || x_start != s_disp.win.x_start || x_end != s_disp.win.x_end)
+            us += tx_param_us(4);
+        if (!s_disp.win.valid || y_start != s_disp.win.y_start || win_y_end != s_disp.win.y_end)
+            us += tx_param_us(4);
+        s_disp.win.valid = true;
+        s_disp.win.x_start = x_start;
+        s_disp.win.x_end = x_end;
+        s_disp.win.y_start = y_start;
+        s_disp.win.y_end = win_y_end;
+    }
+    us += tx_color_us((uint32_t)(x_end - x_start) * (y_end - y_start) * 2);
+    s_disp.win.next_y = y_end;
+    return us;
+}
+
+// 主机上从上一个计时点到现在，折算到板子上
+static uint32_t host_lap(double *est)
+{
+    int64_t now = esp_timer_get_time();
+    uint32_t us = (uint32_t)(now - s_disp.mark);
+    s_disp.mark = now;
+    *est = us * (double)s_disp.cfg.cpu_scale;
+    return us;
+}
+
+static void flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+    double est;
+    s_disp.cur.render_us += host_lap(&est);
+    s_disp.cur.render_est_us += (uint32_t)est;
+    s_disp.cpu += est;
+
+    // 双缓冲：这一块要等上一块传完才能下发
+    double start = s_disp.cpu > s_disp.bus_free ? s_disp.cpu : s_disp.bus_free;
+    s_disp.cur.wait_est_us += (uint32_t)(start - s_disp.cpu);
+    s_disp.cpu = start;
+    double tx = panel_draw_us(area);
+    s_disp.bus_free = start + tx;
+    s_disp.cur.flush_est_us += (uint32_t)tx;
+    s_disp.cur.flushes++;
+    s_disp.cur.px += (uint32_t)lv_area_get_size(area);
+
+    int32_t w = lv_area_get_width(area);
+    size_t row = (size_t)w * 2;
+    for (int32_t y = area->y1; y <= area->y2; y++)
+    {
+        memcpy(s_disp.fb + ((size_t)y * BSP_LCD_H_RES + area->x1) * 2, px_map, row);
+        px_map += row;
+    }
+    lv_display_flush_ready(disp);
+
+    // 拷贝是模拟器自己的开销，不算进下一块的渲染
+    s_disp.mark = esp_timer_get_time();
+}
+
+// 和 BSP 的 rounder_event_cb 一样取整到 2 像素，取整前后的面积都记下
+static void rounder_event_cb(lv_event_t *e)
+{
+    lv_area_t *area = (lv_area_t *)lv_event_get_param(e);
+    s_disp.inv_px += lv_area_get_size(area);
+
+    uint16_t x1 = area->x1;
+    uint16_t x2 = area->x2;
+    uint16_t y1 = area->y1;
+    uint16_t y2 = area->y2;
+    area->x1 = (x1 >> 1) << 1;
+    area->y1 = (y1 >> 1) << 1;
+    area->x2 = ((x2 >> 1) << 1) + 1;
+    area->y2 = ((y2 >> 1) << 1) + 1;
+
+    s_disp.round_px += lv_area_get_size(area);
+}
+
+static void refr_event_cb(lv_event_t *e)
+{
+    double est;
+
+    switch (lv_event_get_code(e))
+    {
+    case LV_EVENT_REFR_START:
+    {
+        memset(&s_disp.cur, 0, sizeof(s_disp.cur));
+        uint32_t t = lv_tick_get();
+        double now = t * 1000.0;
+        s_disp.cur.t_ms = t;
+        // 主循环按 sim_display_busy_until 拨钟，这里只剩不到 1 ms 的零头
+        s_disp.cpu = s_disp.cpu_free > now ? s_disp.cpu_free : now;
+        s_disp.frame_start = s_disp.cpu;
+        s_disp.mark = esp_timer_get_time();
+        break;
+    }
+    case LV_EVENT_RENDER_START:
+        s_disp.cur.layout_us = host_lap(&est);
+        s_disp.cpu += est;
+        break;
+    case LV_EVENT_REFR_READY:
+        s_disp.cur.render_us += host_lap(&est);
+        s_disp.cur.render_est_us += (uint32_t)est;
+        s_disp.cpu += est;
+        s_disp.cpu_free = s_disp.cpu;
+        if (s_disp.cur.flushes == 0)
+            break;
+        s_disp.cur.frame = ++s_disp.frames;
+        s_disp.cur.inv_px = (uint32_t)s_disp.inv_px;
+        s_disp.cur.round_px = (uint32_t)s_disp.round_px;
+        s_disp.inv_px = s_disp.round_px = 0;
+        {
+            double end = s_disp.bus_free > s_disp.cpu ? s_disp.bus_free : s_disp.cpu;
+            s_disp.cur.frame_est_us = (uint32_t)(end - s_disp.frame_start);
+        }
+        if (s_disp.cb)
+            s_disp.cb(&s_disp.cur, s_disp.arg);
+        break;
+    default:
+        break;
+    }
+}
+
+lv_display_t *sim_display_create(const sim_panel_cfg_t *cfg, sim_frame_cb_t cb, void *arg)
+{
+    s_disp.cfg = *cfg;
+    s_disp.cb = cb;
+    s_disp.arg = arg;
+
+    size_t buf_bytes = BSP_LCD_DRAW_BUFF_SIZE * BSP_LCD_BITS_PER_PIXEL / 8;
+    s_disp.fb = calloc((size_t)BSP_LCD_H_RES * BSP_LCD_V_RES, 2);
+    uint8_t *buf1 = malloc(buf_bytes);
+    uint8_t *buf2 = BSP_LCD_DRAW_BUFF_DOUBLE ? malloc(buf_bytes) : NULL;
+    if (!s_disp.fb || !buf1 || (BSP_LCD_DRAW_BUFF_DOUBLE && !buf2))
+    {
+        ESP_LOGE(TAG, "no memory for the frame buffer");
+        free(s_disp.fb);
+        free(buf1);
+        free(buf2);
+        s_disp.fb = NULL;
+        return NULL;
+    }
+
+    lv_display_t *disp = lv_display_create(BSP_LCD_H_RES, BSP_LCD_V_RES);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565_SWAPPED);
+    lv_display_set_buffers(disp, buf1, buf2, buf_bytes, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(disp, flush_cb);
+    lv_display_add_event_cb(disp, rounder_event_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+    lv_display_add_event_cb(disp, refr_event_cb, LV_EVENT_REFR_START, NULL);
+    lv_display_add_event_cb(disp, refr_event_cb, LV_EVENT_RENDER_START, NULL);
+    lv_display_add_event_cb(disp, refr_event_cb, LV_EVENT_REFR_READY, NULL);
+    lv_display_set_default(disp);
+    s_disp.disp = disp;
+
+    ESP_LOGI(TAG, "%dx%d, %u-line buffers x%d, QSPI %.0f MHz, cpu x%.1f", BSP_LCD_H_RES, BSP_LCD_V_RES,
+             (unsigned)LVGL_BUFFER_HEIGHT, BSP_LCD_DRAW_BUFF_DOUBLE ? 2 : 1, cfg->qspi_mhz, cfg->cpu_scale);
+    return disp;
+}
+
+uint32_t sim_display_busy_until(void)
+{
+    return (uint32_t)((s_disp.cpu_free + 999) / 1000);
+}
+
+esp_err_t sim_display_shot(const char *path)
+{
+    if (!s_disp.fb)
+        return ESP_ERR_INVALID_STATE;
+    FILE *f = fopen(path, "wb");
+    if (!f)
+    {
+        ESP_LOGE(TAG, "cannot write %s", path);
+        return ESP_FAIL;
+    }
+
+    fprintf(f, "P6\n%d %d\n255\n", BSP_LCD_H_RES, BSP_LCD_V_RES);
+    uint8_t rgb[BSP_LCD_H_RES * 3];
+    const uint8_t *p = s_disp.fb;
+    for (int y = 0; y < BSP_LCD_V_RES; y++)
+    {
+        for (int x = 0; x < BSP_LCD_H_RES; x++, p += 2)
+        {
+            uint16_t c = (uint16_t)(p[0] << 8 | p[1]);
+            rgb[x * 3 + 0] = (uint8_t)(((c >> 11) & 0x1f) * 255 / 31);
+            rgb[x * 3 + 1] = (uint8_t)(((c >> 5) & 0x3f) * 255 / 63);
+            rgb[x * 3 + 2] = (uint8_t)((c & 0x1f) * 255 / 31);
+        }
+        fwrite(rgb, 1, sizeof(rgb), f);
+    }
+    esp_err_t ret = ferror(f) ? ESP_FAIL : ESP_OK;
+    fclose(f);
+    return ret;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "lvgl.h"
+
+// 模拟器的显示：LVGL 按板子的配置（RGB565_SWAPPED、两块 BSP_LCD_DRAW_BUFF_SIZE 的局部缓冲、2 像素取整）
+// 画进内存里的 410x502 帧缓冲，flush_cb 立刻完成。
+// 同时按板子的时序估算每一帧：主机上量到的布局/渲染时间乘 cpu_scale 当作 S3 上的耗时，
+// 每块送屏按 SH8601 驱动的窗口缓存（CASET/RASET 没变不发，接着上一块往下写用 RAMWRC）和 QSPI 时钟算传输时间，
+// 渲染和传输按双缓冲重叠，得到等传输和整帧完成的时间。时间轴用 LVGL 的虚拟时钟，所以结果和主机快慢无关（除渲染）。
+
+typedef struct
+{
+    float qspi_mhz;  // QSPI 时钟，板子上 40
+    float txn_us;    // 每次 SPI 传输的固定开销（排队、DMA 启动、中断）
+    float cpu_scale; // 主机渲染时间 x cpu_scale = S3 上的估算
+} sim_panel_cfg_t;
+
+#define SIM_PANEL_DEFAULT_CFG() \
+    {                           \
+        .qspi_mhz = 40.0f,      \
+        .txn_us = 8.0f,         \
+        .cpu_scale = 8.0f,      \
+    }
+
+typedef struct
+{
+    uint32_t frame;
+    uint32_t t_ms;      // 虚拟时钟，这次刷新开始时
+    uint32_t flushes;   // 送屏块数
+    uint32_t px;        // 送出的像素
+    uint32_t inv_px;    // 脏区像素（取整前，各区域相加）
+    uint32_t round_px;  // 2 像素取整后
+    uint32_t win_cmds;  // 发出的 CASET/RASET
+    uint32_t ramwrc;    // 接着上一块写、没重设窗口的块
+    uint32_t bytes;
+    uint32_t layout_us; // 主机上量到的
+    uint32_t render_us;
+    uint32_t render_est_us; // 以下是按板子估算的
+    uint32_t flush_est_us;  // 传输合计
+    uint32_t wait_est_us;   // 渲染等总线（上一块还没传完）
+    uint32_t frame_est_us;  // 刷新开始到最后一块传完
+} sim_frame_t;
+
+typedef void (*sim_frame_cb_t)(const sim_frame_t *f, void *arg);
+
+// 建显示并设为默认（持显示锁调用）；每画完一帧回调一次
+lv_display_t *sim_display_create(const sim_panel_cfg_t *cfg, sim_frame_cb_t cb, void *arg);
+
+// 板子上的 LVGL 任务算完上一帧的虚拟时间（毫秒，向上取整）。
+// 主循环不在这之前跑下一次 lv_timer_handler，跟板子一样，算不过来时帧率降下来而不是越积越多
+uint32_t sim_display_busy_until(void);
+
+// 当前帧缓冲存成 PPM（P6）
+esp_err_t sim_display_shot(const char *path);
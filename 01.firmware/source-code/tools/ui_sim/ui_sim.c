@@ -0,0 +1,561 @@
+// 主机（Linux）上不接屏跑手表 UI：固件里同一份页面代码（锁屏、主页、第二页、设置、相册、缩略图、2048）
+// 加 LVGL，画进内存里的 410x502 帧缓冲（见 sim_display.c），用脚本喂触摸，
+// 每帧在 stdout 输出一行 JSON（主机渲染时间和按 SH8601/QSPI 估算的送屏时间），最后按 mark 分段汇总。
+// 日志都在 stderr。
+//
+//   ui_sim [options] -s script.txt > frames.jsonl
+//
+// LVGL 用虚拟时钟：主循环每步拨 LV_DEF_REFR_PERIOD 毫秒（估算板子还没算完上一帧时拨到它算完）再跑一次
+// lv_timer_handler，动画和定时器的推进和主机快慢无关；后台加载图片的任务仍是真线程，用 settle 等它们做完。
+// 脚本命令（一行一条，# 开头是注释）：
+//   page lock|main|page1|settings|game|album DIR|grid DIR   直接换到某页（不带切页动画）
+//   tap X Y                 按下、抬起
+//   press X Y / move X Y / release
+//   swipe X0 Y0 X1 Y1 [MS]  默认 200 ms
+//   pinch CX CY D0 D1 [MS]  两指水平对称，间距从 D0 变到 D1
+//   wait MS                 跑 MS 毫秒
+//   settle [MAX_MS]         跑到没有动画、图片都加载完、一段时间不再出新帧（默认最多 5000 ms）
+//   shot FILE.ppm           存当前帧缓冲
+//   mark NAME               之后的帧记到 NAME 下
+//   profile reset|dump      清零 / 打印帧耗时剖析（frame_prof）到 stderr
+
+#include <ftw.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "bsp/esp-bsp.h"
+#include "src/display/lv_display_private.h"
+
+#include "ui.h"
+#include "game1.h"
+#include "img_cache.h"
+#include "img_loader.h"
+#include "touch_multi.h"
+#include "media_index.h"
+#include "frame_prof.h"
+
+#include "sim_display.h"
+#include "sim_port.h"
+
+static const char *TAG = "ui_sim";
+
+#define SIM_STEP_MS LV_DEF_REFR_PERIOD
+#define SIM_YIELD_US 200            // 每步让后台任务跑一会儿
+#define SIM_SETTLE_QUIET_US 100000 // settle：这么久（真实时间）没有新帧算做完
+#define SIM_SETTLE_POLL_US 5000
+#define SIM_SCHEMA 1
+#define SIM_MAX_MARKS 32
+
+int bench_log_level = 1;
+
+typedef struct
+{
+    char name[32];
+    sim_frame_t *frames;
+    uint32_t count;
+    uint32_t cap;
+} sim_mark_t;
+
+static struct
+{
+    volatile uint32_t now_ms; // 虚拟时钟
+    FILE *out;                // 结果（原来的 stdout）
+    sim_mark_t marks[SIM_MAX_MARKS];
+    int mark_count;
+    uint32_t frames;
+    lv_point_t touch[2];
+} s_sim;
+
+static uint32_t sim_tick(void)
+{
+    return s_sim.now_ms;
+}
+
+static void json_str(const char *s)
+{
+    fputc('"', s_sim.out);
+    for (; *s; s++)
+    {
+        if (*s == '"' || *s == '\\')
+            fputc('\\', s_sim.out);
+        if ((unsigned char)*s < 0x20)
+            fprintf(s_sim.out, "\\u%04x", *s);
+        else
+            fputc(*s, s_sim.out);
+    }
+    fputc('"', s_sim.out);
+}
+
+static void on_frame(const sim_frame_t *f, void *arg)
+{
+    sim_mark_t *m = &s_sim.marks[s_sim.mark_count - 1];
+    if (m->count == m->cap)
+    {
+        uint32_t cap = m->cap ? m->cap * 2 : 256;
+        sim_frame_t *p = realloc(m->frames, cap * sizeof(*p));
+        if (!p)
+            return;
+        m->frames = p;
+        m->cap = cap;
+    }
+    m->frames[m->count++] = *f;
+    s_sim.frames++;
+
+    fprintf(s_sim.out, "{\"schema\":%d,\"type\":\"frame\",\"mark\":", SIM_SCHEMA);
+    json_str(m->name);
+    fprintf(s_sim.out, ",\"frame\":%" PRIu32 ",\"t_ms\":%" PRIu32 ",\"flushes\":%" PRIu32 ",\"px\":%" PRIu32
+           ",\"inv_px\":%" PRIu32 ",\"round_px\":%" PRIu32 ",\"bytes\":%" PRIu32 ",\"win_cmds\":%" PRIu32
+           ",\"ramwrc\":%" PRIu32,
+           f->frame, f->t_ms, f->flushes, f->px, f->inv_px, f->round_px, f->bytes, f->win_cmds, f->ramwrc);
+    fprintf(s_sim.out, ",\"host_us\":{\"layout\":%" PRIu32 ",\"render\":%" PRIu32 "}", f->layout_us, f->render_us);
+    fprintf(s_sim.out, ",\"est_us\":{\"render\":%" PRIu32 ",\"flush\":%" PRIu32 ",\"wait\":%" PRIu32 ",\"frame\":%" PRIu32 "}}\n",
+           f->render_est_us, f->flush_est_us, f->wait_est_us, f->frame_est_us);
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+// 按 offsetof 取出一列，打 p50/p95/max
+static void print_dist(const char *name, const sim_mark_t *m, size_t off, uint32_t *tmp)
+{
+    for (uint32_t i = 0; i < m->count; i++)
+        tmp[i] = *(const uint32_t *)((const uint8_t *)&m->frames[i] + off);
+    qsort(tmp, m->count, sizeof(uint32_t), cmp_u32);
+    uint32_t p50 = tmp[(m->count - 1) * 50 / 100];
+    uint32_t p95 = tmp[(m->count - 1) * 95 / 100];
+    fprintf(s_sim.out, ",\"%s\":{\"p50\":%" PRIu32 ",\"p95\":%" PRIu32 ",\"max\":%" PRIu32 "}", name, p50, p95, tmp[m->count - 1]);
+}
+
+static void print_summary(void)
+{
+    for (int i = 0; i < s_sim.mark_count; i++)
+    {
+        const sim_mark_t *m = &s_sim.marks[i];
+        if (m->count == 0)
+            continue;
+        uint32_t *tmp = malloc(m->count * sizeof(uint32_t));
+        if (!tmp)
+            return;
+        uint64_t bytes = 0, win_cmds = 0, ramwrc = 0, flushes = 0, inv_px = 0, round_px = 0;
+        for (uint32_t j = 0; j < m->count; j++)
+        {
+            bytes += m->frames[j].bytes;
+            win_cmds += m->frames[j].win_cmds;
+            ramwrc += m->frames[j].ramwrc;
+            flushes += m->frames[j].flushes;
+            inv_px += m->frames[j].inv_px;
+            round_px += m->frames[j].round_px;
+        }
+        fprintf(s_sim.out, "{\"schema\":%d,\"type\":\"summary\",\"mark\":", SIM_SCHEMA);
+        json_str(m->name);
+        fprintf(s_sim.out, ",\"frames\":%" PRIu32, m->count);
+        print_dist("frame_est_us", m, offsetof(sim_frame_t, frame_est_us), tmp);
+        print_dist("render_est_us", m, offsetof(sim_frame_t, render_est_us), tmp);
+        print_dist("flush_est_us", m, offsetof(sim_frame_t, flush_est_us), tmp);
+        print_dist("wait_est_us", m, offsetof(sim_frame_t, wait_est_us), tmp);
+        print_dist("render_host_us", m, offsetof(sim_frame_t, render_us), tmp);
+        fprintf(s_sim.out, ",\"flushes\":%" PRIu64 ",\"bytes\":%" PRIu64 ",\"win_cmds\":%" PRIu64 ",\"ramwrc\":%" PRIu64
+               ",\"inv_px\":%" PRIu64 ",\"round_px\":%" PRIu64 "}\n",
+               flushes, bytes, win_cmds, ramwrc, inv_px, round_px);
+        free(tmp);
+        ESP_LOGI(TAG, "%-16s %5" PRIu32 " frames, %.2f MB sent", m->name, m->count, bytes / 1048576.0);
+    }
+
+    bench_heap_stats_t heap;
+    bench_heap_get_stats(&heap);
+    fprintf(s_sim.out, "{\"schema\":%d,\"type\":\"total\",\"frames\":%" PRIu32 ",\"virtual_ms\":%" PRIu32
+           ",\"heap\":{\"peak\":%zu,\"current\":%zu}}\n",
+           SIM_SCHEMA, s_sim.frames, s_sim.now_ms, heap.peak, heap.current);
+}
+
+static bool set_mark(const char *name)
+{
+    if (s_sim.mark_count == SIM_MAX_MARKS)
+        return false;
+    sim_mark_t *m = &s_sim.marks[s_sim.mark_count++];
+    snprintf(m->name, sizeof(m->name), "%s", name);
+    return true;
+}
+
+// 拨一步虚拟时钟，像 esp_lvgl_port 的任务一样持锁跑一次 lv_timer_handler。
+// 按估算板子还在算上一帧时，钟拨到它算完为止
+static void step(void)
+{
+    uint32_t busy = sim_display_busy_until();
+    s_sim.now_ms += SIM_STEP_MS;
+    if ((int32_t)(busy - s_sim.now_ms) > 0)
+        s_sim.now_ms = busy;
+    lvgl_port_lock(0);
+    lv_timer_handler();
+    lvgl_port_unlock();
+    usleep(SIM_YIELD_US);
+}
+
+static void run_ms(uint32_t ms)
+{
+    for (uint32_t t = 0; t < ms; t += SIM_STEP_MS)
+        step();
+}
+
+static void touch(int n, int x0, int y0, int x1, int y1)
+{
+    s_sim.touch[0].x = x0;
+    s_sim.touch[0].y = y0;
+    s_sim.touch[1].x = x1;
+    s_sim.touch[1].y = y1;
+    sim_touch_set(n, s_sim.touch);
+}
+
+// 触点从 from 线性移到 to（两指时是两个点的坐标），每步一个位置，最后抬起
+static void drag(int n, const int from[4], const int to[4], uint32_t ms)
+{
+    uint32_t steps = ms / SIM_STEP_MS ? ms / SIM_STEP_MS : 1;
+    touch(n, from[0], from[1], from[2], from[3]);
+    step();
+    for (uint32_t i = 1; i <= steps; i++)
+    {
+        int p[4];
+        for (int k = 0; k < 4; k++)
+            p[k] = from[k] + (to[k] - from[k]) * (int)i / (int)steps;
+        touch(n, p[0], p[1], p[2], p[3]);
+        step();
+    }
+    touch(0, 0, 0, 0, 0);
+    run_ms(2 * SIM_STEP_MS);
+}
+
+static uint32_t loader_pending(void)
+{
+    img_loader_stats_t st;
+    img_loader_get_stats(&st);
+    return st.submitted - st.hits - st.done - st.failed - st.dropped;
+}
+
+// 缩略图、缩放分块这些页面自己的后台任务没有统计可查，只能看一段真实时间里没有新的帧
+static void settle(uint32_t max_ms)
+{
+    int64_t quiet_since = esp_timer_get_time();
+    uint32_t anims = 0, pending = 0;
+    bool drawing = false;
+    for (uint32_t t = 0; t < max_ms; t += SIM_STEP_MS)
+    {
+        uint32_t frames = s_sim.frames;
+        step();
+        lvgl_port_lock(0);
+        anims = lv_anim_count_running();
+        lvgl_port_unlock();
+        pending = loader_pending();
+        drawing = frames != s_sim.frames;
+        int64_t now = esp_timer_get_time();
+        if (anims || pending || drawing)
+            quiet_since = now;
+        else if (now - quiet_since >= SIM_SETTLE_QUIET_US)
+            return;
+        else
+            usleep(SIM_SETTLE_POLL_US);
+    }
+    ESP_LOGW(TAG, "settle: still busy after %" PRIu32 " ms (%" PRIu32 " anims, %" PRIu32 " loads pending, %s)", max_ms,
+             anims, pending, drawing ? "drawing" : "idle");
+}
+
+// 固件里是回到进游戏前的那页，脚本直接打开的游戏页没有上一页，回第二页
+static void game_back_cb(lv_event_t *e)
+{
+    lv_scr_load_anim(page1_create(), LV_SCR_LOAD_ANIM_FADE_OUT, 200, 0, true);
+}
+
+// 和 page1.c 的 Game1 按钮建的页面一样
+static lv_obj_t *game_page_create(void)
+{
+    lv_obj_t *scr = lv_obj_create(NULL);
+    lv_obj_set_style_bg_color(scr, lv_color_black(), 0);
+    lv_obj_t *game = lv_100ask_2048_create(scr);
+    lv_obj_set_size(game, LV_PCT(100), LV_PCT(100));
+    lv_obj_center(game);
+
+    lv_obj_t *back = lv_btn_create(scr);
+    lv_obj_set_size(back, 78, 42);
+    lv_obj_align(back, LV_ALIGN_BOTTOM_LEFT, 80, -30);
+    lv_obj_add_event_cb(back, game_back_cb, LV_EVENT_CLICKED, NULL);
+    lv_obj_t *lbl = lv_label_create(back);
+    lv_label_set_text(lbl, LV_SYMBOL_LEFT " Back");
+    lv_obj_center(lbl);
+    return scr;
+}
+
+static bool open_page(const char *name, const char *arg)
+{
+    lv_obj_t *page = NULL;
+
+    lvgl_port_lock(0);
+    if (strcmp(name, "lock") == 0)
+        page = page_lock_create();
+    else if (strcmp(name, "main") == 0)
+        page = page_main_create();
+    else if (strcmp(name, "page1") == 0)
+        page = page1_create();
+    else if (strcmp(name, "settings") == 0)
+        page = settings_page();
+    else if (strcmp(name, "game") == 0)
+        page = game_page_create();
+    else if (strcmp(name, "album") == 0 && arg)
+        page = photo_album_create(arg, BSP_LCD_H_RES, BSP_LCD_V_RES, true);
+    else if (strcmp(name, "grid") == 0 && arg)
+        page = photo_grid_create(arg, BSP_LCD_H_RES, BSP_LCD_V_RES, 0);
+
+    // 锁屏页自己带动画切过去，其余的直接换上
+    lv_display_t *disp = lv_display_get_default();
+    if (page && page != lv_screen_active() && page != disp->scr_to_load)
+        lv_scr_load_anim(page, LV_SCR_LOAD_ANIM_NONE, 0, 0, true);
+    lvgl_port_unlock();
+
+    if (!page)
+        ESP_LOGE(TAG, "page %s%s%s failed", name, arg ? " " : "", arg ? arg : "");
+    return page != NULL;
+}
+
+static bool run_line(char *line)
+{
+    char cmd[16], a[PATH_MAX];
+    int v[5];
+    int n;
+
+    char *p = line + strspn(line, " \t");
+    if (*p == '#' || *p == '\0' || *p == '\n')
+        return true;
+    if (sscanf(p, "%15s", cmd) != 1)
+        return false;
+    p += strlen(cmd);
+
+    if (strcmp(cmd, "page") == 0)
+    {
+        char name[16];
+        n = sscanf(p, "%15s %4095s", name, a);
+        return n >= 1 && open_page(name, n == 2 ? a : NULL);
+    }
+    if (strcmp(cmd, "tap") == 0 && sscanf(p, "%d %d", &v[0], &v[1]) == 2)
+    {
+        touch(1, v[0], v[1], 0, 0);
+        run_ms(4 * SIM_STEP_MS);
+        touch(0, 0, 0, 0, 0);
+        run_ms(4 * SIM_STEP_MS);
+        return true;
+    }
+    if ((strcmp(cmd, "press") == 0 || strcmp(cmd, "move") == 0) && sscanf(p, "%d %d", &v[0], &v[1]) == 2)
+    {
+        touch(1, v[0], v[1], 0, 0);
+        step();
+        return true;
+    }
+    if (strcmp(cmd, "release") == 0)
+    {
+        touch(0, 0, 0, 0, 0);
+        step();
+        return true;
+    }
+    if (strcmp(cmd, "swipe") == 0 && (n = sscanf(p, "%d %d %d %d %d", &v[0], &v[1], &v[2], &v[3], &v[4])) >= 4)
+    {
+        const int from[4] = {v[0], v[1], 0, 0};
+        const int to[4] = {v[2], v[3], 0, 0};
+        drag(1, from, to, n == 5 ? (uint32_t)v[4] : 200);
+        return true;
+    }
+    if (strcmp(cmd, "pinch") == 0 && (n = sscanf(p, "%d %d %d %d %d", &v[0], &v[1], &v[2], &v[3], &v[4])) >= 4)
+    {
+        const int from[4] = {v[0] - v[2] / 2, v[1], v[0] + v[2] / 2, v[1]};
+        const int to[4] = {v[0] - v[3] / 2, v[1], v[0] + v[3] / 2, v[1]};
+        drag(2, from, to, n == 5 ? (uint32_t)v[4] : 300);
+        return true;
+    }
+    if (strcmp(cmd, "wait") == 0 && sscanf(p, "%d", &v[0]) == 1 && v[0] >= 0)
+    {
+        run_ms((uint32_t)v[0]);
+        return true;
+    }
+    if (strcmp(cmd, "settle") == 0)
+    {
+        settle(sscanf(p, "%d", &v[0]) == 1 && v[0] > 0 ? (uint32_t)v[0] : 5000);
+        return true;
+    }
+    if (strcmp(cmd, "shot") == 0 && sscanf(p, "%4095s", a) == 1)
+        return sim_display_shot(a) == ESP_OK;
+    if (strcmp(cmd, "mark") == 0 && sscanf(p, "%4095s", a) == 1)
+        return set_mark(a);
+    if (strcmp(cmd, "profile") == 0 && sscanf(p, "%4095s", a) == 1)
+    {
+        lvgl_port_lock(0);
+        if (strcmp(a, "reset") == 0)
+            frame_prof_reset();
+        else
+            frame_prof_dump(stderr);
+        lvgl_port_unlock();
+        return true;
+    }
+    return false;
+}
+
+static int rm_entry(const char *path, const struct stat *st, int flag, struct FTW *ftw)
+{
+    return remove(path);
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [options] -s script.txt\n"
+            "  -s, --script FILE     touch/page script, see the top of ui_sim.c\n"
+            "      --spiffs DIR      folder mapped to /spiffs (default: the firmware's spiffs/)\n"
+            "      --sdcard DIR      folder mapped to /sdcard (default: no card)\n"
+            "      --overlay DIR     where writes go (default: a temporary folder removed at exit)\n"
+            "      --qspi-mhz F      panel QSPI clock (default 40)\n"
+            "      --txn-us F        fixed cost per SPI transaction (default 8)\n"
+            "      --cpu-scale F     host render time x F = ESP32-S3 estimate (default 8)\n"
+            "      --sysmon          keep LVGL's FPS/CPU label (it redraws every 300 ms, so settle never goes quiet)\n"
+            "  -v, --verbose         more logs on stderr, repeat for debug\n",
+            prog);
+}
+
+int main(int argc, char **argv)
+{
+    static const struct option opts[] = {
+        {"script", required_argument, NULL, 's'},
+        {"spiffs", required_argument, NULL, 'S'},
+        {"sdcard", required_argument, NULL, 'D'},
+        {"overlay", required_argument, NULL, 'o'},
+        {"qspi-mhz", required_argument, NULL, 'q'},
+        {"txn-us", required_argument, NULL, 't'},
+        {"cpu-scale", required_argument, NULL, 'c'},
+        {"sysmon", no_argument, NULL, 'm'},
+        {"verbose", no_argument, NULL, 'v'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0},
+    };
+    sim_panel_cfg_t panel = SIM_PANEL_DEFAULT_CFG();
+    const char *script = NULL, *spiffs = SIM_FW_DIR "/spiffs", *sdcard = NULL, *overlay = NULL;
+    bool sysmon = false;
+    int c;
+    while ((c = getopt_long(argc, argv, "s:vh", opts, NULL)) != -1)
+    {
+        switch (c)
+        {
+        case 's':
+            script = optarg;
+            break;
+        case 'S':
+            spiffs = optarg;
+            break;
+        case 'D':
+            sdcard = optarg;
+            break;
+        case 'o':
+            overlay = optarg;
+            break;
+        case 'q':
+            panel.qspi_mhz = strtof(optarg, NULL);
+            break;
+        case 't':
+            panel.txn_us = strtof(optarg, NULL);
+            break;
+        case 'c':
+            panel.cpu_scale = strtof(optarg, NULL);
+            break;
+        case 'm':
+            sysmon = true;
+            break;
+        case 'v':
+            bench_log_level++;
+            break;
+        default:
+            usage(argv[0]);
+            return c == 'h' ? 0 : 2;
+        }
+    }
+    if (!script || optind != argc || panel.qspi_mhz <= 0 || panel.cpu_scale <= 0)
+    {
+        usage(argv[0]);
+        return 2;
+    }
+    // 页面代码有些日志直接 printf，把 stdout 转到 stderr，结果写到原来的 stdout
+    s_sim.out = fdopen(dup(STDOUT_FILENO), "w");
+    if (!s_sim.out || dup2(STDERR_FILENO, STDOUT_FILENO) < 0)
+        return 1;
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    FILE *f = fopen(script, "r");
+    if (!f)
+    {
+        ESP_LOGE(TAG, "cannot open %s", script);
+        return 2;
+    }
+
+    char tmp_overlay[] = "/tmp/ui_sim.XXXXXX";
+    if (!overlay)
+    {
+        overlay = mkdtemp(tmp_overlay);
+        if (!overlay)
+        {
+            ESP_LOGE(TAG, "cannot create a temporary folder");
+            return 1;
+        }
+    }
+
+    // 和 main.c 的 app_main 同样的顺序
+    sim_bsp_init();
+    ESP_ERROR_CHECK(sim_fs_map(BSP_SPIFFS_MOUNT_POINT, spiffs, overlay));
+    ESP_ERROR_CHECK(sim_fs_map(BSP_SD_MOUNT_POINT, sdcard, overlay));
+    img_cache_init(IMG_CACHE_DEFAULT_BUDGET);
+    img_loader_init(IMG_LOADER_DEFAULT_WORKERS);
+    media_index_init();
+
+    lv_init();
+    lv_tick_set_cb(sim_tick);
+    set_mark("boot");
+    lvgl_port_lock(0);
+    lv_display_t *disp = sim_display_create(&panel, on_frame, NULL);
+    if (disp)
+        sim_touch_create_indev(disp);
+#if LV_USE_PERF_MONITOR
+    // 固件的 sdkconfig 开着 LVGL 的 FPS/CPU 角标，它在主机上量的是主机，还每 300 ms 重画一次
+    if (disp && !sysmon)
+        lv_sysmon_hide_performance(disp);
+#endif
+    frame_prof_init(disp);
+    lvgl_port_unlock();
+    if (!disp)
+        return 1;
+    touch_multi_init();
+    page_lock_create();
+
+    char line[PATH_MAX + 64];
+    int lineno = 0, ret = 0;
+    while (fgets(line, sizeof(line), f))
+    {
+        lineno++;
+        ESP_LOGD(TAG, "%s:%d: %.*s", script, lineno, (int)strcspn(line, "\r\n"), line);
+        if (!run_line(line))
+        {
+            ESP_LOGE(TAG, "%s:%d: bad command: %s", script, lineno, line);
+            ret = 2;
+            break;
+        }
+    }
+    fclose(f);
+
+    print_summary();
+    fflush(s_sim.out);
+    if (overlay == tmp_overlay)
+        nftw(tmp_overlay, rm_entry, 16, FTW_DEPTH | FTW_PHYS);
+    return ret;
+}